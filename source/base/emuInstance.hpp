@@ -3,6 +3,7 @@
 #include "../emuInstanceBase.hpp"
 #include <string>
 #include <vector>
+#include <memory>
 #include <jaffarCommon/exceptions.hpp>
 #include <jaffarCommon/json.hpp>
 #include <jaffarCommon/serializers/contiguous.hpp>
@@ -45,9 +46,92 @@ class EmuInstance : public EmuInstanceBase
 
   std::string getCoreName() const override { return "Base DSDA"; }
 
+  // The original core has no sizing pass, so the size is only known after archiving into a large enough buffer
+  size_t getArchiveSizeImpl() const override
+  {
+    headlessSetSaveStatePointer(_sizingBuffer.get(), _SIZING_BUFFER_SIZE);
+    dsda_ArchiveAll();
+    return headlessGetEffectiveSaveSize();
+  }
+
+  size_t writeArchiveImpl(uint8_t* buffer, const size_t size) override
+  {
+    headlessSetSaveStatePointer(buffer, size);
+    dsda_ArchiveAll();
+    return headlessGetEffectiveSaveSize();
+  }
+
+  // The original core keeps no per thinker accounting, so only the archive as a whole is reported
+  void printSaveStateReport() const override
+  {
+    jaffarCommon::logger::log("[] Save State Archive Size:                %lu bytes (no thinker breakdown in the %s core)\n", getArchiveSizeImpl(), getCoreName().c_str());
+  }
+
+  size_t packWorldHashDataImpl(uint8_t* buffer, const size_t capacity) const override
+  {
+    JAFFAR_THROW_LOGIC("The full world hash scope is not supported by the %s core\n", getCoreName().c_str());
+    return 0;
+  }
+
+  void trackWorldHashImpl() override
+  {
+    JAFFAR_THROW_LOGIC("The incremental world hash scope is not supported by the %s core\n", getCoreName().c_str());
+  }
+
+  void getWorldHashImpl(uint64_t* hash) const override
+  {
+    JAFFAR_THROW_LOGIC("The incremental world hash scope is not supported by the %s core\n", getCoreName().c_str());
+  }
+
+  bool checkWorldHashImpl() override
+  {
+    JAFFAR_THROW_LOGIC("The incremental world hash scope is not supported by the %s core\n", getCoreName().c_str());
+    return false;
+  }
+
+  bool checkStateSectionsImpl(const uint8_t* state, const size_t stateSize) const override
+  {
+    JAFFAR_THROW_LOGIC("Save sections are not supported by the %s core\n", getCoreName().c_str());
+    return false;
+  }
+
+  void getTickCommandKeyImpl(const int playerId, const jaffar::playerInput_t &input, ticcmd_t &key) const override
+  {
+    JAFFAR_THROW_LOGIC("Input keys are not supported by the %s core\n", getCoreName().c_str());
+  }
+
+  bool canUseLinesImpl(const int playerId, const int16_t angleturn) const override
+  {
+    JAFFAR_THROW_LOGIC("Probing for usable lines is not supported by the %s core\n", getCoreName().c_str());
+    return false;
+  }
+
+  void getFeaturesImpl(gameFeatures_t& features) const override
+  {
+    JAFFAR_THROW_LOGIC("Game features are not supported by the %s core\n", getCoreName().c_str());
+  }
+
+  bool getStateFeaturesImpl(const uint8_t* state, const size_t stateSize, gameFeatures_t& features) const override
+  {
+    JAFFAR_THROW_LOGIC("Game features are not supported by the %s core\n", getCoreName().c_str());
+    return false;
+  }
+
+  void enableLevelArenaImpl(const size_t size) override
+  {
+    JAFFAR_THROW_LOGIC("Level arena snapshots are not supported by the %s core\n", getCoreName().c_str());
+  }
+
+  size_t getLevelArenaStateSizeImpl() const override { return 0; }
+  size_t getLevelArenaEffectiveSizeImpl() const override { return 0; }
+  void serializeLevelArenaImpl(jaffarCommon::serializer::Base& s) const override {}
+  void deserializeLevelArenaImpl(jaffarCommon::deserializer::Base& d) override {}
+
 
   private:
 
+  static constexpr size_t _SIZING_BUFFER_SIZE = 4 * 1024 * 1024;
+  std::unique_ptr<uint8_t[]> _sizingBuffer = std::make_unique<uint8_t[]>(_SIZING_BUFFER_SIZE);
 };
 
 } // namespace jaffar
\ No newline at end of file
@@ -9,8 +9,13 @@
 #include <jaffarCommon/serializers/contiguous.hpp>
 #include <jaffarCommon/deserializers/contiguous.hpp>
 #include "inputParser.hpp"
+#include "gameFeatures.h"
+#include "wadRegistry.hpp"
 #include <d_player.h>
 #include <w_wad.h>
+#include <deque>
+#include <thread>
+#include <vector>
 
 #ifdef _ENABLE_RENDERING
 #include <SDL.h>
@@ -53,17 +58,35 @@ extern "C"
 
 // Players information
 extern "C" __STORAGE_MODIFIER int enableOutput;
-extern "C" __STORAGE_MODIFIER player_t players[MAX_MAXPLAYERS];
 extern "C" __STORAGE_MODIFIER int preventLevelExit;
 extern "C" __STORAGE_MODIFIER int preventGameEnd;
 extern "C" __STORAGE_MODIFIER int reachedLevelExit;
 extern "C" __STORAGE_MODIFIER int reachedGameEnd;
 extern "C" __STORAGE_MODIFIER int gamemap;
-extern "C" __STORAGE_MODIFIER int gametic;
-extern "C" __STORAGE_MODIFIER dboolean playeringame[MAX_MAXPLAYERS];
 extern "C" __STORAGE_MODIFIER int consoleplayer;
 extern "C" __STORAGE_MODIFIER int displayplayer;
 
+#ifdef _JAFFAR_ENGINE_CONTEXT
+extern "C"
+{
+  #include <d_context.h>
+}
+#else
+extern "C" __STORAGE_MODIFIER player_t players[MAX_MAXPLAYERS];
+extern "C" __STORAGE_MODIFIER int gametic;
+extern "C" __STORAGE_MODIFIER dboolean playeringame[MAX_MAXPLAYERS];
+
+// Cores without an engine context keep its state in plain globals, reached through the same name
+struct engineContextGlobals_t
+{
+  player_t (&players)[MAX_MAXPLAYERS];
+  dboolean (&playeringame)[MAX_MAXPLAYERS];
+  int &gametic;
+};
+static engineContextGlobals_t engineContextGlobals { players, playeringame, gametic };
+static engineContextGlobals_t *const engine_context = &engineContextGlobals;
+#endif
+
 namespace jaffar
 {
 
@@ -73,7 +96,7 @@ class EmuInstanceBase
 {
   public:
 
-  EmuInstanceBase(const nlohmann::json &config)
+  EmuInstanceBase(const nlohmann::json &config) : _config(config)
   {
     // Getting IWAD File Path
     _IWADFilePath = jaffarCommon::json::getString(config, "IWAD File Path");
@@ -81,9 +104,36 @@ class EmuInstanceBase
     // Getting expected IWAD SHA1 hash
     _expectedIWADSHA1 = jaffarCommon::json::getString(config, "Expected IWAD SHA1");
 
-    // Getting maximum state size
-    _stateSize = jaffarCommon::json::getNumber<size_t>(config, "State Size");
+    // Getting the file that keeps WAD hashes across launches (optional, hashing them on every launch otherwise).
+    // A cached hash is trusted without rehashing while the file's path, size, modification time, inode and the
+    // hash of its first and last bytes match (see WadRegistry), so only use it for WADs that are not edited in place.
+    _WADHashCacheFilePath = config.contains("WAD Hash Cache File Path") ? jaffarCommon::json::getString(config, "WAD Hash Cache File Path") : "";
+
+    // Getting level arena size (optional, zero disables the level arena snapshot mode)
+    _levelArenaSize = config.contains("Level Arena Size") ? jaffarCommon::json::getNumber<size_t>(config, "Level Arena Size") : 0;
+
+    // Getting the parts of the state covered by the state hash (optional, player only by default)
+    _hashScope = hashScope_t::player;
+    if (config.contains("Hash Scope"))
+    {
+      const auto hashScope = jaffarCommon::json::getString(config, "Hash Scope");
+      bool hashScopeRecognized = false;
+      if (hashScope == "Player")      { _hashScope = hashScope_t::player; hashScopeRecognized = true; }
+      if (hashScope == "All Players") { _hashScope = hashScope_t::allPlayers; hashScopeRecognized = true; }
+      if (hashScope == "Full World")  { _hashScope = hashScope_t::fullWorld; hashScopeRecognized = true; }
+      if (hashScope == "Incremental World") { _hashScope = hashScope_t::incrementalWorld; hashScopeRecognized = true; }
+      if (hashScopeRecognized == false) JAFFAR_THROW_LOGIC("Unrecognized hash scope: '%s'\n", hashScope.c_str());
+    }
  
+    // Getting the values tried when enumerating legal inputs (optional, see inputGrid_t for the defaults)
+    if (config.contains("Input Grid")) _inputGrid = jaffar::inputGrid_t(jaffarCommon::json::getObject(config, "Input Grid"));
+
+    // Getting the rewind buffer settings (optional, a zero size disables it)
+    _rewindBufferSize = config.contains("Rewind Buffer Size") ? jaffarCommon::json::getNumber<size_t>(config, "Rewind Buffer Size") : 0;
+    _rewindKeyframeInterval = config.contains("Rewind Keyframe Interval") ? jaffarCommon::json::getNumber<size_t>(config, "Rewind Keyframe Interval") : 16;
+    _rewindFullKeyframeInterval = config.contains("Rewind Full Keyframe Interval") ? jaffarCommon::json::getNumber<size_t>(config, "Rewind Full Keyframe Interval") : 8;
+    if (_rewindKeyframeInterval == 0 || _rewindFullKeyframeInterval == 0) JAFFAR_THROW_LOGIC("Rewind keyframe intervals must be at least 1\n");
+
     // Getting Doom parameters
     _skill  = jaffarCommon::json::getNumber<unsigned int>(config, "Skill Level");
     _episode  = jaffarCommon::json::getNumber<unsigned int>(config, "Episode");
@@ -128,37 +178,40 @@ class EmuInstanceBase
 
   virtual ~EmuInstanceBase() 
   {
+    free(_saveData);
+    free(_deltaData);
+    free(_deltaStateData);
+    free(_startStateData);
+
+    #ifdef _ENABLE_RENDERING
+    free(_videoBuffer);
+    #endif
   }
 
   void initialize()
   {
-    // Loading IWAD File
-    if (jaffarCommon::file::loadStringFromFile(_IWADFileDataBuffer, _IWADFilePath) == false) JAFFAR_THROW_LOGIC("Could not IWAD file: %s\n", _IWADFilePath.c_str());
-
-    // Calculating IWAD SHA1
-    auto IWADSHA1 = jaffarCommon::hash::getSHA1String(_IWADFileDataBuffer);
+    // Getting the IWAD file, shared with every other instance in the process
+    auto IWAD = WadRegistry::get(_IWADFilePath, _WADHashCacheFilePath);
+    if (IWAD == nullptr) JAFFAR_THROW_LOGIC("Could not IWAD file: %s\n", _IWADFilePath.c_str());
 
     // Checking with the expected SHA1 hash
-    if (IWADSHA1 != _expectedIWADSHA1) JAFFAR_THROW_LOGIC("Wrong IWAD SHA1. Found: '%s', Expected: '%s'\n", IWADSHA1.c_str(), _expectedIWADSHA1.c_str());
+    if (IWAD->sha1 != _expectedIWADSHA1) JAFFAR_THROW_LOGIC("Wrong IWAD SHA1. Found: '%s', Expected: '%s'\n", IWAD->sha1.c_str(), _expectedIWADSHA1.c_str());
 
     // Loading IWAD into DSDA
-    AddIWAD(_IWADFilePath.c_str(), _IWADFileDataBuffer.data(), _IWADFileDataBuffer.size());
+    AddIWAD(_IWADFilePath.c_str(), (void*) IWAD->data, IWAD->size);
 
     // Loading PWAD Files
-    _PWADFileDataBuffers.resize(_PWADFilePaths.size());
     for (size_t i = 0; i < _PWADFilePaths.size(); i++)
     {
-      // Loading PWAD File
-      if (jaffarCommon::file::loadStringFromFile(_PWADFileDataBuffers[i], _PWADFilePaths[i]) == false) JAFFAR_THROW_LOGIC("Could not PWAD file: %s\n", _PWADFilePaths[i].c_str());
-
-      // Calculating IWAD SHA1
-      auto PWADSHA1 = jaffarCommon::hash::getSHA1String(_PWADFileDataBuffers[i]);
+      // Getting the PWAD file, shared with every other instance in the process
+      auto PWAD = WadRegistry::get(_PWADFilePaths[i], _WADHashCacheFilePath);
+      if (PWAD == nullptr) JAFFAR_THROW_LOGIC("Could not PWAD file: %s\n", _PWADFilePaths[i].c_str());
 
       // Checking with the expected SHA1 hash
-      if (PWADSHA1 != _PWADExpectedSHA1s[i]) JAFFAR_THROW_LOGIC("Wrong PWAD SHA1. Found: '%s', Expected: '%s'\n", PWADSHA1.c_str(), _PWADExpectedSHA1s[i].c_str());
+      if (PWAD->sha1 != _PWADExpectedSHA1s[i]) JAFFAR_THROW_LOGIC("Wrong PWAD SHA1. Found: '%s', Expected: '%s'\n", PWAD->sha1.c_str(), _PWADExpectedSHA1s[i].c_str());
 
-      // Loading IWAD into DSDA
-      D_AddFile(_PWADFilePaths[i].c_str(), source_pwad, _PWADFileDataBuffers[i].data(), _PWADFileDataBuffers[i].size());
+      // Loading PWAD into DSDA
+      D_AddFile(_PWADFilePaths[i].c_str(), source_pwad, (void*) PWAD->data, PWAD->size);
     }
 
     // Creating arguments
@@ -212,17 +265,24 @@ class EmuInstanceBase
     char arg8[] = "-nomonsters";
     if (_noMonsters) argv[argc++] = arg8;
 
+    // The engine state is per thread, so this is the thread the instance runs on from now on
+    _engineThread = std::this_thread::get_id();
+    bindEngineContextImpl();
+
     // Setting players in game
-    playeringame[0] = _player1Present;
-    playeringame[1] = _player2Present;
-    playeringame[2] = _player3Present;
-    playeringame[3] = _player4Present;
+    engine_context->playeringame[0] = _player1Present;
+    engine_context->playeringame[1] = _player2Present;
+    engine_context->playeringame[2] = _player3Present;
+    engine_context->playeringame[3] = _player4Present;
 
     // Getting player count
     auto playerCount = _player1Present + _player2Present + _player3Present + _player4Present;
     char arg9[] = "-solo-net";
     if (playerCount > 1) argv[argc++] = arg9;
 
+    // Level-lifetime memory must come from the arena since the very first level
+    if (_levelArenaSize > 0) enableLevelArenaImpl(_levelArenaSize);
+
     // Initializing DSDA core
     headlessMain(argc, argv);
 
@@ -243,8 +303,9 @@ class EmuInstanceBase
 
     #endif
 
-    // Setting save state size
-    _saveData = (uint8_t*)malloc(_stateSize);
+    // Level arena states are not archived into the save buffer, so delta coding needs its own copy.
+    // They can never exceed the thread globals plus the whole arena.
+    if (_levelArenaSize > 0) reserveBuffer(_deltaStateData, _deltaStateDataCapacity, getLevelArenaStateSizeImpl());
 
     // Setting level exit prevention flag
     if (_preventLevelExit == true) preventLevelExit = 1;
@@ -252,12 +313,19 @@ class EmuInstanceBase
     // Setting level exit prevention flag
     if (_preventGameEnd == true) preventGameEnd = 1;
 
+    // Keeping the world hash up to date, which costs a walk over the mobjs each tic, only if it is read
+    if (_hashScope == hashScope_t::incrementalWorld) trackWorldHashImpl();
+
     // Enabling DSDA output, for debugging
     enableOutput = 1;
   }
 
   virtual void advanceState(const jaffar::input_t &input)
   {
+    if (_rewindBufferSize > 0 && _rewindReplaying == false) recordRewindInput(input);
+
+    invalidateArchive();
+
     // Setting inputs
     headlessClearTickCommand();
     for (int i = 0; i < _playerCount; i++)
@@ -303,8 +371,8 @@ class EmuInstanceBase
 
     #endif
 
-    if (reachedLevelExit == 1) jaffarCommon::logger::log("[] Level Exit detected on tic:   %d\n", gametic);
-    if (reachedGameEnd   == 1) jaffarCommon::logger::log("[] Gane End detected on tic:   %d\n", gametic);
+    if (reachedLevelExit == 1) jaffarCommon::logger::log("[] Level Exit detected on tic:   %d\n", engine_context->gametic);
+    if (reachedGameEnd   == 1) jaffarCommon::logger::log("[] Gane End detected on tic:   %d\n", engine_context->gametic);
   }
 
   inline jaffarCommon::hash::hash_t getStateHash() const
@@ -314,18 +382,29 @@ class EmuInstanceBase
     // hash.Update(reachedLevelExit);
     // hash.Update(reachedGameEnd);
     hash.Update(gamemap);
-    hash.Update(gametic);
-    
-    if (players[0].mo != nullptr)
+    hash.Update(engine_context->gametic);
+
+    if (_hashScope == hashScope_t::player) hashPlayer(hash, 0);
+
+    if (_hashScope != hashScope_t::player)
+      for (int i = 0; i < MAX_MAXPLAYERS; i++)
+        if (engine_context->playeringame[i]) hashPlayer(hash, i);
+
+    // The world is packed into one contiguous buffer first, so hashing it is a single pass
+    if (_hashScope == hashScope_t::fullWorld)
+    {
+      size_t worldHashDataSize;
+      while ((worldHashDataSize = packWorldHashDataImpl(_worldHashData.data(), _worldHashData.size())) > _worldHashData.size())
+        _worldHashData.resize(worldHashDataSize);
+      hash.Update(_worldHashData.data(), worldHashDataSize);
+    }
+
+    // The core keeps this one up to date as the world changes, so reading it is O(1)
+    if (_hashScope == hashScope_t::incrementalWorld)
     {
-      hash.Update(players[0].mo->x);
-      hash.Update(players[0].mo->y);
-      hash.Update(players[0].mo->z);
-      hash.Update(players[0].mo->angle);
-      hash.Update(players[0].mo->momx);
-      hash.Update(players[0].mo->momy);
-      hash.Update(players[0].mo->momz);
-      hash.Update(players[0].mo->health);
+      uint64_t worldHash[2];
+      getWorldHashImpl(worldHash);
+      hash.Update(reinterpret_cast<const uint8_t *>(worldHash), sizeof(worldHash));
     }
 
     jaffarCommon::hash::hash_t result;
@@ -333,6 +412,31 @@ class EmuInstanceBase
     return result;
   }
 
+  static void hashPlayer(MetroHash128 &hash, const int playerId)
+  {
+    const auto mo = engine_context->players[playerId].mo;
+    if (mo == nullptr) return;
+
+    hash.Update(mo->x);
+    hash.Update(mo->y);
+    hash.Update(mo->z);
+    hash.Update(mo->angle);
+    hash.Update(mo->momx);
+    hash.Update(mo->momy);
+    hash.Update(mo->momz);
+    hash.Update(mo->health);
+  }
+
+  // Whether the world hash the core maintains incrementally matches one computed from scratch
+  bool checkWorldHash()
+  {
+    if (_hashScope != hashScope_t::incrementalWorld) JAFFAR_THROW_LOGIC("The world hash is only maintained under the incremental world hash scope\n");
+    return checkWorldHashImpl();
+  }
+
+  // Whether the sections of a serialized state, read back without loading it, hold the current game state
+  bool checkStateSections(const uint8_t* state, const size_t stateSize) const { return checkStateSectionsImpl(state, stateSize); }
+
   int getMapNumber () const { return gamemap; }
   bool isLevelExit () const { return reachedLevelExit == 1; }
   bool isGameEnd () const { return reachedGameEnd == 1; }
@@ -349,17 +453,17 @@ class EmuInstanceBase
     char mapName[512];
     headlessGetMapName(mapName);
     jaffarCommon::logger::log("[] Map:        %s\n", mapName);
-    jaffarCommon::logger::log("[] Game Tic:   %d\n", gametic);
+    jaffarCommon::logger::log("[] Game Tic:   %d\n", engine_context->gametic);
     jaffarCommon::logger::log("[] Level Exit: %s\n", reachedLevelExit == 1 ? "Yes" : "No");
     jaffarCommon::logger::log("[] Game End:   %s\n", reachedGameEnd   == 1 ? "Yes" : "No");
-    jaffarCommon::logger::log("[] Players:    %1d%1d%1d%1d\n", playeringame[0], playeringame[1], playeringame[2], playeringame[3]);
+    jaffarCommon::logger::log("[] Players:    %1d%1d%1d%1d\n", engine_context->playeringame[0], engine_context->playeringame[1], engine_context->playeringame[2], engine_context->playeringame[3]);
 
-    if (players[0].mo != nullptr)
+    if (engine_context->players[0].mo != nullptr)
     {
-      jaffarCommon::logger::log("[] Player 1 Coordinates:    (%f, %f, %f)\n", getFloatFrom1616Fixed(players[0].mo->x), getFloatFrom1616Fixed(players[0].mo->y), getFloatFrom1616Fixed(players[0].mo->z));
-      jaffarCommon::logger::log("[] Player 1 Angle:           %lu\n", players[0].mo->angle);
-      jaffarCommon::logger::log("[] Player 1 Momenta:        (%f, %f, %f)\n", getFloatFrom1616Fixed(players[0].mo->momx), getFloatFrom1616Fixed(players[0].mo->momy), getFloatFrom1616Fixed(players[0].mo->momz));
-      jaffarCommon::logger::log("[] Player 1 Health:          %d\n", players[0].mo->health);
+      jaffarCommon::logger::log("[] Player 1 Coordinates:    (%f, %f, %f)\n", getFloatFrom1616Fixed(engine_context->players[0].mo->x), getFloatFrom1616Fixed(engine_context->players[0].mo->y), getFloatFrom1616Fixed(engine_context->players[0].mo->z));
+      jaffarCommon::logger::log("[] Player 1 Angle:           %lu\n", engine_context->players[0].mo->angle);
+      jaffarCommon::logger::log("[] Player 1 Momenta:        (%f, %f, %f)\n", getFloatFrom1616Fixed(engine_context->players[0].mo->momx), getFloatFrom1616Fixed(engine_context->players[0].mo->momy), getFloatFrom1616Fixed(engine_context->players[0].mo->momz));
+      jaffarCommon::logger::log("[] Player 1 Health:          %d\n", engine_context->players[0].mo->health);
     }
   }
 
@@ -420,27 +524,256 @@ class EmuInstanceBase
     #endif
   }
 
-  inline size_t getStateSize() const 
+  // Exact size of the current state, as serializeState() would emit it
+  size_t getStateSize() const
   {
-    return _stateSize;
+    if (_levelArenaSize > 0) return getLevelArenaEffectiveSizeImpl();
+    return sizeof(size_t) + getArchiveSize();
   }
 
   inline jaffar::InputParser *getInputParser() const { return _inputParser.get(); }
   
-  void serializeState(jaffarCommon::serializer::Base& s) const
+  // The state is the archive size followed by the archive itself. Contiguous serializers get the archive
+  // written in place, into the room reserved for it, unless it was already taken for this state (say, for
+  // its digest); other serializers get a copy of it.
+  void serializeState(jaffarCommon::serializer::Base& s)
   {
-    headlessSetSaveStatePointer(_saveData, _stateSize);
-    dsda_ArchiveAll();
-    s.push(_saveData, _stateSize);
+    if (_levelArenaSize > 0) { serializeLevelArenaImpl(s); return; }
+
+    auto cs = dynamic_cast<jaffarCommon::serializer::Contiguous*>(&s);
+    if (cs == nullptr || _archiveValid == true)
+    {
+      const size_t stateSize = archiveState();
+      s.push(_saveData, stateSize);
+      return;
+    }
+
+    const size_t archiveSize = getArchiveSize();
+    uint8_t* stateData = cs->getOutputDataBuffer() == nullptr ? nullptr : &cs->getOutputDataBuffer()[cs->getOutputSize()];
+    cs->pushContiguous(nullptr, sizeof(size_t) + archiveSize);
+    if (stateData == nullptr) return;
+
+    memcpy(stateData, &archiveSize, sizeof(size_t));
+    writeArchive(&stateData[sizeof(size_t)], archiveSize);
   }
 
+  // Contiguous deserializers get the archive loaded in place, others through a copy of it
   void deserializeState(jaffarCommon::deserializer::Base& d) 
   {
-    d.pop(_saveData, _stateSize);
-    headlessSetSaveStatePointer(_saveData, _stateSize);
+    if (_rewindReplaying == false) clearRewind();
+    invalidateArchive();
+    if (_levelArenaSize > 0) { deserializeLevelArenaImpl(d); return; }
+
+    size_t archiveSize;
+    d.pop(&archiveSize, sizeof(size_t));
+
+    auto cd = dynamic_cast<jaffarCommon::deserializer::Contiguous*>(&d);
+    if (cd == nullptr)
+    {
+      reserveBuffer(_saveData, _saveDataCapacity, sizeof(size_t) + archiveSize);
+      d.pop(&_saveData[sizeof(size_t)], archiveSize);
+      unarchiveState(sizeof(size_t) + archiveSize);
+      return;
+    }
+
+    // The archive code only reads from the buffer while loading
+    uint8_t* archiveData = const_cast<uint8_t*>(&cd->getInputDataBuffer()[cd->getInputSize()]);
+    d.popContiguous(nullptr, archiveSize);
+    headlessSetSaveStatePointer(archiveData, archiveSize);
     dsda_UnArchiveAll();
   }
 
+  // Serializes the state as serializeState() does and also returns a digest of it, for use as a dedup key.
+  // The digest is the MetroHash128 of the archive, that is, of the serialized state past its size prefix
+  // (or of the whole snapshot, for level arena states). Cores that support it hash the archive while
+  // writing it, so both take a single pass over the state data. Returns the size written to the serializer.
+  size_t serializeStateAndHash(jaffarCommon::serializer::Base& s, jaffarCommon::hash::hash_t& digest)
+  {
+    MetroHash128 hash;
+    const size_t stateSize = archiveState(&hash);
+    hash.Finalize(reinterpret_cast<uint8_t *>(&digest));
+
+    s.push(getArchiveBuffer(), stateSize);
+    return stateSize;
+  }
+
+  // Returns the digest serializeStateAndHash() gives, without copying the state out
+  jaffarCommon::hash::hash_t getStateDigest()
+  {
+    MetroHash128 hash;
+    archiveState(&hash);
+    jaffarCommon::hash::hash_t digest;
+    hash.Finalize(reinterpret_cast<uint8_t *>(&digest));
+    return digest;
+  }
+
+  // Returns the same digest for a state serializeState() produced, hashing it where it is
+  jaffarCommon::hash::hash_t getStateDigest(const uint8_t* state, const size_t stateSize) const
+  {
+    MetroHash128 hash;
+    if (_levelArenaSize > 0) hash.Update(state, stateSize);
+    else hash.Update(&state[sizeof(size_t)], stateSize - sizeof(size_t));
+    jaffarCommon::hash::hash_t digest;
+    hash.Finalize(reinterpret_cast<uint8_t *>(&digest));
+    return digest;
+  }
+
+  // Encodes the current state as a delta against a reference state, as produced by serializeState().
+  // The XOR of both states is stored as alternating runs of unchanged bytes (length only) and changed bytes (length + XOR values).
+  // Bytes past the end of the reference are XORed against zero.
+  void serializeDeltaState(jaffarCommon::serializer::Base& s, const uint8_t* referenceState, const size_t referenceSize)
+  {
+    const size_t stateSize = archiveState();
+    const uint8_t* stateData = getArchiveBuffer();
+    const size_t commonSize = std::min(stateSize, referenceSize);
+
+    // Delta states are at most twice the full state, in case every other byte changed
+    reserveBuffer(_deltaData, _deltaDataCapacity, 2 * stateSize + 16);
+
+    uint8_t* output = encodeVarUInt(_deltaData, stateSize);
+    size_t pos = 0;
+    while (pos < stateSize)
+    {
+      // Unchanged run
+      const size_t unchangedStart = pos;
+      pos = findFirstDifference(stateData, referenceState, pos, commonSize);
+
+      // Changed run, it only ends once enough bytes in a row match again, to not pay for a new run header on every short gap
+      const size_t changedStart = pos;
+      size_t matchingBytes = 0;
+      while (pos < stateSize && matchingBytes < _DELTA_MIN_UNCHANGED_RUN)
+      {
+        matchingBytes = pos < commonSize && stateData[pos] == referenceState[pos] ? matchingBytes + 1 : 0;
+        pos++;
+      }
+      pos -= matchingBytes;
+
+      output = encodeVarUInt(output, changedStart - unchangedStart);
+      output = encodeVarUInt(output, pos - changedStart);
+      for (size_t i = changedStart; i < pos; i++) *output++ = stateData[i] ^ (i < commonSize ? referenceState[i] : 0);
+    }
+
+    const size_t deltaSize = output - _deltaData;
+    s.push(&deltaSize, sizeof(size_t));
+    s.push(_deltaData, deltaSize);
+    _effectiveDeltaSize = sizeof(size_t) + deltaSize;
+  }
+
+  // Rebuilds the full state from a delta and the same reference state it was encoded against, and loads it
+  void deserializeDeltaState(jaffarCommon::deserializer::Base& d, const uint8_t* referenceState, const size_t referenceSize)
+  {
+    if (_rewindReplaying == false) clearRewind();
+    invalidateArchive();
+
+    size_t deltaSize;
+    d.pop(&deltaSize, sizeof(size_t));
+    reserveBuffer(_deltaData, _deltaDataCapacity, deltaSize);
+    d.pop(_deltaData, deltaSize);
+
+    const uint8_t* const end = _deltaData + deltaSize;
+    size_t stateSize;
+    const uint8_t* input = decodeVarUInt(_deltaData, end, stateSize);
+    if (stateSize > referenceSize + deltaSize) JAFFAR_THROW_LOGIC("Delta state encodes more bytes than its reference and changes hold\n");
+    if (_levelArenaSize > 0 && stateSize > _deltaStateDataCapacity) JAFFAR_THROW_LOGIC("Delta state encodes %lu bytes, but level arena states are at most %lu\n", stateSize, _deltaStateDataCapacity);
+    if (_levelArenaSize == 0) reserveBuffer(_saveData, _saveDataCapacity, stateSize);
+
+    uint8_t* stateData = getArchiveBuffer();
+    const size_t commonSize = std::min(stateSize, referenceSize);
+    size_t pos = 0;
+    while (pos < stateSize)
+    {
+      size_t unchangedBytes, changedBytes;
+      input = decodeVarUInt(input, end, unchangedBytes);
+      input = decodeVarUInt(input, end, changedBytes);
+      if (unchangedBytes > (pos < commonSize ? commonSize - pos : 0) || changedBytes > stateSize - pos - unchangedBytes) JAFFAR_THROW_LOGIC("Delta state does not match its reference state\n");
+      if (unchangedBytes + changedBytes == 0) JAFFAR_THROW_LOGIC("Delta state holds an empty run\n");
+      if (changedBytes > (size_t)(end - input)) JAFFAR_THROW_LOGIC("Delta state is truncated\n");
+
+      memcpy(&stateData[pos], &referenceState[pos], unchangedBytes);
+      pos += unchangedBytes;
+      for (size_t i = 0; i < changedBytes; i++, pos++) stateData[pos] = *input++ ^ (pos < commonSize ? referenceState[pos] : 0);
+    }
+
+    unarchiveState(stateSize);
+  }
+
+  // Records the inputs advanced from now on, and a keyframe of the state every keyframeInterval tics, so
+  // rewind() can go back to any recorded tic. Keyframes are deltas against the last full one, and one in
+  // every fullKeyframeInterval is full. The oldest keyframes, and their inputs, are dropped to stay within
+  // bufferSize bytes. A zero size disables it. Loading a state clears what was recorded.
+  void enableRewind(const size_t bufferSize, const size_t keyframeInterval, const size_t fullKeyframeInterval)
+  {
+    if (keyframeInterval == 0 || fullKeyframeInterval == 0) JAFFAR_THROW_LOGIC("Rewind keyframe intervals must be at least 1\n");
+
+    _rewindBufferSize = bufferSize;
+    _rewindKeyframeInterval = keyframeInterval;
+    _rewindFullKeyframeInterval = fullKeyframeInterval;
+    clearRewind();
+  }
+
+  // One in how many rewind keyframes is full, as configured
+  size_t getRewindFullKeyframeInterval() const { return _rewindFullKeyframeInterval; }
+
+  // How many tics back rewind() can go
+  size_t getRewindDepth() const { return _rewindKeyframes.empty() ? 0 : _rewindTic - _rewindKeyframes.front().tic; }
+
+  // Memory held by the recorded keyframes and inputs
+  size_t getRewindMemorySize() const { return _rewindMemorySize; }
+
+  // Goes back the given number of tics, by loading the closest keyframe before and replaying the inputs
+  // since. What was recorded after that tic is dropped. Returns false, doing nothing, if it's not recorded.
+  bool rewind(const size_t tics)
+  {
+    if (tics > getRewindDepth()) return false;
+    if (tics == 0) return true;
+
+    const size_t targetTic = _rewindTic - tics;
+    size_t keyframeId = _rewindKeyframes.size() - 1;
+    while (_rewindKeyframes[keyframeId].tic > targetTic) keyframeId--;
+
+    // Recording and clearing on loads resume even if replaying throws
+    struct replayGuard_t
+    {
+      bool &replaying;
+      ~replayGuard_t() { replaying = false; }
+    };
+
+    const size_t firstTic = _rewindKeyframes.front().tic;
+    {
+      _rewindReplaying = true;
+      replayGuard_t replayGuard { _rewindReplaying };
+      loadRewindKeyframe(keyframeId);
+      for (size_t tic = _rewindKeyframes[keyframeId].tic; tic < targetTic; tic++) advanceState(_rewindInputs[tic - firstTic]);
+    }
+
+    while (_rewindKeyframes.back().tic > targetTic)
+    {
+      _rewindMemorySize -= _rewindKeyframes.back().data.size();
+      _rewindKeyframes.pop_back();
+    }
+    _rewindMemorySize -= (_rewindInputs.size() - (targetTic - firstTic)) * sizeof(jaffar::input_t);
+    _rewindInputs.resize(targetTic - firstTic);
+    _rewindTic = targetTic;
+
+    return true;
+  }
+
+  // Level arena states only load back into the instance that saved them
+  bool hasPortableStates() const { return _levelArenaSize == 0; }
+
+  // Records the current state as the one instances created from this one start from, and its hash, which
+  // each of them checks it reaches. Like any other engine call, it runs on this instance's thread.
+  void recordStartState()
+  {
+    if (hasPortableStates() == false) JAFFAR_THROW_LOGIC("Level arena states cannot start other instances\n");
+
+    _startStateSize = getStateSize();
+    reserveBuffer(_startStateData, _startStateDataCapacity, _startStateSize);
+    jaffarCommon::serializer::Contiguous s(_startStateData, _startStateSize);
+    serializeState(s);
+    _startStateHash = getStateHash();
+  }
+
   size_t getVideoBufferSize() const
   {
     #ifdef _ENABLE_RENDERING
@@ -457,35 +790,445 @@ class EmuInstanceBase
      return nullptr;
   }
   
-  size_t getEffectiveSaveStateSize() const { return headlessGetEffectiveSaveSize(); }
+  size_t getEffectiveSaveStateSize() const { return getStateSize(); }
+
+  // Size of the last delta produced by serializeDeltaState()
+  size_t getEffectiveDeltaStateSize() const { return _effectiveDeltaSize; }
+
+  // Key of the tic commands the input gives the players in the current state, without what the game
+  // is going to ignore of them. Inputs with the same key lead to the same next state, except for the
+  // copy of the last command each player keeps.
+  jaffarCommon::hash::hash_t getInputKey(const jaffar::input_t &input) const
+  {
+    MetroHash128 hash;
+
+    for (int i = 0; i < _playerCount; i++)
+    {
+      ticcmd_t key;
+      getTickCommandKeyImpl(i, input[i], key);
+      hash.Update(reinterpret_cast<const uint8_t *>(&key), sizeof(key));
+    }
+
+    jaffarCommon::hash::hash_t result;
+    hash.Finalize(reinterpret_cast<uint8_t *>(&result));
+    return result;
+  }
+
+  // Fills inputs with the inputs of the player, out of those on the grid, that can lead to distinct next
+  // states, packed as the player's part only: the other players stay idle (see jaffar::makePlayerInput).
+  // Inputs with the same key (see getInputKey) are only listed once. Use is only tried when it could
+  // activate a line: otherwise it can only hold the use key down, which is never better than releasing it.
+  // Probing for lines leaves the state untouched, so the first input can be played without reloading.
+  void getLegalInputs(std::vector<jaffar::playerInput_t> &inputs, const jaffar::inputGrid_t &grid, const int playerId = 0) const
+  {
+    inputs.clear();
+
+    // Movement and buttons are canonicalized separately, so their distinct options combine freely
+    _legalMoves.clear();
+    for (const auto forwardSpeed : grid.forwardSpeeds)
+      for (const auto strafingSpeed : grid.strafingSpeeds)
+        for (const auto turningSpeed : grid.turningSpeeds)
+        {
+          legalOption_t move;
+          move.input.forwardSpeed = forwardSpeed;
+          move.input.strafingSpeed = strafingSpeed;
+          move.input.turningSpeed = turningSpeed;
+          getTickCommandKeyImpl(playerId, move.input, move.key);
+
+          bool isNew = true;
+          for (const auto &other : _legalMoves)
+            if (other.key.forwardmove == move.key.forwardmove && other.key.sidemove == move.key.sidemove && other.key.angleturn == move.key.angleturn) { isNew = false; break; }
+          if (isNew) _legalMoves.push_back(move);
+        }
+
+    _legalButtons.clear();
+    bool hasAction = false;
+    for (int fire = 0; fire <= (grid.fire ? 1 : 0); fire++)
+      for (int action = 0; action <= (grid.action ? 1 : 0); action++)
+        for (int weapon = 0; weapon <= (grid.weapons ? 7 : 0); weapon++)
+          for (int altWeapon = 0; altWeapon <= (grid.weapons ? 1 : 0); altWeapon++)
+          {
+            legalOption_t buttons;
+            buttons.input.fire = fire == 1;
+            buttons.input.action = action == 1;
+            buttons.input.weapon = weapon;
+            buttons.input.altWeapon = altWeapon == 1;
+            getTickCommandKeyImpl(playerId, buttons.input, buttons.key);
+
+            bool isNew = true;
+            for (const auto &other : _legalButtons)
+              if (other.key.buttons == buttons.key.buttons) { isNew = false; break; }
+            if (isNew) _legalButtons.push_back(buttons);
+            if (isNew && buttons.input.action) hasAction = true;
+          }
+
+    for (const auto &move : _legalMoves)
+    {
+      // Use traces the line in front of the player after it turns
+      const bool canUse = hasAction && canUseLinesImpl(playerId, move.key.angleturn);
+
+      for (const auto &buttons : _legalButtons)
+      {
+        if (buttons.input.action && canUse == false) continue;
+
+        jaffar::playerInput_t input = buttons.input;
+        input.forwardSpeed = move.input.forwardSpeed;
+        input.strafingSpeed = move.input.strafingSpeed;
+        input.turningSpeed = move.input.turningSpeed;
+        inputs.push_back(input);
+      }
+    }
+  }
+
+  // Same, with the grid from the configuration
+  void getLegalInputs(std::vector<jaffar::playerInput_t> &inputs, const int playerId = 0) const { getLegalInputs(inputs, _inputGrid, playerId); }
+
+  // Fills the game features (see gameFeatures.h) of the current state
+  void getFeatures(gameFeatures_t& features) const { getFeaturesImpl(features); }
+
+  // Reads the game features of a state produced by serializeState() from its save sections, without loading it.
+  // The exit distance needs the level, so it is left negative. Returns false if the state has no sections, as
+  // with level arena states.
+  bool getFeatures(const uint8_t* state, const size_t stateSize, gameFeatures_t& features) const { return getStateFeaturesImpl(state, stateSize, features); }
 
   // Virtual functions
 
   virtual void doSoftReset() = 0;
   virtual void doHardReset() = 0;
   virtual std::string getCoreName() const = 0;
+  virtual void printSaveStateReport() const = 0;
 
   protected:
 
+  // Initializes the engine on the calling thread, and loads the state the source recorded with recordStartState().
+  // This is not a copy of the source's engine: it runs the whole engine setup, as initialize() does. Only the
+  // WAD files come already mapped and hashed, and whatever the source ran to reach that state is not run again.
+  void initializeFromStartState(const EmuInstanceBase& source)
+  {
+    if (source._startStateSize == 0) JAFFAR_THROW_LOGIC("The source instance has not recorded a start state\n");
+    if (source._engineThread == std::this_thread::get_id()) JAFFAR_THROW_LOGIC("A new instance needs a thread of its own, since the engine state is per thread\n");
+
+    initialize();
+    jaffarCommon::deserializer::Contiguous d(source._startStateData, source._startStateSize);
+    deserializeState(d);
+    if (getStateHash() != source._startStateHash) JAFFAR_THROW_LOGIC("An instance did not reach the start state hash of its source\n");
+  }
+
+  // Exact size of the current state's archive, from a sizing pass that does not write it
+  virtual size_t getArchiveSizeImpl() const = 0;
+
+  // Archives the current state into the buffer, which holds the size getArchiveSizeImpl() gave, and returns the size written
+  virtual size_t writeArchiveImpl(uint8_t* buffer, const size_t size) = 0;
+
+  // Packs the mobjs, sectors and RNG hashed by the full world hash scope into the buffer,
+  // if it fits, and returns the size they need
+  virtual size_t packWorldHashDataImpl(uint8_t* buffer, const size_t capacity) const = 0;
+
+  // Gets the 128 bit world hash the core maintains incrementally, for the incremental world hash scope,
+  // once told to keep it up to date
+  virtual void trackWorldHashImpl() = 0;
+  virtual void getWorldHashImpl(uint64_t* hash) const = 0;
+  virtual bool checkWorldHashImpl() = 0;
+  virtual bool checkStateSectionsImpl(const uint8_t* state, const size_t stateSize) const = 0;
+
+  virtual void getTickCommandKeyImpl(const int playerId, const jaffar::playerInput_t &input, ticcmd_t &key) const = 0;
+  virtual bool canUseLinesImpl(const int playerId, const int16_t angleturn) const = 0;
+  virtual void getFeaturesImpl(gameFeatures_t& features) const = 0;
+  virtual bool getStateFeaturesImpl(const uint8_t* state, const size_t stateSize, gameFeatures_t& features) const = 0;
+
+  // Sets the callback the core streams the archive's bytes through as it writes them (nullptr disables it).
+  // Returns false if the core can't do so.
+  virtual bool setArchiveHashImpl(void (*update)(const void* data, size_t size, void* context), void* context) { return false; }
+
+  // Points the calling thread's engine at the context the instance owns, if the core has one
+  virtual void bindEngineContextImpl() {};
 
   virtual void setWorkRamSerializationSizeImpl(const size_t size) {};
   virtual void enableStateBlockImpl(const std::string& block) {};
   virtual void disableStateBlockImpl(const std::string& block) {};
 
-  // State size
-  size_t _stateSize;
-  uint8_t* _saveData;
+  // Level arena snapshot mode: the state is a raw copy of the thread globals and the level arena,
+  // so it can only be loaded back into the same instance, during the same level
+  virtual void enableLevelArenaImpl(const size_t size) = 0;
+  virtual size_t getLevelArenaStateSizeImpl() const = 0;
+  virtual size_t getLevelArenaEffectiveSizeImpl() const = 0;
+  virtual void serializeLevelArenaImpl(jaffarCommon::serializer::Base& s) const = 0;
+  virtual void deserializeLevelArenaImpl(jaffarCommon::deserializer::Base& d) = 0;
+
+  // Configuration the instance was created with, which instances started from it are created with too
+  const nlohmann::json _config;
+
+  // Archive buffer, holding the archive size followed by the archive
+  uint8_t* _saveData = nullptr;
+  size_t _saveDataCapacity = 0;
+
+  // Level arena size (zero if disabled)
+  size_t _levelArenaSize;
 
   private:
 
+  // Parts of the state covered by getStateHash
+  enum class hashScope_t { player, allPlayers, fullWorld, incrementalWorld };
+  hashScope_t _hashScope;
+
+  // Packed world data for the full world hash scope, reused across calls
+  mutable std::vector<uint8_t> _worldHashData;
+
+  // Values tried by getLegalInputs when no grid is given
+  jaffar::inputGrid_t _inputGrid;
+
+  // Distinct movement and button options found by getLegalInputs, reused across calls
+  struct legalOption_t
+  {
+    jaffar::playerInput_t input;
+    ticcmd_t key;
+  };
+  mutable std::vector<legalOption_t> _legalMoves;
+  mutable std::vector<legalOption_t> _legalButtons;
+
+  // Archives the full state into the buffer returned by getArchiveBuffer() and returns its size.
+  // The buffer is sized by the core's sizing pass first (see getArchiveSize), so the archive is
+  // written without bounds checks. It is kept until the state changes, so archiving the same
+  // state again only hashes it, if asked. If a hash is given, the archive (past the size prefix)
+  // is fed to it, streamed by the core while writing if it can.
+  size_t archiveState(MetroHash128* hash = nullptr)
+  {
+    if (_levelArenaSize > 0)
+    {
+      jaffarCommon::serializer::Contiguous s(_deltaStateData, _deltaStateDataCapacity);
+      serializeLevelArenaImpl(s);
+      if (hash != nullptr) hash->Update(_deltaStateData, s.getOutputSize());
+      return s.getOutputSize();
+    }
+
+    if (_archiveValid == true)
+    {
+      if (hash != nullptr) hash->Update(&_saveData[sizeof(size_t)], getArchiveSize());
+      return sizeof(size_t) + getArchiveSize();
+    }
+
+    // Unsets the hash callback even if archiving throws, since it points to the caller's hash
+    struct hashGuard_t
+    {
+      EmuInstanceBase* const instance;
+      const bool streamed;
+      ~hashGuard_t() { if (streamed) instance->setArchiveHashImpl(nullptr, nullptr); }
+    } hashGuard { this, hash != nullptr && setArchiveHashImpl(updateArchiveHash, hash) };
+
+    const size_t archiveSize = getArchiveSize();
+    reserveBuffer(_saveData, _saveDataCapacity, sizeof(size_t) + archiveSize);
+    writeArchive(&_saveData[sizeof(size_t)], archiveSize);
+
+    if (hash != nullptr && hashGuard.streamed == false) hash->Update(&_saveData[sizeof(size_t)], archiveSize);
+
+    _archiveValid = true;
+    memcpy(_saveData, &archiveSize, sizeof(size_t));
+    return sizeof(size_t) + archiveSize;
+  }
+
+  // Loads the full state of the given size from the buffer returned by getArchiveBuffer()
+  void unarchiveState(const size_t size)
+  {
+    if (_levelArenaSize > 0)
+    {
+      jaffarCommon::deserializer::Contiguous d(_deltaStateData, size);
+      deserializeLevelArenaImpl(d);
+      return;
+    }
+
+    headlessSetSaveStatePointer(&_saveData[sizeof(size_t)], size - sizeof(size_t));
+    dsda_UnArchiveAll();
+  }
+
+  // The sizing pass runs once per state, since serializing the state right after asks for the size again
+  size_t getArchiveSize() const
+  {
+    if (_archiveSized == false)
+    {
+      _sizedArchiveSize = getArchiveSizeImpl();
+      _archiveSized = true;
+    }
+    return _sizedArchiveSize;
+  }
+
+  // Writes the current state's archive into a buffer holding the size getArchiveSize() gave
+  void writeArchive(uint8_t* buffer, const size_t archiveSize)
+  {
+    const size_t writtenSize = writeArchiveImpl(buffer, archiveSize);
+    if (writtenSize != archiveSize) JAFFAR_THROW_LOGIC("The %s core wrote an archive of %lu bytes, but sized it at %lu\n", getCoreName().c_str(), writtenSize, archiveSize);
+  }
+
+  // The state changed, so its archive and archive size have to be taken again
+  void invalidateArchive()
+  {
+    _archiveValid = false;
+    _archiveSized = false;
+  }
+
+  static void updateArchiveHash(const void* data, size_t size, void* context)
+  {
+    static_cast<MetroHash128*>(context)->Update(static_cast<const uint8_t*>(data), size);
+  }
+
+  static void reserveBuffer(uint8_t*& buffer, size_t& capacity, const size_t size)
+  {
+    if (size <= capacity) return;
+    buffer = (uint8_t*)realloc(buffer, size);
+    if (buffer == nullptr) JAFFAR_THROW_RUNTIME("Could not allocate %lu bytes for the state buffers\n", size);
+    capacity = size;
+  }
+
+  uint8_t* getArchiveBuffer() const { return _levelArenaSize > 0 ? _deltaStateData : _saveData; }
+
+  // Returns the position of the first byte that differs between both buffers, starting at pos, comparing a word at a time
+  static size_t findFirstDifference(const uint8_t* a, const uint8_t* b, size_t pos, const size_t size)
+  {
+    for (; pos + sizeof(uint64_t) <= size; pos += sizeof(uint64_t))
+    {
+      uint64_t wordA, wordB;
+      memcpy(&wordA, &a[pos], sizeof(uint64_t));
+      memcpy(&wordB, &b[pos], sizeof(uint64_t));
+      if (wordA != wordB) break;
+    }
+
+    while (pos < size && a[pos] == b[pos]) pos++;
+    return pos;
+  }
+
+  static uint8_t* encodeVarUInt(uint8_t* output, size_t value)
+  {
+    while (value >= 0x80) { *output++ = (uint8_t)(value | 0x80); value >>= 7; }
+    *output++ = (uint8_t)value;
+    return output;
+  }
+
+  // Throws if the value runs past end, or over the 10 bytes a 64 bit value takes
+  static const uint8_t* decodeVarUInt(const uint8_t* input, const uint8_t* end, size_t& value)
+  {
+    value = 0;
+    for (int shift = 0; shift < 64; shift += 7)
+    {
+      if (input >= end) JAFFAR_THROW_LOGIC("Delta state is truncated\n");
+      const uint8_t byte = *input++;
+      value |= (size_t)(byte & 0x7F) << shift;
+      if ((byte & 0x80) == 0) return input;
+    }
+    JAFFAR_THROW_LOGIC("Delta state holds a varint longer than 10 bytes\n");
+  }
+
+  // Shortest run of unchanged bytes that closes a changed run in a delta state
+  static constexpr size_t _DELTA_MIN_UNCHANGED_RUN = 4;
+
+  // Whether _saveData holds the current state's archive. Its capacity is kept after the state changes,
+  // as the room to archive the next state into.
+  bool _archiveValid = false;
+
+  // Exact archive size of the current state, while _archiveSized is set
+  mutable size_t _sizedArchiveSize = 0;
+  mutable bool _archiveSized = false;
+
+  // Rewind buffer, see enableRewind()
+  struct rewindKeyframe_t
+  {
+    size_t tic;
+    bool isFull;
+    std::vector<uint8_t> data;
+  };
+
+  void clearRewind()
+  {
+    _rewindKeyframes.clear();
+    _rewindInputs.clear();
+    _rewindMemorySize = 0;
+    _rewindTic = 0;
+  }
+
+  void recordRewindInput(const jaffar::input_t &input)
+  {
+    if (_rewindKeyframes.empty() || _rewindTic - _rewindKeyframes.back().tic >= _rewindKeyframeInterval) pushRewindKeyframe();
+
+    _rewindInputs.push_back(input);
+    _rewindMemorySize += sizeof(jaffar::input_t);
+    _rewindTic++;
+
+    // Dropping the oldest full keyframe with its deltas, as long as a newer full keyframe remains
+    while (_rewindMemorySize > _rewindBufferSize)
+    {
+      size_t nextFullId = 1;
+      while (nextFullId < _rewindKeyframes.size() && _rewindKeyframes[nextFullId].isFull == false) nextFullId++;
+      if (nextFullId == _rewindKeyframes.size()) break;
+
+      const size_t droppedTics = _rewindKeyframes[nextFullId].tic - _rewindKeyframes.front().tic;
+      for (size_t i = 0; i < nextFullId; i++)
+      {
+        _rewindMemorySize -= _rewindKeyframes.front().data.size();
+        _rewindKeyframes.pop_front();
+      }
+      _rewindInputs.erase(_rewindInputs.begin(), _rewindInputs.begin() + droppedTics);
+      _rewindMemorySize -= droppedTics * sizeof(jaffar::input_t);
+    }
+  }
+
+  void pushRewindKeyframe()
+  {
+    // Deltas are against the last full keyframe
+    size_t fullId = _rewindKeyframes.size();
+    while (fullId > 0 && _rewindKeyframes[fullId - 1].isFull == false) fullId--;
+    const bool isFull = fullId == 0 || _rewindKeyframes.size() - (fullId - 1) >= _rewindFullKeyframeInterval;
+
+    const size_t stateSize = getStateSize();
+    _rewindScratch.resize(isFull ? stateSize : sizeof(size_t) + 2 * stateSize + 16);
+    jaffarCommon::serializer::Contiguous s(_rewindScratch.data(), _rewindScratch.size());
+    if (isFull) serializeState(s);
+    else serializeDeltaState(s, _rewindKeyframes[fullId - 1].data.data(), _rewindKeyframes[fullId - 1].data.size());
+
+    _rewindKeyframes.push_back(rewindKeyframe_t{ _rewindTic, isFull, std::vector<uint8_t>(_rewindScratch.data(), _rewindScratch.data() + s.getOutputSize()) });
+    _rewindMemorySize += s.getOutputSize();
+  }
+
+  void loadRewindKeyframe(const size_t keyframeId)
+  {
+    const auto &keyframe = _rewindKeyframes[keyframeId];
+    jaffarCommon::deserializer::Contiguous d(keyframe.data.data(), keyframe.data.size());
+    if (keyframe.isFull) { deserializeState(d); return; }
+
+    size_t fullId = keyframeId;
+    while (_rewindKeyframes[fullId].isFull == false) fullId--;
+    deserializeDeltaState(d, _rewindKeyframes[fullId].data.data(), _rewindKeyframes[fullId].data.size());
+  }
+
+  size_t _rewindBufferSize;
+  size_t _rewindKeyframeInterval;
+  size_t _rewindFullKeyframeInterval;
+  std::deque<rewindKeyframe_t> _rewindKeyframes;
+  std::deque<jaffar::input_t> _rewindInputs; // From the oldest keyframe on
+  std::vector<uint8_t> _rewindScratch;
+  size_t _rewindMemorySize = 0;
+  size_t _rewindTic = 0; // Tics recorded, counting the dropped ones
+  bool _rewindReplaying = false;
+
+  // Delta state encoding buffers
+  uint8_t* _deltaData = nullptr;
+  size_t _deltaDataCapacity = 0;
+  uint8_t* _deltaStateData = nullptr;
+  size_t _deltaStateDataCapacity = 0;
+  size_t _effectiveDeltaSize = 0;
+
+  // State instances created from this one start from, see recordStartState()
+  uint8_t* _startStateData = nullptr;
+  size_t _startStateDataCapacity = 0;
+  size_t _startStateSize = 0;
+  jaffarCommon::hash::hash_t _startStateHash;
+  std::thread::id _engineThread;
+
   std::string _IWADFilePath;
-  std::string _IWADFileDataBuffer;
   std::string _expectedIWADSHA1;
 
   std::vector<std::string> _PWADFilePaths;
-  std::vector<std::string> _PWADFileDataBuffers;
   std::vector<std::string> _PWADExpectedSHA1s;
 
+  std::string _WADHashCacheFilePath;
+
   unsigned int _skill; 
   unsigned int _episode;
   unsigned int _map;
@@ -514,7 +1257,7 @@ class EmuInstanceBase
   SDL_Renderer* _renderer;
   SDL_Texture* _texture;
   uint8_t* _videoSource;
-  uint32_t* _videoBuffer;
+  uint32_t* _videoBuffer = nullptr;
   size_t _videoBufferSize;
   bool _renderingEnabled = false;
   #endif
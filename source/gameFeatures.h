@@ -0,0 +1,48 @@
+#pragma once
+
+// Flat snapshot of the game features used to score states (bots, search rewards).
+// It is plain data shared by the C core and the C++ tools, computed on demand from
+// the current state, or read from the sections of a serialized one (all but the
+// exit distance). Bump the version on any layout change.
+
+#include <stdint.h>
+
+#define GAME_FEATURES_VERSION 1
+#define GAME_FEATURES_MAX_PLAYERS 8
+#define GAME_FEATURES_MAX_AMMO 8
+
+typedef struct
+{
+  int32_t inGame;
+  int32_t hasBody;          // Whether the player has a mobj; position, momentum, angle and sector are zero otherwise
+  int32_t x, y, z;          // 16.16 fixed point
+  int32_t momX, momY, momZ; // 16.16 fixed point
+  uint32_t angle;
+  int32_t sector;           // Index of the sector the player is in
+  int32_t health;
+  int32_t armorPoints;
+  int32_t armorType;
+  int32_t ammo[GAME_FEATURES_MAX_AMMO];
+  uint32_t weaponsOwned;    // One bit per weapon
+  int32_t readyWeapon;
+  int32_t killCount;
+  int32_t itemCount;
+  int32_t secretCount;
+  float exitDistance;       // Map units to the closest exit line, negative if the map has none
+} playerFeatures_t;
+
+typedef struct
+{
+  uint32_t version;
+  uint32_t playerCount;     // Entries of players[] filled in: up to the last player in game
+  int32_t gameTic;
+  int32_t episode;
+  int32_t map;
+  int32_t levelExit;
+  int32_t gameEnd;
+  int32_t liveMonsters;
+  int32_t totalKills;
+  int32_t totalItems;
+  int32_t totalSecrets;
+  playerFeatures_t players[GAME_FEATURES_MAX_PLAYERS];
+} gameFeatures_t;
@@ -4,10 +4,12 @@
 // by eien86
 
 #include <cstdint>
+#include <cstdio>
 #include <jaffarCommon/exceptions.hpp>
 #include <jaffarCommon/json.hpp>
 #include <string>
 #include <sstream>
+#include <vector>
 
 namespace jaffar
 {
@@ -27,6 +29,40 @@ struct playerInput_t
 
 typedef std::array<playerInput_t, _MAX_PLAYERS> input_t;
 
+// Input in which only the given player presses anything
+inline input_t makePlayerInput(const playerInput_t &playerInput, const int playerId = 0)
+{
+  input_t input;
+  input[playerId] = playerInput;
+  return input;
+}
+
+// Values tried for each player input field when enumerating the inputs of a state
+struct inputGrid_t
+{
+  std::vector<int8_t> forwardSpeeds = { -50, 0, 50 };
+  std::vector<int8_t> strafingSpeeds = { -50, 0, 50 };
+  std::vector<int8_t> turningSpeeds = { -120, -40, 0, 40, 120 };
+  bool fire = true;
+  bool action = true;
+  bool weapons = true;
+
+  inputGrid_t() = default;
+
+  // Every entry is optional, and keeps its default when missing
+  inputGrid_t(const nlohmann::json &config)
+  {
+    if (config.contains("Forward Speeds")) forwardSpeeds = jaffarCommon::json::getArray<int8_t>(config, "Forward Speeds");
+    if (config.contains("Strafing Speeds")) strafingSpeeds = jaffarCommon::json::getArray<int8_t>(config, "Strafing Speeds");
+    if (config.contains("Turning Speeds")) turningSpeeds = jaffarCommon::json::getArray<int8_t>(config, "Turning Speeds");
+    if (config.contains("Fire")) fire = jaffarCommon::json::getBoolean(config, "Fire");
+    if (config.contains("Action")) action = jaffarCommon::json::getBoolean(config, "Action");
+    if (config.contains("Weapons")) weapons = jaffarCommon::json::getBoolean(config, "Weapons");
+
+    if (forwardSpeeds.empty() || strafingSpeeds.empty() || turningSpeeds.empty()) JAFFAR_THROW_LOGIC("Input grid speed lists must not be empty\n");
+  }
+};
+
 class InputParser
 {
 public:
@@ -75,6 +111,29 @@ public:
     return input;
   };
 
+  // Inverse of parseInputString, for writing sequence (.sol) files
+  inline std::string generateInputString(const input_t &input) const
+  {
+    std::string inputString = "|";
+
+    for (uint8_t i = 0; i < _playerCount; i++)
+    {
+      char playerString[64];
+      snprintf(playerString, sizeof(playerString), "|%4d,%4d,%4d,%4d,%c%c%c",
+        input[i].forwardSpeed,
+        input[i].strafingSpeed,
+        input[i].turningSpeed,
+        input[i].weapon,
+        input[i].fire ? 'F' : '.',
+        input[i].action ? 'A' : '.',
+        input[i].altWeapon ? 'X' : '.');
+      inputString += playerString;
+    }
+
+    inputString += "|";
+    return inputString;
+  }
+
   private:
 
   static inline void parsePlayerInputs(playerInput_t& input, std::istringstream& ss, const std::string& inputString)
@@ -61,9 +61,9 @@
 #include "dsda/args.h"
 #include "dsda/settings.h"
 
-__thread ticcmd_t local_cmds[MAX_MAXPLAYERS];
-__thread int maketic;
-__thread int solo_net = 0;
+__STORAGE_MODIFIER ticcmd_t local_cmds[MAX_MAXPLAYERS];
+__STORAGE_MODIFIER int maketic;
+__STORAGE_MODIFIER int solo_net = 0;
 
 void D_InitFakeNetGame (void)
 {
@@ -74,9 +74,9 @@ void D_InitFakeNetGame (void)
   coop_spawns = dsda_Flag(dsda_arg_coop_spawns);
   netgame = solo_net;
 
-  playeringame[0] = true;
+  engine_context->playeringame[0] = true;
   for (i = 1; i < g_maxplayers; i++)
-    playeringame[i] = false;
+    engine_context->playeringame[i] = false;
 }
 
 void FakeNetUpdate(void)
@@ -84,7 +84,7 @@ void FakeNetUpdate(void)
 }
 
 // Implicitly tracked whenever we check the current tick
-__thread int ms_to_next_tick;
+__STORAGE_MODIFIER int ms_to_next_tick;
 
 void TryRunTics (void)
 {
@@ -0,0 +1,52 @@
+/* Emacs style mode select   -*- C -*-
+ *-----------------------------------------------------------------------------
+ *
+ *  This program is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU General Public License
+ *  as published by the Free Software Foundation; either version 2
+ *  of the License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ * DESCRIPTION:
+ *      Engine context: game state reached through a single pointer.
+ *
+ *-----------------------------------------------------------------------------*/
+
+#ifndef __D_CONTEXT__
+#define __D_CONTEXT__
+
+#include "d_player.h"
+#include "m_random.h"
+#include "p_tick.h"
+
+/* The players, the thinker lists, the RNG and the level clocks. The
+ * instance running the engine owns the context and points engine_context
+ * at it (see headlessSetEngineContext) before the engine starts. The rest
+ * of the engine state is still made of thread globals, so a thread still
+ * runs a single instance. */
+typedef struct {
+  player_t players[MAX_MAXPLAYERS];
+  dboolean playeringame[MAX_MAXPLAYERS];          // Alive? Disconnected?
+  thinker_t thinkerclasscap[th_all+1];            // killough 8/29/98
+  rng_t rng;                                      // The rng's state
+  int gametic;
+  int leveltime;                                  // level time in tics
+} engine_context_t;
+
+#ifdef _JAFFAR_ENGINE_STATIC_CONTEXT
+/* A single context in engine storage, accessed directly like the globals
+ * around it, to compare what the pointer costs */
+extern __STORAGE_MODIFIER engine_context_t engine_static_context;
+#define engine_context (&engine_static_context)
+#else
+extern __STORAGE_MODIFIER engine_context_t *engine_context;
+#endif
+
+size_t headlessGetEngineContextSize(void);
+void headlessSetEngineContext(void *context);
+
+#endif
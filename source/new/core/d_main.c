@@ -50,6 +50,8 @@
 #include "doomdef.h"
 #include "doomtype.h"
 #include "doomstat.h"
+#include "p_user.h"
+#include "p_map.h"
 #include "d_net.h"
 #include "sounds.h"
 #include "z_zone.h"
@@ -95,38 +97,38 @@
 static void D_PageDrawer(void);
 
 // jff 1/24/98 add new versions of these variables to remember command line
-__thread dboolean clnomonsters;   // checkparm of -nomonsters
-__thread dboolean clrespawnparm;  // checkparm of -respawn
-__thread dboolean clfastparm;     // checkparm of -fast
+__STORAGE_MODIFIER dboolean clnomonsters;   // checkparm of -nomonsters
+__STORAGE_MODIFIER dboolean clrespawnparm;  // checkparm of -respawn
+__STORAGE_MODIFIER dboolean clfastparm;     // checkparm of -fast
 // jff 1/24/98 end definition of command line version of play mode switches
 
-__thread dboolean nomonsters;     // working -nomonsters
-__thread dboolean respawnparm;    // working -respawn
-__thread dboolean fastparm;       // working -fast
+__STORAGE_MODIFIER dboolean nomonsters;     // working -nomonsters
+__STORAGE_MODIFIER dboolean respawnparm;    // working -respawn
+__STORAGE_MODIFIER dboolean fastparm;       // working -fast
 
-__thread dboolean randomclass;
+__STORAGE_MODIFIER dboolean randomclass;
 
-__thread dboolean singletics = false; // debug flag to cancel adaptiveness
+__STORAGE_MODIFIER dboolean singletics = false; // debug flag to cancel adaptiveness
 
 //jff 1/22/98 parms for disabling music and sound
-__thread dboolean nosfxparm;
-__thread dboolean nomusicparm;
+__STORAGE_MODIFIER dboolean nosfxparm;
+__STORAGE_MODIFIER dboolean nomusicparm;
 
 //jff 4/18/98
-extern __thread dboolean inhelpscreens;
-extern __thread dboolean BorderNeedRefresh;
-extern __thread dboolean enableOutput;
+extern __STORAGE_MODIFIER dboolean inhelpscreens;
+extern __STORAGE_MODIFIER dboolean BorderNeedRefresh;
+extern __STORAGE_MODIFIER dboolean enableOutput;
 
-__thread int     startskill;
-__thread int     startepisode;
-__thread int     startmap;
-__thread dboolean autostart;
-__thread FILE    *debugfile;
+__STORAGE_MODIFIER int     startskill;
+__STORAGE_MODIFIER int     startepisode;
+__STORAGE_MODIFIER int     startmap;
+__STORAGE_MODIFIER dboolean autostart;
+__STORAGE_MODIFIER FILE    *debugfile;
 
-__thread dboolean advancedemo;
+__STORAGE_MODIFIER dboolean advancedemo;
 
 //jff 4/19/98 list of standard IWAD names
-__thread const char *const standard_iwads[]=
+__STORAGE_MODIFIER const char *const standard_iwads[]=
 {
   "doom2f.wad",
   "doom2.wad",
@@ -154,7 +156,7 @@ __thread const char *const standard_iwads[]=
   "heretic1.wad"
 };
 //e6y static
-__thread const int nstandard_iwads = sizeof standard_iwads/sizeof*standard_iwads;
+__STORAGE_MODIFIER const int nstandard_iwads = sizeof standard_iwads/sizeof*standard_iwads;
 
 /*
  * D_PostEvent - Event handling
@@ -189,14 +191,14 @@ static void D_Wipe(void)
 //
 
 // wipegamestate can be set to -1 to force a wipe on the next draw
-__thread gamestate_t    wipegamestate = GS_DEMOSCREEN;
-extern __thread dboolean setsizeneeded;
+__STORAGE_MODIFIER gamestate_t    wipegamestate = GS_DEMOSCREEN;
+extern __STORAGE_MODIFIER dboolean setsizeneeded;
 
 static void D_DrawPause(void)
 {
 }
 
-static dboolean must_fill_back_screen;
+static __STORAGE_MODIFIER dboolean must_fill_back_screen;
 
 void D_MustFillBackScreen(void)
 {
@@ -212,10 +214,10 @@ void D_Display (fixed_t frac)
 //  DEMO LOOP
 //
 
-static __thread int  demosequence;         // killough 5/2/98: made static
-static __thread int  pagetic;
-static __thread const char *pagename; // CPhipps - const
-__thread dboolean bfgedition = 0;
+static __STORAGE_MODIFIER int  demosequence;         // killough 5/2/98: made static
+static __STORAGE_MODIFIER int  pagetic;
+static __STORAGE_MODIFIER const char *pagename; // CPhipps - const
+__STORAGE_MODIFIER dboolean bfgedition = 0;
 
 //
 // D_PageTicker
@@ -289,9 +291,9 @@ static void D_DrawTitle2(const char *name)
 /* killough 11/98: tabulate demo sequences
  */
 
-extern __thread const demostate_t (*demostates)[4];
+extern __STORAGE_MODIFIER const demostate_t (*demostates)[4];
 
-const __thread demostate_t doom_demostates[][4] =
+const __STORAGE_MODIFIER demostate_t doom_demostates[][4] =
 {
   {
     {D_DrawTitle1, "TITLEPIC"},
@@ -367,7 +369,7 @@ const __thread demostate_t doom_demostates[][4] =
 
 void D_DoAdvanceDemo(void)
 {
-  players[consoleplayer].playerstate = PST_LIVE;  /* not reborn */
+  engine_context->players[consoleplayer].playerstate = PST_LIVE;  /* not reborn */
   advancedemo = false;
   gameaction = ga_nothing;
 
@@ -650,7 +652,7 @@ void AddIWAD(const char *iwad, void* const buffer, const size_t size)
  */
 static inline dboolean CheckExeSuffix(const char *suffix)
 {
-  extern __thread char **dsda_argv;
+  extern __STORAGE_MODIFIER char **dsda_argv;
 
   char *dash;
 
@@ -780,8 +782,8 @@ static void IdentifyVersion (void)
 
 static void DoLooseFiles(void)
 {
-  extern __thread int dsda_argc;
-  extern __thread char **dsda_argv;
+  extern __STORAGE_MODIFIER int dsda_argc;
+  extern __STORAGE_MODIFIER char **dsda_argv;
 
   int i, k;
   const int loose_wad_index = 0;
@@ -829,15 +831,15 @@ static void DoLooseFiles(void)
   }
 }
 
-__thread const char *port_wad_file;
+__STORAGE_MODIFIER const char *port_wad_file;
 
 // CPhipps - misc screen stuff
-__thread int desired_screenwidth, desired_screenheight;
+__STORAGE_MODIFIER int desired_screenwidth, desired_screenheight;
 
 // Calculate the path to the directory for autoloaded WADs/DEHs.
 // Creates the directory as necessary.
 
-static __thread char *autoload_path = NULL;
+static __STORAGE_MODIFIER char *autoload_path = NULL;
 
 static char *GetAutoloadDir(const char *iwadname, dboolean createdir)
 {
@@ -911,8 +913,8 @@ static const char *D_AutoLoadGameBase()
 
 #define ALL_AUTOLOAD "all-all"
 
-__thread int warpepisode = -1;
-__thread int warpmap = -1;
+__STORAGE_MODIFIER int warpepisode = -1;
+__STORAGE_MODIFIER int warpmap = -1;
 
 static void HandleWarp(void)
 {
@@ -939,7 +941,7 @@ static void HandleClass(void)
   return;
 }
 
-__thread const char* doomverstr = "Unknown";
+__STORAGE_MODIFIER const char* doomverstr = "Unknown";
 
 static void EvaluateDoomVerStr(void)
 {
@@ -1010,10 +1012,10 @@ static void EvaluateDoomVerStr(void)
 //
 // CPhipps - the old contents of D_DoomMain, but moved out of the main
 //  line of execution so its stack space can be freed
-extern __thread dboolean preventLevelExit;
-extern __thread dboolean preventGameEnd;
-extern __thread dboolean reachedLevelExit;
-extern __thread dboolean reachedGameEnd;
+extern __STORAGE_MODIFIER dboolean preventLevelExit;
+extern __STORAGE_MODIFIER dboolean preventGameEnd;
+extern __STORAGE_MODIFIER dboolean reachedLevelExit;
+extern __STORAGE_MODIFIER dboolean reachedGameEnd;
 
 
 void D_DoomMainSetup(void)
@@ -1247,7 +1249,7 @@ void D_DoomMain(void)
 void headlessRunSingleTick(void)
 {
   G_Ticker ();
-  gametic++;
+  engine_context->gametic++;
 }
 
 void headlessUpdateSounds(void)
@@ -1275,27 +1277,81 @@ void headlessDisableRendering()
 /// Headless functions
 
 void headlessClearTickCommand() { memset(local_cmds, 0, sizeof(ticcmd_t) * MAX_MAXPLAYERS); }
+
+static void headlessBuildTickCommand(ticcmd_t* cmd, int forwardSpeed, int strafingSpeed, int turningSpeed, int fire, int action, int weapon, int altWeapon)
+{
+  cmd->forwardmove = forwardSpeed;
+  cmd->sidemove    = strafingSpeed;
+  cmd->angleturn   = turningSpeed << 8;
+
+  if (fire == 1)    cmd->buttons |= 0b00000001;
+  if (action == 1)  cmd->buttons |= 0b00000010;
+
+  if (weapon == 0)  cmd->buttons |= 0b00000000;
+  if (weapon == 1)  cmd->buttons |= 0b00000100;
+  if (weapon == 2)  cmd->buttons |= 0b00001000;
+  if (weapon == 3)  cmd->buttons |= 0b00001100;
+  if (weapon == 4)  cmd->buttons |= 0b00010000;
+  if (weapon == 5)  cmd->buttons |= 0b00010100;
+  if (weapon == 6)  cmd->buttons |= 0b00011000;
+  if (weapon == 7)  cmd->buttons |= 0b00011100;
+
+  if (altWeapon == 1)  cmd->buttons |= 0b00100000;
+}
+
 void headlessSetTickCommand(int playerId, int forwardSpeed, int strafingSpeed, int turningSpeed, int fire, int action, int weapon, int altWeapon)
 {
-  local_cmds[playerId].forwardmove = forwardSpeed;
-  local_cmds[playerId].sidemove    = strafingSpeed;
-  local_cmds[playerId].angleturn   = turningSpeed << 8;
+  headlessBuildTickCommand(&local_cmds[playerId], forwardSpeed, strafingSpeed, turningSpeed, fire, action, weapon, altWeapon);
+
+  // printf("ForwardSpeed: %d - sideMove:     %d - angleTurn:    %d - buttons: %u\n", forwardSpeed, strafingSpeed, turningSpeed, local_cmds[playerId].buttons);
+}
 
-  if (fire == 1)    local_cmds[playerId].buttons |= 0b00000001;
-  if (action == 1)  local_cmds[playerId].buttons |= 0b00000010;
+// Command the inputs would give the player on the next tic, stripped of
+// what it is going to ignore (see P_CanonicalizeTiccmd)
+void headlessGetTickCommandKey(int playerId, int forwardSpeed, int strafingSpeed, int turningSpeed, int fire, int action, int weapon, int altWeapon, ticcmd_t* key)
+{
+  memset(key, 0, sizeof(*key));
+  if (!engine_context->playeringame[playerId])
+    return;
 
-  if (weapon == 0)  local_cmds[playerId].buttons |= 0b00000000;
-  if (weapon == 1)  local_cmds[playerId].buttons |= 0b00000100;
-  if (weapon == 2)  local_cmds[playerId].buttons |= 0b00001000;
-  if (weapon == 3)  local_cmds[playerId].buttons |= 0b00001100;
-  if (weapon == 4)  local_cmds[playerId].buttons |= 0b00010000;
-  if (weapon == 5)  local_cmds[playerId].buttons |= 0b00010100;
-  if (weapon == 6)  local_cmds[playerId].buttons |= 0b00011000;
-  if (weapon == 7)  local_cmds[playerId].buttons |= 0b00011100;
+  headlessBuildTickCommand(key, forwardSpeed, strafingSpeed, turningSpeed, fire, action, weapon, altWeapon);
+  if (gamestate == GS_LEVEL && engine_context->players[playerId].mo)
+    P_CanonicalizeTiccmd(&engine_context->players[playerId], key);
+}
 
-  if (altWeapon == 1)  local_cmds[playerId].buttons |= 0b00100000;
+// Whether pressing use on the next tic, after turning by the given angleturn,
+// could activate a line. Holding use down never does.
+int headlessCanUseLines(int playerId, int angleturn)
+{
+  player_t *player = &engine_context->players[playerId];
 
-  // printf("ForwardSpeed: %d - sideMove:     %d - angleTurn:    %d - buttons: %u\n", forwardSpeed, strafingSpeed, turningSpeed, local_cmds[playerId].buttons);
+  if (gamestate != GS_LEVEL || !engine_context->playeringame[playerId] || !player->mo)
+    return false;
+
+  if (player->playerstate == PST_DEAD || player->usedown)
+    return false;
+
+  return P_UseLinesInRange(player, player->mo->angle + (angleturn << 16));
+}
+
+// Size of the engine context the instance provides, or zero if the build
+// keeps a static one
+size_t headlessGetEngineContextSize(void)
+{
+#ifdef _JAFFAR_ENGINE_STATIC_CONTEXT
+  return 0;
+#else
+  return sizeof(engine_context_t);
+#endif
+}
+
+// Points this thread's engine at the zeroed context the instance owns,
+// before headlessMain
+void headlessSetEngineContext(void *context)
+{
+#ifndef _JAFFAR_ENGINE_STATIC_CONTEXT
+  engine_context = context;
+#endif
 }
 
 //int main(int argc, const char * const * argv)
@@ -41,19 +41,19 @@
 /* CPhipps - removed wadfiles[] stuff to w_wad.h */
 
 //jff 1/24/98 make command line copies of play modes available
-extern __thread dboolean clnomonsters; // checkparm of -nomonsters
-extern __thread dboolean clrespawnparm;  // checkparm of -respawn
-extern __thread dboolean clfastparm; // checkparm of -fast
+extern __STORAGE_MODIFIER dboolean clnomonsters; // checkparm of -nomonsters
+extern __STORAGE_MODIFIER dboolean clrespawnparm;  // checkparm of -respawn
+extern __STORAGE_MODIFIER dboolean clfastparm; // checkparm of -fast
 //jff end of external declaration of command line playmode
 
-extern __thread dboolean nosfxparm;
-extern __thread dboolean nomusicparm;
+extern __STORAGE_MODIFIER dboolean nosfxparm;
+extern __STORAGE_MODIFIER dboolean nomusicparm;
 
 // Called by IO functions when input is detected.
 void D_PostEvent(event_t* ev);
 
 // Demo stuff
-extern __thread dboolean advancedemo;
+extern __STORAGE_MODIFIER dboolean advancedemo;
 void D_AdvanceDemo(void);
 void D_DoAdvanceDemo (void);
 
@@ -68,7 +68,7 @@ void D_DoomMain(void);
 void D_AddFile (const char *file, wad_source_t source, void* const buffer, const size_t size);
 void AddIWAD(const char *iwad, void* const buffer, const size_t size);
 
-extern __thread const char *port_wad_file;
+extern __STORAGE_MODIFIER const char *port_wad_file;
 
 typedef struct
 {
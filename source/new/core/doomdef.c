@@ -39,11 +39,11 @@
 // None.
 
 // proff 08/17/98: Changed for high-res
-__thread int SCREENWIDTH=320;
-__thread int SCREENHEIGHT=200;
-__thread int SCREENPITCH=320;
+__STORAGE_MODIFIER int SCREENWIDTH=320;
+__STORAGE_MODIFIER int SCREENHEIGHT=200;
+__STORAGE_MODIFIER int SCREENPITCH=320;
 
 // e6y: wide-res
-__thread int SCREEN_320x200;
-__thread int WIDE_SCREENWIDTH = 320;
-__thread int WIDE_SCREENHEIGHT = 200;
+__STORAGE_MODIFIER int SCREEN_320x200;
+__STORAGE_MODIFIER int WIDE_SCREENWIDTH = 320;
+__STORAGE_MODIFIER int WIDE_SCREENHEIGHT = 200;
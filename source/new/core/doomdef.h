@@ -57,7 +57,7 @@
 #include "m_swap.h"
 #include "doomtype.h"
 
-extern __thread dboolean bfgedition;
+extern __STORAGE_MODIFIER dboolean bfgedition;
 
 // Game mode handling - identify IWAD version
 //  to handle IWAD dependend animations etc.
@@ -107,18 +107,18 @@ typedef enum {
 // when multiple screen sizes are supported
 
 // SCREENWIDTH and SCREENHEIGHT define the visible size
-extern __thread int SCREENWIDTH;
-extern __thread int SCREENHEIGHT;
+extern __STORAGE_MODIFIER int SCREENWIDTH;
+extern __STORAGE_MODIFIER int SCREENHEIGHT;
 // SCREENPITCH is the size of one line in the buffer and
 // can be bigger than the SCREENWIDTH depending on the size
 // of one pixel (8, 16 or 32 bit) and the padding at the
 // end of the line caused by hardware considerations
-extern __thread int SCREENPITCH;
+extern __STORAGE_MODIFIER int SCREENPITCH;
 
 // e6y: wide-res
-extern __thread int WIDE_SCREENWIDTH;
-extern __thread int WIDE_SCREENHEIGHT;
-extern __thread int SCREEN_320x200;
+extern __STORAGE_MODIFIER int WIDE_SCREENWIDTH;
+extern __STORAGE_MODIFIER int WIDE_SCREENHEIGHT;
+extern __STORAGE_MODIFIER int SCREEN_320x200;
 
 // The maximum number of players, multiplayer/networking.
 #define MAX_MAXPLAYERS   8
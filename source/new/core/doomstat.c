@@ -36,64 +36,71 @@
 
 #include "dsda/map_format.h"
 
+// The engine context, see d_context.h
+#ifdef _JAFFAR_ENGINE_STATIC_CONTEXT
+__STORAGE_MODIFIER engine_context_t engine_static_context;
+#else
+__STORAGE_MODIFIER engine_context_t *engine_context;
+#endif
+
 // Game Mode - identify IWAD as shareware, retail etc.
-__thread GameMode_t gamemode = indetermined;
-__thread GameMission_t   gamemission = doom;
+__STORAGE_MODIFIER GameMode_t gamemode = indetermined;
+__STORAGE_MODIFIER GameMission_t   gamemission = doom;
 
 // Language.
-__thread Language_t   language = english;
+__STORAGE_MODIFIER Language_t   language = english;
 
 // Set if homebrew PWAD stuff has been added.
-__thread dboolean modifiedgame;
+__STORAGE_MODIFIER dboolean modifiedgame;
 
 //-----------------------------------------------------------------------------
 
 // CPhipps - compatibility vars
-__thread complevel_t compatibility_level;
+__STORAGE_MODIFIER complevel_t compatibility_level;
 
 // e6y
 // it's required for demos recorded in "demo compatibility" mode by boom201 for example
-__thread int demover;
+__STORAGE_MODIFIER int demover;
 
-__thread int comp[MBF_COMP_TOTAL];    // killough 10/98
-__thread int default_comperr[COMPERR_NUM];
+__STORAGE_MODIFIER int comp[MBF_COMP_TOTAL];    // killough 10/98
+__STORAGE_MODIFIER int default_comperr[COMPERR_NUM];
 
-__thread int demo_insurance;        // killough 1/16/98
+__STORAGE_MODIFIER int demo_insurance;        // killough 1/16/98
 
-__thread int  allow_pushers = 1;      // MT_PUSH Things              // phares 3/10/98
+__STORAGE_MODIFIER int  allow_pushers = 1;      // MT_PUSH Things              // phares 3/10/98
 
-__thread int  variable_friction = 1;      // ice & mud               // phares 3/10/98
+__STORAGE_MODIFIER int  variable_friction = 1;      // ice & mud               // phares 3/10/98
 
-__thread int  weapon_recoil = 0;              // weapon recoil                   // phares
+__STORAGE_MODIFIER int  weapon_recoil = 0;              // weapon recoil                   // phares
 
-__thread int player_bobbing = 1;  // whether player bobs or not          // phares 2/25/98
+__STORAGE_MODIFIER int player_bobbing = 1;  // whether player bobs or not          // phares 2/25/98
 
-__thread int monsters_remember = 1;          // killough 3/1/98
+__STORAGE_MODIFIER int monsters_remember = 1;          // killough 3/1/98
 
-__thread int monster_infighting=1;       // killough 7/19/98: monster<=>monster attacks
+__STORAGE_MODIFIER int monster_infighting=1;       // killough 7/19/98: monster<=>monster attacks
 
-__thread int monster_friction=1;       // killough 10/98: monsters affected by friction
+__STORAGE_MODIFIER int monster_friction=1;       // killough 10/98: monsters affected by friction
 
-__thread int dogs;         // killough 7/19/98: Marine's best friend :)
-__thread int dog_jumping;   // killough 10/98
+__STORAGE_MODIFIER int dogs;         // killough 7/19/98: Marine's best friend :)
+__STORAGE_MODIFIER int dog_jumping;   // killough 10/98
 
 // killough 8/8/98: distance friends tend to move towards players
-__thread int distfriend = 128;
+__STORAGE_MODIFIER int distfriend = 128;
 
 // killough 9/8/98: whether monsters are allowed to strafe or retreat
-__thread int monster_backing;
+__STORAGE_MODIFIER int monster_backing;
 
 // killough 9/9/98: whether monsters are able to avoid hazards (e.g. crushers)
-__thread int monster_avoid_hazards;
+__STORAGE_MODIFIER int monster_avoid_hazards;
 
 // killough 9/9/98: whether monsters help friends
-__thread int help_friends;
+__STORAGE_MODIFIER int help_friends;
 
-__thread int monkeys;
+__STORAGE_MODIFIER int monkeys;
 
 char *VANILLA_MAP_LUMP_NAME(int e, int m)
 {
-  static __thread char name[9];
+  static __STORAGE_MODIFIER char name[9];
 
   if (gamemode == commercial || map_format.map99)
     snprintf(name, sizeof(name), "MAP%02d", m);
@@ -42,29 +42,32 @@
 // We need the playr data structure as well.
 #include "d_player.h"
 
+// The part of the state gathered behind a single pointer
+#include "d_context.h"
+
 // ------------------------
 // Command line parameters.
 //
 
-extern  __thread dboolean nomonsters; // checkparm of -nomonsters
-extern  __thread dboolean respawnparm;  // checkparm of -respawn
-extern __thread  dboolean fastparm; // checkparm of -fast
+extern  __STORAGE_MODIFIER dboolean nomonsters; // checkparm of -nomonsters
+extern  __STORAGE_MODIFIER dboolean respawnparm;  // checkparm of -respawn
+extern __STORAGE_MODIFIER  dboolean fastparm; // checkparm of -fast
 
 // -----------------------------------------------------
 // Game Mode - identify IWAD as shareware, retail etc.
 //
 
-extern __thread GameMode_t gamemode;
-extern __thread GameMission_t  gamemission;
-extern __thread const char *doomverstr;
+extern __STORAGE_MODIFIER GameMode_t gamemode;
+extern __STORAGE_MODIFIER GameMission_t  gamemission;
+extern __STORAGE_MODIFIER const char *doomverstr;
 
 extern char *VANILLA_MAP_LUMP_NAME(int e, int m);
 
 // Set if homebrew PWAD stuff has been added.
-extern  __thread dboolean modifiedgame;
+extern  __STORAGE_MODIFIER dboolean modifiedgame;
 
 // CPhipps - new compatibility handling
-extern __thread complevel_t compatibility_level;
+extern __STORAGE_MODIFIER complevel_t compatibility_level;
 
 // CPhipps - old compatibility testing flags aliased to new handling
 #define compatibility (compatibility_level<=boom_compatibility_compatibility)
@@ -72,7 +75,7 @@ extern __thread complevel_t compatibility_level;
 #define mbf_features (compatibility_level>=mbf_compatibility)
 #define mbf21 (compatibility_level == mbf21_compatibility)
 
-extern __thread int demo_insurance;      // killough 4/5/98
+extern __STORAGE_MODIFIER int demo_insurance;      // killough 4/5/98
 
 // -------------------------------------------
 // killough 10/98: compatibility vector
@@ -126,28 +129,28 @@ enum {
   COMPERR_NUM
 };
 
-extern __thread int comp[MBF_COMP_TOTAL];
-extern __thread int default_comperr[COMPERR_NUM];
+extern __STORAGE_MODIFIER int comp[MBF_COMP_TOTAL];
+extern __STORAGE_MODIFIER int default_comperr[COMPERR_NUM];
 
 // -------------------------------------------
 // Language.
-extern  __thread Language_t   language;
+extern  __STORAGE_MODIFIER Language_t   language;
 
 // -------------------------------------------
 // Selected skill type, map etc.
 //
 
 // Defaults for menu, methinks.
-extern  __thread int   startskill;
-extern  __thread int             startepisode;
+extern  __STORAGE_MODIFIER int   startskill;
+extern  __STORAGE_MODIFIER int             startepisode;
 
-extern  __thread dboolean   autostart;
+extern  __STORAGE_MODIFIER dboolean   autostart;
 
 // Selected by user.
-extern  __thread int   gameskill;
-extern  __thread int   gameepisode;
+extern  __STORAGE_MODIFIER int   gameskill;
+extern  __STORAGE_MODIFIER int   gameepisode;
 
-extern  __thread int   gamemap;
+extern  __STORAGE_MODIFIER int   gamemap;
 
 typedef struct
 {
@@ -157,22 +160,22 @@ typedef struct
   angle_t angle;
 } leave_data_t;
 
-extern __thread leave_data_t leave_data;
+extern __STORAGE_MODIFIER leave_data_t leave_data;
 
 #define LF_SET_ANGLE 0x01
 #define LEAVE_VICTORY -1
 
 // Netgame? Only true if >1 player.
-extern  __thread dboolean netgame;
+extern  __STORAGE_MODIFIER dboolean netgame;
 
 // Flag: true only if started as net deathmatch.
 // An enum might handle altdeath/cooperative better.
-extern  __thread dboolean deathmatch;
+extern  __STORAGE_MODIFIER dboolean deathmatch;
 
-extern __thread int solo_net;
-extern __thread dboolean coop_spawns;
+extern __STORAGE_MODIFIER int solo_net;
+extern __STORAGE_MODIFIER dboolean coop_spawns;
 
-extern __thread  dboolean randomclass;
+extern __STORAGE_MODIFIER  dboolean randomclass;
 
 // ------------------------------------------
 // Internal parameters for sound rendering.
@@ -185,11 +188,11 @@ extern __thread  dboolean randomclass;
 //  Sound FX volume has default, 0 - 15
 //  Music volume has default, 0 - 15
 // These are multiplied by 8.
-extern __thread int snd_SfxVolume;      // maximum volume for sound
-extern __thread int snd_MusicVolume;    // maximum volume for music
+extern __STORAGE_MODIFIER int snd_SfxVolume;      // maximum volume for sound
+extern __STORAGE_MODIFIER int snd_MusicVolume;    // maximum volume for music
 
 // CPhipps - screen parameters
-extern __thread int desired_screenwidth, desired_screenheight;
+extern __STORAGE_MODIFIER int desired_screenwidth, desired_screenheight;
 
 typedef enum {
   mnact_nochange = -1,
@@ -197,29 +200,28 @@ typedef enum {
   mnact_float, // doom-style large font menu, doesn't overlap anything
   mnact_full, // boom-style small font menu, may overlap status bar
 } menuactive_t;
-extern __thread menuactive_t menuactive; // Type of menu overlaid, if any
+extern __STORAGE_MODIFIER menuactive_t menuactive; // Type of menu overlaid, if any
 
-extern  __thread dboolean nodrawers;
+extern  __STORAGE_MODIFIER dboolean nodrawers;
 
 // Player taking events, and displaying.
-extern  __thread int consoleplayer;
-extern  __thread int displayplayer;
+extern  __STORAGE_MODIFIER int consoleplayer;
+extern  __STORAGE_MODIFIER int displayplayer;
 
 // -------------------------------------
 // Scores, rating.
 // Statistics on a given map, for intermission.
 //
-extern  __thread int totalkills, totallive;
-extern  __thread int totalitems;
-extern  __thread int totalsecret;
-extern  __thread int boom_basetic;
-extern  __thread int true_basetic;
-extern  __thread int leveltime;       // level time in tics
-extern  __thread int totalleveltimes; // sum of intermission times in tics at second resolution
-extern  __thread int levels_completed;
-
-extern  __thread gamestate_t  gamestate;
-extern  __thread dboolean     in_game;
+extern  __STORAGE_MODIFIER int totalkills, totallive;
+extern  __STORAGE_MODIFIER int totalitems;
+extern  __STORAGE_MODIFIER int totalsecret;
+extern  __STORAGE_MODIFIER int boom_basetic;
+extern  __STORAGE_MODIFIER int true_basetic;
+extern  __STORAGE_MODIFIER int totalleveltimes; // sum of intermission times in tics at second resolution
+extern  __STORAGE_MODIFIER int levels_completed;
+
+extern  __STORAGE_MODIFIER gamestate_t  gamestate;
+extern  __STORAGE_MODIFIER dboolean     in_game;
 
 //-----------------------------
 // Internal parameters, fixed.
@@ -227,89 +229,85 @@ extern  __thread dboolean     in_game;
 //  according to user inputs. Partly load from
 //  WAD, partly set at startup time.
 
-extern  __thread int   gametic;
-#define boom_logictic (gametic - boom_basetic)
-#define true_logictic (gametic - true_basetic)
+#define boom_logictic (engine_context->gametic - boom_basetic)
+#define true_logictic (engine_context->gametic - true_basetic)
 
 //e6y
-extern __thread  dboolean realframe;
-
-// Bookkeeping on players - state.
-extern __thread  player_t  players[MAX_MAXPLAYERS];
-extern __thread  int       upmove;
+extern __STORAGE_MODIFIER  dboolean realframe;
 
-// Alive? Disconnected?
-extern  __thread dboolean   playeringame[MAX_MAXPLAYERS];
+// Bookkeeping on players - state. The players, and whether they are
+// in game, are in the engine context.
+extern __STORAGE_MODIFIER  int       upmove;
 
-extern  __thread mapthing_t *deathmatchstarts;     // killough
-extern  __thread size_t     num_deathmatchstarts; // killough
+extern  __STORAGE_MODIFIER mapthing_t *deathmatchstarts;     // killough
+extern  __STORAGE_MODIFIER size_t     num_deathmatchstarts; // killough
 
-extern  __thread mapthing_t *deathmatch_p;
+extern  __STORAGE_MODIFIER mapthing_t *deathmatch_p;
 
 // Player spawn spots.
 #define MAX_PLAYER_STARTS 8
-extern __thread  mapthing_t playerstarts[MAX_PLAYER_STARTS][MAX_MAXPLAYERS];
+extern __STORAGE_MODIFIER  mapthing_t playerstarts[MAX_PLAYER_STARTS][MAX_MAXPLAYERS];
 
 // Intermission stats.
 // Parameters for world map / intermission.
-extern __thread wbstartstruct_t wminfo;
+extern __STORAGE_MODIFIER wbstartstruct_t wminfo;
 
 //-----------------------------------------
 // Internal parameters, used for engine.
 //
 
 // File handling stuff.
-extern __thread  FILE   *debugfile;
+extern __STORAGE_MODIFIER  FILE   *debugfile;
 
 // wipegamestate can be set to -1
 //  to force a wipe on the next draw
-extern  __thread gamestate_t     wipegamestate;
+extern  __STORAGE_MODIFIER gamestate_t     wipegamestate;
 
 // debug flag to cancel adaptiveness
-extern  __thread dboolean         singletics;
+extern  __STORAGE_MODIFIER dboolean         singletics;
 
 // Needed to store the number of the dummy sky flat.
 // Used for rendering, as well as tracking projectiles etc.
 
-extern __thread int    skyflatnum;
+extern __STORAGE_MODIFIER int    skyflatnum;
 
-extern __thread   int        maketic;
+extern __STORAGE_MODIFIER   int        maketic;
 
 // Networking and tick handling related.
 #define BACKUPTICS              12
 
-extern __thread  ticcmd_t   local_cmds[];
+extern __STORAGE_MODIFIER  ticcmd_t   local_cmds[];
 
 //-----------------------------------------------------------------------------
 
-extern __thread int allow_pushers;         // MT_PUSH Things    // phares 3/10/98
-extern __thread int variable_friction;  // ice & mud            // phares 3/10/98
-extern __thread int monsters_remember;                          // killough 3/1/98
-extern __thread int weapon_recoil;          // weapon recoil    // phares
-extern __thread int player_bobbing;  // whether player bobs or not   // phares 2/25/98
-extern __thread int dogs;     // killough 7/19/98: Marine's best friend :)
-extern __thread int dog_jumping;   // killough 10/98
+extern __STORAGE_MODIFIER int allow_pushers;         // MT_PUSH Things    // phares 3/10/98
+extern __STORAGE_MODIFIER int variable_friction;  // ice & mud            // phares 3/10/98
+extern __STORAGE_MODIFIER int monsters_remember;                          // killough 3/1/98
+extern __STORAGE_MODIFIER int weapon_recoil;          // weapon recoil    // phares
+extern __STORAGE_MODIFIER int player_bobbing;  // whether player bobs or not   // phares 2/25/98
+extern __STORAGE_MODIFIER int dogs;     // killough 7/19/98: Marine's best friend :)
+extern __STORAGE_MODIFIER int dog_jumping;   // killough 10/98
 
 /* killough 8/8/98: distance friendly monsters tend to stay from player */
-extern __thread int distfriend;
+extern __STORAGE_MODIFIER int distfriend;
 
 /* killough 9/8/98: whether monsters are allowed to strafe or retreat */
-extern __thread int monster_backing;
+extern __STORAGE_MODIFIER int monster_backing;
 
 /* killough 9/9/98: whether monsters intelligently avoid hazards */
-extern __thread int monster_avoid_hazards;
+extern __STORAGE_MODIFIER int monster_avoid_hazards;
 
 /* killough 10/98: whether monsters are affected by friction */
-extern __thread int monster_friction;
+extern __STORAGE_MODIFIER int monster_friction;
 
 /* killough 9/9/98: whether monsters help friends */
-extern __thread int help_friends;
+extern __STORAGE_MODIFIER int help_friends;
 
 /* killough 7/19/98: whether monsters should fight against each other */
-extern __thread int monster_infighting;
+extern __STORAGE_MODIFIER int monster_infighting;
 
-extern __thread int monkeys;
+extern __STORAGE_MODIFIER int monkeys;
 
-extern __thread int HelperThing;          // type of thing to use for helper
+extern __STORAGE_MODIFIER int HelperThing;          // type of thing to use for helper
 
 #endif
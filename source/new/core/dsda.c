@@ -22,6 +22,7 @@
 #include "doomstat.h"
 #include "p_inter.h"
 #include "p_tick.h"
+#include "p_saveg.h"
 #include "g_game.h"
 #include "sounds.h"
 
@@ -35,27 +36,27 @@
 #define TELEFRAG_DAMAGE 10000
 
 // command-line toggles
-__thread int dsda_track_pacifist;
-__thread int dsda_track_100k;
-__thread int dsda_track_reality;
-__thread int dsda_last_leveltime;
-__thread int dsda_last_gamemap;
-__thread int dsda_startmap;
-__thread int dsda_movie_target;
-__thread dboolean dsda_any_map_completed;
+__STORAGE_MODIFIER int dsda_track_pacifist;
+__STORAGE_MODIFIER int dsda_track_100k;
+__STORAGE_MODIFIER int dsda_track_reality;
+__STORAGE_MODIFIER int dsda_last_leveltime;
+__STORAGE_MODIFIER int dsda_last_gamemap;
+__STORAGE_MODIFIER int dsda_startmap;
+__STORAGE_MODIFIER int dsda_movie_target;
+__STORAGE_MODIFIER dboolean dsda_any_map_completed;
 
 // other
-__thread int dsda_max_kill_requirement;
+__STORAGE_MODIFIER int dsda_max_kill_requirement;
 static int dsda_session_attempts = 1;
 
-static __thread int turbo_scale;
-static __thread int start_in_build_mode;
-static __thread int line_activation[2][LINE_ACTIVATION_INDEX_MAX + 1];
-static __thread int line_activation_frame;
-static __thread int line_activation_index;
-static __thread int dsda_time_keys;
-static __thread int dsda_time_use;
-static __thread int dsda_time_secrets;
+static __STORAGE_MODIFIER int turbo_scale;
+static __STORAGE_MODIFIER int start_in_build_mode;
+static __STORAGE_MODIFIER int line_activation[2][LINE_ACTIVATION_INDEX_MAX + 1];
+static __STORAGE_MODIFIER int line_activation_frame;
+static __STORAGE_MODIFIER int line_activation_index;
+static __STORAGE_MODIFIER int dsda_time_keys;
+static __STORAGE_MODIFIER int dsda_time_use;
+static __STORAGE_MODIFIER int dsda_time_secrets;
 
 dboolean dsda_IsWeapon(mobj_t* thing);
 void dsda_DisplayNotification(const char* msg);
@@ -77,6 +78,7 @@ void dsda_WatchLineActivation(line_t* line, mobj_t* mo) {
       line_activation[line_activation_frame][line_activation_index] = -1;
     }
 
+    P_MarkLineChanged(line);
     ++line->player_activations;
   }
 }
@@ -111,7 +113,7 @@ int dsda_TurboScale(void) {
   return turbo_scale;
 }
 
-static __thread dboolean frozen_mode;
+static __STORAGE_MODIFIER dboolean frozen_mode;
 
 dboolean dsda_FrozenMode(void) {
   return frozen_mode;
@@ -156,7 +158,7 @@ void dsda_ReadCommandLine(void) {
   if (dsda_Flag(dsda_arg_tas) || dsda_Flag(dsda_arg_build)) dsda_SetTas();
 }
 
-static __thread int dsda_shown_attempt = 0;
+static __STORAGE_MODIFIER int dsda_shown_attempt = 0;
 
 int dsda_SessionAttempts(void) {
   return dsda_session_attempts;
@@ -169,7 +171,7 @@ void dsda_DecomposeILTime(dsda_level_time_t* level_time) {
 }
 
 void dsda_DecomposeMovieTime(dsda_movie_time_t* total_time) {
-  extern __thread int totalleveltimes;
+  extern __STORAGE_MODIFIER int totalleveltimes;
 
   total_time->h = totalleveltimes / 35 / 60 / 60;
   total_time->m = (totalleveltimes % (60 * 60 * 35)) / 35 / 60;
@@ -72,8 +72,8 @@ typedef struct {
 #define NOT_STRICT 0, 0
 #define STRICT_INT(x) CONF_FEATURE | CONF_STRICT, x
 
-extern __thread int dsda_input_profile;
-extern __thread int weapon_preferences[2][NUMWEAPONS + 1];
+extern __STORAGE_MODIFIER int dsda_input_profile;
+extern __STORAGE_MODIFIER int weapon_preferences[2][NUMWEAPONS + 1];
 
 void M_ChangeSkyMode(void);
 void M_ChangeAllowFog(void);
@@ -119,7 +119,7 @@ void dsda_UpdateStrictMode(void) {
   dsda_TrackConfigFeatures();
 }
 
-__thread dsda_config_t dsda_config[dsda_config_count] = {
+__STORAGE_MODIFIER dsda_config_t dsda_config[dsda_config_count] = {
   [dsda_config_game_speed] = {
     "game_speed", dsda_config_game_speed,
     dsda_config_int, 3, 10000, { 100 }, NULL, STRICT_INT(100), NULL
@@ -34,10 +34,10 @@
 #include "data_organizer.h"
 
 #define DATA_DIR_LIMIT 9
-static __thread const char* dsda_data_root = "dsda_doom_data";
-static __thread char* dsda_data_dir_strings[DATA_DIR_LIMIT];
-static __thread char* dsda_base_data_dir;
-static __thread char* dsda_wad_data_dir;
+static __STORAGE_MODIFIER const char* dsda_data_root = "dsda_doom_data";
+static __STORAGE_MODIFIER char* dsda_data_dir_strings[DATA_DIR_LIMIT];
+static __STORAGE_MODIFIER char* dsda_base_data_dir;
+static __STORAGE_MODIFIER char* dsda_wad_data_dir;
 
 char* dsda_DetectDirectory(const char* env_key, int arg_id) {
   dsda_arg_t* arg;
@@ -25,14 +25,14 @@
 
 #include "game_controller.h"
 
-static __thread int use_game_controller;
+static __STORAGE_MODIFIER int use_game_controller;
 
 typedef struct {
   int deadzone;
   int sensitivity;
 } axis_t;
 
-static __thread int swap_analogs;
+static __STORAGE_MODIFIER int swap_analogs;
 
 static const char* button_names[] = {
   [DSDA_CONTROLLER_BUTTON_A] = "pad a",
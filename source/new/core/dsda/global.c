@@ -37,92 +37,92 @@
 
 #define IGNORE_VALUE -1
 
-const __thread demostate_t (*demostates)[4];
-extern __thread const demostate_t doom_demostates[][4];
-extern __thread const demostate_t heretic_demostates[][4];
-extern __thread const demostate_t hexen_demostates[][4];
-
-__thread weaponinfo_t* weaponinfo;
-
-__thread int g_maxplayers = 4;
-__thread int g_viewheight = 41 * FRACUNIT;
-__thread int g_numammo;
-__thread int g_mt_player;
-__thread int g_mt_tfog;
-__thread int g_mt_blood;
-__thread int g_skullpop_mt;
-__thread int g_s_bloodyskullx1;
-__thread int g_s_bloodyskullx2;
-__thread int g_s_play_fdth20;
-__thread int g_wp_fist;
-__thread int g_wp_chainsaw;
-__thread int g_wp_pistol;
-__thread int g_telefog_height;
-__thread int g_thrust_factor;
-__thread int g_fuzzy_aim_shift;
-__thread int g_jump;
-__thread int g_s_null;
-__thread int g_mt_bloodsplatter;
-__thread int g_bloodsplatter_shift;
-__thread int g_bloodsplatter_weight;
-__thread int g_mons_look_range;
-__thread int g_hide_state;
-__thread int g_lava_type;
-__thread int g_mntr_charge_speed;
-__thread int g_mntr_atk1_sfx;
-__thread int g_mntr_decide_range;
-__thread int g_mntr_charge_rng;
-__thread int g_mntr_fire_rng;
-__thread int g_mntr_charge_state;
-__thread int g_mntr_fire_state;
-__thread int g_mntr_charge_puff;
-__thread int g_mntr_atk2_sfx;
-__thread int g_mntr_atk2_dice;
-__thread int g_mntr_atk2_missile;
-__thread int g_mntr_atk3_sfx;
-__thread int g_mntr_atk3_dice;
-__thread int g_mntr_atk3_missile;
-__thread int g_mntr_atk3_state;
-__thread int g_mntr_fire;
-__thread int g_arti_health;
-__thread int g_arti_superhealth;
-__thread int g_arti_fly;
-__thread int g_arti_limit;
-__thread int g_sfx_sawup;
-__thread int g_sfx_telept;
-__thread int g_sfx_stnmov;
-__thread int g_sfx_stnmov_plats;
-__thread int g_sfx_swtchn;
-__thread int g_sfx_swtchx;
-__thread int g_sfx_dorcls;
-__thread int g_sfx_doropn;
-__thread int g_sfx_dorlnd;
-__thread int g_sfx_pstart;
-__thread int g_sfx_pstop;
-__thread int g_sfx_itemup;
-__thread int g_sfx_pistol;
-__thread int g_sfx_oof;
-__thread int g_sfx_menu;
-__thread int g_sfx_respawn;
-__thread int g_sfx_secret;
-__thread int g_sfx_revive;
-__thread int g_sfx_console;
-__thread int g_door_normal;
-__thread int g_door_raise_in_5_mins;
-__thread int g_door_open;
-__thread int g_st_height;
-__thread int g_border_offset;
-__thread int g_mf_translucent;
-__thread int g_mf_shadow;
-__thread const char* g_menu_flat;
-__thread int g_menu_save_page_size;
-__thread int g_menu_font_spacing;
-__thread const char* g_skyflatname;
-__thread dboolean hexen = false;
+const __STORAGE_MODIFIER demostate_t (*demostates)[4];
+extern __STORAGE_MODIFIER const demostate_t doom_demostates[][4];
+extern __STORAGE_MODIFIER const demostate_t heretic_demostates[][4];
+extern __STORAGE_MODIFIER const demostate_t hexen_demostates[][4];
+
+__STORAGE_MODIFIER weaponinfo_t* weaponinfo;
+
+__STORAGE_MODIFIER int g_maxplayers = 4;
+__STORAGE_MODIFIER int g_viewheight = 41 * FRACUNIT;
+__STORAGE_MODIFIER int g_numammo;
+__STORAGE_MODIFIER int g_mt_player;
+__STORAGE_MODIFIER int g_mt_tfog;
+__STORAGE_MODIFIER int g_mt_blood;
+__STORAGE_MODIFIER int g_skullpop_mt;
+__STORAGE_MODIFIER int g_s_bloodyskullx1;
+__STORAGE_MODIFIER int g_s_bloodyskullx2;
+__STORAGE_MODIFIER int g_s_play_fdth20;
+__STORAGE_MODIFIER int g_wp_fist;
+__STORAGE_MODIFIER int g_wp_chainsaw;
+__STORAGE_MODIFIER int g_wp_pistol;
+__STORAGE_MODIFIER int g_telefog_height;
+__STORAGE_MODIFIER int g_thrust_factor;
+__STORAGE_MODIFIER int g_fuzzy_aim_shift;
+__STORAGE_MODIFIER int g_jump;
+__STORAGE_MODIFIER int g_s_null;
+__STORAGE_MODIFIER int g_mt_bloodsplatter;
+__STORAGE_MODIFIER int g_bloodsplatter_shift;
+__STORAGE_MODIFIER int g_bloodsplatter_weight;
+__STORAGE_MODIFIER int g_mons_look_range;
+__STORAGE_MODIFIER int g_hide_state;
+__STORAGE_MODIFIER int g_lava_type;
+__STORAGE_MODIFIER int g_mntr_charge_speed;
+__STORAGE_MODIFIER int g_mntr_atk1_sfx;
+__STORAGE_MODIFIER int g_mntr_decide_range;
+__STORAGE_MODIFIER int g_mntr_charge_rng;
+__STORAGE_MODIFIER int g_mntr_fire_rng;
+__STORAGE_MODIFIER int g_mntr_charge_state;
+__STORAGE_MODIFIER int g_mntr_fire_state;
+__STORAGE_MODIFIER int g_mntr_charge_puff;
+__STORAGE_MODIFIER int g_mntr_atk2_sfx;
+__STORAGE_MODIFIER int g_mntr_atk2_dice;
+__STORAGE_MODIFIER int g_mntr_atk2_missile;
+__STORAGE_MODIFIER int g_mntr_atk3_sfx;
+__STORAGE_MODIFIER int g_mntr_atk3_dice;
+__STORAGE_MODIFIER int g_mntr_atk3_missile;
+__STORAGE_MODIFIER int g_mntr_atk3_state;
+__STORAGE_MODIFIER int g_mntr_fire;
+__STORAGE_MODIFIER int g_arti_health;
+__STORAGE_MODIFIER int g_arti_superhealth;
+__STORAGE_MODIFIER int g_arti_fly;
+__STORAGE_MODIFIER int g_arti_limit;
+__STORAGE_MODIFIER int g_sfx_sawup;
+__STORAGE_MODIFIER int g_sfx_telept;
+__STORAGE_MODIFIER int g_sfx_stnmov;
+__STORAGE_MODIFIER int g_sfx_stnmov_plats;
+__STORAGE_MODIFIER int g_sfx_swtchn;
+__STORAGE_MODIFIER int g_sfx_swtchx;
+__STORAGE_MODIFIER int g_sfx_dorcls;
+__STORAGE_MODIFIER int g_sfx_doropn;
+__STORAGE_MODIFIER int g_sfx_dorlnd;
+__STORAGE_MODIFIER int g_sfx_pstart;
+__STORAGE_MODIFIER int g_sfx_pstop;
+__STORAGE_MODIFIER int g_sfx_itemup;
+__STORAGE_MODIFIER int g_sfx_pistol;
+__STORAGE_MODIFIER int g_sfx_oof;
+__STORAGE_MODIFIER int g_sfx_menu;
+__STORAGE_MODIFIER int g_sfx_respawn;
+__STORAGE_MODIFIER int g_sfx_secret;
+__STORAGE_MODIFIER int g_sfx_revive;
+__STORAGE_MODIFIER int g_sfx_console;
+__STORAGE_MODIFIER int g_door_normal;
+__STORAGE_MODIFIER int g_door_raise_in_5_mins;
+__STORAGE_MODIFIER int g_door_open;
+__STORAGE_MODIFIER int g_st_height;
+__STORAGE_MODIFIER int g_border_offset;
+__STORAGE_MODIFIER int g_mf_translucent;
+__STORAGE_MODIFIER int g_mf_shadow;
+__STORAGE_MODIFIER const char* g_menu_flat;
+__STORAGE_MODIFIER int g_menu_save_page_size;
+__STORAGE_MODIFIER int g_menu_font_spacing;
+__STORAGE_MODIFIER const char* g_skyflatname;
+__STORAGE_MODIFIER dboolean hexen = false;
 
 static void dsda_InitDoom(void) {
   int i;
-  doom_mobjinfo_t* mobjinfo_p;
+  const doom_mobjinfo_t* mobjinfo_p;
 
   dsda_InitializeMobjInfo(DOOM_MT_ZERO, DOOM_NUMMOBJTYPES, DOOM_NUMMOBJTYPES);
   dsda_InitializeStates(doom_states, DOOM_NUMSTATES);
@@ -254,8 +254,7 @@ static void dsda_InitDoom(void) {
   mobjinfo[MT_HEADSHOT].altspeed = 20 * FRACUNIT;
   mobjinfo[MT_TROOPSHOT].altspeed = 20 * FRACUNIT;
 
-  for (i = S_SARG_RUN1; i <= S_SARG_PAIN2; ++i)
-    states[i].flags |= STATEF_SKILL5FAST;
+  // The demon states' STATEF_SKILL5FAST flags are set in info.c, as the states table is shared
 }
 
 extern void dsda_ResetNullPClass(void);
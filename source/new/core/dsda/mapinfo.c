@@ -29,7 +29,7 @@
 
 #include "mapinfo.h"
 
-__thread map_info_t map_info;
+__STORAGE_MODIFIER map_info_t map_info;
 
 int dsda_NameToMap(const char* name, int* episode, int* map) {
   int found;
@@ -249,7 +249,7 @@ typedef enum {
   finale_owner_doom,
 } finale_owner_t;
 
-static __thread finale_owner_t finale_owner = finale_owner_legacy;
+static __STORAGE_MODIFIER finale_owner_t finale_owner = finale_owner_legacy;
 
 void dsda_StartFinale(void) {
   if (dsda_DoomStartFinale()) {
@@ -34,13 +34,13 @@
 
 #include "doom.h"
 
-static __thread const doom_mapinfo_map_t* last_map;
-static __thread const doom_mapinfo_map_t* next_map;
-static __thread const doom_mapinfo_map_t* current_map;
-static __thread doom_mapinfo_cluster_t* last_cluster;
-static __thread doom_mapinfo_cluster_t* next_cluster;
-static __thread doom_mapinfo_cluster_t* current_cluster;
-static __thread const doom_mapinfo_map_next_t* end_data;
+static __STORAGE_MODIFIER const doom_mapinfo_map_t* last_map;
+static __STORAGE_MODIFIER const doom_mapinfo_map_t* next_map;
+static __STORAGE_MODIFIER const doom_mapinfo_map_t* current_map;
+static __STORAGE_MODIFIER doom_mapinfo_cluster_t* last_cluster;
+static __STORAGE_MODIFIER doom_mapinfo_cluster_t* next_cluster;
+static __STORAGE_MODIFIER doom_mapinfo_cluster_t* current_cluster;
+static __STORAGE_MODIFIER const doom_mapinfo_map_next_t* end_data;
 
 static doom_mapinfo_map_next_t default_end_data = {
   .end = dmi_end_game_cast
@@ -343,13 +343,13 @@ int dsda_DoomInterMusic(int* music_index, int* music_lump) {
   return true;
 }
 
-extern __thread int finalestage;
-extern __thread int finalecount;
-extern __thread const char* finaletext;
-extern __thread const char* finaleflat;
-extern __thread const char* finalepatch;
-extern __thread int acceleratestage;
-extern __thread int midstage;
+extern __STORAGE_MODIFIER int finalestage;
+extern __STORAGE_MODIFIER int finalecount;
+extern __STORAGE_MODIFIER const char* finaletext;
+extern __STORAGE_MODIFIER const char* finaleflat;
+extern __STORAGE_MODIFIER const char* finalepatch;
+extern __STORAGE_MODIFIER int acceleratestage;
+extern __STORAGE_MODIFIER int midstage;
 
 // TODO: use end_game everywhere and collapse all the finale implementations
 
@@ -404,7 +404,7 @@ int dsda_DoomFTicker(void) {
     int i;
 
     for (i = 0; i < g_maxplayers; i++)
-      if (players[i].cmd.buttons)
+      if (engine_context->players[i].cmd.buttons)
         next_level = true;
   }
 
@@ -578,10 +578,10 @@ int dsda_DoomPrepareIntermission(int* result) {
     int i;
 
     for (i = 0; i < g_maxplayers; i++)
-      players[i].didsecret = false;
+      engine_context->players[i].didsecret = false;
   }
 
-  wminfo.didsecret = players[consoleplayer].didsecret;
+  wminfo.didsecret = engine_context->players[consoleplayer].didsecret;
 
   if (!map) {
     end_data = next;
@@ -657,9 +657,9 @@ int dsda_DoomBorderTexture(const char** border_texture) {
 }
 
 int dsda_DoomPrepareEntering(void) {
-  extern __thread const char *el_levelname;
-  extern __thread const char *el_levelpic;
-  extern __thread const char *el_author;
+  extern __STORAGE_MODIFIER const char *el_levelname;
+  extern __STORAGE_MODIFIER const char *el_levelpic;
+  extern __STORAGE_MODIFIER const char *el_author;
 
   if (!next_map)
     return false;
@@ -679,9 +679,9 @@ int dsda_DoomPrepareEntering(void) {
 }
 
 int dsda_DoomPrepareFinished(void) {
-  extern __thread const char *lf_levelname;
-  extern __thread const char *lf_levelpic;
-  extern __thread const char *lf_author;
+  extern __STORAGE_MODIFIER const char *lf_levelname;
+  extern __STORAGE_MODIFIER const char *lf_levelpic;
+  extern __STORAGE_MODIFIER const char *lf_author;
 
   if (!last_map)
     return false;
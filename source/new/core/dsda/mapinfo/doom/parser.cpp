@@ -794,7 +794,7 @@ static void dsda_ParseDoomMapInfoIdentifier(Scanner &scanner) {
   }
 }
 
-__thread doom_mapinfo_t doom_mapinfo;
+__STORAGE_MODIFIER doom_mapinfo_t doom_mapinfo;
 
 void dsda_ParseDoomMapInfo(const unsigned char* buffer, size_t length, doom_mapinfo_errorfunc err) {
   Scanner scanner((const char*) buffer, length);
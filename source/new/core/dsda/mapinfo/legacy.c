@@ -437,10 +437,10 @@ int dsda_LegacyPrepareIntermission(int* result) {
       int i;
 
       for (i = 0; i < g_maxplayers; i++)
-        players[i].didsecret = true;
+        engine_context->players[i].didsecret = true;
     }
 
-  wminfo.didsecret = players[consoleplayer].didsecret;
+  wminfo.didsecret = engine_context->players[consoleplayer].didsecret;
 
   // wminfo.next is 0 biased, unlike gamemap
   if (gamemode == commercial) {
@@ -569,9 +569,9 @@ int dsda_LegacyBorderTexture(const char** border_texture) {
 }
 
 int dsda_LegacyPrepareEntering(void) {
-  extern __thread const char *el_levelname;
-  extern __thread const char *el_levelpic;
-  extern __thread const char *el_author;
+  extern __STORAGE_MODIFIER const char *el_levelname;
+  extern __STORAGE_MODIFIER const char *el_levelpic;
+  extern __STORAGE_MODIFIER const char *el_author;
 
   el_levelname = NULL;
   el_levelpic = NULL;
@@ -581,9 +581,9 @@ int dsda_LegacyPrepareEntering(void) {
 }
 
 int dsda_LegacyPrepareFinished(void) {
-  extern __thread const char *lf_levelname;
-  extern __thread const char *lf_levelpic;
-  extern __thread const char *lf_author;
+  extern __STORAGE_MODIFIER const char *lf_levelname;
+  extern __STORAGE_MODIFIER const char *lf_levelpic;
+  extern __STORAGE_MODIFIER const char *lf_author;
 
   lf_levelname = NULL;
   lf_levelpic = NULL;
@@ -25,10 +25,10 @@
 
 #include "mobjinfo.h"
 
-__thread mobjinfo_t* mobjinfo;
-__thread int num_mobj_types;
-__thread int mobj_types_zero;
-__thread byte* edited_mobjinfo_bits;
+__STORAGE_MODIFIER mobjinfo_t* mobjinfo;
+__STORAGE_MODIFIER int num_mobj_types;
+__STORAGE_MODIFIER int mobj_types_zero;
+__STORAGE_MODIFIER byte* edited_mobjinfo_bits;
 
 static void dsda_ResetMobjInfo(int from, int to) {
   int i;
@@ -63,7 +63,7 @@ static void dsda_EnsureCapacity(int limit) {
   }
 }
 
-static __thread deh_index_hash_t deh_mobj_index_hash;
+static __STORAGE_MODIFIER deh_index_hash_t deh_mobj_index_hash;
 
 int dsda_FindDehMobjIndex(int index) {
   return 0;
@@ -106,13 +106,13 @@ void dsda_FreeDehMobjInfo(void) {
   // free(edited_mobjinfo_bits);
 }
 
-__thread int ZMT_MAPSPOT = ZMT_UNDEFINED;
-__thread int ZMT_MAPSPOT_GRAVITY = ZMT_UNDEFINED;
-__thread int ZMT_TELEPORTDEST2 = ZMT_UNDEFINED;
-__thread int ZMT_TELEPORTDEST3 = ZMT_UNDEFINED;
-__thread int ZMT_AMBIENTSOUND = ZMT_UNDEFINED;
+__STORAGE_MODIFIER int ZMT_MAPSPOT = ZMT_UNDEFINED;
+__STORAGE_MODIFIER int ZMT_MAPSPOT_GRAVITY = ZMT_UNDEFINED;
+__STORAGE_MODIFIER int ZMT_TELEPORTDEST2 = ZMT_UNDEFINED;
+__STORAGE_MODIFIER int ZMT_TELEPORTDEST3 = ZMT_UNDEFINED;
+__STORAGE_MODIFIER int ZMT_AMBIENTSOUND = ZMT_UNDEFINED;
 
-static __thread mobjinfo_t zmt_mapspot_info = {
+static __STORAGE_MODIFIER mobjinfo_t zmt_mapspot_info = {
   .doomednum = 9001,
   .spawnstate = S_NULL,
   .spawnhealth = 1000,
@@ -149,7 +149,7 @@ static __thread mobjinfo_t zmt_mapspot_info = {
   .visibility = VF_ZDOOM,
 };
 
-static __thread mobjinfo_t zmt_mapspot_gravity_info = {
+static __STORAGE_MODIFIER mobjinfo_t zmt_mapspot_gravity_info = {
   .doomednum = 9013,
   .spawnstate = S_NULL,
   .spawnhealth = 1000,
@@ -186,7 +186,7 @@ static __thread mobjinfo_t zmt_mapspot_gravity_info = {
   .visibility = VF_ZDOOM,
 };
 
-static __thread mobjinfo_t zmt_teleportdest2_info = {
+static __STORAGE_MODIFIER mobjinfo_t zmt_teleportdest2_info = {
   .doomednum = 9044,
   .spawnstate = S_NULL,
   .spawnhealth = 1000,
@@ -223,7 +223,7 @@ static __thread mobjinfo_t zmt_teleportdest2_info = {
   .visibility = VF_ZDOOM,
 };
 
-static __thread mobjinfo_t zmt_teleportdest3_info = {
+static __STORAGE_MODIFIER mobjinfo_t zmt_teleportdest3_info = {
   .doomednum = 9043,
   .spawnstate = S_NULL,
   .spawnhealth = 1000,
@@ -260,7 +260,7 @@ static __thread mobjinfo_t zmt_teleportdest3_info = {
   .visibility = VF_ZDOOM,
 };
 
-static __thread mobjinfo_t zmt_ambient_sound = {
+static __STORAGE_MODIFIER mobjinfo_t zmt_ambient_sound = {
   .doomednum = 14064,
   .spawnstate = S_NULL,
   .spawnhealth = 1000,
@@ -302,7 +302,7 @@ typedef struct {
   mobjinfo_t* mobjinfo_p;
 } append_mobjinfo_t;
 
-static __thread append_mobjinfo_t append_mobjinfo[] = {
+static __STORAGE_MODIFIER append_mobjinfo_t append_mobjinfo[] = {
   { NULL, NULL },
   { NULL, NULL },
   { NULL, NULL },
@@ -310,5 +310,5 @@ static __thread append_mobjinfo_t append_mobjinfo[] = {
   { NULL, NULL },
 };
 
-static __thread int append_mobjinfo_count = sizeof(append_mobjinfo) / sizeof(append_mobjinfo[0]);
+static __STORAGE_MODIFIER int append_mobjinfo_count = sizeof(append_mobjinfo) / sizeof(append_mobjinfo[0]);
 
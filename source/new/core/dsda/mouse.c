@@ -20,10 +20,10 @@
 
 #include "mouse.h"
 
-static __thread int quickstart_cache_tics;
-static __thread int quickstart_queued;
-static __thread signed short angleturn_cache[35];
-static __thread unsigned int angleturn_cache_index;
+static __STORAGE_MODIFIER int quickstart_cache_tics;
+static __STORAGE_MODIFIER int quickstart_queued;
+static __STORAGE_MODIFIER signed short angleturn_cache[35];
+static __STORAGE_MODIFIER unsigned int angleturn_cache_index;
 
 void dsda_InitQuickstartCache(void) {
   quickstart_cache_tics = dsda_IntConfig(dsda_config_quickstart_cache_tics);
@@ -20,9 +20,11 @@
 #include "doomstat.h"
 #include "g_game.h"
 #include "lprintf.h"
+#include "m_random.h"
 #include "z_zone.h"
 #include "p_saveg.h"
 #include "p_map.h"
+#include "p_hash.h"
 
 #include "dsda/args.h"
 #include "dsda/configuration.h"
@@ -34,12 +36,12 @@
 
 #include "save.h"
 
-static __thread char* dsda_base_save_dir;
-static __thread char* dsda_wad_save_dir;
+static __STORAGE_MODIFIER char* dsda_base_save_dir;
+static __STORAGE_MODIFIER char* dsda_wad_save_dir;
 
-extern __thread int dsda_max_kill_requirement;
-extern __thread dboolean reachedLevelExit;
-extern __thread dboolean reachedGameEnd;
+extern __STORAGE_MODIFIER int dsda_max_kill_requirement;
+extern __STORAGE_MODIFIER dboolean reachedLevelExit;
+extern __STORAGE_MODIFIER dboolean reachedGameEnd;
 
 static void dsda_ArchiveInternal(void) {
   uint64_t features;
@@ -48,15 +50,32 @@ static void dsda_ArchiveInternal(void) {
 
   features = dsda_UsedFeatures();
   P_SAVE_X(features);
+
+  P_SAVE_BYTE(world_hash_tracked);
+  P_SAVE_ARRAY(world_hash);
 }
 
 static void dsda_UnArchiveInternal(void) {
   uint64_t features;
+  byte hash_tracked;
+  uint64_t hash[2];
 
   P_LOAD_X(dsda_max_kill_requirement);
 
   P_LOAD_X(features);
   dsda_MergeFeatures(features);
+
+  // The loaded mobjs were hashed as they were linked, so only the sum of
+  // all contributions is missing, unless it was not kept when saving
+  P_LOAD_BYTE(hash_tracked);
+  P_LOAD_ARRAY(hash);
+  if (world_hash_tracked)
+  {
+    if (hash_tracked)
+      memcpy(world_hash, hash, sizeof(hash));
+    else
+      P_RebuildWorldHash();
+  }
 }
 
 static void dsda_ArchiveContext(void) {
@@ -70,22 +89,22 @@ static void dsda_ArchiveContext(void) {
   P_SAVE_BYTE(gamemap);
 
   for (i = 0; i < g_maxplayers; ++i)
-    P_SAVE_BYTE(playeringame[i]);
+    P_SAVE_BYTE(engine_context->playeringame[i]);
 
   for (; i < FUTURE_MAXPLAYERS; ++i)
     P_SAVE_BYTE(0);
 
-  CheckSaveGame(dsda_GameOptionSize());
+  // fixed offset, see dsda_ReadSaveContext
+  P_SAVE_X(engine_context->leveltime);
+  P_SAVE_X(totalleveltimes);
+  P_SAVE_X(levels_completed);
+
   save_p = G_WriteOptions(save_p);
 
   P_SAVE_X(leave_data);
 
   P_SAVE_X(map_info.default_colormap);
 
-  P_SAVE_X(leveltime);
-  P_SAVE_X(totalleveltimes);
-  P_SAVE_X(levels_completed);
-
   boom_logictic_value = boom_logictic;
   P_SAVE_X(boom_logictic_value);
 
@@ -107,9 +126,13 @@ static void dsda_UnArchiveContext(void) {
   dsda_UpdateGameMap(epi, map);
 
   for (i = 0; i < g_maxplayers; ++i)
-    P_LOAD_BYTE(playeringame[i]);
+    P_LOAD_BYTE(engine_context->playeringame[i]);
   save_p += FUTURE_MAXPLAYERS - g_maxplayers;
 
+  P_LOAD_X(engine_context->leveltime);
+  P_LOAD_X(totalleveltimes);
+  P_LOAD_X(levels_completed);
+
   save_p += (G_ReadOptions(save_p) - save_p);
 
   P_LOAD_X(leave_data);
@@ -118,53 +141,384 @@ static void dsda_UnArchiveContext(void) {
 
   P_LOAD_X(map_info.default_colormap);
 
-  P_LOAD_X(leveltime);
-  P_LOAD_X(totalleveltimes);
-  P_LOAD_X(levels_completed);
-
   P_LOAD_X(boom_logictic_value);
-  boom_basetic = gametic - boom_logictic_value;
+  boom_basetic = engine_context->gametic - boom_logictic_value;
 
   P_LOAD_X(true_logictic_value);
-  true_basetic = gametic - true_logictic_value;
+  true_basetic = engine_context->gametic - true_logictic_value;
+}
+
+//
+// Section table
+//
+// A save starts with the number of sections and ends with the offset of each
+// section from the start of the save, plus the end offset of the last one.
+// The table comes last so the whole save is written (and hashed) in order.
+//
+
+typedef uint32_t dsda_save_offset_t;
+
+#define SAVE_TABLE_SIZE ((dsda_save_section_count + 1) * sizeof(dsda_save_offset_t))
+
+static __STORAGE_MODIFIER size_t save_start;
+static __STORAGE_MODIFIER dsda_save_offset_t save_offsets[dsda_save_section_count + 1];
+
+static void dsda_BeginSaveSection(int section) {
+  P_UpdateSaveHash(true);
+  save_offsets[section] = P_SaveOffset() - save_start;
+}
+
+const byte* dsda_SaveSection(const byte* save, size_t save_size, int section, size_t* section_size) {
+  dsda_save_offset_t begin, end;
+  const byte* table;
+
+  if (section < 0 || section >= dsda_save_section_count)
+    return NULL;
+
+  if (save_size < 1 + SAVE_TABLE_SIZE || save[0] != dsda_save_section_count)
+    return NULL;
+
+  table = save + save_size - SAVE_TABLE_SIZE;
+  memcpy(&begin, table + section * sizeof(begin), sizeof(begin));
+  memcpy(&end, table + (section + 1) * sizeof(end), sizeof(end));
+
+  if (begin < 1 || begin > end || end > save_size - SAVE_TABLE_SIZE)
+    return NULL;
+
+  *section_size = end - begin;
+  return save + begin;
+}
+
+// Same encoding as P_LoadVarUInt, reading from a caller owned cursor
+static dboolean dsda_ReadVarUInt(const byte** p, const byte* end, uint64_t* value) {
+  int shift = 0;
+  byte b;
+
+  *value = 0;
+  do {
+    if (*p >= end || shift > 63)
+      return false;
+
+    b = *(*p)++;
+    *value |= (uint64_t) (b & 0x7f) << shift;
+    shift += 7;
+  } while (b & 0x80);
+
+  return true;
+}
+
+static dboolean dsda_ReadVarInt(const byte** p, const byte* end, int* value) {
+  uint64_t v;
+
+  if (!dsda_ReadVarUInt(p, end, &v))
+    return false;
+
+  *value = (int) ((int64_t) (v >> 1) ^ -(int64_t) (v & 1));
+  return true;
+}
+
+dboolean dsda_ReadSaveContext(const byte* save, size_t save_size, dsda_save_context_t* context) {
+  const byte* p;
+  size_t size;
+
+  p = dsda_SaveSection(save, save_size, dsda_save_context, &size);
+  if (!p || size < 4 + FUTURE_MAXPLAYERS + sizeof(engine_context->leveltime) + sizeof(totalleveltimes))
+    return false;
+
+  // see dsda_ArchiveContext
+  context->compatibility_level = p[0];
+  context->skill = p[1];
+  context->episode = p[2];
+  context->map = p[3];
+  p += 4 + FUTURE_MAXPLAYERS;
+  memcpy(&context->leveltime, p, sizeof(engine_context->leveltime));
+  p += sizeof(engine_context->leveltime);
+  memcpy(&context->totalleveltimes, p, sizeof(totalleveltimes));
+
+  return true;
+}
+
+dboolean dsda_ReadSavePlayer(const byte* save, size_t save_size, dsda_save_player_t* player) {
+  const byte* p;
+  const byte* end;
+  size_t size;
+  uint64_t playerstate;
+  int ignored;
+  int i;
+
+  p = dsda_SaveSection(save, save_size, dsda_save_players, &size);
+  if (!p)
+    return false;
+  end = p + size;
+
+  // see P_ArchivePlayers
+  if (!dsda_ReadVarUInt(&p, end, &playerstate))
+    return false;
+  player->playerstate = (int) playerstate;
+
+  // cmd
+  for (i = 0; i < 3; ++i)
+    if (!dsda_ReadVarInt(&p, end, &ignored))
+      return false;
+  if (end - p < 6) // buttons, lookfly, arti and the ex actions and slots
+    return false;
+  p += 6;
+  if (!dsda_ReadVarInt(&p, end, &ignored))
+    return false;
+
+  return dsda_ReadVarInt(&p, end, &player->viewz) &&
+         dsda_ReadVarInt(&p, end, &ignored) && // viewheight
+         dsda_ReadVarInt(&p, end, &ignored) && // deltaviewheight
+         dsda_ReadVarInt(&p, end, &ignored) && // bob
+         dsda_ReadVarInt(&p, end, &player->health) &&
+         dsda_ReadVarInt(&p, end, &player->armorpoints) &&
+         dsda_ReadVarInt(&p, end, &player->armortype);
+}
+
+dboolean dsda_ReadSaveRNG(const byte* save, size_t save_size, rng_t* rng) {
+  const byte* p;
+  size_t size;
+
+  p = dsda_SaveSection(save, save_size, dsda_save_rng, &size);
+  if (!p || size != sizeof(*rng))
+    return false;
+
+  memcpy(rng, p, sizeof(*rng));
+  return true;
+}
+
+dboolean dsda_ReadSaveFlags(const byte* save, size_t save_size, dsda_save_flags_t* flags) {
+  const byte* p;
+  size_t size;
+
+  p = dsda_SaveSection(save, save_size, dsda_save_flags, &size);
+  if (!p || size != 2 + 5 * sizeof(int))
+    return false;
+
+  flags->reached_level_exit = p[0];
+  flags->reached_game_end = p[1];
+  memcpy(&flags->gametic, p + 2, sizeof(int));
+  memcpy(&flags->totallive, p + 2 + sizeof(int), sizeof(int));
+  memcpy(&flags->totalkills, p + 2 + 2 * sizeof(int), sizeof(int));
+  memcpy(&flags->totalitems, p + 2 + 3 * sizeof(int), sizeof(int));
+  memcpy(&flags->totalsecret, p + 2 + 4 * sizeof(int), sizeof(int));
+  return true;
+}
+
+static dboolean dsda_SkipVarInts(const byte** p, const byte* end, int count) {
+  uint64_t ignored;
+
+  while (count-- > 0)
+    if (!dsda_ReadVarUInt(p, end, &ignored))
+      return false;
+
+  return true;
+}
+
+#define READ_VARINT(x) if (!dsda_ReadVarInt(&p, end, &(x))) return false
+#define SKIP_VARINTS(count) if (!dsda_SkipVarInts(&p, end, (count))) return false
+
+// Reads the players of the section into the features, see P_ArchivePlayers
+static dboolean dsda_ReadSavePlayerFeatures(const byte* p, const byte* end, const byte* in_game, gameFeatures_t* features) {
+  int i, j;
+
+  for (i = 0; i < g_maxplayers; i++)
+  {
+    playerFeatures_t* f;
+    int value;
+
+    if (!in_game[i])
+      continue;
+
+    if (i >= GAME_FEATURES_MAX_PLAYERS)
+      return true;
+
+    f = &features->players[i];
+    features->playerCount = i + 1;
+    f->inGame = true;
+
+    SKIP_VARINTS(4); // playerstate, forwardmove, sidemove, angleturn
+    if (end - p < 6)
+      return false;
+    p += 6;
+    SKIP_VARINTS(5); // look, viewz, viewheight, deltaviewheight, bob
+    READ_VARINT(f->health);
+    READ_VARINT(f->armorPoints);
+    READ_VARINT(f->armorType);
+    SKIP_VARINTS(NUMPOWERS + NUMCARDS + 1 + MAX_MAXPLAYERS); // powers, cards, backpack, frags
+    READ_VARINT(f->readyWeapon);
+    SKIP_VARINTS(1); // pendingweapon
+
+    for (j = 0; j < NUMWEAPONS; j++)
+    {
+      READ_VARINT(value);
+      if (value && j < 32)
+        f->weaponsOwned |= 1u << j;
+    }
+
+    for (j = 0; j < NUMAMMO; j++)
+    {
+      READ_VARINT(value);
+      if (j < GAME_FEATURES_MAX_AMMO)
+        f->ammo[j] = value;
+    }
+
+    SKIP_VARINTS(NUMAMMO + 4); // maxammo, attackdown, usedown, cheats, refire
+    READ_VARINT(f->killCount);
+    READ_VARINT(f->itemCount);
+    READ_VARINT(f->secretCount);
+
+    // damagecount up to hazardcount, and the psprites in between
+    SKIP_VARINTS(6 + 4 * NUMPSPRITES + 4 + 8 + 6 + 1);
+    if (end - p < 2) // hazardinterval and the body flag
+      return false;
+    f->hasBody = p[1];
+    p += 2;
+
+    f->exitDistance = -1;
+    if (f->hasBody)
+    {
+      uint64_t angle;
+
+      READ_VARINT(f->x);
+      READ_VARINT(f->y);
+      READ_VARINT(f->z);
+      READ_VARINT(f->momX);
+      READ_VARINT(f->momY);
+      READ_VARINT(f->momZ);
+      if (!dsda_ReadVarUInt(&p, end, &angle))
+        return false;
+      f->angle = (uint32_t) angle;
+      READ_VARINT(f->sector);
+    }
+  }
+
+  return true;
+}
+
+#undef READ_VARINT
+#undef SKIP_VARINTS
+
+// Reads the game features of a save from its context, players and flags
+// sections, without loading it. The exit distance needs the level's lines,
+// so it is left negative, as for a map without exits.
+dboolean dsda_ReadSaveFeatures(const byte* save, size_t save_size, gameFeatures_t* features) {
+  dsda_save_context_t context;
+  dsda_save_flags_t flags;
+  const byte* context_p;
+  const byte* players_p;
+  size_t context_size, players_size;
+
+  memset(features, 0, sizeof(*features));
+
+  context_p = dsda_SaveSection(save, save_size, dsda_save_context, &context_size);
+  players_p = dsda_SaveSection(save, save_size, dsda_save_players, &players_size);
+  if (!context_p || !players_p || !dsda_ReadSaveContext(save, save_size, &context) ||
+      !dsda_ReadSaveFlags(save, save_size, &flags))
+    return false;
+
+  features->version = GAME_FEATURES_VERSION;
+  features->gameTic = flags.gametic;
+  features->episode = context.episode;
+  features->map = context.map;
+  features->levelExit = flags.reached_level_exit;
+  features->gameEnd = flags.reached_game_end;
+  features->liveMonsters = flags.totallive;
+  features->totalKills = flags.totalkills;
+  features->totalItems = flags.totalitems;
+  features->totalSecrets = flags.totalsecret;
+
+  // The context holds which players are in game, see dsda_ArchiveContext
+  return dsda_ReadSavePlayerFeatures(players_p, players_p + players_size, context_p + 4, features);
 }
 
 void dsda_ArchiveAll(void) {
-  // size_t saveSize;
-  // saveSize = headlessGetEffectiveSaveSize(); printf("Save Size: %lu bytes\n");
+  save_start = P_SaveOffset();
+  P_BeginSaveHash();
+  P_SAVE_BYTE(dsda_save_section_count);
 
+  dsda_BeginSaveSection(dsda_save_context);
   dsda_ArchiveContext();
 
+  dsda_BeginSaveSection(dsda_save_acs);
   P_ArchiveACS();
-  // P_ArchivePlayers();
-  P_ThinkerToIndex();
+
+  dsda_BeginSaveSection(dsda_save_players);
+  P_ArchivePlayers();
+
+  dsda_BeginSaveSection(dsda_save_world);
   P_ArchiveWorld();
-  // P_ArchiveThinkers();
+
+  dsda_BeginSaveSection(dsda_save_thinkers);
+  P_ArchiveThinkers();
+
+  dsda_BeginSaveSection(dsda_save_scripts);
   P_ArchiveScripts();
   P_ArchiveSounds();
   P_ArchiveAmbientSound();
   P_ArchiveMisc();
-  P_IndexToThinker();
+
+  dsda_BeginSaveSection(dsda_save_rng);
   P_ArchiveRNG();
-  P_ArchiveMap();
 
+  dsda_BeginSaveSection(dsda_save_internal);
+  P_ArchiveMap();
   dsda_ArchiveInternal();
 
+  dsda_BeginSaveSection(dsda_save_flags);
   P_SAVE_BYTE(reachedLevelExit);
   P_SAVE_BYTE(reachedGameEnd);
-  P_SAVE_X(gametic);
+  P_SAVE_X(engine_context->gametic);
+  P_SAVE_X(totallive);
+  P_SAVE_X(totalkills);
+  P_SAVE_X(totalitems);
+  P_SAVE_X(totalsecret);
+
+  dsda_BeginSaveSection(dsda_save_section_count);
+  P_SAVE_ARRAY(save_offsets);
+  P_UpdateSaveHash(true);
+}
+
+// Exact size of the archive dsda_ArchiveAll writes: the sizing pass of the
+// writers whose output depends on the state, plus the fixed size of the rest
+size_t dsda_ArchiveSize(void) {
+  save_size = 1;
+
+  // context
+  save_size += 4 + FUTURE_MAXPLAYERS + sizeof(engine_context->leveltime) + sizeof(totalleveltimes) +
+               sizeof(levels_completed) + dsda_GameOptionSize() + sizeof(leave_data) +
+               sizeof(map_info.default_colormap) + 2 * sizeof(int);
+
+  P_ArchivePlayersSize();
+  P_ArchiveWorldSize();
+  P_ArchiveThinkersSize();
+
+  // rng, internal and flags
+  save_size += sizeof(engine_context->rng);
+  save_size += sizeof(dsda_max_kill_requirement) + sizeof(uint64_t) + 1 + sizeof(world_hash);
+  save_size += 2 + sizeof(engine_context->gametic) + sizeof(totallive) + sizeof(totalkills) +
+               sizeof(totalitems) + sizeof(totalsecret);
+  save_size += SAVE_TABLE_SIZE;
+
+  return save_size;
 }
 
 extern size_t headlessGetEffectiveSaveSize();
 
 void dsda_UnArchiveAll(void) {
+  const int unloaded_gametic = engine_context->gametic;
+
+  if (*save_p != dsda_save_section_count)
+    I_Error("dsda_UnArchiveAll: Unknown save format");
+  save_p++;
+
   dsda_UnArchiveContext();
 
   P_MapStart();
   P_UnArchiveACS();
-  // P_UnArchivePlayers();
+  P_UnArchivePlayers();
   P_UnArchiveWorld();
-  // P_UnArchiveThinkers();
+  P_UnArchiveThinkers();
   P_UnArchiveScripts();
   P_UnArchiveSounds();
   P_UnArchiveAmbientSound();
@@ -177,7 +531,15 @@ void dsda_UnArchiveAll(void) {
 
   P_LOAD_BYTE(reachedLevelExit);
   P_LOAD_BYTE(reachedGameEnd);
-  P_LOAD_X(gametic);
+  P_LOAD_X(engine_context->gametic);
+  P_LOAD_X(totallive);
+  P_LOAD_X(totalkills);
+  P_LOAD_X(totalitems);
+  P_LOAD_X(totalsecret);
+
+  // The context set the base tics against the gametic from before the load
+  boom_basetic += engine_context->gametic - unloaded_gametic;
+  true_basetic += engine_context->gametic - unloaded_gametic;
 }
 
 void dsda_InitSaveDir(void) {
@@ -195,9 +557,9 @@ char* dsda_SaveDir(void) {
   return dsda_base_save_dir;
 }
 
-static __thread int* demo_save_slots;
-static __thread int allocated_save_slot_count;
-static __thread int demo_save_slot_count;
+static __STORAGE_MODIFIER int* demo_save_slots;
+static __STORAGE_MODIFIER int allocated_save_slot_count;
+static __STORAGE_MODIFIER int demo_save_slot_count;
 
 void dsda_ResetDemoSaveSlots(void) {
   demo_save_slot_count = 0;
@@ -18,7 +18,66 @@
 #ifndef __DSDA_SAVE__
 #define __DSDA_SAVE__
 
+#include "doomtype.h"
+#include "m_random.h"
+#include "gameFeatures.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Sections of a save, in archive order. The save starts with their offsets,
+// so single sections can be read from a buffer without loading it.
+typedef enum {
+  dsda_save_context,
+  dsda_save_acs,
+  dsda_save_players,
+  dsda_save_world,
+  dsda_save_thinkers,
+  dsda_save_scripts,  // scripts, sounds, ambient sounds and misc
+  dsda_save_rng,
+  dsda_save_internal, // automap and dsda internal state
+  dsda_save_flags,    // level exit / game end flags, gametic and level totals
+  dsda_save_section_count
+} dsda_save_section_t;
+
+typedef struct {
+  int compatibility_level;
+  int skill;
+  int episode;
+  int map;
+  int leveltime;
+  int totalleveltimes;
+} dsda_save_context_t;
+
+// Leading fields of the first player in game
+typedef struct {
+  int playerstate;
+  int viewz;
+  int health;
+  int armorpoints;
+  int armortype;
+} dsda_save_player_t;
+
+typedef struct {
+  dboolean reached_level_exit;
+  dboolean reached_game_end;
+  int gametic;
+  int totallive;
+  int totalkills;
+  int totalitems;
+  int totalsecret;
+} dsda_save_flags_t;
+
+const byte* dsda_SaveSection(const byte* save, size_t save_size, int section, size_t* section_size);
+dboolean dsda_ReadSaveContext(const byte* save, size_t save_size, dsda_save_context_t* context);
+dboolean dsda_ReadSavePlayer(const byte* save, size_t save_size, dsda_save_player_t* player);
+dboolean dsda_ReadSaveRNG(const byte* save, size_t save_size, rng_t* rng);
+dboolean dsda_ReadSaveFlags(const byte* save, size_t save_size, dsda_save_flags_t* flags);
+dboolean dsda_ReadSaveFeatures(const byte* save, size_t save_size, gameFeatures_t* features);
+
 void dsda_ArchiveAll(void);
+size_t dsda_ArchiveSize(void);
 void dsda_UnArchiveAll(void);
 void dsda_InitSaveDir(void);
 char* dsda_SaveDir(void);
@@ -32,4 +91,8 @@ int dsda_AllowMenuLoad(int slot);
 int dsda_AllowAnyMenuLoad(void);
 void dsda_UpdateAutoSaves(void);
 
+#ifdef __cplusplus
+}
+#endif
+
 #endif
@@ -30,8 +30,8 @@
 
 #include "settings.h"
 
-__thread int dsda_tas;
-__thread int dsda_skip_next_wipe;
+__STORAGE_MODIFIER int dsda_tas;
+__STORAGE_MODIFIER int dsda_skip_next_wipe;
 
 void dsda_InitSettings(void) {
   void G_UpdateMouseSensitivity(void);
@@ -42,8 +42,8 @@ void dsda_InitSettings(void) {
 }
 
 static int dsda_WadCompatibilityLevel(void) {
-  static __thread int complvl = -1;
-  static __thread int last_numwadfiles = -1;
+  static __STORAGE_MODIFIER int complvl = -1;
+  static __STORAGE_MODIFIER int last_numwadfiles = -1;
 
   // This might be called before all wads are loaded
   if (numwadfiles != last_numwadfiles) {
@@ -242,7 +242,7 @@ int dsda_ShowAliveMonsters(void) {
   return dsda_IntConfig(dsda_config_show_alive_monsters);
 }
 
-__thread int dsda_reveal_map;
+__STORAGE_MODIFIER int dsda_reveal_map;
 
 int dsda_RevealAutomap(void) {
   if (dsda_StrictMode()) return 0;
@@ -284,8 +284,8 @@ dboolean dsda_SkipWipe(void) {
   return !dsda_RenderWipeScreen();
 }
 
-static __thread dboolean game_controller_used;
-static __thread dboolean mouse_used;
+static __STORAGE_MODIFIER dboolean game_controller_used;
+static __STORAGE_MODIFIER dboolean mouse_used;
 
 dboolean dsda_AllowGameController(void) {
   return !dsda_StrictMode() || !mouse_used;
@@ -23,19 +23,20 @@
 
 #include "sprite.h"
 
-__thread const char** sprnames;
-__thread int num_sprites;
-static __thread int deh_spritenames_size;
-static __thread char** deh_spritenames;
-static __thread byte* sprnames_state;
-
+__STORAGE_MODIFIER const char** sprnames;
+__STORAGE_MODIFIER int num_sprites;
+static __STORAGE_MODIFIER int deh_spritenames_size;
+static __STORAGE_MODIFIER char** deh_spritenames;
+static __STORAGE_MODIFIER byte* sprnames_state;
+static __STORAGE_MODIFIER dboolean own_sprnames;
+
+// The initial sprite names are shared by every instance in the process,
+//   so the first change makes a private copy
 static void dsda_PrepAllocation(void) {
-  static int first_allocation = true;
-
-  if (first_allocation) {
+  if (!own_sprnames) {
     const char** source = sprnames;
 
-    first_allocation = false;
+    own_sprnames = true;
     sprnames = malloc(num_sprites * sizeof(*sprnames));
     memcpy(sprnames, source, num_sprites * sizeof(*sprnames));
   }
@@ -89,13 +90,14 @@ int dsda_GetOriginalSpriteIndex(const char* key) {
   return i;
 }
 
-void dsda_InitializeSprites(const char** source, int count) {
+void dsda_InitializeSprites(const char* const* source, int count) {
   int i;
 
   num_sprites = count;
   deh_spritenames_size = num_sprites + 1;
 
-  sprnames = source;
+  sprnames = (const char**) source;
+  own_sprnames = false;
 
   deh_spritenames = malloc(deh_spritenames_size * sizeof(*deh_spritenames));
   for (i = 0; i < num_sprites; i++)
@@ -20,7 +20,7 @@
 
 int dsda_GetDehSpriteIndex(const char* key);
 int dsda_GetOriginalSpriteIndex(const char* key);
-void dsda_InitializeSprites(const char** source, int count);
+void dsda_InitializeSprites(const char* const* source, int count);
 void dsda_FreeDehSprites(void);
 
 #endif
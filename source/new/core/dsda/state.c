@@ -18,14 +18,22 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include "doomstat.h"
+#include "p_mobj.h"
+#include "p_tick.h"
+
 #include "state.h"
 
-__thread state_t* states;
-__thread int num_states;
-__thread byte* defined_codeptr_args;
-__thread statenum_t* seenstate_tab;
+__STORAGE_MODIFIER state_t* states;
+__STORAGE_MODIFIER int num_states;
+__STORAGE_MODIFIER byte* defined_codeptr_args;
+__STORAGE_MODIFIER statenum_t* seenstate_tab;
+
+static __STORAGE_MODIFIER actionf_t* deh_codeptr;
 
-static __thread actionf_t* deh_codeptr;
+// The private copy of the states table, if one was made. Level arena
+//   restores keep it, so it is never lost along with the pointer to it.
+__STORAGE_MODIFIER state_t* states_copy;
 
 static void dsda_ResetStates(int from, int to) {
   int i;
@@ -37,27 +45,52 @@ static void dsda_ResetStates(int from, int to) {
   }
 }
 
-static void dsda_PrepAllocation(void) {
-  static int first_allocation = true;
-
-  if (first_allocation) {
-    state_t* source = states;
+static state_t* dsda_MoveState(state_t* state, const state_t* source) {
+  return state ? states + (state - source) : NULL;
+}
 
-    first_allocation = false;
-    states = malloc(num_states * sizeof(*states));
-    memcpy(states, source, num_states * sizeof(*states));
-  }
+// The initial states table is shared by every instance in the process, and
+//   never written. The first change makes a private copy, and moves the
+//   state pointers of the existing mobjs and player sprites to it. A restore
+//   to before that change brings back the shared table, and the next change
+//   then refills the same copy.
+void dsda_PrepStatesForWrite(void) {
+  state_t* source;
+  thinker_t* th;
+  int i, j;
+
+  if (states == states_copy)
+    return;
+
+  source = states;
+  if (!states_copy)
+    states_copy = malloc(num_states * sizeof(*states));
+  states = states_copy;
+  memcpy(states, source, num_states * sizeof(*states));
+
+  for (th = thinkercap.next; th && th != &thinkercap; th = th->next)
+    if (th->function == P_MobjThinker || th->function == P_BlasterMobjThinker ||
+        (th->function == P_RemoveThinkerDelayed && th->references)) {
+      mobj_t* mobj = (mobj_t*) th;
+
+      mobj->state = dsda_MoveState(mobj->state, source);
+    }
+
+  for (i = 0; i < MAX_MAXPLAYERS; i++)
+    for (j = 0; j < NUMPSPRITES; j++)
+      engine_context->players[i].psprites[j].state = dsda_MoveState(engine_context->players[i].psprites[j].state, source);
 }
 
 static void dsda_EnsureCapacity(int limit) {
   while (limit >= num_states) {
     int old_num_states = num_states;
 
-    dsda_PrepAllocation();
+    dsda_PrepStatesForWrite();
 
     num_states *= 2;
 
     states = realloc(states, num_states * sizeof(*states));
+    states_copy = states;
     memset(states + old_num_states, 0, (num_states - old_num_states) * sizeof(*states));
 
     deh_codeptr = realloc(deh_codeptr, num_states * sizeof(*deh_codeptr));
@@ -80,6 +113,7 @@ dsda_deh_state_t dsda_GetDehState(int index) {
   dsda_deh_state_t deh_state;
 
   dsda_EnsureCapacity(index);
+  dsda_PrepStatesForWrite();
 
   deh_state.state = &states[index];
   deh_state.codeptr = &deh_codeptr[index];
@@ -88,12 +122,12 @@ dsda_deh_state_t dsda_GetDehState(int index) {
   return deh_state;
 }
 
-void dsda_InitializeStates(state_t* source, int count) {
+void dsda_InitializeStates(const state_t* source, int count) {
   int i;
 
   num_states = count;
 
-  states = source;
+  states = (state_t*) source;
 
   seenstate_tab = calloc(num_states, sizeof(*seenstate_tab));
 
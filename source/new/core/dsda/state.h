@@ -27,7 +27,8 @@ typedef struct {
 } dsda_deh_state_t;
 
 dsda_deh_state_t dsda_GetDehState(int index);
-void dsda_InitializeStates(state_t* source, int count);
+void dsda_InitializeStates(const state_t* source, int count);
+void dsda_PrepStatesForWrite(void);
 void dsda_FreeDehStates(void);
 
 #endif
@@ -51,13 +51,13 @@ typedef enum
   patch_stretch_max
 } patch_stretch_t;
 
-extern __thread int wide_offsetx;
-extern __thread int wide_offset2x;
-extern __thread int wide_offsety;
-extern __thread int wide_offset2y;
-extern __thread int render_stretch_hud;
-extern __thread int patches_scalex;
-extern __thread int patches_scaley;
+extern __STORAGE_MODIFIER int wide_offsetx;
+extern __STORAGE_MODIFIER int wide_offset2x;
+extern __STORAGE_MODIFIER int wide_offsety;
+extern __STORAGE_MODIFIER int wide_offset2y;
+extern __STORAGE_MODIFIER int render_stretch_hud;
+extern __STORAGE_MODIFIER int patches_scalex;
+extern __STORAGE_MODIFIER int patches_scaley;
 
 stretch_param_t* dsda_StretchParams(int flags);
 void dsda_SetupStretchParams(void);
@@ -29,11 +29,11 @@
 
 #include "wad_stats.h"
 
-static __thread const char* filename = "stats.txt";
-static __thread const int current_version = 1;
-static __thread map_stats_t* current_map_stats;
+static __STORAGE_MODIFIER const char* filename = "stats.txt";
+static __STORAGE_MODIFIER const int current_version = 1;
+static __STORAGE_MODIFIER map_stats_t* current_map_stats;
 
-__thread wad_stats_t wad_stats;
+__STORAGE_MODIFIER wad_stats_t wad_stats;
 
 static void dsda_EnsureMapCount(int count) {
   wad_stats.map_count = count;
@@ -51,7 +51,7 @@ static void dsda_EnsureMapCount(int count) {
 }
 
 static const char* dsda_WadStatsPath(void) {
-  static __thread dsda_string_t path;
+  static __STORAGE_MODIFIER dsda_string_t path;
 
   if (!path.string)
     dsda_StringPrintF(&path, "%s/%s", dsda_DataDir(), filename);
@@ -200,7 +200,7 @@ static void dsda_LoadWadStats(void) {
   }
 }
 
-static __thread dboolean forget_wad_stats;
+static __STORAGE_MODIFIER dboolean forget_wad_stats;
 
 void M_ForgetWadStats(void)
 {
@@ -285,12 +285,12 @@ void dsda_WadStatsExitMap(int missed_monsters) {
 
     if (skill >= current_map_stats->best_skill || skill == 4) {
       if (levels_completed == 1)
-        if (current_map_stats->best_time == -1 || current_map_stats->best_time > leveltime)
-          current_map_stats->best_time = leveltime;
+        if (current_map_stats->best_time == -1 || current_map_stats->best_time > engine_context->leveltime)
+          current_map_stats->best_time = engine_context->leveltime;
 
       if (levels_completed == 1 && skill == 5)
-        if (current_map_stats->best_sk5_time == -1 || current_map_stats->best_sk5_time > leveltime)
-          current_map_stats->best_sk5_time = leveltime;
+        if (current_map_stats->best_sk5_time == -1 || current_map_stats->best_sk5_time > engine_context->leveltime)
+          current_map_stats->best_sk5_time = engine_context->leveltime;
 
       current_map_stats->max_kills = totalkills;
       current_map_stats->max_items = totalitems;
@@ -301,16 +301,16 @@ void dsda_WadStatsExitMap(int missed_monsters) {
           current_map_stats->best_kills = totalkills - missed_monsters;
 
         if (levels_completed == 1)
-          if (missed_monsters == 0 && players[consoleplayer].secretcount == totalsecret &&
-              (current_map_stats->best_max_time == -1 || current_map_stats->best_max_time > leveltime))
-            current_map_stats->best_max_time = leveltime;
+          if (missed_monsters == 0 && engine_context->players[consoleplayer].secretcount == totalsecret &&
+              (current_map_stats->best_max_time == -1 || current_map_stats->best_max_time > engine_context->leveltime))
+            current_map_stats->best_max_time = engine_context->leveltime;
       }
 
-      if (players[consoleplayer].itemcount > current_map_stats->best_items)
-        current_map_stats->best_items = players[consoleplayer].itemcount;
+      if (engine_context->players[consoleplayer].itemcount > current_map_stats->best_items)
+        current_map_stats->best_items = engine_context->players[consoleplayer].itemcount;
 
-      if (players[consoleplayer].secretcount > current_map_stats->best_secrets)
-        current_map_stats->best_secrets = players[consoleplayer].secretcount;
+      if (engine_context->players[consoleplayer].secretcount > current_map_stats->best_secrets)
+        current_map_stats->best_secrets = engine_context->players[consoleplayer].secretcount;
     }
   }
 
@@ -68,26 +68,26 @@
 #include "dsda/stretch.h"
 #include <math.h>
 
-__thread dboolean wasWiped = false;
+__STORAGE_MODIFIER dboolean wasWiped = false;
 
-__thread int secretfound;
-__thread int demo_playerscount;
-__thread int demo_tics_count;
-__thread char demo_len_st[80];
+__STORAGE_MODIFIER int secretfound;
+__STORAGE_MODIFIER int demo_playerscount;
+__STORAGE_MODIFIER int demo_tics_count;
+__STORAGE_MODIFIER char demo_len_st[80];
 
-__thread int mouse_handler;
-__thread int gl_render_fov = 90;
+__STORAGE_MODIFIER int mouse_handler;
+__STORAGE_MODIFIER int gl_render_fov = 90;
 
-__thread camera_t walkcamera;
+__STORAGE_MODIFIER camera_t walkcamera;
 
-__thread angle_t viewpitch;
-__thread float skyscale;
-__thread float screen_skybox_zplane;
-__thread float tan_pitch;
-__thread float skyUpAngle;
-__thread float skyUpShift;
-__thread float skyXShift;
-__thread float skyYShift;
+__STORAGE_MODIFIER angle_t viewpitch;
+__STORAGE_MODIFIER float skyscale;
+__STORAGE_MODIFIER float screen_skybox_zplane;
+__STORAGE_MODIFIER float tan_pitch;
+__STORAGE_MODIFIER float skyUpAngle;
+__STORAGE_MODIFIER float skyUpShift;
+__STORAGE_MODIFIER float skyXShift;
+__STORAGE_MODIFIER float skyYShift;
 
 //--------------------------------------------------
 
@@ -111,7 +111,7 @@ void ParamsMatchingCheck()
     I_Error("Params are not matching: Can not being played back and recorded at the same time.");
 }
 
-__thread  prboom_comp_t prboom_comp[PC_MAX] = {
+__STORAGE_MODIFIER  prboom_comp_t prboom_comp[PC_MAX] = {
   {0xffffffff, 0x02020615, 0, dsda_arg_force_monster_avoid_hazards},
   {0x00000000, 0x02040601, 0, dsda_arg_force_remove_slime_trails},
   {0x02020200, 0x02040801, 0, dsda_arg_force_no_dropoff},
@@ -264,7 +264,7 @@ void M_ChangeFOV(void)
 {
 }
 
-float __thread viewPitch;
+float __STORAGE_MODIFIER viewPitch;
 
 int StepwiseSum(int value, int direction, int minval, int maxval, int defval)
 {
@@ -324,11 +324,11 @@ int I_MessageBox(const char* text, unsigned int type)
   return PRB_IDCANCEL;
 }
 
-__thread int stats_level;
-__thread int stroller;
-__thread int numlevels = 0;
-__thread int levels_max = 0;
-__thread timetable_t *stats = NULL;
+__STORAGE_MODIFIER int stats_level;
+__STORAGE_MODIFIER int stroller;
+__STORAGE_MODIFIER int numlevels = 0;
+__STORAGE_MODIFIER int levels_max = 0;
+__STORAGE_MODIFIER timetable_t *stats = NULL;
 
 void e6y_G_DoCompleted(void)
 {
@@ -347,8 +347,8 @@ void e6y_WriteStats(void)
 
 //--------------------------------------------------
 
-static __thread double mouse_accelfactor;
-static __thread double analog_accelfactor;
+static __STORAGE_MODIFIER double mouse_accelfactor;
+static __STORAGE_MODIFIER double analog_accelfactor;
 
 void AccelChanging(void)
 {
@@ -364,7 +364,7 @@ int AccelerateAnalog(float val)
   return 0;
 }
 
-__thread int mlooky = 0;
+__STORAGE_MODIFIER int mlooky = 0;
 
 void e6y_G_Compatibility(void)
 {
@@ -405,9 +405,9 @@ const char* PathFindFileName(const char* pPath)
   return pT;
 }
 
-__thread int levelstarttic;
+__STORAGE_MODIFIER int levelstarttic;
 
-__thread int force_singletics_to = 0;
+__STORAGE_MODIFIER int force_singletics_to = 0;
 
 int HU_DrawDemoProgress(int force)
 {
@@ -53,27 +53,27 @@ typedef struct camera_s
   int type;
 } camera_t;
 
-extern __thread dboolean wasWiped;
-extern __thread int secretfound;
-extern __thread int demo_tics_count;
-extern __thread int demo_playerscount;
-extern __thread char demo_len_st[80];
-extern __thread int mouse_handler;
+extern __STORAGE_MODIFIER dboolean wasWiped;
+extern __STORAGE_MODIFIER int secretfound;
+extern __STORAGE_MODIFIER int demo_tics_count;
+extern __STORAGE_MODIFIER int demo_playerscount;
+extern __STORAGE_MODIFIER char demo_len_st[80];
+extern __STORAGE_MODIFIER int mouse_handler;
 
 void M_ChangeAspectRatio(void);
 void M_ChangeStretch(void);
 
-extern __thread camera_t walkcamera;
+extern __STORAGE_MODIFIER camera_t walkcamera;
 
-extern __thread int PitchSign;
-extern __thread float skyscale;
-extern __thread float screen_skybox_zplane;
-extern __thread float maxNoPitch[];
-extern __thread float tan_pitch;
-extern __thread float skyUpAngle;
-extern __thread float skyUpShift;
-extern __thread float skyXShift;
-extern __thread float skyYShift;
+extern __STORAGE_MODIFIER int PitchSign;
+extern __STORAGE_MODIFIER float skyscale;
+extern __STORAGE_MODIFIER float screen_skybox_zplane;
+extern __STORAGE_MODIFIER float maxNoPitch[];
+extern __STORAGE_MODIFIER float tan_pitch;
+extern __STORAGE_MODIFIER float skyUpAngle;
+extern __STORAGE_MODIFIER float skyUpShift;
+extern __STORAGE_MODIFIER float skyXShift;
+extern __STORAGE_MODIFIER float skyYShift;
 
 void ParamsMatchingCheck();
 void e6y_HandleSkip(void);
@@ -105,7 +105,7 @@ void CheckPitch(signed int *pitch);
 
 dboolean HaveMouseLook(void);
 
-extern __thread float viewPitch;
+extern __STORAGE_MODIFIER float viewPitch;
 
 typedef struct prboom_comp_s
 {
@@ -144,7 +144,7 @@ enum
   PC_MAX
 };
 
-extern __thread prboom_comp_t prboom_comp[];
+extern __STORAGE_MODIFIER prboom_comp_t prboom_comp[];
 
 int StepwiseSum(int value, int direction, int minval, int maxval, int defval);
 
@@ -175,8 +175,8 @@ typedef struct timetable_s
 const char* WINError(void);
 #endif
 
-extern __thread int stats_level;
-extern __thread int stroller;
+extern __STORAGE_MODIFIER int stats_level;
+extern __STORAGE_MODIFIER int stroller;
 
 void e6y_G_DoCompleted(void);
 void e6y_WriteStats(void);
@@ -191,7 +191,7 @@ int AccelerateMouse(int val);
 int AccelerateAnalog(float val);
 void AccelChanging(void);
 
-extern __thread int mlooky;
+extern __STORAGE_MODIFIER int mlooky;
 
 void e6y_G_Compatibility(void);
 
@@ -199,11 +199,11 @@ const char* PathFindFileName(const char* pPath);
 
 //extern int viewMaxY;
 
-extern __thread dboolean isskytexture;
+extern __STORAGE_MODIFIER dboolean isskytexture;
 
-extern __thread int levelstarttic;
+extern __STORAGE_MODIFIER int levelstarttic;
 
-extern __thread int force_singletics_to;
+extern __STORAGE_MODIFIER int force_singletics_to;
 
 int HU_DrawDemoProgress(int force);
 
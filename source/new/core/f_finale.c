@@ -53,11 +53,11 @@
 
 // Stage of animation:
 //  0 = text, 1 = art screen, 2 = character cast
-__thread int finalestage;
-__thread int finalecount;
-__thread const char*   finaletext;
-__thread const char*   finaleflat;
-__thread const char*   finalepatch;
+__STORAGE_MODIFIER int finalestage;
+__STORAGE_MODIFIER int finalecount;
+__STORAGE_MODIFIER const char*   finaletext;
+__STORAGE_MODIFIER const char*   finaleflat;
+__STORAGE_MODIFIER const char*   finalepatch;
 
 // defines for the end mission display text                     // phares
 
@@ -71,8 +71,8 @@ dboolean F_CastResponder (event_t *ev);
 void    F_CastDrawer (void);
 
 void WI_checkForAccelerate(void);    // killough 3/28/98: used to
-extern __thread int acceleratestage;          // accelerate intermission screens
-__thread int midstage;                 // whether we're in "mid-stage"
+extern __STORAGE_MODIFIER int acceleratestage;          // accelerate intermission screens
+__STORAGE_MODIFIER int midstage;                 // whether we're in "mid-stage"
 
 //
 // F_StartFinale
@@ -154,7 +154,7 @@ void F_Ticker(void)
   else
     if (gamemode == commercial && finalecount > 50) // check for skipping
       for (i = 0; i < g_maxplayers; i++)
-        if (players[i].cmd.buttons)
+        if (engine_context->players[i].cmd.buttons)
           goto next_level;      // go on to the next level
 
   // advance animation
@@ -217,14 +217,14 @@ typedef struct
   mobjtype_t   type;
 } castinfo_t;
 
-static __thread int castnum;
-static __thread int casttics;
-static __thread state_t* caststate;
-static __thread dboolean castdeath;
-static __thread int castframes;
-static __thread int castonmelee;
-static __thread dboolean castattacking;
-static __thread const char *castbackground;
+static __STORAGE_MODIFIER int castnum;
+static __STORAGE_MODIFIER int casttics;
+static __STORAGE_MODIFIER state_t* caststate;
+static __STORAGE_MODIFIER dboolean castdeath;
+static __STORAGE_MODIFIER int castframes;
+static __STORAGE_MODIFIER int castonmelee;
+static __STORAGE_MODIFIER dboolean castattacking;
+static __STORAGE_MODIFIER const char *castbackground;
 
 //
 // F_StartCast
@@ -278,16 +278,16 @@ void F_CastDrawer (void)
 //
 // F_BunnyScroll
 //
-static __thread const char* pfub1 = "PFUB1";
-static __thread const char* pfub2 = "PFUB2";
-static __thread const char* scrollpic1;
-static __thread const char* scrollpic2;
+static __STORAGE_MODIFIER const char* pfub1 = "PFUB1";
+static __STORAGE_MODIFIER const char* pfub2 = "PFUB2";
+static __STORAGE_MODIFIER const char* scrollpic1;
+static __STORAGE_MODIFIER const char* scrollpic2;
 
 static void F_StartScrollMusic(const char* music, dboolean loop_music)
 {
 }
 
-static dboolean end_patches_exist;
+static __STORAGE_MODIFIER dboolean end_patches_exist;
 
 void F_StartScroll (const char* right, const char* left, const char* music, dboolean loop_music)
 {
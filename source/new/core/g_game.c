@@ -38,6 +38,7 @@
 #include <stdio.h>
 #include <stdarg.h>
 #include <stdlib.h>
+#include <math.h>
 #ifdef _MSC_VER
 #include <io.h>
 #else
@@ -87,10 +88,11 @@
 #include "dsda/mouse.h"
 #include "dsda/options.h"
 #include "dsda/skill_info.h"
+#include "dsda/state.h"
 #include "dsda/utility.h"
 
 // Allows use of HELP2 screen for PWADs under DOOM 1
-__thread int pwad_help2_check;
+__STORAGE_MODIFIER int pwad_help2_check;
 
 
 // e6y
@@ -100,46 +102,43 @@ __thread int pwad_help2_check;
 // The old format is still supported.
 #define NEWFORMATSIG "\xff\xff\xff\xff"
 
-static __thread const byte *demobuffer;   /* cph - only used for playback */
-static __thread int demolength; // check for overrun (missing DEMOMARKER)
-
-__thread dboolean        preventLevelExit;
-__thread dboolean        preventGameEnd;
-__thread dboolean        reachedLevelExit;
-__thread dboolean        reachedGameEnd;
-__thread gameaction_t    gameaction;
-__thread gamestate_t     gamestate;
-__thread dboolean        in_game;
-__thread int             gameskill;
-__thread int             gameepisode;
- __thread int             gamemap;
- static __thread dboolean forced_loadgame = false;
- static __thread dboolean load_via_cmd = false;
-__thread dboolean         timingdemo;    // if true, exit with report on completion
-__thread dboolean         fastdemo;      // if true, run at full speed -- killough
-__thread dboolean         nodrawers;     // for comparative timing purposes
-__thread int             starttime;     // for comparative timing purposes
-__thread dboolean         deathmatch;    // only if started as net death
-__thread dboolean         netgame;       // only true if packets are broadcast
-__thread dboolean         playeringame[MAX_MAXPLAYERS];
-__thread player_t        players[MAX_MAXPLAYERS];
-__thread int             upmove;
-__thread int             consoleplayer; // player taking events and displaying
-__thread int             displayplayer; // view being displayed
-__thread int             gametic;
-__thread int             boom_basetic;       /* killough 9/29/98: for demo sync */
-__thread int             true_basetic;
-__thread int             totalkills, totallive, totalitems, totalsecret;    // for intermission
-__thread dboolean         demorecording;
-__thread wbstartstruct_t wminfo;               // parms for world map / intermission
-__thread dboolean         haswolflevels = false;// jff 4/18/98 wolf levels present
-__thread int             totalleveltimes;      // CPhipps - total time for all completed levels
-__thread int             levels_completed;
-__thread int             longtics;
-__thread dboolean coop_spawns;
-__thread int shorttics;
-static __thread int     turnheld;       // for accelerative turning
-static __thread int next_weapon = 0;
+static __STORAGE_MODIFIER const byte *demobuffer;   /* cph - only used for playback */
+static __STORAGE_MODIFIER int demolength; // check for overrun (missing DEMOMARKER)
+
+__STORAGE_MODIFIER dboolean        preventLevelExit;
+__STORAGE_MODIFIER dboolean        preventGameEnd;
+__STORAGE_MODIFIER dboolean        reachedLevelExit;
+__STORAGE_MODIFIER dboolean        reachedGameEnd;
+__STORAGE_MODIFIER gameaction_t    gameaction;
+__STORAGE_MODIFIER gamestate_t     gamestate;
+__STORAGE_MODIFIER dboolean        in_game;
+__STORAGE_MODIFIER int             gameskill;
+__STORAGE_MODIFIER int             gameepisode;
+ __STORAGE_MODIFIER int             gamemap;
+ static __STORAGE_MODIFIER dboolean forced_loadgame = false;
+ static __STORAGE_MODIFIER dboolean load_via_cmd = false;
+__STORAGE_MODIFIER dboolean         timingdemo;    // if true, exit with report on completion
+__STORAGE_MODIFIER dboolean         fastdemo;      // if true, run at full speed -- killough
+__STORAGE_MODIFIER dboolean         nodrawers;     // for comparative timing purposes
+__STORAGE_MODIFIER int             starttime;     // for comparative timing purposes
+__STORAGE_MODIFIER dboolean         deathmatch;    // only if started as net death
+__STORAGE_MODIFIER dboolean         netgame;       // only true if packets are broadcast
+__STORAGE_MODIFIER int             upmove;
+__STORAGE_MODIFIER int             consoleplayer; // player taking events and displaying
+__STORAGE_MODIFIER int             displayplayer; // view being displayed
+__STORAGE_MODIFIER int             boom_basetic;       /* killough 9/29/98: for demo sync */
+__STORAGE_MODIFIER int             true_basetic;
+__STORAGE_MODIFIER int             totalkills, totallive, totalitems, totalsecret;    // for intermission
+__STORAGE_MODIFIER dboolean         demorecording;
+__STORAGE_MODIFIER wbstartstruct_t wminfo;               // parms for world map / intermission
+__STORAGE_MODIFIER dboolean         haswolflevels = false;// jff 4/18/98 wolf levels present
+__STORAGE_MODIFIER int             totalleveltimes;      // CPhipps - total time for all completed levels
+__STORAGE_MODIFIER int             levels_completed;
+__STORAGE_MODIFIER int             longtics;
+__STORAGE_MODIFIER dboolean coop_spawns;
+__STORAGE_MODIFIER int shorttics;
+static __STORAGE_MODIFIER int     turnheld;       // for accelerative turning
+static __STORAGE_MODIFIER int next_weapon = 0;
 
 //
 // controls (have defaults)
@@ -149,13 +148,13 @@ static __thread int next_weapon = 0;
 #define SLOWTURNTICS  6
 #define QUICKREVERSE (short)32768 // 180 degree reverse                    // phares
 
-fixed_t forwardmove[2] = {0x19, 0x32};
-fixed_t sidemove[2]    = {0x18, 0x28};
-fixed_t angleturn[3]   = {640, 1280, 320};  // + slow turn
-fixed_t flyspeed[2]    = {1*256, 3*256};
+__STORAGE_MODIFIER fixed_t forwardmove[2] = {0x19, 0x32};
+__STORAGE_MODIFIER fixed_t sidemove[2]    = {0x18, 0x28};
+__STORAGE_MODIFIER fixed_t angleturn[3]   = {640, 1280, 320};  // + slow turn
+__STORAGE_MODIFIER fixed_t flyspeed[2]    = {1*256, 3*256};
 
 
-static __thread const struct
+static __STORAGE_MODIFIER const struct
 {
   weapontype_t weapon;
   weapontype_t weapon_num;
@@ -189,26 +188,27 @@ static __thread const struct
 // };
 
 // mouse values are used once
-static __thread  int   mousex;
-static __thread  int   mousey;
-static __thread  int   dclicktime;
-static __thread  int   dclickstate;
-static __thread  int   dclicks;
-static __thread  int   dclicktime2;
-static __thread  int   dclickstate2;
-static __thread  int   dclicks2;
-static __thread  int left_analog_x;
-static __thread  int left_analog_y;
+static __STORAGE_MODIFIER  int   mousex;
+static __STORAGE_MODIFIER  int   mousey;
+static __STORAGE_MODIFIER  int   dclicktime;
+static __STORAGE_MODIFIER  int   dclickstate;
+static __STORAGE_MODIFIER  int   dclicks;
+static __STORAGE_MODIFIER  int   dclicktime2;
+static __STORAGE_MODIFIER  int   dclickstate2;
+static __STORAGE_MODIFIER  int   dclicks2;
+static __STORAGE_MODIFIER  int left_analog_x;
+static __STORAGE_MODIFIER  int left_analog_y;
 
 // Game events info
-static __thread buttoncode_t special_event; // Event triggered by local player, to send
-static __thread int   savegameslot;         // Slot to load if gameaction == ga_loadgame
-__thread char         savedescription[SAVEDESCLEN];  // Description to save in savegame if gameaction == ga_savegame
+static __STORAGE_MODIFIER buttoncode_t special_event; // Event triggered by local player, to send
+static __STORAGE_MODIFIER int   savegameslot;         // Slot to load if gameaction == ga_loadgame
+__STORAGE_MODIFIER char         savedescription[SAVEDESCLEN];  // Description to save in savegame if gameaction == ga_savegame
 
 // heretic
 #include "p_user.h"
+#include "p_hash.h"
 
-__thread int lookheld;
+__STORAGE_MODIFIER int lookheld;
 
 static dboolean InventoryMoveLeft(void);
 static dboolean InventoryMoveRight(void);
@@ -217,9 +217,9 @@ static dboolean InventoryMoveRight(void);
 // hexen
 
 // Position indicator for cooperative net-play reborn
-__thread int RebornPosition;
+__STORAGE_MODIFIER int RebornPosition;
 
-__thread leave_data_t leave_data;
+__STORAGE_MODIFIER leave_data_t leave_data;
 
 void G_DoTeleportNewMap(void);
 static void Hexen_G_DoReborn(int playernum);
@@ -233,7 +233,7 @@ typedef enum
   NUMDOUBLECARRY
 } double_carry_t;
 
-static __thread double double_carry[NUMDOUBLECARRY];
+static __STORAGE_MODIFIER double double_carry[NUMDOUBLECARRY];
 
 static int G_CarryDouble(double_carry_t c, double value)
 {
@@ -268,7 +268,7 @@ static inline signed char fudgef(signed char b)
 void G_SetSpeed(dboolean reset)
 {
   dsda_pclass_t *player_class;
-  static __thread dsda_pclass_t *last_player_class = NULL;
+  static __STORAGE_MODIFIER dsda_pclass_t *last_player_class = NULL;
 
   player_class = &pclass;
 
@@ -331,7 +331,7 @@ static dboolean WeaponSelectable(weapontype_t weapon)
   }
 
   // Can't select a weapon if we don't own it.
-  if (!players[consoleplayer].weaponowned[weapon])
+  if (!engine_context->players[consoleplayer].weaponowned[weapon])
   {
     return false;
   }
@@ -345,13 +345,13 @@ static int G_NextWeapon(int direction)
   int start_i, i, arrlen;
 
   // Find index in the table.
-  if (players[consoleplayer].pendingweapon == wp_nochange)
+  if (engine_context->players[consoleplayer].pendingweapon == wp_nochange)
   {
-    weapon = players[consoleplayer].readyweapon;
+    weapon = engine_context->players[consoleplayer].readyweapon;
   }
   else
   {
-    weapon = players[consoleplayer].pendingweapon;
+    weapon = engine_context->players[consoleplayer].pendingweapon;
   }
 
   arrlen = sizeof(weapon_order_table) / sizeof(*weapon_order_table);
@@ -375,10 +375,10 @@ static int G_NextWeapon(int direction)
   return weapon_order_table[i].weapon_num;
 }
 
-static __thread double mouse_sensitivity_horiz;
-static __thread double mouse_sensitivity_vert;
-static __thread double mouse_sensitivity_mlook;
-static __thread double mouse_strafe_divisor;
+static __STORAGE_MODIFIER double mouse_sensitivity_horiz;
+static __STORAGE_MODIFIER double mouse_sensitivity_vert;
+static __STORAGE_MODIFIER double mouse_sensitivity_mlook;
+static __STORAGE_MODIFIER double mouse_strafe_divisor;
 
 void G_UpdateMouseSensitivity(void)
 {
@@ -504,7 +504,7 @@ void G_BuildTiccmd(ticcmd_t* cmd)
     }
   }
 
-  if (players[consoleplayer].mo && players[consoleplayer].mo->pitch && !dsda_MouseLook())
+  if (engine_context->players[consoleplayer].mo && engine_context->players[consoleplayer].mo->pitch && !dsda_MouseLook())
     dsda_QueueExCmdLook(XC_LOOK_RESET);
 
   if (dsda_InputActive(dsda_input_fire))
@@ -518,10 +518,10 @@ void G_BuildTiccmd(ticcmd_t* cmd)
   }
 
   {
-    extern __thread dboolean boom_weapon_state_injection;
-    static __thread dboolean done_autoswitch = false;
+    extern __STORAGE_MODIFIER dboolean boom_weapon_state_injection;
+    static __STORAGE_MODIFIER dboolean done_autoswitch = false;
 
-    if (!players[consoleplayer].attackdown)
+    if (!engine_context->players[consoleplayer].attackdown)
     {
       done_autoswitch = false;
     }
@@ -541,8 +541,8 @@ void G_BuildTiccmd(ticcmd_t* cmd)
     if (
       (
         !demo_compatibility &&
-        players[consoleplayer].attackdown && // killough
-        !P_CheckAmmo(&players[consoleplayer]) &&
+        engine_context->players[consoleplayer].attackdown && // killough
+        !P_CheckAmmo(&engine_context->players[consoleplayer]) &&
         (
           (
             (
@@ -552,7 +552,7 @@ void G_BuildTiccmd(ticcmd_t* cmd)
             !done_autoswitch
           ) || (
             cmd->buttons & BT_ATTACK &&
-            players[consoleplayer].pendingweapon == wp_nochange
+            engine_context->players[consoleplayer].pendingweapon == wp_nochange
           )
         )
       ) || (dsda_InputActive(dsda_input_toggleweapon))
@@ -560,11 +560,11 @@ void G_BuildTiccmd(ticcmd_t* cmd)
     {
       done_autoswitch = true;
       boom_weapon_state_injection = false;
-      newweapon = P_SwitchWeapon(&players[consoleplayer]);           // phares
+      newweapon = P_SwitchWeapon(&engine_context->players[consoleplayer]);           // phares
     }
     else
     {                                 // phares 02/26/98: Added gamemode checks
-      if (next_weapon && players[consoleplayer].morphTics == 0)
+      if (next_weapon && engine_context->players[consoleplayer].morphTics == 0)
       {
         newweapon = G_NextWeapon(next_weapon);
       }
@@ -597,7 +597,7 @@ void G_BuildTiccmd(ticcmd_t* cmd)
 
       if (!demo_compatibility)
       {
-        const player_t *player = &players[consoleplayer];
+        const player_t *player = &engine_context->players[consoleplayer];
 
         // only select chainsaw from '1' if it's owned, it's
         // not already in use, and the player prefers it or
@@ -629,7 +629,7 @@ void G_BuildTiccmd(ticcmd_t* cmd)
 
   next_weapon = 0;
 
-  if (newweapon != wp_nochange && players[consoleplayer].chickenTics == 0)
+  if (newweapon != wp_nochange && engine_context->players[consoleplayer].chickenTics == 0)
   {
     cmd->buttons |= BT_CHANGE;
     cmd->buttons |= newweapon<<BT_WEAPONSHIFT;
@@ -691,7 +691,7 @@ void G_BuildTiccmd(ticcmd_t* cmd)
 
   if (strafe)
   {
-    static __thread double mousestrafe_carry = 0;
+    static __STORAGE_MODIFIER double mousestrafe_carry = 0;
     int delta;
     double true_delta;
 
@@ -753,7 +753,7 @@ void G_BuildTiccmd(ticcmd_t* cmd)
     // Don't discard mouse delta even if value is too small to
     // turn the player this tic
     if (dsda_IntConfig(dsda_config_mouse_carrytics)) {
-      static __thread signed short carry = 0;
+      static __STORAGE_MODIFIER signed short carry = 0;
       signed short desired_angleturn = cmd->angleturn + carry;
       cmd->angleturn = (desired_angleturn + 128) & 0xff00;
       carry = desired_angleturn - cmd->angleturn;
@@ -777,7 +777,7 @@ void G_BuildTiccmd(ticcmd_t* cmd)
   dsda_PopExCmdQueue(cmd);
 
   if (!dsda_StrictMode()) {
-    if (leveltime == 0 && totalleveltimes == 0) {
+    if (engine_context->leveltime == 0 && totalleveltimes == 0) {
       dsda_arg_t* arg;
 
       arg = dsda_Arg(dsda_arg_first_input);
@@ -832,7 +832,7 @@ static void G_ResetInventory(player_t *p)
 //
 // G_DoLoadLevel
 //
-int __thread skyflatnum;
+int __STORAGE_MODIFIER skyflatnum;
 
 static void G_DoLoadLevel (void)
 {
@@ -846,10 +846,10 @@ static void G_DoLoadLevel (void)
 
   skyflatnum = R_FlatNumForName(g_skyflatname);
 
-  levelstarttic = gametic;        // for time calculation
+  levelstarttic = engine_context->gametic;        // for time calculation
 
   if (!demo_compatibility && !mbf_features)   // killough 9/29/98
-    boom_basetic = gametic;
+    boom_basetic = engine_context->gametic;
 
   if (wipegamestate == GS_LEVEL)
     wipegamestate = -1;             // force a wipe
@@ -858,20 +858,20 @@ static void G_DoLoadLevel (void)
 
   for (i = 0; i < g_maxplayers; i++)
   {
-    if (playeringame[i])
+    if (engine_context->playeringame[i])
     {
-      if (players[i].playerstate == PST_DEAD)
-        players[i].playerstate = PST_REBORN;
+      if (engine_context->players[i].playerstate == PST_DEAD)
+        engine_context->players[i].playerstate = PST_REBORN;
       else
       {
         if (map_info.flags & MI_RESET_HEALTH)
-          G_ResetHealth(&players[i]);
+          G_ResetHealth(&engine_context->players[i]);
 
         if (map_info.flags & MI_RESET_INVENTORY)
-          G_ResetInventory(&players[i]);
+          G_ResetInventory(&engine_context->players[i]);
       }
     }
-    memset(players[i].frags, 0, sizeof(players[i].frags));
+    memset(engine_context->players[i].frags, 0, sizeof(engine_context->players[i].frags));
   }
 
   // automatic pistol start when advancing from one level to the next
@@ -920,7 +920,7 @@ dboolean G_Responder (event_t* ev)
     do                                          // spy mode
       if (++displayplayer >= g_maxplayers)
         displayplayer = 0;
-    while (!playeringame[displayplayer] && displayplayer!=consoleplayer);
+    while (!engine_context->playeringame[displayplayer] && displayplayer!=consoleplayer);
 
     return true;
   }
@@ -1031,14 +1031,14 @@ void G_Ticker (void)
   int entry_leveltime;
   int pause_mask;
   dboolean advance_frame = false;
-  static __thread gamestate_t prevgamestate;
+  static __STORAGE_MODIFIER gamestate_t prevgamestate;
 
-  entry_leveltime = leveltime;
+  entry_leveltime = engine_context->leveltime;
 
   P_MapStart();
   // do player reborns if needed
   for (i = 0; i < g_maxplayers; i++)
-    if (playeringame[i] && players[i].playerstate == PST_REBORN)
+    if (engine_context->playeringame[i] && engine_context->players[i].playerstate == PST_REBORN)
       G_DoReborn(i);
   P_MapEnd();
 
@@ -1071,7 +1071,7 @@ void G_Ticker (void)
       case ga_loadlevel:
         // force players to be initialized on level reload
           for (i = 0; i < g_maxplayers; i++)
-            players[i].playerstate = PST_REBORN;
+            engine_context->players[i].playerstate = PST_REBORN;
         G_DoLoadLevel();
         break;
       case ga_newgame:
@@ -1103,15 +1103,15 @@ void G_Ticker (void)
   }
 
  {
-    int buf = gametic % BACKUPTICS;
+    int buf = engine_context->gametic % BACKUPTICS;
 
     dsda_UpdateAutoSaves();
 
     for (i = 0; i < g_maxplayers; i++)
     {
-      if (playeringame[i])
+      if (engine_context->playeringame[i])
       {
-        ticcmd_t *cmd = &players[i].cmd;
+        ticcmd_t *cmd = &engine_context->players[i].cmd;
 
         memcpy(cmd, &local_cmds[i], sizeof *cmd);
       }
@@ -1122,16 +1122,16 @@ void G_Ticker (void)
     // check for special buttons
     for (i = 0; i < g_maxplayers; i++)
     {
-      if (playeringame[i])
+      if (engine_context->playeringame[i])
       {
-        if (players[i].cmd.buttons & BT_SPECIAL)
+        if (engine_context->players[i].cmd.buttons & BT_SPECIAL)
         {
-          players[i].cmd.buttons = 0;
+          engine_context->players[i].cmd.buttons = 0;
         }
 
         if (dsda_AllowExCmd())
         {
-          excmd_t *ex = &players[i].cmd.ex;
+          excmd_t *ex = &engine_context->players[i].cmd.ex;
 
           if (ex->actions & XC_SAVE)
           {
@@ -1229,7 +1229,7 @@ static void G_FinishLevelBehaviour(finish_level_behaviour_t *flb, player_t *p)
 static void G_PlayerFinishLevel(int player)
 {
   int i;
-  player_t *p = &players[player];
+  player_t *p = &engine_context->players[player];
   finish_level_behaviour_t flb;
 
   G_FinishLevelBehaviour(&flb, p);
@@ -1278,14 +1278,14 @@ void G_PlayerReborn (int player)
   int maxkilldiscount; //e6y
   unsigned int worldTimer;
 
-  memcpy (frags, players[player].frags, sizeof frags);
-  killcount = players[player].killcount;
-  itemcount = players[player].itemcount;
-  secretcount = players[player].secretcount;
-  maxkilldiscount = players[player].maxkilldiscount; //e6y
-  worldTimer = players[player].worldTimer;
+  memcpy (frags, engine_context->players[player].frags, sizeof frags);
+  killcount = engine_context->players[player].killcount;
+  itemcount = engine_context->players[player].itemcount;
+  secretcount = engine_context->players[player].secretcount;
+  maxkilldiscount = engine_context->players[player].maxkilldiscount; //e6y
+  worldTimer = engine_context->players[player].worldTimer;
 
-  p = &players[player];
+  p = &engine_context->players[player];
 
   // killough 3/10/98,3/21/98: preserve cheats across idclev
   {
@@ -1294,12 +1294,12 @@ void G_PlayerReborn (int player)
     p->cheats = cheats;
   }
 
-  memcpy(players[player].frags, frags, sizeof(players[player].frags));
-  players[player].killcount = killcount;
-  players[player].itemcount = itemcount;
-  players[player].secretcount = secretcount;
-  players[player].maxkilldiscount = maxkilldiscount; //e6y
-  players[player].worldTimer = worldTimer;
+  memcpy(engine_context->players[player].frags, frags, sizeof(engine_context->players[player].frags));
+  engine_context->players[player].killcount = killcount;
+  engine_context->players[player].itemcount = itemcount;
+  engine_context->players[player].secretcount = secretcount;
+  engine_context->players[player].maxkilldiscount = maxkilldiscount; //e6y
+  engine_context->players[player].worldTimer = worldTimer;
 
   p->usedown = p->attackdown = true;  // don't do anything immediately
   p->playerstate = PST_LIVE;
@@ -1325,11 +1325,11 @@ static dboolean G_CheckSpot(int playernum, mapthing_t *mthing)
   sector_t *sec;
   int         i;
 
-  if (!players[playernum].mo)
+  if (!engine_context->players[playernum].mo)
     {
       // first spawn of level, before corpses
       for (i=0 ; i<playernum ; i++)
-        if (players[i].mo->x == mthing->x && players[i].mo->y == mthing->y)
+        if (engine_context->players[i].mo->x == mthing->x && engine_context->players[i].mo->y == mthing->y)
           return false;
       return true;
     }
@@ -1344,9 +1344,9 @@ static dboolean G_CheckSpot(int playernum, mapthing_t *mthing)
   // if (!P_CheckPosition (players[playernum].mo, x, y))
   //    return false;
 
-  players[playernum].mo->flags |=  MF_SOLID;
-  i = P_CheckPosition(players[playernum].mo, x, y);
-  players[playernum].mo->flags &= ~MF_SOLID;
+  engine_context->players[playernum].mo->flags |=  MF_SOLID;
+  i = P_CheckPosition(engine_context->players[playernum].mo, x, y);
+  engine_context->players[playernum].mo->flags &= ~MF_SOLID;
   if (!i)
     return false;
 
@@ -1434,7 +1434,7 @@ void G_DoReborn (int playernum)
       int i;
 
       // first dissasociate the corpse
-      players[playernum].mo->player = NULL;
+      engine_context->players[playernum].mo->player = NULL;
 
       // spawn at random spot if in death match
       if (deathmatch)
@@ -1464,7 +1464,7 @@ void G_DoReborn (int playernum)
 }
 
 // DOOM Par Times
-__thread int pars[5][10] = {
+__STORAGE_MODIFIER int pars[5][10] = {
   {0},
   {0,30,75,120,90,165,180,180,30,165},
   {0,90,90,90,120,90,360,240,30,170},
@@ -1474,14 +1474,14 @@ __thread int pars[5][10] = {
 };
 
 // DOOM II Par Times
-__thread  int cpars[34] = {
+__STORAGE_MODIFIER  int cpars[34] = {
   30,90,120,120,90,150,120,120,270,90,  //  1-10
   210,150,150,150,210,150,420,150,210,150,  // 11-20
   240,150,180,150,150,300,330,420,300,180,  // 21-30
   120,30,30,30          // 31-34
 };
 
-__thread dboolean secretexit;
+__STORAGE_MODIFIER dboolean secretexit;
 
 void G_ExitLevel(int position)
 {
@@ -1514,13 +1514,13 @@ void G_DoCompleted (void)
 
   R_ResetColorMap();
 
-    totalleveltimes += leveltime - leveltime % 35;
+    totalleveltimes += engine_context->leveltime - engine_context->leveltime % 35;
   ++levels_completed;
 
   gameaction = ga_nothing;
 
   for (i = 0; i < g_maxplayers; i++)
-    if (playeringame[i])
+    if (engine_context->playeringame[i])
       G_PlayerFinishLevel(i);        // take away cards and stuff
 
   e6y_G_DoCompleted();
@@ -1547,12 +1547,12 @@ void G_DoCompleted (void)
 
   for (i = 0; i < g_maxplayers; i++)
   {
-    wminfo.plyr[i].in = playeringame[i];
-    wminfo.plyr[i].skills = players[i].killcount;
-    wminfo.plyr[i].sitems = players[i].itemcount;
-    wminfo.plyr[i].ssecret = players[i].secretcount;
-    wminfo.plyr[i].stime = leveltime;
-    memcpy (wminfo.plyr[i].frags, players[i].frags,
+    wminfo.plyr[i].in = engine_context->playeringame[i];
+    wminfo.plyr[i].skills = engine_context->players[i].killcount;
+    wminfo.plyr[i].sitems = engine_context->players[i].itemcount;
+    wminfo.plyr[i].ssecret = engine_context->players[i].secretcount;
+    wminfo.plyr[i].stime = engine_context->leveltime;
+    memcpy (wminfo.plyr[i].frags, engine_context->players[i].frags,
             sizeof(wminfo.plyr[i].frags));
   }
 
@@ -1586,7 +1586,7 @@ void G_WorldDone (void)
   gameaction = ga_worlddone;
 
   if (secretexit)
-    players[consoleplayer].didsecret = true;
+    engine_context->players[consoleplayer].didsecret = true;
 
   dsda_PrepareFinale(&done_behaviour);
 
@@ -1603,8 +1603,8 @@ void G_WorldDone (void)
         int i;
 
         for (i = 0; i < g_maxplayers; ++i)
-          if (playeringame[i])
-            players[i].playerstate = PST_DEAD;
+          if (engine_context->playeringame[i])
+            engine_context->players[i].playerstate = PST_DEAD;
 
         wminfo.nextep = epi - 1;
         wminfo.next = map - 1;
@@ -1634,7 +1634,7 @@ void G_DoWorldDone (void)
   gameaction = ga_nothing;
 }
 
-extern __thread dboolean setsizeneeded;
+extern __STORAGE_MODIFIER dboolean setsizeneeded;
 
 //CPhipps - savename variable redundant
 
@@ -1661,8 +1661,8 @@ static uint64_t G_UpdateSignature(uint64_t s, const char *name)
 
 static uint64_t G_Signature(void)
 {
-  static __thread uint64_t s = 0;
-  static __thread dboolean computed = false;
+  static __STORAGE_MODIFIER uint64_t s = 0;
+  static __STORAGE_MODIFIER dboolean computed = false;
   int episode, map;
 
   if (!computed) {
@@ -1718,7 +1718,7 @@ static void G_LoadGameErr(const char *msg)
   P_FreeSaveBuffer();
 }
 
-__thread const char * comp_lev_str[MAX_COMPATIBILITY_LEVEL] =
+__STORAGE_MODIFIER const char * comp_lev_str[MAX_COMPATIBILITY_LEVEL] =
 { "Doom v1.2", "Doom v1.666", "Doom/Doom2 v1.9", "Ultimate Doom/Doom95", "Final Doom",
   "early DosDoom", "TASDoom", "\"boom compatibility\"", "boom v2.01", "boom v2.02", "lxdoom v1.3.2+",
   "MBF", "PrBoom 2.03beta", "PrBoom v2.1.0-2.1.1", "PrBoom v2.1.2-v2.2.6",
@@ -1796,9 +1796,9 @@ static void G_DoSaveGame(dboolean via_cmd)
 
 }
 
-static __thread int     d_skill;
-static __thread int     d_episode;
-static __thread int     d_map;
+static __STORAGE_MODIFIER int     d_skill;
+static __STORAGE_MODIFIER int     d_episode;
+static __STORAGE_MODIFIER int     d_map;
 
 void G_DeferedInitNew(int skill, int episode, int map)
 {
@@ -1823,7 +1823,7 @@ void G_DeferedInitNew(int skill, int episode, int map)
 
 void G_Compatibility(void)
 {
-  static __thread const struct {
+  static __STORAGE_MODIFIER const struct {
     complevel_t fix; // level at which fix/change was introduced
     complevel_t opt; // level at which fix/change was made optional
   } levels[] = {
@@ -1993,7 +1993,7 @@ void G_ReloadDefaults(void)
   nomonsters = clnomonsters;
 
   // killough 2/21/98:
-  memset(playeringame + 1, 0, sizeof(*playeringame) * (MAX_MAXPLAYERS - 1));
+  memset(engine_context->playeringame + 1, 0, sizeof(*engine_context->playeringame) * (MAX_MAXPLAYERS - 1));
 
   consoleplayer = 0;
 
@@ -2040,7 +2040,7 @@ void G_ReloadDefaults(void)
   // killough 3/31/98, 4/5/98: demo sync insurance
   demo_insurance = 0;
 
-  rngseed += I_GetRandomTimeSeed() + gametic; // CPhipps
+  rngseed += I_GetRandomTimeSeed() + engine_context->gametic; // CPhipps
 }
 
 void G_DoNewGame (void)
@@ -2067,7 +2067,7 @@ void G_DoNewGame (void)
 
 void G_RefreshFastMonsters(void)
 {
-  static __thread int fast = 0;            // remembers fast state
+  static __STORAGE_MODIFIER int fast = 0;            // remembers fast state
   int i;
   int fast_pending;
 
@@ -2075,6 +2075,8 @@ void G_RefreshFastMonsters(void)
 
 
   if (fast != fast_pending) {     /* only change if necessary */
+    dsda_PrepStatesForWrite();
+
     for (i = 0; i < num_mobj_types; ++i)
       if (mobjinfo[i].altspeed != NO_ALTSPEED)
       {
@@ -2131,7 +2133,7 @@ int G_ValidateMapName(const char *mapname, int *pEpi, int *pMap)
 // consoleplayer, displayplayer, playeringame[] should be set.
 //
 
-extern __thread int EpiCustom;
+extern __STORAGE_MODIFIER int EpiCustom;
 
 void G_InitNew(int skill, int episode, int map, dboolean prepare)
 {
@@ -2209,7 +2211,7 @@ void G_InitNew(int skill, int episode, int map, dboolean prepare)
   }
 
   {
-    extern __thread int dsda_startmap;
+    extern __STORAGE_MODIFIER int dsda_startmap;
 
     dsda_startmap = map;
   }
@@ -2219,8 +2221,8 @@ void G_InitNew(int skill, int episode, int map, dboolean prepare)
   // force players to be initialized upon first level load
   for (i = 0; i < g_maxplayers; i++)
   {
-    players[i].playerstate = PST_REBORN;
-    players[i].worldTimer = 0;
+    engine_context->players[i].playerstate = PST_REBORN;
+    engine_context->players[i].worldTimer = 0;
   }
 
   dsda_UpdateGameSkill(skill);
@@ -2496,7 +2498,7 @@ void G_BeginRecording (void)
 // G_PlayDemo
 //
 
-static __thread const char *defdemoname;
+static __STORAGE_MODIFIER const char *defdemoname;
 
 void G_DeferedPlayDemo (const char* name)
 {
@@ -2596,4 +2598,338 @@ void G_DoTeleportNewMap(void)
 void headlessGetMapName(char* outString)
 {
   sprintf(outString, "%s", dsda_MapLumpName(gameepisode, gamemap));
-}
\ No newline at end of file
+}
+
+// Packs the hashed parts of the world (mobjs in thinker order, sectors with
+// the thinkers moving them, and the RNG) into fixed size records of 32 bit fields, so the hash consumes one
+// contiguous buffer. Returns the size needed; data is only written if it
+// fits in the given capacity.
+
+typedef struct {
+  int32_t type, x, y, z, angle, momx, momy, momz;
+  int32_t health, flags_low, flags_high, tics, sprite, frame, movedir, reactiontime;
+} hashed_mobj_t;
+
+typedef struct {
+  int32_t direction, speed, target, countdown;
+} hashed_mover_t;
+
+typedef struct {
+  int32_t floorheight, ceilingheight, lightlevel, specials;
+  hashed_mover_t floor, ceiling;
+} hashed_sector_t;
+
+// Fills in where the thinker moving a sector's floor or ceiling is heading.
+// Plats and ceilings in stasis have no function, but keep their fields.
+static void G_PackMover(const thinker_t *th, dboolean ceiling, hashed_mover_t *m)
+{
+  memset(m, 0, sizeof(*m));
+
+  if (th == NULL)
+    return;
+
+  if (th->function == T_MoveFloor)
+  {
+    const floormove_t *floor = (const floormove_t *) th;
+
+    m->direction = floor->direction;
+    m->speed = floor->speed;
+    m->target = floor->floordestheight;
+    m->countdown = floor->delayCount;
+  }
+  else if (th->function == T_MoveElevator)
+  {
+    const elevator_t *elevator = (const elevator_t *) th;
+
+    m->direction = elevator->direction;
+    m->speed = elevator->speed;
+    m->target = ceiling ? elevator->ceilingdestheight : elevator->floordestheight;
+  }
+  else if (th->function == T_VerticalDoor)
+  {
+    const vldoor_t *door = (const vldoor_t *) th;
+
+    m->direction = door->direction;
+    m->speed = door->speed;
+    m->target = door->topheight;
+    m->countdown = door->topcountdown;
+  }
+  else if (!ceiling && (th->function == T_PlatRaise || th->function == NULL))
+  {
+    const plat_t *plat = (const plat_t *) th;
+
+    m->direction = plat->status;
+    m->speed = plat->speed;
+    m->target = plat->status == up ? plat->high : plat->low;
+    m->countdown = plat->count;
+  }
+  else if (ceiling && (th->function == T_MoveCeiling || th->function == NULL))
+  {
+    const ceiling_t *ceiling_mover = (const ceiling_t *) th;
+
+    m->direction = ceiling_mover->direction;
+    m->speed = ceiling_mover->speed;
+    m->target = ceiling_mover->direction > 0 ? ceiling_mover->topheight : ceiling_mover->bottomheight;
+  }
+}
+
+size_t headlessPackWorldHashData(void* buffer, size_t capacity)
+{
+  thinker_t *th;
+  size_t mobj_count = 0;
+  size_t size;
+  hashed_mobj_t *m;
+  hashed_sector_t *s;
+  int i;
+
+  for (th = thinkercap.next; th != &thinkercap; th = th->next)
+    if (th->function == P_MobjThinker || th->function == P_BlasterMobjThinker)
+      mobj_count++;
+
+  size = mobj_count * sizeof(hashed_mobj_t) + numsectors * sizeof(hashed_sector_t) + sizeof(engine_context->rng);
+  if (size > capacity)
+    return size;
+
+  m = buffer;
+  for (th = thinkercap.next; th != &thinkercap; th = th->next)
+  {
+    const mobj_t *mobj = (const mobj_t *) th;
+
+    if (th->function != P_MobjThinker && th->function != P_BlasterMobjThinker)
+      continue;
+
+    m->type = mobj->type;
+    m->x = mobj->x;
+    m->y = mobj->y;
+    m->z = mobj->z;
+    m->angle = mobj->angle;
+    m->momx = mobj->momx;
+    m->momy = mobj->momy;
+    m->momz = mobj->momz;
+    m->health = mobj->health;
+    m->flags_low = (int32_t) mobj->flags;
+    m->flags_high = (int32_t) (mobj->flags >> 32);
+    m->tics = mobj->tics;
+    m->sprite = mobj->sprite;
+    m->frame = mobj->frame;
+    m->movedir = mobj->movedir;
+    m->reactiontime = mobj->reactiontime;
+    m++;
+  }
+
+  s = (hashed_sector_t *) m;
+  for (i = 0; i < numsectors; i++, s++)
+  {
+    const sector_t *sec = &sectors[i];
+
+    s->floorheight = sec->floorheight;
+    s->ceilingheight = sec->ceilingheight;
+    s->lightlevel = sec->lightlevel;
+    s->specials = (sec->special << 3) |
+                  (sec->floordata != NULL) |
+                  (sec->ceilingdata != NULL) << 1 |
+                  (sec->lightingdata != NULL) << 2;
+    G_PackMover(sec->floordata, false, &s->floor);
+    G_PackMover(sec->ceilingdata, true, &s->ceiling);
+  }
+
+  // The seeds are only used (and only reproducible) outside demo compatibility
+  memcpy(s, &engine_context->rng, sizeof(engine_context->rng));
+  if (demo_compatibility)
+    memset(((rng_t *) s)->seed, 0, sizeof(engine_context->rng.seed));
+
+  return size;
+}
+
+// Keeps the world hash up to date from now on (see p_hash.h). Nothing was
+// hashed while it was not tracked, so it is built here from scratch.
+void headlessTrackWorldHash(void)
+{
+  world_hash_tracked = true;
+  P_RebuildWorldHash();
+}
+
+// The incrementally maintained world hash (see p_hash.h), read in O(1)
+void headlessGetWorldHash(uint64_t* hash)
+{
+  P_GetWorldHash(hash);
+}
+
+// Whether the maintained world hash is the one rebuilt from scratch. The
+// rebuild replaces it, so a mismatch is only reported once.
+int headlessCheckWorldHash(void)
+{
+  uint64_t maintained[2], rebuilt[2];
+
+  P_GetWorldHash(maintained);
+  P_RebuildWorldHash();
+  P_GetWorldHash(rebuilt);
+
+  return maintained[0] == rebuilt[0] && maintained[1] == rebuilt[1];
+}
+
+// Whether the sections of a save, read back without loading it, hold the
+// current game state
+int headlessCheckSaveSections(const byte* save, size_t save_size)
+{
+  dsda_save_context_t context;
+  dsda_save_player_t player;
+  dsda_save_flags_t flags;
+  gameFeatures_t features, save_features;
+  rng_t save_rng;
+  int i;
+
+  if (!dsda_ReadSaveContext(save, save_size, &context) ||
+      !dsda_ReadSavePlayer(save, save_size, &player) ||
+      !dsda_ReadSaveRNG(save, save_size, &save_rng) ||
+      !dsda_ReadSaveFlags(save, save_size, &flags) ||
+      !dsda_ReadSaveFeatures(save, save_size, &save_features))
+    return false;
+
+  // Only the exit distance is not read from the save
+  headlessGetFeatures(&features);
+  for (i = 0; i < GAME_FEATURES_MAX_PLAYERS; i++)
+    features.players[i].exitDistance = save_features.players[i].exitDistance;
+  if (memcmp(&features, &save_features, sizeof(features)))
+    return false;
+
+  for (i = 0; i < g_maxplayers && !engine_context->playeringame[i]; i++);
+  if (i == g_maxplayers)
+    return false;
+
+  return context.compatibility_level == compatibility_level &&
+         context.skill == gameskill &&
+         context.episode == gameepisode &&
+         context.map == gamemap &&
+         context.leveltime == engine_context->leveltime &&
+         context.totalleveltimes == totalleveltimes &&
+         player.playerstate == engine_context->players[i].playerstate &&
+         player.viewz == engine_context->players[i].viewz &&
+         player.health == engine_context->players[i].health &&
+         player.armorpoints == engine_context->players[i].armorpoints &&
+         player.armortype == engine_context->players[i].armortype &&
+         !memcmp(&save_rng, &engine_context->rng, sizeof(engine_context->rng)) &&
+         flags.reached_level_exit == reachedLevelExit &&
+         flags.reached_game_end == reachedGameEnd &&
+         flags.gametic == engine_context->gametic &&
+         flags.totallive == totallive &&
+         flags.totalkills == totalkills &&
+         flags.totalitems == totalitems &&
+         flags.totalsecret == totalsecret;
+}
+
+static dboolean G_IsExitLine(const line_t *line)
+{
+  switch (line->special)
+  {
+    case 11:  // S1 exit
+    case 51:  // S1 secret exit
+    case 52:  // W1 exit
+    case 124: // W1 secret exit
+    case 197: // G1 exit
+    case 198: // G1 secret exit
+      return true;
+  }
+
+  return false;
+}
+
+// Distance in map units from a point to the closest exit line, or -1 if none.
+// The lines are scanned on every call rather than cached, so nothing outside
+// the archived state (or a level arena snapshot) has to be kept in sync.
+static float G_ExitDistance(fixed_t x, fixed_t y)
+{
+  const double px = (double) x / FRACUNIT, py = (double) y / FRACUNIT;
+  double best = -1.0;
+  int i;
+
+  // Hexen format maps exit through action specials with other numbers
+  if (map_format.hexen)
+    return -1;
+
+  for (i = 0; i < numlines; i++)
+  {
+    const line_t *line = &lines[i];
+    double ax, ay, dx, dy, length2, t, ex, ey, distance;
+
+    if (!G_IsExitLine(line))
+      continue;
+
+    ax = (double) line->v1->x / FRACUNIT, ay = (double) line->v1->y / FRACUNIT;
+    dx = (double) line->dx / FRACUNIT, dy = (double) line->dy / FRACUNIT;
+    length2 = dx * dx + dy * dy;
+    t = length2 > 0 ? ((px - ax) * dx + (py - ay) * dy) / length2 : 0;
+
+    if (t < 0) t = 0;
+    if (t > 1) t = 1;
+    ex = ax + t * dx - px;
+    ey = ay + t * dy - py;
+    distance = sqrt(ex * ex + ey * ey);
+
+    if (best < 0 || distance < best)
+      best = distance;
+  }
+
+  return (float) best;
+}
+
+// Fills the game features (see gameFeatures.h) of the current state
+void headlessGetFeatures(gameFeatures_t* features)
+{
+  int i, j;
+
+  memset(features, 0, sizeof(*features));
+  features->version = GAME_FEATURES_VERSION;
+  features->gameTic = engine_context->gametic;
+  features->episode = gameepisode;
+  features->map = gamemap;
+  features->levelExit = reachedLevelExit;
+  features->gameEnd = reachedGameEnd;
+  features->liveMonsters = totallive;
+  features->totalKills = totalkills;
+  features->totalItems = totalitems;
+  features->totalSecrets = totalsecret;
+
+  for (i = 0; i < g_maxplayers && i < GAME_FEATURES_MAX_PLAYERS; i++)
+  {
+    const player_t *player = &engine_context->players[i];
+    playerFeatures_t *f = &features->players[i];
+
+    if (!engine_context->playeringame[i])
+      continue;
+
+    features->playerCount = i + 1;
+    f->inGame = true;
+
+    if (player->mo)
+    {
+      const mobj_t *mo = player->mo;
+
+      f->hasBody = true;
+      f->x = mo->x;
+      f->y = mo->y;
+      f->z = mo->z;
+      f->momX = mo->momx;
+      f->momY = mo->momy;
+      f->momZ = mo->momz;
+      f->angle = mo->angle;
+      f->sector = mo->subsector->sector->iSectorID;
+      f->exitDistance = G_ExitDistance(mo->x, mo->y);
+    }
+    else
+      f->exitDistance = -1;
+
+    f->health = player->health;
+    f->armorPoints = player->armorpoints;
+    f->armorType = player->armortype;
+    for (j = 0; j < NUMAMMO && j < GAME_FEATURES_MAX_AMMO; j++)
+      f->ammo[j] = player->ammo[j];
+    for (j = 0; j < NUMWEAPONS && j < 32; j++)
+      if (player->weaponowned[j])
+        f->weaponsOwned |= 1u << j;
+    f->readyWeapon = player->readyweapon;
+    f->killCount = player->killcount;
+    f->itemCount = player->itemcount;
+    f->secretCount = player->secretcount;
+  }
+}
@@ -36,6 +36,7 @@
 #include "d_event.h"
 #include "d_ticcmd.h"
 #include "tables.h"
+#include "gameFeatures.h"
 
 //
 // GAME
@@ -95,22 +96,22 @@ void doom_printf(const char *, ...) __attribute__((format(printf,1,2)));
 
 // killough 5/2/98: moved from m_misc.c:
 
-extern __thread int  key_forward;
-extern __thread int  key_backward;
+extern __STORAGE_MODIFIER int  key_forward;
+extern __STORAGE_MODIFIER int  key_backward;
 
-extern __thread dboolean haswolflevels;  //jff 4/18/98 wolf levels present
-extern __thread dboolean secretexit;
+extern __STORAGE_MODIFIER dboolean haswolflevels;  //jff 4/18/98 wolf levels present
+extern __STORAGE_MODIFIER dboolean secretexit;
 
 // killough 5/2/98: moved from d_deh.c:
 // Par times (new item with BOOM) - from g_game.c
-extern __thread int pars[5][10];  // hardcoded array size
-extern __thread int cpars[];      // hardcoded array size
+extern __STORAGE_MODIFIER int pars[5][10];  // hardcoded array size
+extern __STORAGE_MODIFIER int cpars[];      // hardcoded array size
 // CPhipps - Make savedesciption visible in wider scope
 #define SAVEDESCLEN 32
-extern __thread char savedescription[SAVEDESCLEN];  // Description to save in savegame
+extern __STORAGE_MODIFIER char savedescription[SAVEDESCLEN];  // Description to save in savegame
 
 /* cph - compatibility level strings */
-extern __thread const char * comp_lev_str[];
+extern __STORAGE_MODIFIER const char * comp_lev_str[];
 
 // e6y
 // There is a new command-line switch "-shorttics".
@@ -118,14 +119,15 @@ extern __thread const char * comp_lev_str[];
 // (e.g. glides, where this makes a significant difference)
 // with the same mouse behaviour as when recording,
 // but without having to be recording every time.
-extern __thread int shorttics;
-extern __thread int longtics;
+extern __STORAGE_MODIFIER int shorttics;
+extern __STORAGE_MODIFIER int longtics;
 
 // Allows use of HELP2 screen for PWADs under DOOM 1
-extern __thread int pwad_help2_check;
+extern __STORAGE_MODIFIER int pwad_help2_check;
 
 // hexen
 
 void G_Completed(int map, int position, int flags, angle_t angle);
+void headlessGetFeatures(gameFeatures_t* features);
 
 #endif
@@ -49,10 +49,10 @@
 
 #include "dsda/args.h"
 
-__thread int overflows_enabled = true;
+__STORAGE_MODIFIER int overflows_enabled = true;
 
-__thread overrun_param_t overflows[OVERFLOW_MAX];
-__thread const char *overflow_cfgname[OVERFLOW_MAX] =
+__STORAGE_MODIFIER overrun_param_t overflows[OVERFLOW_MAX];
+__STORAGE_MODIFIER const char *overflow_cfgname[OVERFLOW_MAX] =
 {
   "overrun_spechit_emulate",
   "overrun_reject_emulate",
@@ -205,7 +205,7 @@ int PlayeringameOverrun(const mapthing_t* mthing)
   if (mthing->type == 0 && PROCESS(OVERFLOW_PLAYERINGAME))
   {
     // playeringame[-1] == players[3].didsecret
-    ShowOverflowWarning(OVERFLOW_PLAYERINGAME, (players + 3)->didsecret, "");
+    ShowOverflowWarning(OVERFLOW_PLAYERINGAME, (engine_context->players + 3)->didsecret, "");
 
     if (EMULATE(OVERFLOW_PLAYERINGAME))
     {
@@ -219,7 +219,7 @@ int PlayeringameOverrun(const mapthing_t* mthing)
 // spechit overrun emulation
 //
 
-__thread unsigned int spechit_baseaddr = 0;
+__STORAGE_MODIFIER unsigned int spechit_baseaddr = 0;
 
 // e6y
 // Code to emulate the behavior of Vanilla Doom when encountering an overrun
@@ -279,7 +279,7 @@ unsigned char *dos_mem_dump = mem_dump_dos622;
 
 static int GetMemoryValue(unsigned int offset, void *value, int size)
 {
-  static __thread int firsttime = true;
+  static __STORAGE_MODIFIER int firsttime = true;
 
   if (firsttime)
   {
@@ -349,8 +349,8 @@ int MissedBackSideOverrun(line_t *line)
 //
 sector_t* GetSectorAtNullAddress(void)
 {
-  static __thread int null_sector_is_initialized = false;
-  static __thread sector_t null_sector;
+  static __STORAGE_MODIFIER int null_sector_is_initialized = false;
+  static __STORAGE_MODIFIER sector_t null_sector;
 
   if (demo_compatibility && EMULATE(OVERFLOW_MISSEDBACKSIDE))
   {
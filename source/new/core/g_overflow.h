@@ -60,9 +60,9 @@ typedef enum overrun_list_s
   OVERFLOW_MAX //last
 } overrun_list_t;
 
-extern __thread int overflows_enabled;
-extern __thread overrun_param_t overflows[];
-extern __thread const char *overflow_cfgname[OVERFLOW_MAX];
+extern __STORAGE_MODIFIER int overflows_enabled;
+extern __STORAGE_MODIFIER overrun_param_t overflows[];
+extern __STORAGE_MODIFIER const char *overflow_cfgname[OVERFLOW_MAX];
 
 #define EMULATE(overflow) (overflows_enabled && (overflows[overflow].footer ? overflows[overflow].footer_emulate : overflows[overflow].emulate))
 #define PROCESS(overflow) (overflows_enabled && (overflows[overflow].warn || EMULATE(overflow)))
@@ -86,7 +86,7 @@ typedef struct
     void *addr2;
 } intercepts_overrun_t;
 
-extern __thread intercepts_overrun_t intercepts_overrun[];
+extern __STORAGE_MODIFIER intercepts_overrun_t intercepts_overrun[];
 void InterceptsOverrun(int num_intercepts, intercept_t *intercept);
 
 //
@@ -117,7 +117,7 @@ typedef struct spechit_overrun_param_s
   dboolean *nofit;
 } spechit_overrun_param_t;
 
-extern __thread unsigned int spechit_baseaddr;
+extern __STORAGE_MODIFIER unsigned int spechit_baseaddr;
 
 void SpechitOverrun(spechit_overrun_param_t *params);
 
@@ -39,8 +39,8 @@
 
 #include "dsda/configuration.h"
 
-int __thread capturing_video = 0;
-static __thread const char *vid_fname;
+int __STORAGE_MODIFIER capturing_video = 0;
+static __STORAGE_MODIFIER const char *vid_fname;
 
 typedef struct
 { // information on a running pipe
@@ -53,13 +53,13 @@ typedef struct
   void *user;
 } pipeinfo_t;
 
-static __thread pipeinfo_t soundpipe;
-static __thread pipeinfo_t videopipe;
-static __thread pipeinfo_t muxpipe;
+static __STORAGE_MODIFIER pipeinfo_t soundpipe;
+static __STORAGE_MODIFIER pipeinfo_t videopipe;
+static __STORAGE_MODIFIER pipeinfo_t muxpipe;
 
-int __thread cap_fps;
-int __thread cap_frac;
-int __thread cap_wipescreen;
+int __STORAGE_MODIFIER cap_fps;
+int __STORAGE_MODIFIER cap_frac;
+int __STORAGE_MODIFIER cap_wipescreen;
 
 // parses a command with simple printf-style replacements.
 
@@ -86,9 +86,9 @@ void I_uSleep(unsigned long usecs)
 {
 }
 
-static __thread dboolean InDisplay = false;
-static __thread int saved_gametic = -1;
-__thread dboolean realframe = false;
+static __STORAGE_MODIFIER dboolean InDisplay = false;
+static __STORAGE_MODIFIER int saved_gametic = -1;
+__STORAGE_MODIFIER dboolean realframe = false;
 
 dboolean I_StartDisplay(void)
 {
@@ -99,7 +99,7 @@ void I_EndDisplay(void)
 {
 }
 
-__thread int interpolation_method;
+__STORAGE_MODIFIER int interpolation_method;
 fixed_t I_GetTimeFrac (void)
 {
   fixed_t frac = FRACUNIT;
@@ -110,10 +110,13 @@ fixed_t I_GetTimeFrac (void)
  * I_GetRandomTimeSeed
  *
  * CPhipps - extracted from G_ReloadDefaults because it is O/S based
+ *
+ * The seed is archived with the state, so it is fixed for states (and their
+ * digests) to be the same on every run
  */
 unsigned long I_GetRandomTimeSeed(void)
 {
-  return (unsigned long)time(NULL);
+  return 0;
 }
 
 /* cphipps - I_GetVersionString
@@ -175,7 +178,7 @@ int I_Filelength(int handle)
 
 const char *I_ConfigDir(void)
 {
-  static __thread char *base;
+  static __STORAGE_MODIFIER char *base;
 
   if (!base)
   {
@@ -220,9 +223,9 @@ const char *I_ConfigDir(void)
 
 const char *I_ExeDir(void)
 {
-  extern __thread  char **dsda_argv;
+  extern __STORAGE_MODIFIER  char **dsda_argv;
 
-  static __thread char *base;
+  static __STORAGE_MODIFIER char *base;
   if (!base)        // cache multiple requests
     {
       size_t len = strlen(*dsda_argv);
@@ -268,7 +271,7 @@ dboolean HasTrailingSlash(const char* dn)
 
 static const char *I_GetBasePath(void)
 {
-  static __thread char *executable_dir = "";
+  static __STORAGE_MODIFIER char *executable_dir = "";
   return executable_dir;
 }
 
@@ -292,7 +295,7 @@ static const char *I_GetBasePath(void)
 char* I_FindFileInternal(const char* wfname, const char* ext, dboolean isStatic)
 {
   // lookup table of directories to search
-  static __thread struct {
+  static __STORAGE_MODIFIER struct {
     const char *dir; // directory
     const char *sub; // subdirectory
     const char *env; // environment variable
@@ -316,11 +319,11 @@ char* I_FindFileInternal(const char* wfname, const char* ext, dboolean isStatic)
     {"/usr/share/doom"},
   }, *search;
 
-  static __thread size_t num_search = 0;
+  static __STORAGE_MODIFIER size_t num_search = 0;
   size_t  i = 0;
   size_t  pl = 0;
 
-  static __thread char static_p[PATH_MAX];
+  static __STORAGE_MODIFIER char static_p[PATH_MAX];
   char * dinamic_p = NULL;
   char *p = (isStatic ? static_p : dinamic_p);
 
@@ -49,8 +49,8 @@
 #define    R_OK    4    /* Check for read permission */
 #endif
 
-extern __thread int interpolation_method;
-extern __thread int ms_to_next_tick;
+extern __STORAGE_MODIFIER int interpolation_method;
+extern __STORAGE_MODIFIER int ms_to_next_tick;
 dboolean I_StartDisplay(void);
 void I_EndDisplay(void);
 fixed_t I_GetTimeFrac (void);
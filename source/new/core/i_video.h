@@ -41,9 +41,9 @@
 #include "doomtype.h"
 #include "v_video.h"
 
-extern __thread const char *screen_resolutions_list[];
+extern __STORAGE_MODIFIER const char *screen_resolutions_list[];
 
-extern __thread const char *sdl_video_window_pos;
+extern __STORAGE_MODIFIER const char *sdl_video_window_pos;
 
 void I_PreInitGraphics(void); /* CPhipps - do stuff immediately on start */
 void I_InitScreenResolution(void); /* init resolution */
@@ -85,14 +85,14 @@ void I_StartTic (void);
 
 void I_StartFrame (void);
 
-extern __thread int desired_fullscreen; //e6y
-extern __thread int exclusive_fullscreen;
+extern __STORAGE_MODIFIER int desired_fullscreen; //e6y
+extern __STORAGE_MODIFIER int exclusive_fullscreen;
 
 void I_UpdateRenderSize(void);	// Handle potential
-extern __thread int renderW;		// resolution scaling
-extern __thread int renderH;		// - DTIED
+extern __STORAGE_MODIFIER int renderW;		// resolution scaling
+extern __STORAGE_MODIFIER int renderH;		// - DTIED
 
-extern __thread dboolean window_focused;
+extern __STORAGE_MODIFIER dboolean window_focused;
 dboolean I_WindowFocused(void);
 void UpdateGrab(void);
 
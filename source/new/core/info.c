@@ -53,7 +53,7 @@ void A_Stop();
 // Sprite names
 // ********************************************************************
 
-__thread const char *doom_sprnames[] = {
+const char * const doom_sprnames[] = {
   "TROO","SHTG","PUNG","PISG","PISF","SHTF","SHT2","CHGG","CHGF","MISG",
   "MISF","SAWG","PLSG","PLSF","BFGG","BFGF","BLUD","PUFF","BAL1","BAL2",
   "PLSS","PLSE","MISL","BFS1","BFE1","BFE2","TFOG","IFOG","PLAY","POSS",
@@ -108,7 +108,7 @@ __thread const char *doom_sprnames[] = {
 // parts where frame rewiring is done for more details and the
 // extended way a BEX file can handle this.
 
-__thread state_t doom_states[DOOM_NUMSTATES] = {
+const state_t doom_states[DOOM_NUMSTATES] = {
   {SPR_TROO,0,-1,NULL,S_NULL,0,0},  // S_NULL
   {SPR_SHTG,4,0,A_Light0,S_NULL,0,0}, // S_LIGHTDONE
   {SPR_PUNG,0,1,A_WeaponReady,S_PUNCH,0,0}, // S_PUNCH
@@ -586,19 +586,19 @@ __thread state_t doom_states[DOOM_NUMSTATES] = {
   {SPR_TROO,8,6,NULL,S_TROO_RUN1,0,0},  // S_TROO_RAISE5
   {SPR_SARG,0,10,A_Look,S_SARG_STND2,0,0},  // S_SARG_STND
   {SPR_SARG,1,10,A_Look,S_SARG_STND,0,0}, // S_SARG_STND2
-  {SPR_SARG,0,2,A_Chase,S_SARG_RUN2,0,0}, // S_SARG_RUN1
-  {SPR_SARG,0,2,A_Chase,S_SARG_RUN3,0,0}, // S_SARG_RUN2
-  {SPR_SARG,1,2,A_Chase,S_SARG_RUN4,0,0}, // S_SARG_RUN3
-  {SPR_SARG,1,2,A_Chase,S_SARG_RUN5,0,0}, // S_SARG_RUN4
-  {SPR_SARG,2,2,A_Chase,S_SARG_RUN6,0,0}, // S_SARG_RUN5
-  {SPR_SARG,2,2,A_Chase,S_SARG_RUN7,0,0}, // S_SARG_RUN6
-  {SPR_SARG,3,2,A_Chase,S_SARG_RUN8,0,0}, // S_SARG_RUN7
-  {SPR_SARG,3,2,A_Chase,S_SARG_RUN1,0,0}, // S_SARG_RUN8
-  {SPR_SARG,4,8,A_FaceTarget,S_SARG_ATK2,0,0},  // S_SARG_ATK1
-  {SPR_SARG,5,8,A_FaceTarget,S_SARG_ATK3,0,0},  // S_SARG_ATK2
-  {SPR_SARG,6,8,A_SargAttack,S_SARG_RUN1,0,0},  // S_SARG_ATK3
-  {SPR_SARG,7,2,NULL,S_SARG_PAIN2,0,0}, // S_SARG_PAIN
-  {SPR_SARG,7,2,NULL,S_SARG_RUN1,0,0},  // S_SARG_PAIN2
+  {SPR_SARG,0,2,A_Chase,S_SARG_RUN2,0,0,.flags = STATEF_SKILL5FAST}, // S_SARG_RUN1
+  {SPR_SARG,0,2,A_Chase,S_SARG_RUN3,0,0,.flags = STATEF_SKILL5FAST}, // S_SARG_RUN2
+  {SPR_SARG,1,2,A_Chase,S_SARG_RUN4,0,0,.flags = STATEF_SKILL5FAST}, // S_SARG_RUN3
+  {SPR_SARG,1,2,A_Chase,S_SARG_RUN5,0,0,.flags = STATEF_SKILL5FAST}, // S_SARG_RUN4
+  {SPR_SARG,2,2,A_Chase,S_SARG_RUN6,0,0,.flags = STATEF_SKILL5FAST}, // S_SARG_RUN5
+  {SPR_SARG,2,2,A_Chase,S_SARG_RUN7,0,0,.flags = STATEF_SKILL5FAST}, // S_SARG_RUN6
+  {SPR_SARG,3,2,A_Chase,S_SARG_RUN8,0,0,.flags = STATEF_SKILL5FAST}, // S_SARG_RUN7
+  {SPR_SARG,3,2,A_Chase,S_SARG_RUN1,0,0,.flags = STATEF_SKILL5FAST}, // S_SARG_RUN8
+  {SPR_SARG,4,8,A_FaceTarget,S_SARG_ATK2,0,0,.flags = STATEF_SKILL5FAST},  // S_SARG_ATK1
+  {SPR_SARG,5,8,A_FaceTarget,S_SARG_ATK3,0,0,.flags = STATEF_SKILL5FAST},  // S_SARG_ATK2
+  {SPR_SARG,6,8,A_SargAttack,S_SARG_RUN1,0,0,.flags = STATEF_SKILL5FAST},  // S_SARG_ATK3
+  {SPR_SARG,7,2,NULL,S_SARG_PAIN2,0,0,.flags = STATEF_SKILL5FAST}, // S_SARG_PAIN
+  {SPR_SARG,7,2,NULL,S_SARG_RUN1,0,0,.flags = STATEF_SKILL5FAST},  // S_SARG_PAIN2
   {SPR_SARG,8,8,NULL,S_SARG_DIE2,0,0},  // S_SARG_DIE1
   {SPR_SARG,9,8,A_Scream,S_SARG_DIE3,0,0},  // S_SARG_DIE2
   {SPR_SARG,10,4,NULL,S_SARG_DIE4,0,0}, // S_SARG_DIE3
@@ -1217,7 +1217,7 @@ __thread state_t doom_states[DOOM_NUMSTATES] = {
 //
 // This goes on for the next 3000+ lines...
 
-__thread doom_mobjinfo_t doom_mobjinfo[DOOM_NUMMOBJTYPES] = {
+const doom_mobjinfo_t doom_mobjinfo[DOOM_NUMMOBJTYPES] = {
   {   // MT_PLAYER
     -1,   // doomednum
     S_PLAY,   // spawnstate
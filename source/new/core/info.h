@@ -2021,28 +2021,29 @@ typedef struct
 } raven_mobjinfo_t;
 
 // all the stuff - dynamically selected in global.c
+// These are shared by every instance in the process, and never written
 
-extern __thread state_t doom_states[DOOM_NUMSTATES];
-extern __thread const char *doom_sprnames[];
-extern __thread doom_mobjinfo_t doom_mobjinfo[DOOM_NUMMOBJTYPES];
+extern const state_t doom_states[DOOM_NUMSTATES];
+extern const char * const doom_sprnames[];
+extern const doom_mobjinfo_t doom_mobjinfo[DOOM_NUMMOBJTYPES];
 
-extern __thread state_t* states;
-extern __thread int num_states;
-extern __thread const char** sprnames;
-extern __thread int num_sprites;
-extern __thread  mobjinfo_t* mobjinfo;
-extern __thread int num_mobj_types;
-extern __thread int mobj_types_zero;
-extern __thread int mobj_types_max;
+extern __STORAGE_MODIFIER state_t* states;
+extern __STORAGE_MODIFIER int num_states;
+extern __STORAGE_MODIFIER const char** sprnames;
+extern __STORAGE_MODIFIER int num_sprites;
+extern __STORAGE_MODIFIER  mobjinfo_t* mobjinfo;
+extern __STORAGE_MODIFIER int num_mobj_types;
+extern __STORAGE_MODIFIER int mobj_types_zero;
+extern __STORAGE_MODIFIER int mobj_types_max;
 
 // zdoom
 
 #define ZMT_UNDEFINED -2
 
-extern __thread int ZMT_MAPSPOT;
-extern __thread int ZMT_MAPSPOT_GRAVITY;
-extern __thread int ZMT_TELEPORTDEST2;
-extern __thread int ZMT_TELEPORTDEST3;
-extern __thread int ZMT_AMBIENTSOUND;
+extern __STORAGE_MODIFIER int ZMT_MAPSPOT;
+extern __STORAGE_MODIFIER int ZMT_MAPSPOT_GRAVITY;
+extern __STORAGE_MODIFIER int ZMT_TELEPORTDEST2;
+extern __STORAGE_MODIFIER int ZMT_TELEPORTDEST3;
+extern __STORAGE_MODIFIER int ZMT_AMBIENTSOUND;
 
 #endif
@@ -42,6 +42,7 @@
 #include "m_random.h"
 #include "lprintf.h"
 #include "tables.h"
+#include "p_hash.h"
 
 //
 // M_Random
@@ -90,9 +91,7 @@ static const unsigned char hexen_rndtable[256] = {
 
 static const unsigned char *rndtable = doom_rndtable;
 
-__thread rng_t rng;     // the random number state
-
-__thread unsigned int rngseed = 1993;   // killough 3/26/98: The seed
+__STORAGE_MODIFIER unsigned int rngseed = 1993;   // killough 3/26/98: The seed
 
 int (P_Random)(pr_class_t pr_class)
 {
@@ -106,8 +105,8 @@ int (P_Random)(pr_class_t pr_class)
   // it's like playing with explosives :) Lee
 
   int compat = pr_class == pr_misc ?
-    (rng.prndindex = (rng.prndindex + 1) & 255) :
-    (rng. rndindex = (rng. rndindex + 1) & 255) ;
+    (engine_context->rng.prndindex = (engine_context->rng.prndindex + 1) & 255) :
+    (engine_context->rng. rndindex = (engine_context->rng. rndindex + 1) & 255) ;
 
   unsigned long boom;
 
@@ -119,11 +118,17 @@ int (P_Random)(pr_class_t pr_class)
   if (pr_class != pr_misc && !demo_insurance)      // killough 3/31/98
     pr_class = pr_all_in_one;
 
-  boom = rng.seed[pr_class];
+  boom = engine_context->rng.seed[pr_class];
 
   // killough 3/26/98: add pr_class*2 to addend
 
-  rng.seed[pr_class] = boom * 1664525ul + 221297ul + pr_class*2;
+  engine_context->rng.seed[pr_class] = boom * 1664525ul + 221297ul + pr_class*2;
+
+  if (world_hash_tracked && !demo_compatibility)
+  {
+    P_ToggleRNGSeedHash(pr_class, boom);
+    P_ToggleRNGSeedHash(pr_class, engine_context->rng.seed[pr_class]);
+  }
 
   if (demo_compatibility)
     return rndtable[compat];
@@ -156,8 +161,8 @@ void M_ClearRandom (void)
   int i;
   unsigned int seed = rngseed*2+1;     // add 3/26/98: add rngseed
   for (i=0; i<NUMPRCLASS; i++)         // go through each pr_class and set
-    rng.seed[i] = seed *= 69069ul;     // each starting seed differently
-  rng.prndindex = rng.rndindex = 0;    // clear two compatibility indices
+    engine_context->rng.seed[i] = seed *= 69069ul;     // each starting seed differently
+  engine_context->rng.prndindex = engine_context->rng.rndindex = 0;    // clear two compatibility indices
 }
 
 // [XA] Common random formulas used by codepointers
@@ -138,9 +138,7 @@ typedef struct {
   int rndindex, prndindex;             // For compatibility support
 } rng_t;
 
-extern __thread rng_t rng;                      // The rng's state
-
-extern __thread unsigned int rngseed;           // The starting seed (not part of state)
+extern __STORAGE_MODIFIER unsigned int rngseed;           // The starting seed (not part of state)
 
 // As M_Random, but used by the play simulation.
 int P_Random(pr_class_t);
@@ -36,6 +36,8 @@
 #include "p_map.h"
 #include "p_spec.h"
 #include "p_tick.h"
+#include "p_hash.h"
+#include "p_saveg.h"
 #include "sounds.h"
 #include "e6y.h"//e6y
 
@@ -43,7 +45,7 @@
 #include "dsda/map_format.h"
 
 // the list of ceilings moving currently, including crushers
-__thread ceilinglist_t *activeceilings;
+__STORAGE_MODIFIER ceilinglist_t *activeceilings;
 
 /////////////////////////////////////////////////////////////////
 //
@@ -66,7 +68,7 @@ __thread ceilinglist_t *activeceilings;
 //  pastdest - plane moved normally and is now at destination height
 //  crushed - plane encountered an obstacle, is holding until removed
 //
-result_e T_MoveCeilingPlane
+static result_e P_DoMoveCeilingPlane
 ( sector_t*     sector,
   fixed_t       speed,
   fixed_t       dest,
@@ -150,6 +152,28 @@ result_e T_MoveCeilingPlane
   return ok;
 }
 
+// The sector's heights are XORed out of the world hash before the move
+// and back in after it, whatever the outcome
+result_e T_MoveCeilingPlane
+( sector_t*     sector,
+  fixed_t       speed,
+  fixed_t       dest,
+  int           crush,
+  int           direction,
+  dboolean      hexencrush )
+{
+  result_e res;
+
+  P_MarkSectorChanged(sector);
+  if (world_hash_tracked)
+    P_ToggleSectorHash(sector);
+  res = P_DoMoveCeilingPlane(sector, speed, dest, crush, direction, hexencrush);
+  if (world_hash_tracked)
+    P_ToggleSectorHash(sector);
+
+  return res;
+}
+
 //
 // T_MoveCeiling
 //
@@ -201,6 +225,7 @@ void T_MoveCompatibleCeiling(ceiling_t * ceiling)
             P_TransferSpecial(ceiling->sector, &ceiling->newspecial);
             // fallthrough
           case genCeilingChg:
+            P_MarkSectorChanged(ceiling->sector);
             ceiling->sector->ceilingpic = ceiling->texture;
             P_RemoveActiveCeiling(ceiling);
             break;
@@ -272,6 +297,7 @@ void T_MoveCompatibleCeiling(ceiling_t * ceiling)
             P_TransferSpecial(ceiling->sector, &ceiling->newspecial);
             // fallthrough
           case genCeilingChg:
+            P_MarkSectorChanged(ceiling->sector);
             ceiling->sector->ceilingpic = ceiling->texture;
             P_RemoveActiveCeiling(ceiling);
             break;
@@ -585,7 +611,7 @@ int EV_CeilingCrushStop(line_t* line)
 //
 void P_AddActiveCeiling(ceiling_t* ceiling)
 {
-  ceilinglist_t *list = Z_Malloc(sizeof *list);
+  ceilinglist_t *list = Z_MallocLevel(sizeof *list);
   list->ceiling = ceiling;
   ceiling->list = list;
   if ((list->next = activeceilings))
@@ -34,6 +34,7 @@
 #include "doomstat.h"
 #include "p_spec.h"
 #include "p_tick.h"
+#include "p_saveg.h"
 #include "sounds.h"
 #include "r_main.h"
 #include "lprintf.h"
@@ -641,6 +642,7 @@ int EV_VerticalDoor
     case 33:
     case 34:
       door->type = openDoor;
+      P_MarkLineChanged(line);
       line->special = 0;
       break;
 
@@ -650,6 +652,7 @@ int EV_VerticalDoor
       break;
     case 118: // blazing door open
       door->type = blazeOpen;
+      P_MarkLineChanged(line);
       line->special = 0;
       door->speed = VDOORSPEED*4;
       break;
@@ -45,6 +45,7 @@
 #include "g_game.h"
 #include "p_enemy.h"
 #include "p_tick.h"
+#include "p_hash.h"
 #include "i_sound.h"
 #include "m_bbox.h"
 #include "lprintf.h"
@@ -56,8 +57,9 @@
 #include "dsda/map_format.h"
 #include "dsda/mapinfo.h"
 #include "dsda/skill_info.h"
+#include "dsda/state.h"
 
-static __thread mobj_t *current_actor;
+static __STORAGE_MODIFIER mobj_t *current_actor;
 
 typedef enum {
   DI_EAST,
@@ -345,8 +347,8 @@ static fixed_t xspeed[8] = {FRACUNIT,47000,0,-47000,-FRACUNIT,-47000,0,47000};
 static fixed_t yspeed[8] = {0,47000,FRACUNIT,47000,0,-47000,-FRACUNIT,-47000};
 
 // 1/11/98 killough: Limit removed on special lines crossed
-extern  __thread line_t **spechit;          // New code -- killough
-extern  __thread int    numspechit;
+extern  __STORAGE_MODIFIER line_t **spechit;          // New code -- killough
+extern  __STORAGE_MODIFIER int    numspechit;
 
 static dboolean P_Move(mobj_t *actor, dboolean dropoff) /* killough 9/12/98 */
 {
@@ -390,6 +392,7 @@ static dboolean P_Move(mobj_t *actor, dboolean dropoff) /* killough 9/12/98 */
   {
     actor->x = origx;
     actor->y = origy;
+    P_RehashMobj(actor);
     movefactor *= FRACUNIT / ORIG_FRICTION_FACTOR / 4;
     actor->momx += FixedMul(deltax, movefactor);
     actor->momy += FixedMul(deltay, movefactor);
@@ -630,9 +633,9 @@ static void P_DoNewChaseDir(mobj_t *actor, fixed_t deltax, fixed_t deltay)
 // monsters to free themselves without making them tend to
 // hang over dropoffs.
 
-static __thread fixed_t dropoff_deltax;
-static __thread fixed_t dropoff_deltay;
-static __thread fixed_t floorz;
+static __STORAGE_MODIFIER fixed_t dropoff_deltax;
+static __STORAGE_MODIFIER fixed_t dropoff_deltay;
+static __STORAGE_MODIFIER fixed_t floorz;
 
 static dboolean PIT_AvoidDropoff(line_t *line)
 {
@@ -799,7 +802,7 @@ static dboolean P_IsVisible(mobj_t *actor, mobj_t *mo, dboolean allaround)
 // Finds monster targets for other monsters
 //
 
-static __thread int current_allaround;
+static __STORAGE_MODIFIER int current_allaround;
 
 static dboolean PIT_FindTarget(mobj_t *mo)
 {
@@ -830,7 +833,7 @@ static dboolean PIT_FindTarget(mobj_t *mo)
   // list, so that it gets searched last next time.
 
   {
-    thinker_t *cap = &thinkerclasscap[mo->flags & MF_FRIEND ?
+    thinker_t *cap = &engine_context->thinkerclasscap[mo->flags & MF_FRIEND ?
              th_friends : th_enemies];
     (mo->thinker.cprev->cnext = mo->thinker.cnext)->cprev = mo->thinker.cprev;
     (mo->thinker.cprev = cap->cprev)->cnext = &mo->thinker;
@@ -858,10 +861,10 @@ static dboolean P_LookForPlayers(mobj_t *actor, dboolean allaround)
     // Go back to a player, no matter whether it's visible or not
     for (anyone=0; anyone<=1; anyone++)
       for (c=0; c<g_maxplayers; c++)
-        if (playeringame[c] && players[c].playerstate==PST_LIVE &&
-            (anyone || P_IsVisible(actor, players[c].mo, allaround)))
+        if (engine_context->playeringame[c] && engine_context->players[c].playerstate==PST_LIVE &&
+            (anyone || P_IsVisible(actor, engine_context->players[c].mo, allaround)))
         {
-          P_SetTarget(&actor->target, players[c].mo);
+          P_SetTarget(&actor->target, engine_context->players[c].mo);
 
           // killough 12/98:
           // get out of refiring loop, to avoid hitting player accidentally
@@ -889,7 +892,7 @@ static dboolean P_LookForPlayers(mobj_t *actor, dboolean allaround)
 
   for (;; actor->lastlook = (actor->lastlook+1)&(g_maxplayers-1))
     {
-      if (!playeringame[actor->lastlook])
+      if (!engine_context->playeringame[actor->lastlook])
   continue;
 
       // killough 2/15/98, 9/9/98:
@@ -913,7 +916,7 @@ static dboolean P_LookForPlayers(mobj_t *actor, dboolean allaround)
         return false;
       }
 
-      player = &players[actor->lastlook];
+      player = &engine_context->players[actor->lastlook];
 
       if (player->cheats & CF_NOTARGET)
         continue; // no target
@@ -964,7 +967,7 @@ static dboolean P_LookForMonsters(mobj_t *actor, dboolean allaround)
     return false;
 
   // Search the threaded list corresponding to this object's potential targets
-  cap = &thinkerclasscap[actor->flags & MF_FRIEND ? th_enemies : th_friends];
+  cap = &engine_context->thinkerclasscap[actor->flags & MF_FRIEND ? th_enemies : th_friends];
 
   // Search for new enemy
 
@@ -1063,7 +1066,7 @@ static dboolean P_HelpFriend(mobj_t *actor)
   current_allaround = true;
 
   // Possibly help a friend under 50% health
-  cap = &thinkerclasscap[actor->flags & MF_FRIEND ? th_friends : th_enemies];
+  cap = &engine_context->thinkerclasscap[actor->flags & MF_FRIEND ? th_friends : th_enemies];
 
   for (th = cap->cnext; th != cap; th = th->cnext)
     if (((mobj_t *) th)->health*2 >= P_MobjSpawnHealth((mobj_t *) th))
@@ -1577,10 +1580,11 @@ void A_SkelMissile(mobj_t *actor)
 
   mo->x += mo->momx;
   mo->y += mo->momy;
+  P_RehashMobj(mo);
   P_SetTarget(&mo->tracer, actor->target);
 }
 
-__thread int     TRACEANGLE = 0xc000000;
+__STORAGE_MODIFIER int     TRACEANGLE = 0xc000000;
 
 void A_Tracer(mobj_t *actor)
 {
@@ -1688,11 +1692,11 @@ void A_SkelFist(mobj_t *actor)
 // Detect a corpse that could be raised.
 //
 
-__thread mobj_t* corpsehit;
-__thread mobj_t* vileobj;
-__thread fixed_t viletryx;
-__thread fixed_t viletryy;
-__thread int viletryradius;
+__STORAGE_MODIFIER mobj_t* corpsehit;
+__STORAGE_MODIFIER mobj_t* vileobj;
+__STORAGE_MODIFIER fixed_t viletryx;
+__STORAGE_MODIFIER fixed_t viletryy;
+__STORAGE_MODIFIER int viletryradius;
 
 static dboolean PIT_VileCheck(mobj_t *thing)
 {
@@ -1801,6 +1805,7 @@ dboolean P_RaiseThing(mobj_t *corpse, mobj_t *raiser)
     totallive++;
 
   corpse->health = P_MobjSpawnHealth(corpse);
+  P_RehashMobj(corpse);
   P_SetTarget(&corpse->target, NULL);
   P_SetTarget(&corpse->lastenemy, NULL);
 
@@ -1876,6 +1881,7 @@ static dboolean P_HealCorpse(mobj_t* actor, int radius, statenum_t healstate, sf
             totallive++;
 
           corpsehit->health = P_MobjSpawnHealth(corpsehit);
+          P_RehashMobj(corpsehit);
           P_SetTarget(&corpsehit->target, NULL);  // killough 11/98
 
           if (mbf_features)
@@ -2007,6 +2013,7 @@ void A_VileAttack(mobj_t *actor)
   // move the fire between the vile and the player
   fire->x = actor->target->x - FixedMul (24*FRACUNIT, finecosine[an]);
   fire->y = actor->target->y - FixedMul (24*FRACUNIT, finesine[an]);
+  P_RehashMobj(fire);
   P_RadiusAttack(fire, actor, 70, 70, BF_DAMAGESOURCE | BF_HORIZONTAL);
 }
 
@@ -2323,7 +2330,7 @@ dboolean P_CheckBossDeath(mobj_t *mo)
 
   // make sure there is a player alive for victory
   for (i = 0; i < g_maxplayers; i++)
-    if (playeringame[i] && players[i].health > 0)
+    if (engine_context->playeringame[i] && engine_context->players[i].health > 0)
       break;
 
   if (i == g_maxplayers)
@@ -2344,7 +2351,7 @@ dboolean P_CheckBossDeath(mobj_t *mo)
 
 void A_BossDeath(mobj_t *mo)
 {
-  static __thread line_t junk;
+  static __STORAGE_MODIFIER line_t junk;
 
   if (dsda_BossAction(mo))
   {
@@ -2519,10 +2526,10 @@ void A_CloseShotgun2(player_t *player, pspdef_t *psp)
 }
 
 // killough 2/7/98: Remove limit on icon landings:
-__thread mobj_t **braintargets;
-__thread int    numbraintargets_alloc;
-__thread int    numbraintargets;
-__thread struct brain_s brain;   // killough 3/26/98: global state of boss brain
+__STORAGE_MODIFIER mobj_t **braintargets;
+__STORAGE_MODIFIER int    numbraintargets_alloc;
+__STORAGE_MODIFIER int    numbraintargets;
+__STORAGE_MODIFIER struct brain_s brain;   // killough 3/26/98: global state of boss brain
 
 // killough 3/26/98: initialize icon landings at level startup,
 // rather than at boss wakeup, to prevent savegame-related crashes
@@ -2882,7 +2889,10 @@ void A_LineEffect(mobj_t *mo)
   junk.tag = (short)mo->state->misc2;
   if (!P_UseSpecialLine(mo, &junk, 0, false))
     map_format.cross_special_line(&junk, 0, mo, false);
-  mo->state->misc1 = junk.special;
+  if (mo->state->misc1 != junk.special) {
+    dsda_PrepStatesForWrite();
+    mo->state->misc1 = junk.special;
+  }
   mo->player = oldplayer;
 }
 
@@ -3005,6 +3015,7 @@ void A_MonsterProjectile(mobj_t *actor)
   mo->x += FixedMul(spawnofs_xy, finecosine[an]);
   mo->y += FixedMul(spawnofs_xy, finesine[an]);
   mo->z += spawnofs_z;
+  P_RehashMobj(mo);
 
   // always set the 'tracer' field, so this pointer
   // can be used to fire seeker missiles at will.
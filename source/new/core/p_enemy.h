@@ -42,7 +42,7 @@ void P_NoiseAlert (mobj_t *target, mobj_t *emmiter);
 void P_SpawnBrainTargets(void); /* killough 3/26/98: spawn icon landings */
 dboolean P_CheckBossDeath(mobj_t *mo);
 
-extern __thread struct brain_s {         /* killough 3/26/98: global state of boss brain */
+extern __STORAGE_MODIFIER struct brain_s {         /* killough 3/26/98: global state of boss brain */
   int easy, targeton;
 } brain;
 
@@ -37,6 +37,8 @@
 #include "p_map.h"
 #include "p_spec.h"
 #include "p_tick.h"
+#include "p_hash.h"
+#include "p_saveg.h"
 #include "sounds.h"
 #include "lprintf.h"
 #include "g_overflow.h"
@@ -66,7 +68,7 @@
 //  pastdest - plane moved normally and is now at destination height
 //  crushed - plane encountered an obstacle, is holding until removed
 //
-result_e T_MoveFloorPlane
+static result_e P_DoMoveFloorPlane
 ( sector_t*     sector,
   fixed_t       speed,
   fixed_t       dest,
@@ -150,7 +152,7 @@ result_e T_MoveFloorPlane
             if (crush == STAIRS_UNINITIALIZED_CRUSH_FIELD_VALUE)
             {
               lprintf(LO_WARN, "T_MoveFloorPlane: Stairs which can potentially crush may lead to desynch in compatibility mode.\n");
-              lprintf(LO_WARN, " gametic: %d, sector: %d, complevel: %d\n", gametic, sector->iSectorID, compatibility_level);
+              lprintf(LO_WARN, " gametic: %d, sector: %d, complevel: %d\n", engine_context->gametic, sector->iSectorID, compatibility_level);
             }
 
             if (crush >= 0)
@@ -167,6 +169,28 @@ result_e T_MoveFloorPlane
   return ok;
 }
 
+// The sector's heights are XORed out of the world hash before the move
+// and back in after it, whatever the outcome
+result_e T_MoveFloorPlane
+( sector_t*     sector,
+  fixed_t       speed,
+  fixed_t       dest,
+  int           crush,
+  int           direction,
+  dboolean      hexencrush )
+{
+  result_e res;
+
+  P_MarkSectorChanged(sector);
+  if (world_hash_tracked)
+    P_ToggleSectorHash(sector);
+  res = P_DoMoveFloorPlane(sector, speed, dest, crush, direction, hexencrush);
+  if (world_hash_tracked)
+    P_ToggleSectorHash(sector);
+
+  return res;
+}
+
 //
 // T_MoveFloor()
 //
@@ -247,6 +271,7 @@ void T_MoveCompatibleFloor(floormove_t * floor)
             P_TransferSpecial(floor->sector, &floor->newspecial);
             //fall thru
           case genFloorChg:
+            P_MarkSectorChanged(floor->sector);
             floor->sector->floorpic = floor->texture;
             break;
           default:
@@ -264,6 +289,7 @@ void T_MoveCompatibleFloor(floormove_t * floor)
             P_TransferSpecial(floor->sector, &floor->newspecial);
             //fall thru
           case genFloorChg:
+            P_MarkSectorChanged(floor->sector);
             floor->sector->floorpic = floor->texture;
             break;
           default:
@@ -535,6 +561,7 @@ int EV_DoFloor
         floor->sector = sec;
         floor->speed = FLOORSPEED;
         floor->floordestheight = floor->sector->floorheight + 24 * FRACUNIT;
+        P_MarkSectorChanged(sec);
         sec->floorpic = line->frontsector->floorpic;
         P_CopySectorSpecial(sec, line->frontsector);
         break;
@@ -642,6 +669,7 @@ int EV_DoChange
       case trigChangeOnly:
         if (line)
         {
+          P_MarkSectorChanged(sec);
           sec->floorpic = line->frontsector->floorpic;
           P_CopySectorSpecial(sec, line->frontsector);
         }
@@ -650,6 +678,7 @@ int EV_DoChange
         secm = P_FindModelFloorSector(sec->floorheight,*id_p);
         if (secm) // if no model, no change
         {
+          P_MarkSectorChanged(sec);
           sec->floorpic = secm->floorpic;
           P_CopySectorSpecial(sec, secm);
         }
@@ -1142,23 +1171,23 @@ int EV_DoFloorAndCeiling(line_t * line, byte * args, dboolean raise)
 #define STAIR_SECTOR_TYPE       26
 #define STAIR_QUEUE_SIZE        32
 
-__thread struct
+__STORAGE_MODIFIER struct
 {
     sector_t *sector;
     int type;
     int height;
 } StairQueue[STAIR_QUEUE_SIZE];
 
-static __thread int QueueHead;
-static __thread int QueueTail;
-static __thread int StepDelta;
-static __thread int Direction;
-static __thread int Speed;
-static __thread int Texture;
-static __thread int StartDelay;
-static __thread int StartDelayDelta;
-static __thread int TextureChange;
-static __thread int StartHeight;
+static __STORAGE_MODIFIER int QueueHead;
+static __STORAGE_MODIFIER int QueueTail;
+static __STORAGE_MODIFIER int StepDelta;
+static __STORAGE_MODIFIER int Direction;
+static __STORAGE_MODIFIER int Speed;
+static __STORAGE_MODIFIER int Texture;
+static __STORAGE_MODIFIER int StartDelay;
+static __STORAGE_MODIFIER int StartDelayDelta;
+static __STORAGE_MODIFIER int TextureChange;
+static __STORAGE_MODIFIER int StartHeight;
 
 static void QueueStairSector(sector_t * sec, int type, int height)
 {
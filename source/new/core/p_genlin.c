@@ -36,6 +36,7 @@
 #include "r_main.h"
 #include "p_spec.h"
 #include "p_tick.h"
+#include "p_saveg.h"
 #include "m_random.h"
 #include "sounds.h"
 #include "e6y.h"
@@ -723,7 +724,10 @@ int EV_DoGenStairs
   }
   // retriggerable generalized stairs build up or down alternately
   if (rtn)
+  {
+    P_MarkLineChanged(line);
     line->special ^= StairDirection; // alternate dir on succ activations
+  }
   return rtn;
 }
 
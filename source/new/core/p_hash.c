@@ -0,0 +1,187 @@
+/* Emacs style mode select   -*- C -*-
+ *-----------------------------------------------------------------------------
+ *
+ *  This program is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU General Public License
+ *  as published by the Free Software Foundation; either version 2
+ *  of the License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ * DESCRIPTION:
+ *      Incrementally maintained world hash.
+ *
+ *-----------------------------------------------------------------------------*/
+
+#include "doomstat.h"
+#include "m_random.h"
+#include "p_mobj.h"
+#include "p_tick.h"
+#include "r_state.h"
+#include "p_hash.h"
+
+__STORAGE_MODIFIER uint64_t world_hash[2];
+__STORAGE_MODIFIER dboolean world_hash_tracked;
+
+// splitmix64 finalizer
+static uint64_t P_HashMix(uint64_t x)
+{
+  x ^= x >> 30;
+  x *= 0xbf58476d1ce4e5b9ull;
+  x ^= x >> 27;
+  x *= 0x94d049bb133111ebull;
+  x ^= x >> 31;
+  return x;
+}
+
+enum { hash_mobj = 1, hash_sector, hash_rng_seed, hash_rng_index };
+
+#define HASH_PAIR(hi, lo) ((uint64_t)(uint32_t)(hi) << 32 | (uint32_t)(lo))
+
+// Hashes the index of an element and words of its fields into a 128 bit
+// contribution. The kind of element is hashed along with its index, so equal
+// fields of different kinds don't cancel out.
+static void P_HashWords(uint64_t out[2], int kind, int index, const uint64_t *words, int count)
+{
+  uint64_t h0 = P_HashMix(HASH_PAIR(kind, index) ^ 0x9e3779b97f4a7c15ull);
+  uint64_t h1 = P_HashMix(HASH_PAIR(kind, index) ^ 0xc2b2ae3d27d4eb4full);
+  int i;
+
+  for (i = 0; i < count; i++)
+  {
+    h0 = P_HashMix(h0 ^ words[i]);
+    h1 = P_HashMix(h1 + words[i]);
+  }
+
+  out[0] = h0;
+  out[1] = h1;
+}
+
+void P_UnhashMobj(mobj_t *mobj)
+{
+  world_hash[0] ^= mobj->hash[0];
+  world_hash[1] ^= mobj->hash[1];
+  mobj->hash[0] = mobj->hash[1] = 0;
+}
+
+static void P_GetMobjHashWords(const mobj_t *mobj, uint64_t words[MOBJ_HASH_WORDS])
+{
+  const int state = mobj->state ? mobj->state - states : -1;
+
+  words[0] = HASH_PAIR(mobj->type, state);
+  words[1] = HASH_PAIR(mobj->x, mobj->y);
+  words[2] = HASH_PAIR(mobj->z, mobj->angle);
+  words[3] = HASH_PAIR(mobj->momx, mobj->momy);
+  words[4] = HASH_PAIR(mobj->momz, mobj->tics);
+  words[5] = mobj->flags;
+  words[6] = (uint32_t)mobj->health;
+}
+
+// Replaces the mobj's contribution with the one of the words it keeps
+static void P_HashMobjWords(mobj_t *mobj)
+{
+  P_UnhashMobj(mobj);
+
+  P_HashWords(mobj->hash, hash_mobj, mobj->id, mobj->hash_words, MOBJ_HASH_WORDS);
+
+  // A nonzero contribution marks the mobj as hashed
+  mobj->hash[0] |= 1;
+
+  world_hash[0] ^= mobj->hash[0];
+  world_hash[1] ^= mobj->hash[1];
+}
+
+void P_HashMobj(mobj_t *mobj)
+{
+  P_GetMobjHashWords(mobj, mobj->hash_words);
+  P_HashMobjWords(mobj);
+}
+
+void P_RehashMobj(mobj_t *mobj)
+{
+  if (mobj->hash[0])
+    P_HashMobj(mobj);
+}
+
+// Most mobjs keep still between tics, so the words are compared before hashing them again
+void P_RehashMobjs(void)
+{
+  uint64_t words[MOBJ_HASH_WORDS];
+  mobj_t *mobj;
+  int id;
+
+  for (id = 1; id < mobj_ids_end; id++)
+  {
+    mobj = mobj_ids[id];
+    if (!mobj || !mobj->hash[0])
+      continue;
+
+    P_GetMobjHashWords(mobj, words);
+    if (memcmp(words, mobj->hash_words, sizeof(words)))
+    {
+      memcpy(mobj->hash_words, words, sizeof(words));
+      P_HashMobjWords(mobj);
+    }
+  }
+}
+
+void P_ToggleSectorHash(const sector_t *sector)
+{
+  const uint64_t heights = HASH_PAIR(sector->floorheight, sector->ceilingheight);
+  uint64_t h[2];
+
+  P_HashWords(h, hash_sector, sector - sectors, &heights, 1);
+
+  world_hash[0] ^= h[0];
+  world_hash[1] ^= h[1];
+}
+
+void P_ToggleRNGSeedHash(int pr_class, unsigned int seed)
+{
+  const uint64_t word = seed;
+  uint64_t h[2];
+
+  P_HashWords(h, hash_rng_seed, pr_class, &word, 1);
+
+  world_hash[0] ^= h[0];
+  world_hash[1] ^= h[1];
+}
+
+void P_RebuildWorldHash(void)
+{
+  thinker_t *th;
+  int i;
+
+  world_hash[0] = world_hash[1] = 0;
+
+  for (th = thinkercap.next; th != &thinkercap; th = th->next)
+    if (th->function == P_MobjThinker || th->function == P_BlasterMobjThinker)
+    {
+      mobj_t *mobj = (mobj_t *) th;
+
+      mobj->hash[0] = mobj->hash[1] = 0;
+      P_HashMobj(mobj);
+    }
+
+  for (i = 0; i < numsectors; i++)
+    P_ToggleSectorHash(&sectors[i]);
+
+  // The seeds are time seeded under demo compatibility, where they are unused
+  if (!demo_compatibility)
+    for (i = 0; i < NUMPRCLASS; i++)
+      P_ToggleRNGSeedHash(i, engine_context->rng.seed[i]);
+}
+
+void P_GetWorldHash(uint64_t hash[2])
+{
+  const uint64_t indices = HASH_PAIR(engine_context->rng.rndindex, engine_context->rng.prndindex);
+  uint64_t h[2];
+
+  P_HashWords(h, hash_rng_index, 0, &indices, 1);
+
+  hash[0] = world_hash[0] ^ h[0];
+  hash[1] = world_hash[1] ^ h[1];
+}
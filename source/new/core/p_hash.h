@@ -0,0 +1,66 @@
+/* Emacs style mode select   -*- C -*-
+ *-----------------------------------------------------------------------------
+ *
+ *  This program is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU General Public License
+ *  as published by the Free Software Foundation; either version 2
+ *  of the License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ * DESCRIPTION:
+ *      Incrementally maintained world hash.
+ *
+ *-----------------------------------------------------------------------------*/
+
+#ifndef __P_HASH__
+#define __P_HASH__
+
+#include "doomtype.h"
+
+struct mobj_s;
+struct sector_s;
+
+/* Running 128 bit hash of the world. Each linked mobj, sector plane pair and
+ * (outside demo compatibility) RNG seed XORs its own contribution into it,
+ * and the places that change them XOR the old one out and the new one in,
+ * so reading the hash is O(1). Keeping it costs a walk over every mobj each
+ * tic, though (see P_RehashMobjs), so all of this is only done while
+ * world_hash_tracked is set, that is, while something reads the hash: every
+ * hook below is skipped, or finds nothing hashed, while it is not. The hash
+ * is archived with the state, so loading one does not rebuild it. */
+extern __STORAGE_MODIFIER uint64_t world_hash[2];
+extern __STORAGE_MODIFIER dboolean world_hash_tracked;
+
+/* Mobjs are hashed while linked into the world: P_SetThingPosition hashes
+ * them in (replacing any previous contribution), P_UnsetThingPosition out.
+ * Code changing a hashed field (id, type, x, y, health, state) of a mobj
+ * calls P_RehashMobj afterwards, which does nothing for unlinked ones. */
+void P_HashMobj(struct mobj_s *mobj);
+void P_UnhashMobj(struct mobj_s *mobj);
+void P_RehashMobj(struct mobj_s *mobj);
+
+/* The other hashed fields (z, angle, momentum, flags, tics) change nearly
+ * every tic for every moving or animated mobj, from many places, so P_Ticker
+ * rehashes the linked mobjs whose fields changed at the end of each tic
+ * instead, walking every mobj to compare them. */
+void P_RehashMobjs(void);
+
+/* XORs a sector's floor / ceiling heights in or out, called around each move */
+void P_ToggleSectorHash(const struct sector_s *sector);
+
+/* XORs the seed of a RNG class in or out, called around each seed update */
+void P_ToggleRNGSeedHash(int pr_class, unsigned int seed);
+
+/* Recomputes the hash and the per mobj contributions from scratch, once
+ * the level is set up or tracking starts, or after loading a save taken
+ * while the hash was not tracked */
+void P_RebuildWorldHash(void);
+
+/* The world hash, including the RNG indices */
+void P_GetWorldHash(uint64_t hash[2]);
+
+#endif
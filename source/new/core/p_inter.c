@@ -43,6 +43,7 @@
 #include "p_spec.h"
 #include "p_pspr.h"
 #include "p_user.h"
+#include "p_hash.h"
 
 #include "p_inter.h"
 #include "e6y.h"//e6y
@@ -57,31 +58,31 @@
 // dehacked support (and future flexibility).  Most var names came from the key
 // strings used in dehacked.
 
-__thread int initial_health = 100;
-__thread int initial_bullets = 50;
-__thread int maxhealth = 100; // was MAXHEALTH as a #define, used only in this module
-__thread int maxhealthbonus = 200;
-__thread int max_armor = 200;
-__thread int green_armor_class = 1;  // these are involved with armortype below
-__thread int blue_armor_class = 2;
-__thread int max_soul = 200;
-__thread int soul_health = 100;
-__thread int mega_health = 200;
-__thread int god_health = 100;   // these are used in cheats (see st_stuff.c)
-__thread int idfa_armor = 200;
-__thread int idfa_armor_class = 2;
+__STORAGE_MODIFIER int initial_health = 100;
+__STORAGE_MODIFIER int initial_bullets = 50;
+__STORAGE_MODIFIER int maxhealth = 100; // was MAXHEALTH as a #define, used only in this module
+__STORAGE_MODIFIER int maxhealthbonus = 200;
+__STORAGE_MODIFIER int max_armor = 200;
+__STORAGE_MODIFIER int green_armor_class = 1;  // these are involved with armortype below
+__STORAGE_MODIFIER int blue_armor_class = 2;
+__STORAGE_MODIFIER int max_soul = 200;
+__STORAGE_MODIFIER int soul_health = 100;
+__STORAGE_MODIFIER int mega_health = 200;
+__STORAGE_MODIFIER int god_health = 100;   // these are used in cheats (see st_stuff.c)
+__STORAGE_MODIFIER int idfa_armor = 200;
+__STORAGE_MODIFIER int idfa_armor_class = 2;
 // not actually used due to pairing of cheat_k and cheat_fa
-__thread int idkfa_armor = 200;
-__thread int idkfa_armor_class = 2;
+__STORAGE_MODIFIER int idkfa_armor = 200;
+__STORAGE_MODIFIER int idkfa_armor_class = 2;
 
-__thread int bfgcells = 40;      // used in p_pspr.c
-__thread int monsters_infight = 0; // e6y: Dehacked support - monsters infight
+__STORAGE_MODIFIER int bfgcells = 40;      // used in p_pspr.c
+__STORAGE_MODIFIER int monsters_infight = 0; // e6y: Dehacked support - monsters infight
 // Ty 03/07/98 - end deh externals
 
 // a weapon is found with two clip loads,
 // a big item has five clip loads
-__thread int maxammo[NUMAMMO]  = {200, 50, 300, 50, 0, 0}; // heretic +2 ammo types
-__thread int clipammo[NUMAMMO] = { 10,  4,  20,  1, 0, 0}; // heretic +2 ammo types
+__STORAGE_MODIFIER int maxammo[NUMAMMO]  = {200, 50, 300, 50, 0, 0}; // heretic +2 ammo types
+__STORAGE_MODIFIER int clipammo[NUMAMMO] = { 10,  4,  20,  1, 0, 0}; // heretic +2 ammo types
 
 //
 // GET STUFF
@@ -288,6 +289,7 @@ dboolean P_GiveBody(player_t * player, int num)
         player->health = max;
     }
     player->mo->health = player->health;
+    P_RehashMobj(player->mo);
     return (true);
 }
 
@@ -310,6 +312,7 @@ void P_HealMobj(mobj_t *mo, int num)
     mo->health += num;
     if (mo->health > max)
       mo->health = max;
+    P_RehashMobj(mo);
   }
 }
 
@@ -421,6 +424,7 @@ void P_TouchSpecialThing(mobj_t *special, mobj_t *toucher)
       if (player->health > (maxhealthbonus))//e6y
         player->health = (maxhealthbonus);//e6y
       player->mo->health = player->health;
+      P_RehashMobj(player->mo);
       break;
 
     case SPR_BON2:
@@ -449,6 +453,7 @@ void P_TouchSpecialThing(mobj_t *special, mobj_t *toucher)
       if (player->health > max_soul)
         player->health = max_soul;
       player->mo->health = player->health;
+      P_RehashMobj(player->mo);
       sound = sfx_getpow;
       break;
 
@@ -457,6 +462,7 @@ void P_TouchSpecialThing(mobj_t *special, mobj_t *toucher)
         return;
       player->health = mega_health;
       player->mo->health = player->health;
+      P_RehashMobj(player->mo);
       // e6y
       // We always give armor type 2 for the megasphere;
       // dehacked only affects the MegaArmor.
@@ -722,7 +728,7 @@ static void P_KillMobj(mobj_t *source, mobj_t *target)
   {
     if (target->player)
     {
-      source->player->frags[target->player-players]++;
+      source->player->frags[target->player-engine_context->players]++;
 
     }
   }
@@ -743,7 +749,7 @@ static void P_KillMobj(mobj_t *source, mobj_t *target)
               unsigned int player;
               for (player = 0; player < g_maxplayers; player++)
               {
-                if (playeringame[player])
+                if (engine_context->playeringame[player])
                 {
                   break;
                 }
@@ -767,14 +773,14 @@ static void P_KillMobj(mobj_t *source, mobj_t *target)
             unsigned int activeplayers = 0, player, i;
 
             for (player = 0; player < g_maxplayers; player++)
-              if (playeringame[player])
+              if (engine_context->playeringame[player])
                 activeplayers++;
 
             if (activeplayers) {
               player = P_Random(pr_friends) % activeplayers;
 
               for (i = 0; i < g_maxplayers; i++)
-                if (playeringame[i])
+                if (engine_context->playeringame[i])
                   if (!player--)
                   {
                   }
@@ -787,7 +793,7 @@ static void P_KillMobj(mobj_t *source, mobj_t *target)
   {
     // count environment kills against you
     if (!source)
-      target->player->frags[target->player-players]++;
+      target->player->frags[target->player-engine_context->players]++;
 
     target->flags &= ~MF_SOLID;
 
@@ -978,6 +984,7 @@ void P_DamageMobj(mobj_t *target,mobj_t *inflictor, mobj_t *source, int damage)
 
   // do the damage
   target->health -= damage;
+  P_RehashMobj(target);
   if (target->health <= 0)
   {
 
@@ -1000,7 +1007,7 @@ void P_DamageMobj(mobj_t *target,mobj_t *inflictor, mobj_t *source, int damage)
      */
     if (target->health*2 < P_MobjSpawnHealth(target))
     {
-      thinker_t *cap = &thinkerclasscap[target->flags & MF_FRIEND ?
+      thinker_t *cap = &engine_context->thinkerclasscap[target->flags & MF_FRIEND ?
                th_friends : th_enemies];
       (target->thinker.cprev->cnext = target->thinker.cnext)->cprev =
         target->thinker.cprev;
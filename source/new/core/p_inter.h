@@ -53,23 +53,23 @@ int P_PlayerHealthIncrease(int value);
 
 /* killough 5/2/98: moved from d_deh.c, g_game.c, m_misc.c, others: */
 
-extern __thread  int god_health;   /* Ty 03/09/98 - deh support, see also p_inter.c */
-extern __thread  int idfa_armor;
-extern __thread  int idfa_armor_class;
-extern __thread  int idkfa_armor;
-extern __thread  int idkfa_armor_class;  /* Ty - end */
-extern __thread  int initial_health;
-extern __thread  int initial_bullets;
-extern __thread  int maxhealth;
-extern __thread  int maxhealthbonus;
-extern __thread  int max_armor;
-extern __thread  int green_armor_class;
-extern __thread  int blue_armor_class;
-extern __thread  int max_soul;
-extern __thread  int soul_health;
-extern __thread  int mega_health;
-extern __thread  int bfgcells;
-extern __thread  int monsters_infight; // e6y: Dehacked support - monsters infight
-extern __thread  int maxammo[], clipammo[];
+extern __STORAGE_MODIFIER  int god_health;   /* Ty 03/09/98 - deh support, see also p_inter.c */
+extern __STORAGE_MODIFIER  int idfa_armor;
+extern __STORAGE_MODIFIER  int idfa_armor_class;
+extern __STORAGE_MODIFIER  int idkfa_armor;
+extern __STORAGE_MODIFIER  int idkfa_armor_class;  /* Ty - end */
+extern __STORAGE_MODIFIER  int initial_health;
+extern __STORAGE_MODIFIER  int initial_bullets;
+extern __STORAGE_MODIFIER  int maxhealth;
+extern __STORAGE_MODIFIER  int maxhealthbonus;
+extern __STORAGE_MODIFIER  int max_armor;
+extern __STORAGE_MODIFIER  int green_armor_class;
+extern __STORAGE_MODIFIER  int blue_armor_class;
+extern __STORAGE_MODIFIER  int max_soul;
+extern __STORAGE_MODIFIER  int soul_health;
+extern __STORAGE_MODIFIER  int mega_health;
+extern __STORAGE_MODIFIER  int bfgcells;
+extern __STORAGE_MODIFIER  int monsters_infight; // e6y: Dehacked support - monsters infight
+extern __STORAGE_MODIFIER  int maxammo[], clipammo[];
 
 #endif
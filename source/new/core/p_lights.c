@@ -39,6 +39,7 @@
 #include "r_main.h"
 #include "p_spec.h"
 #include "p_tick.h"
+#include "p_saveg.h"
 
 #include "dsda/id_list.h"
 
@@ -65,6 +66,7 @@ void T_FireFlicker (fireflicker_t* flick)
 
   amount = (P_Random(pr_lights)&3)*16;
 
+  P_MarkSectorChanged(flick->sector);
   if (flick->sector->lightlevel - amount < flick->minlight)
     flick->sector->lightlevel = flick->minlight;
   else
@@ -86,6 +88,7 @@ void T_LightFlash (lightflash_t* flash)
   if (--flash->count)
     return;
 
+  P_MarkSectorChanged(flash->sector);
   if (flash->sector->lightlevel == flash->maxlight)
   {
     flash-> sector->lightlevel = flash->minlight;
@@ -112,6 +115,7 @@ void T_StrobeFlash (strobe_t*   flash)
   if (--flash->count)
     return;
 
+  P_MarkSectorChanged(flash->sector);
   if (flash->sector->lightlevel == flash->minlight)
   {
     flash-> sector->lightlevel = flash->maxlight;
@@ -135,6 +139,7 @@ void T_StrobeFlash (strobe_t*   flash)
 
 void T_Glow(glow_t* g)
 {
+  P_MarkSectorChanged(g->sector);
   switch(g->direction)
   {
     case -1:
@@ -356,6 +361,7 @@ int EV_TurnTagLightsOff(line_t* line)
       if ((tsec = getNextSector(sector->lines[i], sector)) &&
         tsec->lightlevel < min)
     min = tsec->lightlevel;
+    P_MarkSectorChanged(sector);
     sector->lightlevel = min;
   }
   return 1;
@@ -392,6 +398,7 @@ int EV_LightTurnOn(line_t *line, int bright)
             temp->lightlevel > tbright)
     tbright = temp->lightlevel;
 
+    P_MarkSectorChanged(sector);
     sector->lightlevel = tbright;
 
     //jff 5/17/98 unless compatibility optioned
@@ -439,6 +446,7 @@ int EV_LightTurnOnPartway(line_t *line, fixed_t level)
           min = temp->lightlevel;
       }
 
+    P_MarkSectorChanged(sector);
     sector->lightlevel =   // Set level in-between extremes
       (level * bright + (FRACUNIT-level) * min) >> FRACBITS;
   }
@@ -450,7 +458,10 @@ void EV_LightChange(int tag, short change)
   const int *id_p;
 
   FIND_SECTORS(id_p, tag)
+  {
+    P_MarkSectorChanged(&sectors[*id_p]);
     sectors[*id_p].lightlevel += change;
+  }
 }
 
 void EV_LightSet(int tag, short level)
@@ -458,7 +469,10 @@ void EV_LightSet(int tag, short level)
   const int *id_p;
 
   FIND_SECTORS(id_p, tag)
+  {
+    P_MarkSectorChanged(&sectors[*id_p]);
     sectors[*id_p].lightlevel = level;
+  }
 }
 
 void EV_LightSetMinNeighbor(int tag)
@@ -478,6 +492,7 @@ void EV_LightSetMinNeighbor(int tag)
       if ((temp = getNextSector(sector->lines[i], sector)) && temp->lightlevel < level)
         level = temp->lightlevel;
 
+    P_MarkSectorChanged(sector);
     sector->lightlevel = level;
   }
 }
@@ -499,12 +514,14 @@ void EV_LightSetMaxNeighbor(int tag)
       if ((temp = getNextSector(sector->lines[i], sector)) && temp->lightlevel > level)
         level = temp->lightlevel;
 
+    P_MarkSectorChanged(sector);
     sector->lightlevel = level;
   }
 }
 
 void T_ZDoom_Glow(zdoom_glow_t *g)
 {
+  P_MarkSectorChanged(g->sector);
   if (g->tics++ >= g->maxtics)
   {
     if (g->oneshot)
@@ -563,6 +580,7 @@ void EV_StartLightFading(int tag, short level, short tics)
     }
     else
     {
+      P_MarkSectorChanged(sec);
       sec->lightlevel = level;
     }
   }
@@ -601,11 +619,13 @@ void T_ZDoom_Flicker(zdoom_flicker_t *g)
   }
   else if (g->sector->lightlevel == g->upper)
   {
+    P_MarkSectorChanged(g->sector);
     g->sector->lightlevel = g->lower;
     g->count = (P_Random(pr_lights) & 7) + 1;
   }
   else
   {
+    P_MarkSectorChanged(g->sector);
     g->sector->lightlevel = g->upper;
     g->count = (P_Random(pr_lights) & 31) + 1;
   }
@@ -732,6 +752,7 @@ void T_Light(light_t * light)
         light->count--;
         return;
     }
+    P_MarkSectorChanged(light->sector);
     switch (light->type)
     {
         case LITE_FADE:
@@ -826,6 +847,7 @@ dboolean EV_SpawnLight(line_t * line, byte * arg, lighttype_t type)
         light->sector = sec;
         light->count = 0;
         rtn = true;
+        P_MarkSectorChanged(sec);
         switch (type)
         {
             case LITE_RAISEBYVALUE:
@@ -927,6 +949,7 @@ static int PhaseTable[64] = {
 void T_Phase(phase_t * phase)
 {
     phase->index = (phase->index + 1) & 63;
+    P_MarkSectorChanged(phase->sector);
     phase->sector->lightlevel = phase->base + PhaseTable[phase->index];
 }
 
@@ -947,6 +970,7 @@ void P_SpawnPhasedLight(sector_t * sector, int base, int index)
         phase->index = index & 63;
     }
     phase->base = base & 255;
+    P_MarkSectorChanged(sector);
     sector->lightlevel = phase->base + PhaseTable[phase->index];
     phase->thinker.function = T_Phase;
 
@@ -971,6 +995,7 @@ void P_SpawnLightSequence(sector_t * sector, int indexStep)
     do
     {
         nextSec = NULL;
+        P_MarkSectorChanged(sec);
         sec->special = LIGHT_SEQUENCE_START;    // make sure that the search doesn't back up.
         for (i = 0; i < sec->linecount; i++)
         {
@@ -55,14 +55,14 @@
 #include "dsda/map_format.h"
 #include "dsda/mapinfo.h"
 
-static __thread mobj_t    *tmthing;
-static __thread mobj_t    *tsthing; // hexen
-static __thread fixed_t   tmx;
-static __thread fixed_t   tmy;
-static __thread int pe_x; // Pain Elemental position for Lost Soul checks // phares
-static __thread int pe_y; // Pain Elemental position for Lost Soul checks // phares
-static __thread int ls_x; // Lost Soul position for Lost Soul checks      // phares
-static __thread int ls_y; // Lost Soul position for Lost Soul checks      // phares
+static __STORAGE_MODIFIER mobj_t    *tmthing;
+static __STORAGE_MODIFIER mobj_t    *tsthing; // hexen
+static __STORAGE_MODIFIER fixed_t   tmx;
+static __STORAGE_MODIFIER fixed_t   tmy;
+static __STORAGE_MODIFIER int pe_x; // Pain Elemental position for Lost Soul checks // phares
+static __STORAGE_MODIFIER int pe_y; // Pain Elemental position for Lost Soul checks // phares
+static __STORAGE_MODIFIER int ls_x; // Lost Soul position for Lost Soul checks      // phares
+static __STORAGE_MODIFIER int ls_y; // Lost Soul position for Lost Soul checks      // phares
 
 //
 // SECTOR HEIGHT CHANGING
@@ -78,51 +78,51 @@ static __thread int ls_y; // Lost Soul position for Lost Soul checks      // pha
 //  to undo the changes.
 //
 
-static __thread int crushchange;
-static __thread dboolean nofit;
+static __STORAGE_MODIFIER int crushchange;
+static __STORAGE_MODIFIER dboolean nofit;
 
 // If "floatok" true, move would be ok
 // if within "tmfloorz - tmceilingz".
 
-__thread dboolean   floatok;
+__STORAGE_MODIFIER dboolean   floatok;
 
 /* killough 11/98: if "felldown" true, object was pushed down ledge */
-__thread dboolean   felldown;
+__STORAGE_MODIFIER dboolean   felldown;
 
 // The tm* items are used to hold information globally, usually for
 // line or object intersection checking
 
-__thread fixed_t   tmbbox[4];  // bounding box for line intersection checks
-__thread fixed_t   tmfloorz;   // floor you'd hit if free to fall
-__thread fixed_t   tmceilingz; // ceiling of sector you're in
-__thread fixed_t   tmdropoffz; // dropoff on other side of line you're crossing
+__STORAGE_MODIFIER fixed_t   tmbbox[4];  // bounding box for line intersection checks
+__STORAGE_MODIFIER fixed_t   tmfloorz;   // floor you'd hit if free to fall
+__STORAGE_MODIFIER fixed_t   tmceilingz; // ceiling of sector you're in
+__STORAGE_MODIFIER fixed_t   tmdropoffz; // dropoff on other side of line you're crossing
 
 // heretic
-__thread int tmflags;
+__STORAGE_MODIFIER int tmflags;
 
 // hexen
-__thread int tmfloorpic;
-__thread mobj_t *BlockingMobj;
+__STORAGE_MODIFIER int tmfloorpic;
+__STORAGE_MODIFIER mobj_t *BlockingMobj;
 
 // keep track of the line that lowers the ceiling,
 // so missiles don't explode against sky hack walls
 
-__thread line_t        *ceilingline;
-__thread line_t        *blockline;    /* killough 8/11/98: blocking linedef */
-__thread line_t        *floorline;    /* killough 8/1/98: Highest touched floor */
- static __thread int    tmunstuck;     /* killough 8/1/98: whether to allow unsticking */
+__STORAGE_MODIFIER line_t        *ceilingline;
+__STORAGE_MODIFIER line_t        *blockline;    /* killough 8/11/98: blocking linedef */
+__STORAGE_MODIFIER line_t        *floorline;    /* killough 8/1/98: Highest touched floor */
+ static __STORAGE_MODIFIER int    tmunstuck;     /* killough 8/1/98: whether to allow unsticking */
 
 // keep track of special lines as they are hit,
 // but don't process them until the move is proven valid
 
 // 1/11/98 killough: removed limit on special lines crossed
-__thread line_t **spechit;                // new code -- killough
-static __thread int spechit_max;          // killough
+__STORAGE_MODIFIER line_t **spechit;                // new code -- killough
+__STORAGE_MODIFIER int spechit_max;                 // killough
 
-__thread int numspechit;
+__STORAGE_MODIFIER int numspechit;
 
 // Temporary holder for thing_sectorlist threads
-__thread msecnode_t* sector_list = NULL;                             // phares 3/16/98
+__STORAGE_MODIFIER msecnode_t* sector_list = NULL;                             // phares 3/16/98
 
 //
 // TELEPORT MOVE
@@ -132,7 +132,7 @@ __thread msecnode_t* sector_list = NULL;                             // phares 3
 // PIT_StompThing
 //
 
-static __thread dboolean telefrag;   /* killough 8/9/98: whether to telefrag at exit */
+static __STORAGE_MODIFIER dboolean telefrag;   /* killough 8/9/98: whether to telefrag at exit */
 
 dboolean PIT_StompThing (mobj_t* thing)
 {
@@ -1515,11 +1515,11 @@ dboolean P_ThingHeightClip (mobj_t* thing)
 //
 
 /* killough 8/2/98: make variables static */
-static __thread fixed_t   bestslidefrac;
-static __thread line_t*   bestslideline;
-static __thread mobj_t*   slidemo;
-static __thread fixed_t   tmxmove;
-static __thread fixed_t   tmymove;
+static __STORAGE_MODIFIER fixed_t   bestslidefrac;
+static __STORAGE_MODIFIER line_t*   bestslideline;
+static __STORAGE_MODIFIER mobj_t*   slidemo;
+static __STORAGE_MODIFIER fixed_t   tmxmove;
+static __STORAGE_MODIFIER fixed_t   tmymove;
 
 //
 // P_HitSlideLine
@@ -1559,7 +1559,7 @@ void P_HitSlideLine (line_t* ld)
   }
   else
   {
-    extern __thread dboolean onground;
+    extern __STORAGE_MODIFIER dboolean onground;
     icyfloor = !compatibility &&
                variable_friction &&
                slidemo->player &&
@@ -1804,26 +1804,26 @@ void P_SlideMove(mobj_t *mo)
 //
 // P_LineAttack
 //
-__thread mobj_t*    linetarget; // who got hit (or NULL)
-__thread mobj_t*   crosshair_target;
-static __thread mobj_t*   shootthing;
+__STORAGE_MODIFIER mobj_t*    linetarget; // who got hit (or NULL)
+__STORAGE_MODIFIER mobj_t*   crosshair_target;
+static __STORAGE_MODIFIER mobj_t*   shootthing;
 
 /* killough 8/2/98: for more intelligent autoaiming */
-static __thread uint64_t aim_flags_mask;
+static __STORAGE_MODIFIER uint64_t aim_flags_mask;
 
 // Height if not aiming up or down
-__thread fixed_t   shootz;
+__STORAGE_MODIFIER fixed_t   shootz;
 
-__thread int       la_damage;
-__thread fixed_t   attackrange;
+__STORAGE_MODIFIER int       la_damage;
+__STORAGE_MODIFIER fixed_t   attackrange;
 
-static __thread fixed_t   aimslope;
+static __STORAGE_MODIFIER fixed_t   aimslope;
 
 // slopes to top and bottom of target
 // killough 4/20/98: make static instead of using ones in p_sight.c
 
-static __thread fixed_t  topslope;
-static __thread fixed_t  bottomslope;
+static __STORAGE_MODIFIER fixed_t  topslope;
+static __STORAGE_MODIFIER fixed_t  bottomslope;
 
 
 //
@@ -2170,36 +2170,31 @@ if (t1->flags2 & MF2_FEETARECLIPPED)
 // USE LINES
 //
 
-__thread mobj_t*   usething;
+__STORAGE_MODIFIER mobj_t*   usething;
 
-dboolean PTR_UseTraverse (intercept_t* in)
+// Whether the use trace goes on past a line without a special
+static dboolean P_UsePassesLine(line_t* line)
 {
-  int side;
-
-  if (!in->d.line->special)
+  if (line->flags & (ML_BLOCKEVERYTHING | ML_BLOCKUSE))
   {
-    int sound;
-
-    if (in->d.line->flags & (ML_BLOCKEVERYTHING | ML_BLOCKUSE))
-    {
-      line_opening.range = 0;
-    }
-    else
-    {
-      P_LineOpening (in->d.line, NULL);
-    }
-
-    if (line_opening.range <= 0)
-    {
+    line_opening.range = 0;
+  }
+  else
+  {
+    P_LineOpening (line, NULL);
+  }
 
-      // can't use through a wall
-      return false;
-    }
+  // can't use through a wall
+  return line_opening.range > 0;
+}
 
-    // not a special line, but keep checking
+dboolean PTR_UseTraverse (intercept_t* in)
+{
+  int side;
 
-    return true;
-  }
+  // not a special line, but keep checking
+  if (!in->d.line->special)
+    return P_UsePassesLine(in->d.line);
 
   side = 0;
   if (P_PointOnLineSide (usething->x, usething->y, in->d.line) == 1)
@@ -2273,11 +2268,69 @@ void P_UseLines (player_t*  player)
 }
 
 
+//
+// P_UseLinesInRange
+// Whether P_UseLines, with the player facing the given angle, would reach a
+// special line. It only looks for one, so the line may still not react.
+// The trace is undone afterwards, so probing leaves the game state untouched.
+//
+
+static __STORAGE_MODIFIER dboolean use_probe_hit;
+
+static dboolean PTR_UseProbeTraverse(intercept_t* in)
+{
+  if (!in->d.line->special)
+    return P_UsePassesLine(in->d.line);
+
+  // P_UseSpecialLine ignores the back side, see PTR_UseTraverse
+  if (compatibility_level != boom_201_compatibility &&
+      P_PointOnLineSide(usething->x, usething->y, in->d.line) == 1)
+    return !demo_compatibility && (in->d.line->flags & ML_PASSUSE);
+
+  use_probe_hit = true;
+  return false;
+}
+
+dboolean P_UseLinesInRange(player_t* player, angle_t angle)
+{
+  int     fineangle = angle >> ANGLETOFINESHIFT;
+  fixed_t x1 = player->mo->x;
+  fixed_t y1 = player->mo->y;
+  fixed_t x2 = x1 + (USERANGE>>FRACBITS)*finecosine[fineangle];
+  fixed_t y2 = y1 + (USERANGE>>FRACBITS)*finesine[fineangle];
+  mobj_t* oldusething = usething;
+  int oldvalidcount = validcount;
+  divline_t oldtrace = trace;
+  line_opening_t oldline_opening = line_opening;
+  int oldtmfloorpic = tmfloorpic;
+  size_t oldintercepts = intercept_p - intercepts;
+  dboolean hit;
+
+  usething = player->mo;
+  use_probe_hit = false;
+  P_PathTraverse(x1, y1, x2, y2, PT_ADDLINES | PT_KEEPMARKS, PTR_UseProbeTraverse);
+  hit = use_probe_hit;
+
+  // The intercepts themselves are only read during a traversal, which starts
+  // them over, so only where the list ended is put back
+  P_RestoreLineMarks();
+  validcount = oldvalidcount;
+  trace = oldtrace;
+  line_opening = oldline_opening;
+  tmfloorpic = oldtmfloorpic;
+  intercept_p = intercepts + oldintercepts;
+  usething = oldusething;
+  use_probe_hit = false;
+
+  return hit;
+}
+
+
 //
 // RADIUS ATTACK
 //
 
-__thread bomb_t bomb;
+__STORAGE_MODIFIER bomb_t bomb;
 
 //
 // PIT_RadiusAttack
@@ -2491,7 +2544,7 @@ dboolean PIT_ChangeSector (mobj_t* thing)
 
   nofit = true;
 
-  if (crushchange > 0 && !(leveltime & 3)) {
+  if (crushchange > 0 && !(engine_context->leveltime & 3)) {
     int t;
 
     P_DamageMobj(thing, NULL, NULL, crushchange);
@@ -2647,7 +2700,7 @@ inline static void P_PutSecnode(msecnode_t* node)
 //
 // Maintain a freelist of msecnode_t's to reduce memory allocs and frees.
 
-msecnode_t *headsecnode = NULL;
+__STORAGE_MODIFIER msecnode_t *headsecnode = NULL;
 
 //
 // P_FreeSecNodeList
@@ -2937,7 +2990,7 @@ void P_MapEnd(void) {
 	tmthing = NULL;
 }
 
-__thread mobj_t *onmobj; // generic global onmobj...used for landing on pods/players
+__STORAGE_MODIFIER mobj_t *onmobj; // generic global onmobj...used for landing on pods/players
 
 dboolean P_TestMobjLocation(mobj_t * mobj)
 {
@@ -3076,9 +3129,9 @@ void P_FakeZMovement(mobj_t * mo)
         }
     }
     if (mo->player && mo->flags2 & MF2_FLY && !(mo->z <= mo->floorz)
-        && leveltime & 2)
+        && engine_context->leveltime & 2)
     {
-        mo->z += finesine[(FINEANGLES / 20 * leveltime >> 2) & FINEMASK];
+        mo->z += finesine[(FINEANGLES / 20 * engine_context->leveltime >> 2) & FINEMASK];
     }
 
 //
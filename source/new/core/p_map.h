@@ -74,9 +74,10 @@ void    P_SlideMove(mobj_t *mo);
 dboolean P_CheckSight(mobj_t *t1, mobj_t *t2);
 dboolean P_CheckFov(mobj_t *t1, mobj_t *t2, angle_t fov);
 void    P_UseLines(player_t *player);
+dboolean P_UseLinesInRange(player_t *player, angle_t angle);
 
 typedef dboolean (*CrossSubsectorFunc)(int num);
-extern __thread CrossSubsectorFunc P_CrossSubsector;
+extern __STORAGE_MODIFIER CrossSubsectorFunc P_CrossSubsector;
 dboolean P_CrossSubsector_Doom(int num);
 dboolean P_CrossSubsector_Boom(int num);
 dboolean P_CrossSubsector_PrBoom(int num);
@@ -115,17 +116,17 @@ void	P_MapStart(void);
 void	P_MapEnd(void);
 
 // If "floatok" true, move would be ok if within "tmfloorz - tmceilingz".
-extern __thread dboolean floatok;
-extern __thread dboolean felldown;   // killough 11/98: indicates object pushed off ledge
-extern __thread fixed_t tmfloorz;
-extern __thread fixed_t tmceilingz;
-extern __thread line_t *ceilingline;
-extern __thread line_t *floorline;      // killough 8/23/98
-extern __thread mobj_t *linetarget;     // who got hit (or NULL)
-extern __thread mobj_t *crosshair_target;
-extern __thread msecnode_t *sector_list;                             // phares 3/16/98
-extern __thread fixed_t tmbbox[4];         // phares 3/20/98
-extern __thread line_t *blockline;   // killough 8/11/98
+extern __STORAGE_MODIFIER dboolean floatok;
+extern __STORAGE_MODIFIER dboolean felldown;   // killough 11/98: indicates object pushed off ledge
+extern __STORAGE_MODIFIER fixed_t tmfloorz;
+extern __STORAGE_MODIFIER fixed_t tmceilingz;
+extern __STORAGE_MODIFIER line_t *ceilingline;
+extern __STORAGE_MODIFIER line_t *floorline;      // killough 8/23/98
+extern __STORAGE_MODIFIER mobj_t *linetarget;     // who got hit (or NULL)
+extern __STORAGE_MODIFIER mobj_t *crosshair_target;
+extern __STORAGE_MODIFIER msecnode_t *sector_list;                             // phares 3/16/98
+extern __STORAGE_MODIFIER fixed_t tmbbox[4];         // phares 3/20/98
+extern __STORAGE_MODIFIER line_t *blockline;   // killough 8/11/98
 
 // heretic
 
@@ -137,8 +138,8 @@ void P_AppendSpecHit(line_t * ld);
 
 // hexen
 
-extern __thread int tmfloorpic;
-extern __thread mobj_t *BlockingMobj;
+extern __STORAGE_MODIFIER int tmfloorpic;
+extern __STORAGE_MODIFIER mobj_t *BlockingMobj;
 
 void P_BounceWall(mobj_t * mo);
 dboolean P_UsePuzzleItem(player_t * player, int itemType);
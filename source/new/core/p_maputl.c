@@ -47,6 +47,7 @@
 #include "e6y.h"//e6y
 
 #include "dsda/map_format.h"
+#include "p_hash.h"
 
 //
 // P_AproxDistance
@@ -85,7 +86,7 @@ int PUREFUNC P_ZDoomPointOnLineSide(fixed_t x, fixed_t y, const line_t *line)
     ((long long) y - line->v1->y) * line->dx >= ((long long) x - line->v1->x) * line->dy;
 }
 
-__thread int (*P_PointOnLineSide)(fixed_t x, fixed_t y, const line_t *line);
+__STORAGE_MODIFIER int (*P_PointOnLineSide)(fixed_t x, fixed_t y, const line_t *line);
 
 //
 // P_BoxOnLineSide
@@ -143,7 +144,7 @@ int PUREFUNC P_ZDoomPointOnDivlineSide(fixed_t x, fixed_t y, const divline_t *li
     (long long) y * line->dx >= (long long) x * line->dy;
 }
 
-__thread int (*P_PointOnDivlineSide)(fixed_t x, fixed_t y, const divline_t *line);
+__STORAGE_MODIFIER int (*P_PointOnDivlineSide)(fixed_t x, fixed_t y, const divline_t *line);
 
 //
 // P_MakeDivline
@@ -196,7 +197,7 @@ fixed_t PUREFUNC P_InterceptVector(const divline_t *v2, const divline_t *v1)
 // OPTIMIZE: keep this precalculated
 //
 
-__thread line_opening_t line_opening;
+__STORAGE_MODIFIER line_opening_t line_opening;
 
 dboolean P_GetMidTexturePosition(const line_t *line, int sideno, fixed_t *top, fixed_t *bottom)
 {
@@ -265,7 +266,7 @@ void P_LineOpening_3dMidtex(const line_t *line, const mobj_t *actor)
 
 void P_LineOpening(const line_t *linedef, const mobj_t *actor)
 {
-  extern __thread int tmfloorpic;
+  extern __STORAGE_MODIFIER int tmfloorpic;
 
   if (linedef->sidenum[1] == NO_INDEX)      // single sided line
   {
@@ -319,6 +320,9 @@ void P_LineOpening(const line_t *linedef, const mobj_t *actor)
 
 void P_UnsetThingPosition (mobj_t *thing)
 {
+  if (world_hash_tracked)
+    P_UnhashMobj(thing);
+
   if (!(thing->flags & MF_NOSECTOR))
     {
       /* invisible things don't need to be in sector list
@@ -435,6 +439,9 @@ void P_SetThingPosition(mobj_t *thing, int refind)
       else        // thing is off the map
         thing->bnext = NULL, thing->bprev = NULL;
     }
+
+  if (world_hash_tracked)
+    P_HashMobj(thing);
 }
 
 //
@@ -555,13 +562,13 @@ dboolean P_BlockThingsIterator(int x, int y, dboolean func(mobj_t*))
 //
 
 // 1/11/98 killough: Intercept limit removed
-__thread intercept_t *intercepts = 0;
-__thread intercept_t *intercept_p = 0;
+__STORAGE_MODIFIER intercept_t *intercepts = 0;
+__STORAGE_MODIFIER intercept_t *intercept_p = 0;
+__STORAGE_MODIFIER size_t num_intercepts = 0;
 
 // Check for limit and double size if necessary -- killough
 void check_intercept(void)
 {
-  static __thread size_t num_intercepts = 0;
   size_t offset = intercept_p - intercepts;
   if (offset >= num_intercepts)
     {
@@ -571,7 +578,53 @@ void check_intercept(void)
     }
 }
 
-__thread divline_t trace;
+__STORAGE_MODIFIER divline_t trace;
+
+__STORAGE_MODIFIER line_mark_t *line_marks = 0;
+__STORAGE_MODIFIER int line_marks_max = 0;
+static __STORAGE_MODIFIER int line_marks_count = 0;
+
+// Logs the marks of a block's lines that P_BlockLinesIterator is about to change
+static void P_KeepBlockLineMarks(int x, int y)
+{
+  const int *list;
+
+  if (x<0 || y<0 || x>=bmapwidth || y>=bmapheight)
+    return;
+
+  // same list as P_BlockLinesIterator
+  list = blockmaplump + blockmap[y*bmapwidth+x];
+  if ((!demo_compatibility && !mbf21) || (mbf21 && skipblstart))
+    list++;
+
+  for ( ; *list != -1 ; list++)
+    {
+      line_t *ld = &lines[*list];
+
+      if (ld->validcount == validcount)
+        continue;
+
+      if (line_marks_count == line_marks_max)
+        {
+          line_marks_max = line_marks_max ? line_marks_max*2 : 64;
+          line_marks = Z_Realloc(line_marks, sizeof(*line_marks)*line_marks_max);
+        }
+
+      line_marks[line_marks_count].line = ld;
+      line_marks[line_marks_count].validcount = ld->validcount;
+      line_marks_count++;
+    }
+}
+
+// Puts back, newest first, the line marks logged by a PT_KEEPMARKS traversal
+void P_RestoreLineMarks(void)
+{
+  while (line_marks_count > 0)
+    {
+      line_marks_count--;
+      line_marks[line_marks_count].line->validcount = line_marks[line_marks_count].validcount;
+    }
+}
 
 // PIT_AddLineIntercepts.
 // Looks for lines in the given block
@@ -810,8 +863,13 @@ dboolean P_PathTraverse(fixed_t x1, fixed_t y1, fixed_t x2, fixed_t y2,
   for (count = 0; count < 64; count++)
     {
       if (flags & PT_ADDLINES)
-        if (!P_BlockLinesIterator(mapx, mapy,PIT_AddLineIntercepts))
-          return false; // early out
+        {
+          if (flags & PT_KEEPMARKS)
+            P_KeepBlockLineMarks(mapx, mapy);
+
+          if (!P_BlockLinesIterator(mapx, mapy,PIT_AddLineIntercepts))
+            return false; // early out
+        }
 
       if (flags & PT_ADDTHINGS)
         if (!P_BlockThingsIterator(mapx, mapy,PIT_AddThingIntercepts))
@@ -1043,9 +1101,9 @@ int P_GetSafeBlockY(int coord)
 // playerstarts, which is effectively an array of 16-bit integers and
 // must be treated differently.
 
-extern __thread fixed_t bulletslope;
+extern __STORAGE_MODIFIER fixed_t bulletslope;
 
-__thread intercepts_overrun_t intercepts_overrun[] =
+__STORAGE_MODIFIER intercepts_overrun_t intercepts_overrun[] =
 {
   {4,   NULL,                          NULL},
   {4,   NULL, /* &earlyout, */         NULL},
@@ -46,6 +46,7 @@
 #define PT_ADDLINES     1
 #define PT_ADDTHINGS    2
 #define PT_EARLYOUT     4
+#define PT_KEEPMARKS    8 // log the line marks it changes, see P_RestoreLineMarks
 
 typedef struct {
   fixed_t top;
@@ -81,19 +82,29 @@ fixed_t CONSTFUNC P_AproxDistance (fixed_t dx, fixed_t dy);
 
 int PUREFUNC P_CompatiblePointOnLineSide(fixed_t x, fixed_t y, const line_t *line);
 int PUREFUNC P_ZDoomPointOnLineSide(fixed_t x, fixed_t y, const line_t *line);
-extern __thread int (*P_PointOnLineSide)(fixed_t x, fixed_t y, const line_t *line);
+extern __STORAGE_MODIFIER int (*P_PointOnLineSide)(fixed_t x, fixed_t y, const line_t *line);
 
 int     PUREFUNC  P_BoxOnLineSide (const fixed_t *tmbox, const line_t *ld);
 fixed_t PUREFUNC  P_InterceptVector (const divline_t *v2, const divline_t *v1);
 /* cph - old compatibility version below */
 fixed_t PUREFUNC  P_InterceptVector2(const divline_t *v2, const divline_t *v1);
 
-extern __thread intercept_t *intercepts, *intercept_p;
+extern __STORAGE_MODIFIER intercept_t *intercepts, *intercept_p;
+
+// A line's validcount before P_PathTraverse marked it
+typedef struct {
+  line_t *line;
+  int validcount;
+} line_mark_t;
+
+extern __STORAGE_MODIFIER line_mark_t *line_marks;
+extern __STORAGE_MODIFIER int line_marks_max;
+void P_RestoreLineMarks(void);
 void P_MakeDivline(const line_t *li, divline_t *dl);
 
 int PUREFUNC P_CompatiblePointOnDivlineSide(fixed_t x, fixed_t y, const divline_t *line);
 int PUREFUNC P_ZDoomPointOnDivlineSide(fixed_t x, fixed_t y, const divline_t *line);
-extern __thread int (*P_PointOnDivlineSide)(fixed_t x, fixed_t y, const divline_t *line);
+extern __STORAGE_MODIFIER int (*P_PointOnDivlineSide)(fixed_t x, fixed_t y, const divline_t *line);
 
 void check_intercept(void);
 
@@ -113,8 +124,8 @@ mobj_t *P_RoughTargetSearch(mobj_t *mo, angle_t fov, int distance);
 int P_GetSafeBlockX(int coord);
 int P_GetSafeBlockY(int coord);
 
-extern __thread line_opening_t line_opening;
-extern __thread divline_t trace;
+extern __STORAGE_MODIFIER line_opening_t line_opening;
+extern __STORAGE_MODIFIER divline_t trace;
 
 dboolean P_GetMidTexturePosition(const line_t *line, int sideno, fixed_t *top, fixed_t *bottom);
 
@@ -46,6 +46,7 @@
 #include "lprintf.h"
 #include "p_enemy.h"
 #include "p_spec.h"
+#include "p_hash.h"
 #include "g_overflow.h"
 #include "e6y.h"//e6y
 
@@ -74,9 +75,9 @@ dboolean P_SetMobjState(mobj_t* mobj,statenum_t state)
 
   // killough 4/9/98: remember states seen, to detect cycles:
 
-  extern __thread statenum_t* seenstate_tab;           // fast transition table
+  extern __STORAGE_MODIFIER statenum_t* seenstate_tab;           // fast transition table
   statenum_t *seenstate;                      // pointer to table
-  static __thread int recursion;                       // detects recursion
+  static __STORAGE_MODIFIER int recursion;                       // detects recursion
   statenum_t i;                               // initial state
   dboolean ret;                               // return value
   statenum_t* tempstate = NULL;               // for use with recursion
@@ -103,6 +104,7 @@ dboolean P_SetMobjState(mobj_t* mobj,statenum_t state)
     mobj->tics = st->tics;
     mobj->sprite = st->sprite;
     mobj->frame = st->frame;
+    P_RehashMobj(mobj);
 
     // Modified handling.
     // Call action functions when the state is set
@@ -640,14 +642,14 @@ floater:
 
   if (mo->player && (mo->flags & MF_FLY) && (mo->z > mo->floorz))
   {
-    mo->z += finesine[(FINEANGLES/80*gametic)&FINEMASK]/8;
+    mo->z += finesine[(FINEANGLES/80*engine_context->gametic)&FINEMASK]/8;
     mo->momz = FixedMul (mo->momz, FRICTION_FLY);
   }
 
   if (mo->player && mo->flags2 & MF2_FLY && !(mo->z <= mo->floorz)
-      && leveltime & 2)
+      && engine_context->leveltime & 2)
   {
-      mo->z += finesine[(FINEANGLES / 20 * leveltime >> 2) & FINEMASK];
+      mo->z += finesine[(FINEANGLES / 20 * engine_context->leveltime >> 2) & FINEMASK];
   }
 
   // clip movement
@@ -935,6 +937,7 @@ void P_MobjThinker (mobj_t* mobj)
   if (mobj->flags2 & MF2_FLOATBOB)
   {                           // Floating item bobbing motion
       mobj->z = mobj->floorz + FloatBobOffsets[(mobj->health++) & 63];
+      P_RehashMobj(mobj);
   }
   else if (mobj->z != mobj->floorz || mobj->momz || BlockingMobj)
   {
@@ -1061,7 +1064,7 @@ void P_MobjThinker (mobj_t* mobj)
     if (mobj->movecount < skill_info.respawn_time * 35)
       return;
 
-    if (leveltime & 31)
+    if (engine_context->leveltime & 31)
       return;
 
     if (P_Random(pr_respawn) > 4)
@@ -1110,7 +1113,7 @@ static dboolean P_IsTypeMatch(unsigned doomednum, int type)
 
 static PUREFUNC int P_FindDoomedNum(unsigned type)
 {
-  static __thread struct { int first, next; } *hash;
+  static __STORAGE_MODIFIER struct { int first, next; } *hash;
   register int i = 0;
 
   if (!hash)
@@ -1307,6 +1310,88 @@ int P_MobjSpawnHealth(const mobj_t* mobj)
   return mobj->info->spawnhealth;
 }
 
+//
+// Persistent mobj ids
+//
+// Every mobj holds a slot in mobj_ids from the moment it is spawned until it
+// is removed and no longer referenced, i.e. for as long as it is archived.
+// The archive code refers to mobjs by these ids instead of numbering the
+// thinker list on every save. The lowest free slot is always handed out, so
+// the ids a run assigns do not depend on whether a state was loaded on the
+// way, and no free list needs to be saved.
+//
+
+__STORAGE_MODIFIER mobj_t **mobj_ids;
+__STORAGE_MODIFIER int mobj_ids_end = 1;            // one past the highest slot in use so far
+static __STORAGE_MODIFIER int mobj_ids_capacity;
+static __STORAGE_MODIFIER int mobj_ids_free = 1;    // no free slot below this one
+
+static void P_ReserveMobjIds(int count)
+{
+  int capacity = mobj_ids_capacity ? mobj_ids_capacity : 256;
+
+  if (count <= mobj_ids_capacity)
+    return;
+
+  while (capacity < count)
+    capacity *= 2;
+
+  mobj_ids = Z_ReallocLevel(mobj_ids, capacity * sizeof(*mobj_ids));
+  memset(mobj_ids + mobj_ids_capacity, 0, (capacity - mobj_ids_capacity) * sizeof(*mobj_ids));
+  mobj_ids_capacity = capacity;
+}
+
+// Called once the level zone has been freed
+void P_InitMobjIds(void)
+{
+  mobj_ids = NULL;
+  mobj_ids_capacity = 0;
+  mobj_ids_end = mobj_ids_free = 1;
+}
+
+// Empties the table, keeping room for ids below end
+void P_ClearMobjIds(int end)
+{
+  P_ReserveMobjIds(end);
+  memset(mobj_ids, 0, mobj_ids_capacity * sizeof(*mobj_ids));
+  mobj_ids_end = end > 1 ? end : 1;
+  mobj_ids_free = 1;
+}
+
+void P_AssignMobjId(mobj_t *mobj)
+{
+  int id = mobj_ids_free;
+
+  while (id < mobj_ids_end && mobj_ids[id])
+    id++;
+
+  if (id == mobj_ids_end)
+  {
+    P_ReserveMobjIds(id + 1);
+    mobj_ids_end++;
+  }
+
+  mobj_ids[id] = mobj;
+  mobj->id = id;
+  mobj_ids_free = id + 1;
+  P_RehashMobj(mobj);
+}
+
+void P_ReleaseMobjId(mobj_t *mobj)
+{
+  int id = mobj->id;
+
+  if (id > 0 && id < mobj_ids_end && mobj_ids[id] == mobj)
+  {
+    mobj_ids[id] = NULL;
+    if (id < mobj_ids_free)
+      mobj_ids_free = id;
+  }
+
+  mobj->id = 0;
+  P_RehashMobj(mobj);
+}
+
 //
 // P_SpawnMobj
 //
@@ -1389,6 +1474,7 @@ mobj_t* P_SpawnMobj(fixed_t x,fixed_t y,fixed_t z,mobjtype_t type)
 
   mobj->target = mobj->tracer = mobj->lastenemy = NULL;
   P_AddThinker(&mobj->thinker);
+  P_AssignMobjId(mobj);
   if (!((mobj->flags ^ MF_COUNTKILL) & (MF_FRIEND | MF_COUNTKILL)))
     totallive++;
 
@@ -1396,10 +1482,10 @@ mobj_t* P_SpawnMobj(fixed_t x,fixed_t y,fixed_t z,mobjtype_t type)
 }
 
 
-static __thread mapthing_t itemrespawnque[ITEMQUESIZE];
-static __thread int        itemrespawntime[ITEMQUESIZE];
-__thread int        iquehead;
-__thread int        iquetail;
+static __STORAGE_MODIFIER mapthing_t itemrespawnque[ITEMQUESIZE];
+static __STORAGE_MODIFIER int        itemrespawntime[ITEMQUESIZE];
+__STORAGE_MODIFIER int        iquehead;
+__STORAGE_MODIFIER int        iquetail;
 
 
 //
@@ -1415,7 +1501,7 @@ void P_RemoveMobj (mobj_t* mobj)
       && (mobj->type != MT_INS))
     {
     itemrespawnque[iquehead] = mobj->spawnpoint;
-    itemrespawntime[iquehead] = leveltime;
+    itemrespawntime[iquehead] = engine_context->leveltime;
     iquehead = (iquehead+1)&(ITEMQUESIZE-1);
 
     // lose one off the end?
@@ -1459,6 +1545,11 @@ void P_RemoveMobj (mobj_t* mobj)
   // free block
 
   P_RemoveThinker (&mobj->thinker);
+
+  // Still referenced mobjs keep their id until P_SetTarget drops the last
+  // reference, since they are archived until then
+  if (!mobj->thinker.references)
+    P_ReleaseMobjId(mobj);
 }
 
 
@@ -1513,7 +1604,7 @@ void P_RespawnSpecials (void)
 
   // wait at least 30 seconds
 
-  if (leveltime - itemrespawntime[iquetail] < 30*35)
+  if (engine_context->leveltime - itemrespawntime[iquetail] < 30*35)
     return;
 
   mthing = &itemrespawnque[iquetail];
@@ -1572,10 +1663,10 @@ void P_SpawnPlayer (int n, const mapthing_t* mthing)
 
   // not playing?
 
-  if (!playeringame[n])
+  if (!engine_context->playeringame[n])
     return;
 
-  p = &players[n];
+  p = &engine_context->players[n];
 
   if (p->playerstate == PST_REBORN)
     G_PlayerReborn (n);
@@ -1808,7 +1899,7 @@ mobj_t* P_SpawnMapThing (const mapthing_t* mthing, int index)
       {
         num_deathmatchstarts = num_deathmatchstarts ?
                                num_deathmatchstarts * 2 : 16;
-        deathmatchstarts = Z_Realloc(deathmatchstarts,
+        deathmatchstarts = Z_ReallocLevel(deathmatchstarts,
                                    num_deathmatchstarts *
                                    sizeof(*deathmatchstarts));
         deathmatch_p = deathmatchstarts + offset;
@@ -1831,10 +1922,10 @@ mobj_t* P_SpawnMapThing (const mapthing_t* mthing, int index)
     if (
       !netgame &&
       player > 0 && player <= dogs &&
-      !players[player].secretcount
+      !engine_context->players[player].secretcount
     )
     {  // use secretcount to avoid multiple dogs in case of multiple starts
-      players[player].secretcount = 1;
+      engine_context->players[player].secretcount = 1;
 
       // killough 10/98: force it to be a friend
       options |= (map_format.zdoom ? MTF_FRIENDLY : MTF_FRIEND);
@@ -1944,6 +2035,8 @@ spawnit:
     mobj->health = P_Random(pr_heretic);
   }
 
+  P_RehashMobj(mobj);
+
   if (mobj->tics > 0)
     mobj->tics = 1 + (P_Random(pr_spawnthing) % mobj->tics);
 
@@ -1987,7 +2080,7 @@ spawnit:
 // P_SpawnPuff
 //
 
-extern __thread fixed_t attackrange;
+extern __STORAGE_MODIFIER fixed_t attackrange;
 
 void P_SpawnPuff(fixed_t x,fixed_t y,fixed_t z)
 {
@@ -2053,6 +2146,7 @@ dboolean P_CheckMissileSpawn (mobj_t* th)
     th->x += (th->momx>>1);
     th->y += (th->momy>>1);
     th->z += (th->momz>>1);
+    P_RehashMobj(th);
 
   // killough 8/12/98: for non-missile objects (e.g. grenades)
   if (!(th->flags & MF_MISSILE) && mbf_features)
@@ -2159,8 +2253,8 @@ mobj_t* P_SpawnPlayerMissile(mobj_t* source, mobjtype_t type)
 
 #include "p_spec.h"
 
-__thread mobjtype_t PuffType;
-__thread mobj_t *MissileMobj;
+__STORAGE_MODIFIER mobjtype_t PuffType;
+__STORAGE_MODIFIER mobj_t *MissileMobj;
 
 void P_BlasterMobjThinker(mobj_t * mobj)
 {
@@ -2259,6 +2353,7 @@ dboolean P_SetMobjStateNF(mobj_t * mobj, statenum_t state)
     mobj->tics = st->tics;
     mobj->sprite = st->sprite;
     mobj->frame = st->frame;
+    P_RehashMobj(mobj);
     return (true);
 }
 
@@ -274,6 +274,9 @@ typedef struct
 /* cph 2006/08/28 - move Prev[XYZ] fields to the end of the struct. Add any
  * other new fields to the end, and make sure you don't break savegames! */
 
+// Fields of a mobj that go into the world hash, packed in 64 bit words (see p_hash.c)
+#define MOBJ_HASH_WORDS 7
+
 typedef struct mobj_s
 {
     // List: thinker links.
@@ -389,6 +392,14 @@ typedef struct mobj_s
     // zdoom
     fixed_t gravity;
 
+    // Slot in mobj_ids, held while the mobj can be referenced; 0 if none
+    int id;
+
+    // Contribution to the world hash while linked, 0 otherwise (see p_hash.h),
+    // and the fields it was last computed from
+    uint64_t hash[2];
+    uint64_t hash_words[MOBJ_HASH_WORDS];
+
     // SEE WARNING ABOVE ABOUT POINTER FIELDS!!!
 } mobj_t;
 
@@ -416,8 +427,8 @@ typedef struct mobj_s
 // Whether an object is "sentient" or not. Used for environmental influences.
 #define sentient(mobj) ((mobj)->health > 0 && (mobj)->info->seestate)
 
-extern __thread int iquehead;
-extern __thread int iquetail;
+extern __STORAGE_MODIFIER int iquehead;
+extern __STORAGE_MODIFIER int iquetail;
 
 int P_MobjSpawnHealth(const mobj_t* mobj);
 mobj_t* P_SubstNullMobj (mobj_t* th);
@@ -436,6 +447,14 @@ void    P_SpawnPlayer(int n, const mapthing_t *mthing);
 dboolean P_CheckMissileSpawn(mobj_t*);  // killough 8/2/98
 void    P_ExplodeMissile(mobj_t*);    // killough
 void P_RemoveMobjSP (mobj_t* mobj);
+
+// Persistent mobj ids, used by the archive code to refer to mobjs
+extern __STORAGE_MODIFIER mobj_t **mobj_ids;
+extern __STORAGE_MODIFIER int mobj_ids_end;
+void P_InitMobjIds(void);
+void P_ClearMobjIds(int end);
+void P_AssignMobjId(mobj_t *mobj);
+void P_ReleaseMobjId(mobj_t *mobj);
 void P_RemoveMonsters(void);
 
 // heretic
@@ -513,7 +532,7 @@ void P_RemoveMonsters(void);
 #define AMMO_MACE_WIMPY 20
 #define AMMO_MACE_HEFTY 100
 
-extern __thread mobj_t* MissileMobj;
+extern __STORAGE_MODIFIER mobj_t* MissileMobj;
 
 void P_BlasterMobjThinker(mobj_t * mobj);
 mobj_t *P_SpawnMissileAngle(mobj_t * source, mobjtype_t type, angle_t angle, fixed_t momz);
@@ -36,6 +36,7 @@
 #include "r_main.h"
 #include "p_spec.h"
 #include "p_tick.h"
+#include "p_saveg.h"
 #include "sounds.h"
 #include "lprintf.h"
 #include "e6y.h"//e6y
@@ -43,7 +44,7 @@
 #include "dsda/id_list.h"
 #include "dsda/map_format.h"
 
-__thread platlist_t *activeplats;       // killough 2/14/98: made global again
+__STORAGE_MODIFIER platlist_t *activeplats;       // killough 2/14/98: made global again
 
 //
 // T_PlatRaise()
@@ -82,7 +83,7 @@ void T_CompatiblePlatRaise(plat_t * plat)
           lprintf(LO_WARN, "T_PlatRaise: raise-and-change type has reversed "
                   "direction in compatibility mode - may lead to desync\n"
                   " gametic: %d sector: %d complevel: %d\n",
-                  gametic, plat->sector->iSectorID, compatibility_level);
+                  engine_context->gametic, plat->sector->iSectorID, compatibility_level);
         }
       }
       else  // else handle reaching end of up stroke
@@ -347,7 +348,10 @@ int EV_DoZDoomPlat(int tag, line_t *line, plattype_e type, fixed_t height,
     if (change)
     {
       if (line)
+      {
+        P_MarkSectorChanged(sec);
         sec->floorpic = sides[line->sidenum[0]].sector->floorpic;
+      }
       if (change == 1)
         P_ResetSectorSpecial(sec);
     }
@@ -479,6 +483,7 @@ int EV_DoPlat
     {
       case raiseToNearestAndChange:
         plat->speed = PLATSPEED/2;
+        P_MarkSectorChanged(sec);
         sec->floorpic = sides[line->sidenum[0]].sector->floorpic;
         plat->high = P_FindNextHighestFloor(sec,sec->floorheight);
         plat->wait = 0;
@@ -489,6 +494,7 @@ int EV_DoPlat
 
       case raiseAndChange:
         plat->speed = PLATSPEED/2;
+        P_MarkSectorChanged(sec);
         sec->floorpic = sides[line->sidenum[0]].sector->floorpic;
         plat->high = sec->floorheight + amount*FRACUNIT;
         plat->wait = 0;
@@ -649,7 +655,7 @@ int EV_StopPlat(line_t* line)
 //
 void P_AddActivePlat(plat_t* plat)
 {
-  platlist_t *list = Z_Malloc(sizeof *list);
+  platlist_t *list = Z_MallocLevel(sizeof *list);
   list->plat = plat;
   plat->list = list;
   if ((list->next = activeplats))
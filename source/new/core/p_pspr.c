@@ -40,6 +40,7 @@
 #include "p_user.h"
 #include "p_enemy.h"
 #include "p_tick.h"
+#include "p_hash.h"
 #include "m_random.h"
 #include "sounds.h"
 #include "d_event.h"
@@ -169,7 +170,7 @@ static void P_BringUpWeapon(player_t *player)
 // in DOOM2 to bring up the weapon, i.e. 6 = plasma gun. These    //    |
 // are NOT the wp_* constants.                                    //    V
 
-__thread int weapon_preferences[2][NUMWEAPONS+1] = {
+__STORAGE_MODIFIER int weapon_preferences[2][NUMWEAPONS+1] = {
   {6, 9, 4, 3, 2, 8, 5, 7, 1, 0},  // !compatibility preferences
   {6, 9, 4, 3, 2, 8, 5, 7, 1, 0},  //  compatibility preferences
 };
@@ -511,7 +512,7 @@ void A_WeaponReady(player_t *player, pspdef_t *psp)
   // bob the weapon based on movement speed
   if (!player->morphTics)
   {
-    int angle = (128 * leveltime) & FINEMASK;
+    int angle = (128 * engine_context->leveltime) & FINEMASK;
     psp->sx = FRACUNIT + FixedMul(player->bob, finecosine[angle]);
     angle &= FINEANGLES / 2 - 1;
     psp->sy = WEAPONTOP + FixedMul(player->bob, finesine[angle]);
@@ -544,7 +545,7 @@ void A_ReFire(player_t *player, pspdef_t *psp)
     }
 }
 
-__thread dboolean boom_weapon_state_injection;
+__STORAGE_MODIFIER dboolean boom_weapon_state_injection;
 
 void A_CheckReload(player_t *player, pspdef_t *psp)
 {
@@ -798,7 +799,7 @@ void A_FireBFG(player_t *player, pspdef_t *psp)
 // This code may not be used in other mods without appropriate credit given.
 // Code leeches will be telefragged.
 
-__thread int autoaim = 0;  // killough 7/19/98: autoaiming was not in original beta
+__STORAGE_MODIFIER int autoaim = 0;  // killough 7/19/98: autoaiming was not in original beta
 void A_FireOldBFG(player_t *player, pspdef_t *psp)
 {
   int type = MT_PLASMA1;
@@ -822,7 +823,7 @@ void A_FireOldBFG(player_t *player, pspdef_t *psp)
     angle_t an = mo->angle;
     angle_t an1 = ((P_Random(pr_bfg)&127) - 64) * (ANG90/768) + an;
     angle_t an2 = ((P_Random(pr_bfg)&127) - 64) * (ANG90/640) + ANG90;
-    extern __thread int autoaim;
+    extern __STORAGE_MODIFIER int autoaim;
 
     if (autoaim/* || !beta_emulation*/)
     {
@@ -876,7 +877,7 @@ void A_FirePlasma(player_t *player, pspdef_t *psp)
 //
 
 //e6y static
-__thread fixed_t bulletslope;
+__STORAGE_MODIFIER fixed_t bulletslope;
 
 static void P_BulletSlope(mobj_t *mo)
 {
@@ -1115,6 +1116,7 @@ void A_WeaponProjectile(player_t *player, pspdef_t *psp)
   mo->x += FixedMul(spawnofs_xy, finecosine[an]);
   mo->y += FixedMul(spawnofs_xy, finesine[an]);
   mo->z += spawnofs_z;
+  P_RehashMobj(mo);
 
   // set tracer to the player's autoaim target,
   // so player seeker missiles prioritizing the
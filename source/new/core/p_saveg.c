@@ -45,74 +45,95 @@
 #include "e6y.h"//e6y
 
 #include "dsda/map_format.h"
+#include "dsda/mapinfo.h"
+#include "dsda/save.h"
 #include "dsda/scroll.h"
 #include "dsda/utility.h"
 
 #define MARKED_FOR_DELETION -2
 
-#define SAVEGAMESIZE 0x20000
+__STORAGE_MODIFIER byte *save_p;
+__STORAGE_MODIFIER byte *savebuffer;
+__STORAGE_MODIFIER size_t save_size;
 
-__thread byte *save_p;
-__thread byte *savebuffer;
-static __thread int savegamesize;
+void P_ForgetSaveBuffer(void)
+{
+  save_p = savebuffer = NULL;
+}
 
-// Check for overrun and realloc if necessary -- Lee Killough 1/22/98
-void CheckSaveGame(size_t size)
+// Bytes archived so far
+size_t P_SaveOffset(void)
 {
-  size_t offset = save_p - savebuffer;
+  return (size_t) (save_p - savebuffer);
+}
 
-  if (offset + size <= savegamesize)
-  {
-    return;
-  }
+void P_FreeSaveBuffer(void)
+{
+  Z_Free(savebuffer);
+  P_ForgetSaveBuffer();
+}
+
+//
+// Packed encoding
+//
+// Integers are written as LEB128 varints. Signed values are zigzag mapped
+// first, so that small magnitudes of either sign fit in a single byte.
+//
 
-  while (offset + size > savegamesize)
+void P_SaveVarUInt(uint64_t value)
+{
+  while (value >= 0x80)
   {
-    savegamesize *= 2;
+    P_SAVE_BYTE((byte) (value | 0x80));
+    value >>= 7;
   }
 
-  savebuffer = Z_Realloc(savebuffer, savegamesize);
-  save_p = savebuffer + offset;
+  P_SAVE_BYTE((byte) value);
 }
 
-void P_InitSaveBuffer(void)
+void P_SaveVarInt(int64_t value)
 {
-  savegamesize = SAVEGAMESIZE;
-  save_p = savebuffer = Z_Malloc(savegamesize);
+  P_SaveVarUInt(((uint64_t) value << 1) ^ (uint64_t) (value >> 63));
 }
 
-void P_ForgetSaveBuffer(void)
+uint64_t P_LoadVarUInt(void)
 {
-  save_p = savebuffer = NULL;
+  uint64_t value = 0;
+  int shift = 0;
+  byte b;
+
+  do
+  {
+    b = *save_p++;
+    value |= (uint64_t) (b & 0x7f) << shift;
+    shift += 7;
+  } while (b & 0x80);
+
+  return value;
 }
 
-void P_FreeSaveBuffer(void)
+int64_t P_LoadVarInt(void)
 {
-  Z_Free(savebuffer);
-  P_ForgetSaveBuffer();
+  uint64_t value = P_LoadVarUInt();
+
+  return (int64_t) (value >> 1) ^ -(int64_t) (value & 1);
 }
 
-//
-// P_ArchivePlayers
-//
-void P_ArchivePlayers (void)
+// Bytes P_SaveVarUInt / P_SaveVarInt write for a value: one per started
+// group of 7 significant bits
+static size_t P_VarUIntSize(uint64_t value)
 {
-  int i;
+  return 1 + (63 - __builtin_clzll(value | 1)) / 7;
+}
 
-  for (i = 0; i < g_maxplayers; i++)
-    if (playeringame[i])
-      {
-        int      j;
-        player_t *dest;
-
-        P_SAVE_TYPE_REF(&players[i], dest, player_t);
-        for (j=0; j<NUMPSPRITES; j++)
-          if (dest->psprites[j].state)
-            dest->psprites[j].state =
-              (state_t *)(dest->psprites[j].state-states);
-      }
+static size_t P_VarIntSize(int64_t value)
+{
+  return P_VarUIntSize(((uint64_t) value << 1) ^ (uint64_t) (value >> 63));
 }
 
+static int P_MobjIndex(const mobj_t *mobj);
+static int P_UnreferencedMobjIndex(const mobj_t *mobj);
+
 //
 // P_UnArchivePlayers
 //
@@ -121,77 +142,298 @@ void P_UnArchivePlayers (void)
   int i;
 
   for (i = 0; i < g_maxplayers; i++)
-    if (playeringame[i])
+    if (engine_context->playeringame[i])
       {
         int j;
+        player_t *p = &engine_context->players[i];
+
+        P_LOAD_VARUINT(p->playerstate);
+        P_LOAD_VARINT(p->cmd.forwardmove);
+        P_LOAD_VARINT(p->cmd.sidemove);
+        P_LOAD_VARINT(p->cmd.angleturn);
+        P_LOAD_BYTE(p->cmd.buttons);
+        P_LOAD_BYTE(p->cmd.lookfly);
+        P_LOAD_BYTE(p->cmd.arti);
+        P_LOAD_BYTE(p->cmd.ex.actions);
+        P_LOAD_BYTE(p->cmd.ex.save_slot);
+        P_LOAD_BYTE(p->cmd.ex.load_slot);
+        P_LOAD_VARINT(p->cmd.ex.look);
+
+        P_LOAD_VARINT(p->viewz);
+        P_LOAD_VARINT(p->viewheight);
+        P_LOAD_VARINT(p->deltaviewheight);
+        P_LOAD_VARINT(p->bob);
+        P_LOAD_VARINT(p->health);
+        P_LOAD_VARINT(p->armorpoints);
+        P_LOAD_VARINT(p->armortype);
+        P_LOAD_VARINT_ARRAY(p->powers);
+        P_LOAD_VARINT_ARRAY(p->cards);
+        P_LOAD_VARINT(p->backpack);
+        P_LOAD_VARINT_ARRAY(p->frags);
+        P_LOAD_VARINT(p->readyweapon);
+        P_LOAD_VARINT(p->pendingweapon);
+        P_LOAD_VARINT_ARRAY(p->weaponowned);
+        P_LOAD_VARINT_ARRAY(p->ammo);
+        P_LOAD_VARINT_ARRAY(p->maxammo);
+        P_LOAD_VARINT(p->attackdown);
+        P_LOAD_VARINT(p->usedown);
+        P_LOAD_VARINT(p->cheats);
+        P_LOAD_VARINT(p->refire);
+        P_LOAD_VARINT(p->killcount);
+        P_LOAD_VARINT(p->itemcount);
+        P_LOAD_VARINT(p->secretcount);
+        P_LOAD_VARINT(p->damagecount);
+        P_LOAD_VARINT(p->bonuscount);
+
+        // resolved to a pointer once the thinkers are unarchived
+        p->attacker = (mobj_t *) (intptr_t) P_LoadVarUInt();
+
+        P_LOAD_VARINT(p->extralight);
+        P_LOAD_VARINT(p->fixedcolormap);
+        P_LOAD_VARINT(p->colormap);
+
+        for (j = 0; j < NUMPSPRITES; j++)
+        {
+          pspdef_t *psp = &p->psprites[j];
+          size_t state;
+
+          P_LOAD_VARUINT(state);
+          psp->state = state ? &states[state - 1] : NULL;
+          P_LOAD_VARINT(psp->tics);
+          P_LOAD_VARINT(psp->sx);
+          P_LOAD_VARINT(psp->sy);
+        }
 
-        P_LOAD_X(players[i]);
+        P_LOAD_VARINT(p->didsecret);
+        P_LOAD_VARINT(p->momx);
+        P_LOAD_VARINT(p->momy);
+        P_LOAD_VARINT(p->maxkilldiscount);
+
+        // heretic
+        P_LOAD_VARINT(p->flyheight);
+        P_LOAD_VARINT(p->lookdir);
+        P_LOAD_VARINT(p->centering);
+        P_LOAD_VARINT(p->artifactCount);
+        P_LOAD_VARINT(p->inventorySlotNum);
+        P_LOAD_VARINT(p->flamecount);
+        P_LOAD_VARINT(p->chickenTics);
+        P_LOAD_VARINT(p->chickenPeck);
+
+        // hexen
+        P_LOAD_VARINT(p->morphTics);
+        P_LOAD_VARINT(p->pieces);
+        P_LOAD_VARINT(p->yellowMessage);
+        P_LOAD_VARINT(p->poisoncount);
+        P_LOAD_VARUINT(p->jumpTics);
+        P_LOAD_VARUINT(p->worldTimer);
+
+        // zdoom
+        P_LOAD_VARINT(p->hazardcount);
+        P_LOAD_BYTE(p->hazardinterval);
+
+        // the body fields only serve readers of the section
+        if (*save_p++)
+          for (j = 0; j < 8; j++)
+            P_LoadVarUInt();
 
         // will be set when unarc thinker
-        players[i].mo = NULL;
-        players[i].attacker = NULL;
+        p->mo = NULL;
         // HERETIC_TODO: does the rain need to be remembered?
-        players[i].rain1 = NULL;
-        players[i].rain2 = NULL;
+        p->rain1 = NULL;
+        p->rain2 = NULL;
 
         // hexen_note: poisoner not reloaded
-        players[i].poisoner = NULL;
-
-        for (j=0 ; j<NUMPSPRITES ; j++)
-          if (players[i]. psprites[j].state)
-            players[i]. psprites[j].state =
-              &states[ (size_t)players[i].psprites[j].state ];
+        p->poisoner = NULL;
       }
 }
 
 
 //
-// P_ArchiveWorld
+// World dirty tracking
 //
-void P_ArchiveWorld (void)
+// Saved states only carry the sectors and lines that may differ from the
+// level's initial geometry. The code that changes a sector's heights, pics,
+// light, special, tag or flags calls P_MarkSectorChanged, and the code that
+// changes a line's flags, special, tag, activations or arguments calls
+// P_MarkLineChanged. The first call for an entry sets its dirty flag and adds
+// it to the dirty list, so archiving walks the dirty lists only, with no
+// compare. Loading a state resets the entries dirty in the current one to
+// their initial geometry before applying the loaded ones, which become the
+// new dirty lists.
+//
+
+typedef struct
 {
-  int            i;
-  const sector_t *sec;
-  const line_t   *li;
-  const side_t   *si;
+  fixed_t floorheight;
+  fixed_t ceilingheight;
+  short floorpic;
+  short ceilingpic;
+  short lightlevel;
+  short special;
+  short tag;
+  unsigned int flags;
+} world_sector_t;
+
+typedef struct
+{
+  line_flags_t flags;
+  short special;
+  short tag;
+  byte player_activations;
+  int special_args[5];
+} world_line_t;
+
+static __STORAGE_MODIFIER world_sector_t *initial_sectors;
+static __STORAGE_MODIFIER world_line_t *initial_lines;
+
+static __STORAGE_MODIFIER byte *sector_dirty;
+static __STORAGE_MODIFIER byte *line_dirty;
+static __STORAGE_MODIFIER int *dirty_sectors;
+static __STORAGE_MODIFIER int *dirty_lines;
+static __STORAGE_MODIFIER int num_dirty_sectors;
+static __STORAGE_MODIFIER int num_dirty_lines;
+
+static void P_GetWorldSector(world_sector_t *ws, const sector_t *sec)
+{
+  ws->floorheight = sec->floorheight;
+  ws->ceilingheight = sec->ceilingheight;
+  ws->floorpic = sec->floorpic;
+  ws->ceilingpic = sec->ceilingpic;
+  ws->lightlevel = sec->lightlevel;
+  ws->special = sec->special;
+  ws->tag = sec->tag;
+  ws->flags = sec->flags;
+}
 
-  for (i = 0, sec = sectors; i < numsectors; i++, sec++)
-  {
-    P_SAVE_X(sec->floorheight);
-    P_SAVE_X(sec->ceilingheight);
-    P_SAVE_X(sec->floorpic);
-    P_SAVE_X(sec->ceilingpic);
-    P_SAVE_X(sec->lightlevel);
-    P_SAVE_X(sec->special);
-    P_SAVE_X(sec->tag);
-    P_SAVE_X(sec->flags);
-  }
+static void P_SetWorldSector(sector_t *sec, const world_sector_t *ws)
+{
+  sec->floorheight = ws->floorheight;
+  sec->ceilingheight = ws->ceilingheight;
+  sec->floorpic = ws->floorpic;
+  sec->ceilingpic = ws->ceilingpic;
+  sec->lightlevel = ws->lightlevel;
+  sec->special = ws->special;
+  sec->tag = ws->tag;
+  sec->flags = ws->flags;
+}
 
-  for (i = 0, li = lines; i < numlines; i++, li++)
-  {
-    int j;
+static void P_GetWorldLine(world_line_t *wl, const line_t *li)
+{
+  wl->flags = li->flags;
+  wl->special = li->special;
+  wl->tag = li->tag;
+  wl->player_activations = li->player_activations;
+  memcpy(wl->special_args, li->special_args, sizeof(wl->special_args));
+}
 
-    P_SAVE_X(li->flags);
-    P_SAVE_X(li->special);
-    P_SAVE_X(li->tag);
-    P_SAVE_BYTE(li->player_activations);
-    P_SAVE_ARRAY(li->special_args);
+static void P_SetWorldLine(line_t *li, const world_line_t *wl)
+{
+  li->flags = wl->flags;
+  li->special = wl->special;
+  li->tag = wl->tag;
+  li->player_activations = wl->player_activations;
+  memcpy(li->special_args, wl->special_args, sizeof(li->special_args));
+}
+
+// Records the level's initial geometry, must be called once the level is fully set up
+void P_InitWorldArchive(void)
+{
+  int i;
+
+  initial_sectors = Z_MallocLevel(numsectors * sizeof(*initial_sectors));
+  sector_dirty = Z_CallocLevel(numsectors, sizeof(*sector_dirty));
+  dirty_sectors = Z_MallocLevel(numsectors * sizeof(*dirty_sectors));
+  num_dirty_sectors = 0;
+
+  for (i = 0; i < numsectors; i++)
+    P_GetWorldSector(&initial_sectors[i], &sectors[i]);
+
+  initial_lines = Z_MallocLevel(numlines * sizeof(*initial_lines));
+  line_dirty = Z_CallocLevel(numlines, sizeof(*line_dirty));
+  dirty_lines = Z_MallocLevel(numlines * sizeof(*dirty_lines));
+  num_dirty_lines = 0;
+
+  for (i = 0; i < numlines; i++)
+    P_GetWorldLine(&initial_lines[i], &lines[i]);
+}
+
+// The level zone is about to be freed, so the dirty lists go with it
+void P_ResetWorldArchive(void)
+{
+  initial_sectors = NULL;
+  initial_lines = NULL;
+  sector_dirty = line_dirty = NULL;
+  dirty_sectors = dirty_lines = NULL;
+  num_dirty_sectors = num_dirty_lines = 0;
+}
+
+// Offsets are compared as unsigned, so copies of sectors or lines living outside
+// the level arrays (like the line A_LineEffect activates) are never recorded
+void P_MarkSectorChanged(const sector_t *sec)
+{
+  const uintptr_t offset = (uintptr_t) sec - (uintptr_t) sectors;
+  int i;
+
+  if (!sector_dirty || offset >= (uintptr_t) numsectors * sizeof(*sec))
+    return;
+
+  i = offset / sizeof(*sec);
+  if (!sector_dirty[i])
+  {
+    sector_dirty[i] = true;
+    dirty_sectors[num_dirty_sectors++] = i;
   }
 }
 
+void P_MarkLineChanged(const line_t *li)
+{
+  const uintptr_t offset = (uintptr_t) li - (uintptr_t) lines;
+  int i;
 
+  if (!line_dirty || offset >= (uintptr_t) numlines * sizeof(*li))
+    return;
+
+  i = offset / sizeof(*li);
+  if (!line_dirty[i])
+  {
+    line_dirty[i] = true;
+    dirty_lines[num_dirty_lines++] = i;
+  }
+}
 
 //
 // P_UnArchiveWorld
 //
 void P_UnArchiveWorld (void)
 {
-  int          i;
+  int          i, count, index;
   sector_t     *sec;
   line_t       *li;
 
-  for (i = 0, sec = sectors; i < numsectors; i++, sec++)
+  // Entries dirty in the current level state go back to their initial geometry,
+  // unless the loaded state overwrites them below
+  for (i = 0; i < num_dirty_sectors; i++)
+  {
+    P_SetWorldSector(&sectors[dirty_sectors[i]], &initial_sectors[dirty_sectors[i]]);
+    sector_dirty[dirty_sectors[i]] = false;
+  }
+  num_dirty_sectors = 0;
+
+  for (i = 0; i < num_dirty_lines; i++)
+  {
+    P_SetWorldLine(&lines[dirty_lines[i]], &initial_lines[dirty_lines[i]]);
+    line_dirty[dirty_lines[i]] = false;
+  }
+  num_dirty_lines = 0;
+
+  P_LOAD_VARUINT(count);
+  for (i = 0; i < count; i++)
   {
+    P_LOAD_VARUINT(index);
+    if (index < 0 || index >= numsectors || sector_dirty[index])
+      I_Error("P_UnArchiveWorld: invalid sector %d", index);
+
+    sec = &sectors[index];
     P_LOAD_X(sec->floorheight);
     P_LOAD_X(sec->ceilingheight);
     P_LOAD_X(sec->floorpic);
@@ -201,6 +443,12 @@ void P_UnArchiveWorld (void)
     P_LOAD_X(sec->tag);
     P_LOAD_X(sec->flags);
 
+    sector_dirty[index] = true;
+    dirty_sectors[num_dirty_sectors++] = index;
+  }
+
+  for (i = 0, sec = sectors; i < numsectors; i++, sec++)
+  {
     sec->ceilingdata = 0; //jff 2/22/98 now three thinker fields, not two
     sec->floordata = 0;
     sec->lightingdata = 0;
@@ -208,15 +456,22 @@ void P_UnArchiveWorld (void)
   }
 
   // do lines
-  for (i = 0, li = lines; i < numlines; i++, li++)
+  P_LOAD_VARUINT(count);
+  for (i = 0; i < count; i++)
   {
-    int j;
+    P_LOAD_VARUINT(index);
+    if (index < 0 || index >= numlines || line_dirty[index])
+      I_Error("P_UnArchiveWorld: invalid line %d", index);
 
+    li = &lines[index];
     P_LOAD_X(li->flags);
     P_LOAD_X(li->special);
     P_LOAD_X(li->tag);
     P_LOAD_BYTE(li->player_activations);
     P_LOAD_ARRAY(li->special_args);
+
+    line_dirty[index] = true;
+    dirty_lines[num_dirty_lines++] = index;
   }
 }
 
@@ -224,11 +479,6 @@ void P_UnArchiveWorld (void)
 // Thinkers
 //
 
-// phares 9/13/98: Moved this code outside of P_ArchiveThinkers so the
-// thinker indices could be used by the code that saves sector info.
-
-static __thread int number_of_thinkers;
-
 static dboolean P_IsMobjThinker(thinker_t* thinker)
 {
   return thinker->function == P_MobjThinker ||
@@ -236,16 +486,6 @@ static dboolean P_IsMobjThinker(thinker_t* thinker)
          (thinker->function == P_RemoveThinkerDelayed && thinker->references);
 }
 
-static void P_ReplaceMobjWithIndex(mobj_t **mobj)
-{
-  if (*mobj)
-  {
-    *mobj = P_IsMobjThinker(&(*mobj)->thinker) ?
-            (mobj_t *) (*mobj)->thinker.prev   :
-            NULL;
-  }
-}
-
 /*
  * killough 11/98
  *
@@ -270,53 +510,28 @@ int P_GetMobj(mobj_t* mi, size_t s)
   return i;
 }
 
-static void P_ReplaceIndexWithMobj(mobj_t **mobj, mobj_t **mobj_p, int mobj_count)
+// Mobjs are archived by their persistent id (see P_AssignMobjId), which
+// mobj_ids maps back to the mobj once all of them have been loaded
+static mobj_t *P_IdToMobj(mobj_t *mobj)
 {
-  P_SetNewTarget(
-    mobj,
-    mobj_p[
-      P_GetMobj(*mobj, mobj_count + 1)
-    ]
-  );
+  return mobj_ids[P_GetMobj(mobj, mobj_ids_end)];
 }
 
-void P_ThinkerToIndex(void)
+static void P_ReplaceIndexWithMobj(mobj_t **mobj)
 {
-  thinker_t *th;
-
-  // killough 2/14/98:
-  // count the number of thinkers, and mark each one with its index, using
-  // the prev field as a placeholder, since it can be restored later.
-
-  number_of_thinkers = 0;
-  for (th = thinkercap.next ; th != &thinkercap ; th=th->next)
-    if (P_IsMobjThinker(th))
-      th->prev = (thinker_t *)(intptr_t) ++number_of_thinkers;
-}
-
-// phares 9/13/98: Moved this code outside of P_ArchiveThinkers so the
-// thinker indices could be used by the code that saves sector info.
-
-void P_IndexToThinker(void)
-{
-  // killough 2/14/98: restore prev pointers
-  thinker_t *th;
-  thinker_t *prev = &thinkercap;
-
-  for (th = thinkercap.next ; th != &thinkercap ; prev=th, th=th->next)
-    th->prev = prev;
+  P_SetNewTarget(mobj, P_IdToMobj(*mobj));
 }
 
 // killough 2/16/98: save/restore random number generator state information
 
 void P_ArchiveRNG(void)
 {
-  P_SAVE_X(rng);
+  P_SAVE_X(engine_context->rng);
 }
 
 void P_UnArchiveRNG(void)
 {
-  P_LOAD_X(rng);
+  P_LOAD_X(engine_context->rng);
 }
 
 // killough 2/22/98: Save/restore automap state
@@ -329,52 +544,48 @@ void P_UnArchiveMap(void)
 {
 }
 
-void P_ArchiveThinkerSubclass(th_class class)
+// Returns the archive index of a mobj referenced through P_SetTarget
+// (target / tracer / lastenemy / sector soundtargets). The reference keeps
+// the block allocated, and its id assigned, even after the mobj is removed.
+static int P_MobjIndex(const mobj_t *mobj)
 {
-  int count;
-  thinker_t *cap, *th;
-
-  count = 0;
-  cap = &thinkerclasscap[class];
-  for (th = cap->cnext; th != cap; th = th->cnext)
-    count++;
-
-  P_SAVE_X(count);
-
-  for (th = cap->cnext; th != cap; th = th->cnext)
-  {
-    P_SAVE_X(th->prev);
-  }
+  return mobj ? mobj->id : 0;
 }
 
-void P_ArchiveThinkerSubclasses(void)
+// Returns the archive index of a mobj that is not reference counted
+// (player->attacker), 0 if it is not archived. Such a pointer may outlive
+// its block, so it is only compared against the live slots, never read.
+static int P_UnreferencedMobjIndex(const mobj_t *mobj)
 {
-  // Other subclass ordering is not relevant
-  P_ArchiveThinkerSubclass(th_friends);
-  P_ArchiveThinkerSubclass(th_enemies);
+  int id;
+
+  if (mobj)
+    for (id = 1; id < mobj_ids_end; id++)
+      if (mobj_ids[id] == mobj)
+        return id;
+
+  return 0;
 }
 
-void P_UnArchiveThinkerSubclass(th_class class, mobj_t** mobj_p, int mobj_count)
+void P_UnArchiveThinkerSubclass(th_class class)
 {
   int i;
   int count;
 
   // Reset thinker subclass list
-  thinkerclasscap[class].cprev->cnext = thinkerclasscap[class].cnext;
-  thinkerclasscap[class].cnext->cprev = thinkerclasscap[class].cprev;
-  thinkerclasscap[class].cprev =
-    thinkerclasscap[class].cnext = &thinkerclasscap[class];
+  engine_context->thinkerclasscap[class].cprev->cnext = engine_context->thinkerclasscap[class].cnext;
+  engine_context->thinkerclasscap[class].cnext->cprev = engine_context->thinkerclasscap[class].cprev;
+  engine_context->thinkerclasscap[class].cprev =
+    engine_context->thinkerclasscap[class].cnext = &engine_context->thinkerclasscap[class];
 
-  P_LOAD_X(count);
+  P_LOAD_VARUINT(count);
 
   for (i = 0; i < count; ++i)
   {
     thinker_t* th;
     mobj_t* mobj;
 
-    P_LOAD_X(mobj);
-
-    mobj = mobj_p[P_GetMobj(mobj, mobj_count + 1)];
+    mobj = P_IdToMobj((mobj_t *)(intptr_t) P_LoadVarUInt());
 
     if (mobj)
     {
@@ -386,7 +597,7 @@ void P_UnArchiveThinkerSubclass(th_class class, mobj_t** mobj_p, int mobj_count)
         th->cprev->cnext = th;
       }
 
-      th = &thinkerclasscap[class];
+      th = &engine_context->thinkerclasscap[class];
       th->cprev->cnext = &mobj->thinker;
       mobj->thinker.cnext = th;
       mobj->thinker.cprev = th->cprev;
@@ -399,45 +610,18 @@ void P_UnArchiveThinkerSubclass(th_class class, mobj_t** mobj_p, int mobj_count)
   }
 }
 
-void P_UnArchiveThinkerSubclasses(mobj_t** mobj_p, int mobj_count)
+void P_UnArchiveThinkerSubclasses(void)
 {
-  P_UnArchiveThinkerSubclass(th_friends, mobj_p, mobj_count);
-  P_UnArchiveThinkerSubclass(th_enemies, mobj_p, mobj_count);
+  P_UnArchiveThinkerSubclass(th_friends);
+  P_UnArchiveThinkerSubclass(th_enemies);
 }
 
-extern __thread mobj_t** blocklinks;
-extern __thread int      blocklinks_count;
-extern __thread int      bmapwidth;
-extern __thread int      bmapheight;
+extern __STORAGE_MODIFIER mobj_t** blocklinks;
+extern __STORAGE_MODIFIER int      blocklinks_count;
+extern __STORAGE_MODIFIER int      bmapwidth;
+extern __STORAGE_MODIFIER int      bmapheight;
 
-void P_ArchiveBlockLinks(void)
-{
-  int i;
-
-  for (i = 0; i < blocklinks_count; ++i)
-  {
-    int count = 0;
-    mobj_t*  mobj;
-
-    mobj = blocklinks[i];
-    while (mobj)
-    {
-      ++count;
-      mobj = mobj->bnext;
-    }
-
-    P_SAVE_X(count);
-
-    mobj = blocklinks[i];
-    while (mobj)
-    {
-      P_SAVE_X(mobj->thinker.prev);
-      mobj = mobj->bnext;
-    }
-  }
-}
-
-void P_UnArchiveBlockLinks(mobj_t** mobj_p, int mobj_count)
+void P_UnArchiveBlockLinks(void)
 {
   int i;
   int size;
@@ -451,15 +635,13 @@ void P_UnArchiveBlockLinks(mobj_t** mobj_p, int mobj_count)
     mobj_t* mobj;
     mobj_t** bprev;
 
-    P_LOAD_X(count);
+    P_LOAD_VARUINT(count);
 
     blocklinks[i] = NULL;
     bprev = &blocklinks[i];
     for (j = 0; j < count; ++j)
     {
-      P_LOAD_X(mobj);
-
-      mobj = mobj_p[P_GetMobj(mobj, mobj_count + 1)];
+      mobj = P_IdToMobj((mobj_t *)(intptr_t) P_LoadVarUInt());
 
       if (mobj)
       {
@@ -523,327 +705,232 @@ typedef enum {
   tc_end
 } true_thinkerclass_t;
 
-// dsda - fix save / load synchronization
-// merges P_ArchiveThinkers & P_ArchiveSpecials
-void P_ArchiveThinkers(void) {
-  thinker_t *th;
-
-  P_SAVE_X(brain);
-
-  // save off the current thinkers
-  for (th = thinkercap.next ; th != &thinkercap ; th=th->next) {
-    if (!th->function)
-    {
-      platlist_t *pl;
-      ceilinglist_t *cl;    //jff 2/22/98 add iter variable for ceilings
-
-      // killough 2/8/98: fix plat original height bug.
-      // Since acv==NULL, this could be a plat in stasis.
-      // so check the active plats list, and save this
-      // plat (jff: or ceiling) even if it is in stasis.
-
-      for (pl=activeplats; pl; pl=pl->next)
-        if (pl->plat == (plat_t *) th)      // killough 2/14/98
-          goto plat;
-
-      for (cl=activeceilings; cl; cl=cl->next)
-        if (cl->ceiling == (ceiling_t *) th)      //jff 2/22/98
-          goto ceiling;
-
-      continue;
-    }
-
-    if (th->function == T_MoveCeiling)
-    {
-      ceiling_t *ceiling;
-    ceiling:                               // killough 2/14/98
-      P_SAVE_BYTE(tc_ceiling);
-      P_SAVE_TYPE_REF(th, ceiling, ceiling_t);
-      ceiling->sector = (sector_t *)(intptr_t)(ceiling->sector->iSectorID);
-      continue;
-    }
-
-    if (th->function == T_VerticalDoor)
-    {
-      vldoor_t *door;
-      P_SAVE_BYTE(tc_door);
-      P_SAVE_TYPE_REF(th, door, vldoor_t);
-      door->sector = (sector_t *)(intptr_t)(door->sector->iSectorID);
-      //jff 1/31/98 archive line remembered by door as well
-      door->line = (line_t *) (door->line ? door->line-lines : -1);
-      continue;
-    }
-
-    if (th->function == T_MoveFloor)
-    {
-      floormove_t *floor;
-      P_SAVE_BYTE(tc_floor);
-      P_SAVE_TYPE_REF(th, floor, floormove_t);
-      floor->sector = (sector_t *)(intptr_t)(floor->sector->iSectorID);
-      continue;
-    }
-
-    if (th->function == T_PlatRaise)
-    {
-      plat_t *plat;
-    plat:   // killough 2/14/98: added fix for original plat height above
-      P_SAVE_BYTE(tc_plat);
-      P_SAVE_TYPE_REF(th, plat, plat_t);
-      plat->sector = (sector_t *)(intptr_t)(plat->sector->iSectorID);
-      continue;
-    }
-
-    if (th->function == T_LightFlash)
-    {
-      lightflash_t *flash;
-      P_SAVE_BYTE(tc_flash);
-      P_SAVE_TYPE_REF(th, flash, lightflash_t);
-      flash->sector = (sector_t *)(intptr_t)(flash->sector->iSectorID);
-      continue;
-    }
-
-    if (th->function == T_StrobeFlash)
-    {
-      strobe_t *strobe;
-      P_SAVE_BYTE(tc_strobe);
-      P_SAVE_TYPE_REF(th, strobe, strobe_t);
-      strobe->sector = (sector_t *)(intptr_t)(strobe->sector->iSectorID);
-      continue;
-    }
-
-    if (th->function == T_Glow)
-    {
-      glow_t *glow;
-      P_SAVE_BYTE(tc_glow);
-      P_SAVE_TYPE_REF(th, glow, glow_t);
-      glow->sector = (sector_t *)(intptr_t)(glow->sector->iSectorID);
-      continue;
-    }
-
-    if (th->function == T_ZDoom_Glow)
-    {
-      zdoom_glow_t *glow;
-      P_SAVE_BYTE(tc_zdoom_glow);
-      P_SAVE_TYPE_REF(th, glow, zdoom_glow_t);
-      glow->sector = (sector_t *)(intptr_t)(glow->sector->iSectorID);
-      continue;
-    }
-
-    // killough 10/4/98: save flickers
-    if (th->function == T_FireFlicker)
-    {
-      fireflicker_t *flicker;
-      P_SAVE_BYTE(tc_flicker);
-      P_SAVE_TYPE_REF(th, flicker, fireflicker_t);
-      flicker->sector = (sector_t *)(intptr_t)(flicker->sector->iSectorID);
-      continue;
-    }
-
-    if (th->function == T_ZDoom_Flicker)
-    {
-      zdoom_flicker_t *flicker;
-      P_SAVE_BYTE(tc_zdoom_flicker);
-      P_SAVE_TYPE_REF(th, flicker, zdoom_flicker_t);
-      flicker->sector = (sector_t *)(intptr_t)(flicker->sector->iSectorID);
-      continue;
-    }
-
-    //jff 2/22/98 new case for elevators
-    if (th->function == T_MoveElevator)
-    {
-      elevator_t *elevator;         //jff 2/22/98
-      P_SAVE_BYTE(tc_elevator);
-      P_SAVE_TYPE_REF(th, elevator, elevator_t);
-      elevator->sector = (sector_t *)(intptr_t)(elevator->sector->iSectorID);
-      continue;
-    }
-
-    if (th->function == dsda_UpdateSideScroller)
-    {
-      P_SAVE_BYTE(tc_scroll_side);
-      P_SAVE_TYPE(th, scroll_t);
-      continue;
-    }
-
-    if (th->function == dsda_UpdateFloorScroller)
-    {
-      P_SAVE_BYTE(tc_scroll_floor);
-      P_SAVE_TYPE(th, scroll_t);
-      continue;
-    }
-
-    if (th->function == dsda_UpdateCeilingScroller)
-    {
-      P_SAVE_BYTE(tc_scroll_ceiling);
-      P_SAVE_TYPE(th, scroll_t);
-      continue;
-    }
-
-    if (th->function == dsda_UpdateFloorCarryScroller)
-    {
-      P_SAVE_BYTE(tc_scroll_floor_carry);
-      P_SAVE_TYPE(th, scroll_t);
-      continue;
-    }
-
-    if (th->function == dsda_UpdateZDoomFloorScroller)
-    {
-      P_SAVE_BYTE(tc_zdoom_scroll_floor);
-      P_SAVE_TYPE(th, scroll_t);
-      continue;
-    }
-
-    if (th->function == dsda_UpdateZDoomCeilingScroller)
-    {
-      P_SAVE_BYTE(tc_zdoom_scroll_ceiling);
-      P_SAVE_TYPE(th, scroll_t);
-      continue;
-    }
-
-    if (th->function == dsda_UpdateThruster)
-    {
-      P_SAVE_BYTE(tc_thrust);
-      P_SAVE_TYPE(th, scroll_t);
-      continue;
-    }
-
-    if (th->function == dsda_UpdateControlSideScroller)
-    {
-      P_SAVE_BYTE(tc_scroll_side_control);
-      P_SAVE_TYPE(th, control_scroll_t);
-      continue;
-    }
-
-    if (th->function == dsda_UpdateControlFloorScroller)
-    {
-      P_SAVE_BYTE(tc_scroll_floor_control);
-      P_SAVE_TYPE(th, control_scroll_t);
-      continue;
-    }
-
-    if (th->function == dsda_UpdateControlCeilingScroller)
-    {
-      P_SAVE_BYTE(tc_scroll_ceiling_control);
-      P_SAVE_TYPE(th, control_scroll_t);
-      continue;
-    }
-
-    if (th->function == dsda_UpdateControlFloorCarryScroller)
-    {
-      P_SAVE_BYTE(tc_scroll_floor_carry_control);
-      P_SAVE_TYPE(th, control_scroll_t);
-      continue;
-    }
-
-    // phares 3/22/98: Push/Pull effect thinkers
-
-    if (th->function == T_Pusher)
-    {
-      P_SAVE_BYTE(tc_pusher);
-      P_SAVE_TYPE(th, pusher_t);
-      continue;
-    }
-
-    if (th->function == T_Friction)
-    {
-      P_SAVE_BYTE(tc_friction);
-      P_SAVE_TYPE(th, friction_t);
-      continue;
-    }
-
-    if (th->function == T_Light)
-    {
-      light_t *light;
-      P_SAVE_BYTE(tc_light);
-      P_SAVE_TYPE_REF(th, light, light_t);
-      light->sector = (sector_t *)(intptr_t)(light->sector->iSectorID);
-      continue;
-    }
-
-    if (th->function == T_Phase)
-    {
-      phase_t *phase;
-      P_SAVE_BYTE(tc_phase);
-      P_SAVE_TYPE_REF(th, phase, phase_t);
-      phase->sector = (sector_t *)(intptr_t)(phase->sector->iSectorID);
-      continue;
-    }
-
-    if (th->function == T_BuildPillar)
-    {
-      pillar_t *pillar;
-      P_SAVE_BYTE(tc_pillar);
-      P_SAVE_TYPE_REF(th, pillar, pillar_t);
-      pillar->sector = (sector_t *)(intptr_t)(pillar->sector->iSectorID);
-      continue;
-    }
-
-    if (P_IsMobjThinker(th))
-    {
-      mobj_t *mobj;
-
-      P_SAVE_BYTE(tc_mobj);
-      P_SAVE_TYPE_REF(th, mobj, mobj_t);
+// Set on the class byte of plats / ceilings in stasis (no thinker function)
+#define TC_STASIS 0x80
+
+static const char* thinker_class_names[tc_end + 1] = {
+  "mobj",
+  "ceiling",
+  "door",
+  "floor",
+  "plat",
+  "flash",
+  "strobe",
+  "glow",
+  "zdoom_glow",
+  "elevator",
+  "scroll_side",
+  "scroll_side_control",
+  "scroll_floor",
+  "scroll_floor_control",
+  "scroll_ceiling",
+  "scroll_ceiling_control",
+  "scroll_floor_carry",
+  "scroll_floor_carry_control",
+  "zdoom_scroll_floor",
+  "zdoom_scroll_ceiling",
+  "thrust",
+  "pusher",
+  "flicker",
+  "zdoom_flicker",
+  "friction",
+  "light",
+  "phase",
+  "acs",
+  "pillar",
+  "floor_waggle",
+  "ceiling_waggle",
+  "poly_rotate",
+  "poly_move",
+  "poly_door",
+  "quake",
+  "ambient_source",
+  "other" // class bytes, soundtargets, block links and subclasses
+};
+
+static __STORAGE_MODIFIER int thinker_class_count[tc_end + 1];
+static __STORAGE_MODIFIER size_t thinker_class_bytes[tc_end + 1];
+
+int P_GetThinkerArchiveStats(int tc, const char** name, int* count, size_t* bytes)
+{
+  if (tc < 0 || tc > tc_end)
+    return false;
 
-      mobj->state = (state_t *)(mobj->state - states);
+  *name = thinker_class_names[tc];
+  *count = thinker_class_count[tc];
+  *bytes = thinker_class_bytes[tc];
+  return true;
+}
 
-      // Example:
-      // - Archvile is attacking a lost soul
-      // - The lost soul dies before the attack hits
-      // - The lost soul is marked for deletion
-      // - The archvile will still attack the spot where the lost soul was
-      // - We need to save such objects and remember they are marked for deletion
-      if (mobj->thinker.function == P_RemoveThinkerDelayed)
-        mobj->index = MARKED_FOR_DELETION;
+static void P_LoadPackedThinker(thinker_t *th, size_t size)
+{
+  byte *body = (byte *) (th + 1);
+  size_t i, count = (size - sizeof(*th)) / sizeof(int);
 
-      // killough 2/14/98: convert pointers into indices.
-      // Fixes many savegame problems, by properly saving
-      // target and tracer fields. Note: we store NULL if
-      // the thinker pointed to by these fields is not a
-      // mobj thinker.
+  memset(th, 0, size);
 
-      P_ReplaceMobjWithIndex(&mobj->target);
-      P_ReplaceMobjWithIndex(&mobj->tracer);
+  for (i = 0; i < count; i++)
+  {
+    int word = P_LoadVarInt();
 
-      // killough 2/14/98: new field: save last known enemy. Prevents
-      // monsters from going to sleep after killing monsters and not
-      // seeing player anymore.
+    memcpy(body + i * sizeof(word), &word, sizeof(word));
+  }
+}
 
-      P_ReplaceMobjWithIndex(&mobj->lastenemy);
+//
+// Mobjs are stored as type, state, subsector, position and flags, then a
+// mask of the optional fields that differ from what can be derived on load
+// (mostly spawn defaults), followed by those fields only. Links (thinker,
+// sector, block, touching sectors), info and reference counts are rebuilt.
+//
 
-      // killough 2/14/98: end changes
+enum {
+  MF_SAVE_DELETED    = 1 << 0,  // marked for deletion (P_RemoveThinkerDelayed)
+  MF_SAVE_BLASTER    = 1 << 1,  // thinks with P_BlasterMobjThinker
+  MF_SAVE_ANGLE      = 1 << 2,
+  MF_SAVE_SPRITE     = 1 << 3,  // sprite / frame differ from the state's
+  MF_SAVE_TICS       = 1 << 4,  // tics differ from the state's
+  MF_SAVE_FLOORZ     = 1 << 5,
+  MF_SAVE_CEILINGZ   = 1 << 6,
+  MF_SAVE_DROPOFFZ   = 1 << 7,
+  MF_SAVE_SIZE       = 1 << 8,  // radius / height differ from info
+  MF_SAVE_MOMXY      = 1 << 9,
+  MF_SAVE_MOMZ       = 1 << 10,
+  MF_SAVE_INTFLAGS   = 1 << 11,
+  MF_SAVE_HEALTH     = 1 << 12,
+  MF_SAVE_MOVE       = 1 << 13, // movedir, movecount, strafecount
+  MF_SAVE_TARGET     = 1 << 14,
+  MF_SAVE_TRACER     = 1 << 15,
+  MF_SAVE_LASTENEMY  = 1 << 16,
+  MF_SAVE_REACTION   = 1 << 17,
+  MF_SAVE_THRESHOLD  = 1 << 18, // threshold, pursuecount, gear
+  MF_SAVE_PLAYER     = 1 << 19,
+  MF_SAVE_LASTLOOK   = 1 << 20,
+  MF_SAVE_SPAWNPOINT = 1 << 21,
+  MF_SAVE_FRICTION   = 1 << 22, // friction, movefactor
+  MF_SAVE_PITCH      = 1 << 23,
+  MF_SAVE_INDEX      = 1 << 24,
+  MF_SAVE_IDEN       = 1 << 25,
+  MF_SAVE_FLAGS2     = 1 << 26,
+  MF_SAVE_GRAVITY    = 1 << 27,
+};
+
+static void P_UnArchiveSpawnPoint(mapthing_t *mt)
+{
+  P_LOAD_VARINT(mt->tid);
+  P_LOAD_VARINT(mt->x);
+  P_LOAD_VARINT(mt->y);
+  P_LOAD_VARINT(mt->height);
+  P_LOAD_VARINT(mt->angle);
+  P_LOAD_VARINT(mt->type);
+  P_LOAD_VARINT(mt->options);
+  P_LOAD_VARINT(mt->special);
+  P_LOAD_VARINT_ARRAY(mt->special_args);
+  P_LOAD_VARINT(mt->gravity);
+  P_LOAD_VARINT(mt->health);
+  P_LOAD_X(mt->alpha);
+}
 
-      if (mobj->player)
-        mobj->player = (player_t *)((mobj->player-players) + 1);
-    }
+// Unarchives a mobj. Pointers to other mobjs are left as indices, to be
+// replaced once all mobjs exist. Returns the set of stored fields.
+static unsigned int P_UnArchiveMobj(mobj_t *mobj)
+{
+  const mobjinfo_t *info;
+  const state_t *st;
+  const sector_t *sec;
+  unsigned int fields;
+
+  memset(mobj, 0, sizeof(*mobj));
+
+  P_LOAD_VARUINT(mobj->id);
+  P_LOAD_VARUINT(mobj->type);
+  info = mobj->info = &mobjinfo[mobj->type];
+  st = mobj->state = &states[P_LoadVarUInt()];
+  mobj->subsector = &subsectors[P_LoadVarUInt()];
+  sec = mobj->subsector->sector;
+  P_LOAD_VARINT(mobj->x);
+  P_LOAD_VARINT(mobj->y);
+  P_LOAD_VARINT(mobj->z);
+  P_LOAD_VARUINT(mobj->flags);
+  P_LOAD_VARUINT(fields);
+
+  if (fields & MF_SAVE_ANGLE) P_LOAD_X(mobj->angle);
+  if (fields & MF_SAVE_SPRITE)
+  {
+    P_LOAD_VARUINT(mobj->sprite);
+    P_LOAD_VARUINT(mobj->frame);
   }
-
-  // add a terminating marker
-  P_SAVE_BYTE(tc_end);
-
-  // killough 9/14/98: save soundtargets
+  else
   {
-    int i;
-    for (i = 0; i < numsectors; i++)
-    {
-      mobj_t *target = sectors[i].soundtarget;
-      // Fix crash on reload when a soundtarget points to a removed corpse
-      // (prboom bug #1590350)
-      P_ReplaceMobjWithIndex(&target);
-      P_SAVE_X(target);
-    }
+    mobj->sprite = st->sprite;
+    mobj->frame = st->frame;
   }
+  if (fields & MF_SAVE_TICS) P_LOAD_VARINT(mobj->tics) else mobj->tics = st->tics;
+  if (fields & MF_SAVE_FLOORZ) P_LOAD_VARINT(mobj->floorz) else mobj->floorz = sec->floorheight;
+  if (fields & MF_SAVE_CEILINGZ) P_LOAD_VARINT(mobj->ceilingz) else mobj->ceilingz = sec->ceilingheight;
+  if (fields & MF_SAVE_DROPOFFZ) P_LOAD_VARINT(mobj->dropoffz) else mobj->dropoffz = mobj->floorz;
+  if (fields & MF_SAVE_SIZE)
+  {
+    P_LOAD_VARINT(mobj->radius);
+    P_LOAD_VARINT(mobj->height);
+  }
+  else
+  {
+    mobj->radius = info->radius;
+    mobj->height = info->height;
+  }
+  if (fields & MF_SAVE_MOMXY)
+  {
+    P_LOAD_VARINT(mobj->momx);
+    P_LOAD_VARINT(mobj->momy);
+  }
+  if (fields & MF_SAVE_MOMZ) P_LOAD_VARINT(mobj->momz);
+  if (fields & MF_SAVE_INTFLAGS) P_LOAD_VARINT(mobj->intflags);
+  if (fields & MF_SAVE_HEALTH) P_LOAD_VARINT(mobj->health) else mobj->health = info->spawnhealth;
+  if (fields & MF_SAVE_MOVE)
+  {
+    P_LOAD_VARINT(mobj->movedir);
+    P_LOAD_VARINT(mobj->movecount);
+    P_LOAD_VARINT(mobj->strafecount);
+  }
+  if (fields & MF_SAVE_TARGET) mobj->target = (mobj_t *) (intptr_t) P_LoadVarUInt();
+  if (fields & MF_SAVE_TRACER) mobj->tracer = (mobj_t *) (intptr_t) P_LoadVarUInt();
+  if (fields & MF_SAVE_LASTENEMY) mobj->lastenemy = (mobj_t *) (intptr_t) P_LoadVarUInt();
+  if (fields & MF_SAVE_REACTION) P_LOAD_VARINT(mobj->reactiontime) else mobj->reactiontime = info->reactiontime;
+  if (fields & MF_SAVE_THRESHOLD)
+  {
+    P_LOAD_VARINT(mobj->threshold);
+    P_LOAD_VARINT(mobj->pursuecount);
+    P_LOAD_VARINT(mobj->gear);
+  }
+  if (fields & MF_SAVE_PLAYER)
+    (mobj->player = &engine_context->players[P_LoadVarUInt()])->mo = mobj;
+  if (fields & MF_SAVE_LASTLOOK) P_LOAD_VARINT(mobj->lastlook);
+  if (fields & MF_SAVE_SPAWNPOINT) P_UnArchiveSpawnPoint(&mobj->spawnpoint);
+  if (fields & MF_SAVE_FRICTION)
+  {
+    P_LOAD_VARINT(mobj->friction);
+    P_LOAD_VARINT(mobj->movefactor);
+  }
+  else
+  {
+    mobj->friction = ORIG_FRICTION;
+    mobj->movefactor = ORIG_FRICTION_FACTOR;
+  }
+  if (fields & MF_SAVE_PITCH) P_LOAD_X(mobj->pitch);
+  if (fields & MF_SAVE_INDEX) P_LOAD_VARINT(mobj->index) else mobj->index = -1;
+  if (fields & MF_SAVE_IDEN) P_LOAD_VARINT(mobj->iden_nums);
+  if (fields & MF_SAVE_FLAGS2) P_LOAD_VARUINT(mobj->flags2) else mobj->flags2 = info->flags2;
+  if (fields & MF_SAVE_GRAVITY) P_LOAD_VARINT(mobj->gravity) else mobj->gravity = map_info.gravity;
 
-  P_ArchiveBlockLinks();
-  P_ArchiveThinkerSubclasses();
+  return fields;
 }
 
 // dsda - fix save / load synchronization
 // merges P_UnArchiveThinkers & P_UnArchiveSpecials
 void P_UnArchiveThinkers(void) {
 
-  mobj_t    **mobj_p;    // killough 2/14/98: Translation table
-  int    mobj_count;        // killough 2/14/98: size of or index into table
+  int mobj_end;
 
   totallive = 0;
 
@@ -864,81 +951,32 @@ void P_UnArchiveThinkers(void) {
     th = next;
   }
   P_InitThinkers ();
-  
-  // killough 2/14/98: count number of thinkers by skipping through them
-  {
-    byte *sp;     // save pointer and skip header
-    sp = save_p;
-    mobj_count = 0;
-
-    while (true)
-    {
-      true_thinkerclass_t tc;
-      P_LOAD_BYTE(tc);
-      if (tc == tc_end)
-        break;
-
-      if (tc == tc_mobj) mobj_count++;
-      save_p +=
-        tc == tc_ceiling        ? sizeof(ceiling_t)        :
-        tc == tc_door           ? sizeof(vldoor_t)         :
-        tc == tc_floor          ? sizeof(floormove_t)      :
-        tc == tc_plat           ? sizeof(plat_t)           :
-        tc == tc_flash          ? sizeof(lightflash_t)     :
-        tc == tc_strobe         ? sizeof(strobe_t)         :
-        tc == tc_glow           ? sizeof(glow_t)           :
-        tc == tc_zdoom_glow     ? sizeof(zdoom_glow_t)     :
-        tc == tc_elevator       ? sizeof(elevator_t)       :
-        tc == tc_scroll_side                ? sizeof(scroll_t)         :
-        tc == tc_scroll_floor               ? sizeof(scroll_t)         :
-        tc == tc_scroll_ceiling             ? sizeof(scroll_t)         :
-        tc == tc_scroll_floor_carry         ? sizeof(scroll_t)         :
-        tc == tc_zdoom_scroll_floor         ? sizeof(scroll_t)         :
-        tc == tc_zdoom_scroll_ceiling       ? sizeof(scroll_t)         :
-        tc == tc_thrust                     ? sizeof(scroll_t)         :
-        tc == tc_scroll_side_control        ? sizeof(control_scroll_t) :
-        tc == tc_scroll_floor_control       ? sizeof(control_scroll_t) :
-        tc == tc_scroll_ceiling_control     ? sizeof(control_scroll_t) :
-        tc == tc_scroll_floor_carry_control ? sizeof(control_scroll_t) :
-        tc == tc_pusher         ? sizeof(pusher_t)         :
-        tc == tc_flicker        ? sizeof(fireflicker_t)    :
-        tc == tc_zdoom_flicker  ? sizeof(zdoom_flicker_t)  :
-        tc == tc_friction       ? sizeof(friction_t)       :
-        tc == tc_light          ? sizeof(light_t)          :
-        tc == tc_phase          ? sizeof(phase_t)          :
-        tc == tc_pillar         ? sizeof(pillar_t)         :
-        tc == tc_floor_waggle   ? sizeof(planeWaggle_t)    :
-        tc == tc_ceiling_waggle ? sizeof(planeWaggle_t)    :
-        tc == tc_quake          ? sizeof(quake_t)          :
-        tc == tc_mobj           ? sizeof(mobj_t)           :
-      0;
-    }
 
-    if (*--save_p != tc_end)
-      I_Error ("P_UnArchiveThinkers: Unknown tc %i in size calculation", *save_p);
+  // mobjs are put back at their ids; slot 0 maps to NULL
+  P_LOAD_VARUINT(mobj_end);
+  P_ClearMobjIds(mobj_end);
 
-    // first table entry special: 0 maps to NULL
-    *(mobj_p = Z_Malloc((mobj_count + 1) * sizeof *mobj_p)) = 0;   // table of pointers
-    save_p = sp;           // restore save pointer
-  }
-
-  mobj_count = 0;
   while (true)
   {
-    true_thinkerclass_t tc;
+    byte tc;
+    dboolean stasis;
+
     P_LOAD_BYTE(tc);
     if (tc == tc_end)
       break;
 
+    stasis = (tc & TC_STASIS) != 0;
+    tc &= ~TC_STASIS;
+
     switch (tc) {
       case tc_ceiling:
         {
           ceiling_t *ceiling = Z_MallocLevel (sizeof(*ceiling));
-          P_LOAD_P(ceiling);
+          P_LoadPackedThinker(&ceiling->thinker, sizeof(*ceiling));
           ceiling->sector = &sectors[(size_t)ceiling->sector];
           ceiling->sector->ceilingdata = ceiling; //jff 2/22/98
 
-          if (ceiling->thinker.function)
+          if (!stasis)
             ceiling->thinker.function = T_MoveCeiling;
 
           P_AddThinker (&ceiling->thinker);
@@ -949,7 +987,7 @@ void P_UnArchiveThinkers(void) {
       case tc_door:
         {
           vldoor_t *door = Z_MallocLevel (sizeof(*door));
-          P_LOAD_P(door);
+          P_LoadPackedThinker(&door->thinker, sizeof(*door));
           door->sector = &sectors[(size_t)door->sector];
 
           //jff 1/31/98 unarchive line remembered by door as well
@@ -964,7 +1002,7 @@ void P_UnArchiveThinkers(void) {
       case tc_floor:
         {
           floormove_t *floor = Z_MallocLevel (sizeof(*floor));
-          P_LOAD_P(floor);
+          P_LoadPackedThinker(&floor->thinker, sizeof(*floor));
           floor->sector = &sectors[(size_t)floor->sector];
           floor->sector->floordata = floor; //jff 2/22/98
           floor->thinker.function = T_MoveFloor;
@@ -975,11 +1013,11 @@ void P_UnArchiveThinkers(void) {
       case tc_plat:
         {
           plat_t *plat = Z_MallocLevel (sizeof(*plat));
-          P_LOAD_P(plat);
+          P_LoadPackedThinker(&plat->thinker, sizeof(*plat));
           plat->sector = &sectors[(size_t)plat->sector];
           plat->sector->floordata = plat; //jff 2/22/98
 
-          if (plat->thinker.function)
+          if (!stasis)
             plat->thinker.function = T_PlatRaise;
 
           P_AddThinker (&plat->thinker);
@@ -990,7 +1028,7 @@ void P_UnArchiveThinkers(void) {
       case tc_flash:
         {
           lightflash_t *flash = Z_MallocLevel (sizeof(*flash));
-          P_LOAD_P(flash);
+          P_LoadPackedThinker(&flash->thinker, sizeof(*flash));
           flash->sector = &sectors[(size_t)flash->sector];
           flash->sector->lightingdata = flash;
           flash->thinker.function = T_LightFlash;
@@ -1001,7 +1039,7 @@ void P_UnArchiveThinkers(void) {
       case tc_strobe:
         {
           strobe_t *strobe = Z_MallocLevel (sizeof(*strobe));
-          P_LOAD_P(strobe);
+          P_LoadPackedThinker(&strobe->thinker, sizeof(*strobe));
           strobe->sector = &sectors[(size_t)strobe->sector];
           strobe->sector->lightingdata = strobe;
           strobe->thinker.function = T_StrobeFlash;
@@ -1012,7 +1050,7 @@ void P_UnArchiveThinkers(void) {
       case tc_glow:
         {
           glow_t *glow = Z_MallocLevel (sizeof(*glow));
-          P_LOAD_P(glow);
+          P_LoadPackedThinker(&glow->thinker, sizeof(*glow));
           glow->sector = &sectors[(size_t)glow->sector];
           glow->sector->lightingdata = glow;
           glow->thinker.function = T_Glow;
@@ -1023,7 +1061,7 @@ void P_UnArchiveThinkers(void) {
       case tc_zdoom_glow:
         {
           zdoom_glow_t *glow = Z_MallocLevel (sizeof(*glow));
-          P_LOAD_P(glow);
+          P_LoadPackedThinker(&glow->thinker, sizeof(*glow));
           glow->sector = &sectors[(size_t)glow->sector];
           glow->sector->lightingdata = glow;
           glow->thinker.function = T_ZDoom_Glow;
@@ -1034,7 +1072,7 @@ void P_UnArchiveThinkers(void) {
       case tc_flicker:           // killough 10/4/98
         {
           fireflicker_t *flicker = Z_MallocLevel (sizeof(*flicker));
-          P_LOAD_P(flicker);
+          P_LoadPackedThinker(&flicker->thinker, sizeof(*flicker));
           flicker->sector = &sectors[(size_t)flicker->sector];
           flicker->sector->lightingdata = flicker;
           flicker->thinker.function = T_FireFlicker;
@@ -1045,7 +1083,7 @@ void P_UnArchiveThinkers(void) {
       case tc_zdoom_flicker:
         {
           zdoom_flicker_t *flicker = Z_MallocLevel (sizeof(*flicker));
-          P_LOAD_P(flicker);
+          P_LoadPackedThinker(&flicker->thinker, sizeof(*flicker));
           flicker->sector = &sectors[(size_t)flicker->sector];
           flicker->sector->lightingdata = flicker;
           flicker->thinker.function = T_ZDoom_Flicker;
@@ -1057,7 +1095,7 @@ void P_UnArchiveThinkers(void) {
       case tc_elevator:
         {
           elevator_t *elevator = Z_MallocLevel (sizeof(*elevator));
-          P_LOAD_P(elevator);
+          P_LoadPackedThinker(&elevator->thinker, sizeof(*elevator));
           elevator->sector = &sectors[(size_t)elevator->sector];
           elevator->sector->floordata = elevator; //jff 2/22/98
           elevator->sector->ceilingdata = elevator; //jff 2/22/98
@@ -1069,7 +1107,7 @@ void P_UnArchiveThinkers(void) {
       case tc_scroll_side:
         {
           scroll_t *scroll = Z_MallocLevel (sizeof(*scroll));
-          P_LOAD_P(scroll);
+          P_LoadPackedThinker(&scroll->thinker, sizeof(*scroll));
           scroll->thinker.function = dsda_UpdateSideScroller;
           P_AddThinker(&scroll->thinker);
           break;
@@ -1078,7 +1116,7 @@ void P_UnArchiveThinkers(void) {
       case tc_scroll_floor:
         {
           scroll_t *scroll = Z_MallocLevel (sizeof(*scroll));
-          P_LOAD_P(scroll);
+          P_LoadPackedThinker(&scroll->thinker, sizeof(*scroll));
           scroll->thinker.function = dsda_UpdateFloorScroller;
           P_AddThinker(&scroll->thinker);
           break;
@@ -1087,7 +1125,7 @@ void P_UnArchiveThinkers(void) {
       case tc_scroll_ceiling:
         {
           scroll_t *scroll = Z_MallocLevel (sizeof(*scroll));
-          P_LOAD_P(scroll);
+          P_LoadPackedThinker(&scroll->thinker, sizeof(*scroll));
           scroll->thinker.function = dsda_UpdateCeilingScroller;
           P_AddThinker(&scroll->thinker);
           break;
@@ -1096,7 +1134,7 @@ void P_UnArchiveThinkers(void) {
       case tc_scroll_floor_carry:
         {
           scroll_t *scroll = Z_MallocLevel (sizeof(*scroll));
-          P_LOAD_P(scroll);
+          P_LoadPackedThinker(&scroll->thinker, sizeof(*scroll));
           scroll->thinker.function = dsda_UpdateFloorCarryScroller;
           P_AddThinker(&scroll->thinker);
           break;
@@ -1105,7 +1143,7 @@ void P_UnArchiveThinkers(void) {
       case tc_zdoom_scroll_floor:
         {
           scroll_t *scroll = Z_MallocLevel (sizeof(*scroll));
-          P_LOAD_P(scroll);
+          P_LoadPackedThinker(&scroll->thinker, sizeof(*scroll));
           scroll->thinker.function = dsda_UpdateZDoomFloorScroller;
           P_AddThinker(&scroll->thinker);
           break;
@@ -1114,7 +1152,7 @@ void P_UnArchiveThinkers(void) {
       case tc_zdoom_scroll_ceiling:
         {
           scroll_t *scroll = Z_MallocLevel (sizeof(*scroll));
-          P_LOAD_P(scroll);
+          P_LoadPackedThinker(&scroll->thinker, sizeof(*scroll));
           scroll->thinker.function = dsda_UpdateZDoomCeilingScroller;
           P_AddThinker(&scroll->thinker);
           break;
@@ -1123,7 +1161,7 @@ void P_UnArchiveThinkers(void) {
       case tc_thrust:
         {
           scroll_t *scroll = Z_MallocLevel (sizeof(*scroll));
-          P_LOAD_P(scroll);
+          P_LoadPackedThinker(&scroll->thinker, sizeof(*scroll));
           scroll->thinker.function = dsda_UpdateThruster;
           P_AddThinker(&scroll->thinker);
           break;
@@ -1132,7 +1170,7 @@ void P_UnArchiveThinkers(void) {
       case tc_scroll_side_control:
         {
           control_scroll_t *scroll = Z_MallocLevel (sizeof(*scroll));
-          P_LOAD_P(scroll);
+          P_LoadPackedThinker(&scroll->scroll.thinker, sizeof(*scroll));
           scroll->scroll.thinker.function = dsda_UpdateControlSideScroller;
           P_AddThinker(&scroll->scroll.thinker);
           break;
@@ -1141,7 +1179,7 @@ void P_UnArchiveThinkers(void) {
       case tc_scroll_floor_control:
         {
           control_scroll_t *scroll = Z_MallocLevel (sizeof(*scroll));
-          P_LOAD_P(scroll);
+          P_LoadPackedThinker(&scroll->scroll.thinker, sizeof(*scroll));
           scroll->scroll.thinker.function = dsda_UpdateControlFloorScroller;
           P_AddThinker(&scroll->scroll.thinker);
           break;
@@ -1150,7 +1188,7 @@ void P_UnArchiveThinkers(void) {
       case tc_scroll_ceiling_control:
         {
           control_scroll_t *scroll = Z_MallocLevel (sizeof(*scroll));
-          P_LOAD_P(scroll);
+          P_LoadPackedThinker(&scroll->scroll.thinker, sizeof(*scroll));
           scroll->scroll.thinker.function = dsda_UpdateControlCeilingScroller;
           P_AddThinker(&scroll->scroll.thinker);
           break;
@@ -1159,7 +1197,7 @@ void P_UnArchiveThinkers(void) {
       case tc_scroll_floor_carry_control:
         {
           control_scroll_t *scroll = Z_MallocLevel (sizeof(*scroll));
-          P_LOAD_P(scroll);
+          P_LoadPackedThinker(&scroll->scroll.thinker, sizeof(*scroll));
           scroll->scroll.thinker.function = dsda_UpdateControlFloorCarryScroller;
           P_AddThinker(&scroll->scroll.thinker);
           break;
@@ -1168,7 +1206,7 @@ void P_UnArchiveThinkers(void) {
       case tc_pusher:   // phares 3/22/98: new Push/Pull effect thinkers
         {
           pusher_t *pusher = Z_MallocLevel (sizeof(pusher_t));
-          P_LOAD_P(pusher);
+          P_LoadPackedThinker(&pusher->thinker, sizeof(*pusher));
           pusher->thinker.function = T_Pusher;
           pusher->source = P_GetPushThing(pusher->affectee);
           P_AddThinker(&pusher->thinker);
@@ -1178,7 +1216,7 @@ void P_UnArchiveThinkers(void) {
       case tc_friction:
         {
           friction_t *friction = Z_MallocLevel (sizeof(friction_t));
-          P_LOAD_P(friction);
+          P_LoadPackedThinker(&friction->thinker, sizeof(*friction));
           friction->thinker.function = T_Friction;
           P_AddThinker(&friction->thinker);
           break;
@@ -1187,7 +1225,7 @@ void P_UnArchiveThinkers(void) {
       case tc_light:
         {
           light_t *light = Z_MallocLevel(sizeof(*light));
-          P_LOAD_P(light);
+          P_LoadPackedThinker(&light->thinker, sizeof(*light));
           light->sector = &sectors[(size_t)light->sector];
           light->thinker.function = T_Light;
           P_AddThinker(&light->thinker);
@@ -1197,7 +1235,7 @@ void P_UnArchiveThinkers(void) {
       case tc_phase:
         {
           phase_t *phase = Z_MallocLevel(sizeof(*phase));
-          P_LOAD_P(phase);
+          P_LoadPackedThinker(&phase->thinker, sizeof(*phase));
           phase->sector = &sectors[(size_t)phase->sector];
           phase->sector->lightingdata = phase;
           phase->thinker.function = T_Phase;
@@ -1208,7 +1246,7 @@ void P_UnArchiveThinkers(void) {
       case tc_pillar:
         {
           pillar_t *pillar = Z_MallocLevel(sizeof(*pillar));
-          P_LOAD_P(pillar);
+          P_LoadPackedThinker(&pillar->thinker, sizeof(*pillar));
           pillar->sector = &sectors[(size_t)pillar->sector];
           pillar->sector->floordata = pillar;
           pillar->thinker.function = T_BuildPillar;
@@ -1219,42 +1257,34 @@ void P_UnArchiveThinkers(void) {
       case tc_mobj:
         {
           mobj_t *mobj = Z_MallocLevel(sizeof(mobj_t));
+          unsigned int fields;
 
-          // killough 2/14/98 -- insert pointers to thinkers into table, in order:
-          mobj_count++;
-          mobj_p[mobj_count] = mobj;
+          fields = P_UnArchiveMobj(mobj);
 
-          P_LOAD_P(mobj);
-
-          mobj->state = states + (intptr_t) mobj->state;
-
-          if (mobj->player)
-            (mobj->player = &players[(size_t) mobj->player - 1]) -> mo = mobj;
-
-          mobj->info = &mobjinfo[mobj->type];
+          if (mobj->id <= 0 || mobj->id >= mobj_ids_end || mobj_ids[mobj->id])
+            I_Error("Corrupt savegame");
+          mobj_ids[mobj->id] = mobj;
 
           // Don't place objects marked for deletion
-          if (mobj->index == MARKED_FOR_DELETION)
+          if (fields & MF_SAVE_DELETED)
           {
             mobj->thinker.function = P_RemoveThinkerDelayed;
             P_AddThinker(&mobj->thinker);
 
             // The references value must be nonzero to reach the target code
             mobj->thinker.references = 1;
+            mobj->index = MARKED_FOR_DELETION;
             break;
           }
 
-          #pragma omp critical (thinker)
-          {
-            P_SetThingPosition (mobj, 0);
-          }
+          P_SetThingPosition (mobj, 0);
 
           // killough 2/28/98:
           // Fix for falling down into a wall after savegame loaded:
           //      mobj->floorz = mobj->subsector->sector->floorheight;
           //      mobj->ceilingz = mobj->subsector->sector->ceilingheight;
 
-          mobj->thinker.function = P_MobjThinker;
+          mobj->thinker.function = fields & MF_SAVE_BLASTER ? P_BlasterMobjThinker : P_MobjThinker;
           P_AddThinker (&mobj->thinker);
 
           if (!((mobj->flags ^ MF_COUNTKILL) & (MF_FRIEND | MF_COUNTKILL | MF_CORPSE)))
@@ -1278,9 +1308,9 @@ void P_UnArchiveThinkers(void) {
   {
     if (P_IsMobjThinker(th))
     {
-      P_ReplaceIndexWithMobj(&((mobj_t *) th)->target, mobj_p, mobj_count);
-      P_ReplaceIndexWithMobj(&((mobj_t *) th)->tracer, mobj_p, mobj_count);
-      P_ReplaceIndexWithMobj(&((mobj_t *) th)->lastenemy, mobj_p, mobj_count);
+      P_ReplaceIndexWithMobj(&((mobj_t *) th)->target);
+      P_ReplaceIndexWithMobj(&((mobj_t *) th)->tracer);
+      P_ReplaceIndexWithMobj(&((mobj_t *) th)->lastenemy);
 
       // restore references now that targets are set
       if (((mobj_t *) th)->index == MARKED_FOR_DELETION)
@@ -1291,22 +1321,27 @@ void P_UnArchiveThinkers(void) {
     }
   }
 
+  // player attackers are not reference counted
+  {
+    int i;
+    for (i = 0; i < g_maxplayers; i++)
+      if (engine_context->playeringame[i])
+        engine_context->players[i].attacker = P_IdToMobj(engine_context->players[i].attacker);
+  }
 
   {  // killough 9/14/98: restore soundtargets
     int i;
     for (i = 0; i < numsectors; i++)
     {
-      P_LOAD_X(sectors[i].soundtarget);
+      sectors[i].soundtarget = (mobj_t *)(intptr_t) P_LoadVarUInt();
       // Must verify soundtarget. See P_ArchiveThinkers.
-      P_ReplaceIndexWithMobj(&sectors[i].soundtarget, mobj_p, mobj_count);
+      P_ReplaceIndexWithMobj(&sectors[i].soundtarget);
     }
   }
 
 
-  P_UnArchiveBlockLinks(mobj_p, mobj_count);
-  P_UnArchiveThinkerSubclasses(mobj_p, mobj_count);
-
-  Z_Free(mobj_p);    // free translation table
+  P_UnArchiveBlockLinks();
+  P_UnArchiveThinkerSubclasses();
 
   // TODO: not in sync, need to save and load existing order
   if (map_format.thing_id)
@@ -1398,16 +1433,93 @@ void P_UnArchiveMisc(void)
 }
 
 
+// Archive digest
+
+static __STORAGE_MODIFIER void (*save_hash_update)(const void *data, size_t size, void *context);
+static __STORAGE_MODIFIER void *save_hash_context;
+static __STORAGE_MODIFIER byte *save_hash_p;
+
+void P_BeginSaveHash(void)
+{
+  save_hash_p = save_p;
+}
+
+void P_UpdateSaveHash(dboolean flush)
+{
+  if (!save_hash_update)
+    return;
+
+  if (save_p - save_hash_p < (flush ? 1 : SAVE_HASH_CHUNK))
+    return;
+
+  save_hash_update(save_hash_p, save_p - save_hash_p, save_hash_context);
+  save_hash_p = save_p;
+}
+
 /// Headless functions
 
+// Archives are written without bounds checks, so the buffer must hold
+// headlessGetSaveSize() bytes
 void headlessSetSaveStatePointer(void* savePtr, int saveStateSize)
 { 
   save_p = savePtr;
   savebuffer = savePtr;
-  savegamesize = saveStateSize;
+}
+
+// Sets the callback the archive code streams its output through (NULL disables it)
+void headlessSetSaveHash(void (*update)(const void *data, size_t size, void *context), void *context)
+{
+  save_hash_update = update;
+  save_hash_context = context;
 }
 
 size_t headlessGetEffectiveSaveSize()
 { 
-  return (size_t)save_p - (size_t)savebuffer;
-}
\ No newline at end of file
+  return P_SaveOffset();
+}
+// Exact size of the archive dsda_ArchiveAll would write for the current state
+size_t headlessGetSaveSize()
+{
+  return dsda_ArchiveSize();
+}
+
+// Archive writers
+
+#include "p_saveg_archive.inl"
+
+// The same writers again as a sizing pass, named P_*Size: every write only
+// adds its size to save_size, so the archive is sized without being written
+// or checked against its buffer. P_SaveOffset() follows save_size, so the
+// thinker statistics come out the same as when archiving.
+
+#undef P_SAVE_WRITE
+#define P_SAVE_WRITE(x, size) { save_size += (size); }
+
+#undef P_SAVE_BYTE
+#define P_SAVE_BYTE(x) { save_size++; }
+
+#undef P_SAVE_VARUINT
+#define P_SAVE_VARUINT(x) { save_size += P_VarUIntSize((uint64_t)(x)); }
+
+#undef P_SAVE_VARINT
+#define P_SAVE_VARINT(x) { save_size += P_VarIntSize((int64_t)(x)); }
+
+#undef P_SAVE_VARINT_ARRAY
+#define P_SAVE_VARINT_ARRAY(x) { size_t _i; \
+                                 for (_i = 0; _i < sizeof(x) / sizeof(*(x)); _i++) \
+                                   save_size += P_VarIntSize((int64_t)(x)[_i]); }
+
+#define P_UpdateSaveHash(flush)
+#define P_SaveOffset() save_size
+
+#define P_ArchivePlayers P_ArchivePlayersSize
+#define P_ArchiveWorld P_ArchiveWorldSize
+#define P_ArchiveThinkerSubclass P_ArchiveThinkerSubclassSize
+#define P_ArchiveThinkerSubclasses P_ArchiveThinkerSubclassesSize
+#define P_ArchiveBlockLinks P_ArchiveBlockLinksSize
+#define P_SavePackedThinker P_SavePackedThinkerSize
+#define P_ArchiveSpawnPoint P_ArchiveSpawnPointSize
+#define P_ArchiveMobj P_ArchiveMobjSize
+#define P_ArchiveThinkers P_ArchiveThinkersSize
+
+#include "p_saveg_archive.inl"
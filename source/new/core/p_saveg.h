@@ -36,6 +36,9 @@
 
 #include "doomtype.h"
 
+struct sector_s;
+struct line_s;
+
 #define SAVEVERSION 5
 
 /* Persistent storage/archiving.
@@ -44,8 +47,15 @@ void P_ArchivePlayers(void);
 void P_UnArchivePlayers(void);
 void P_ArchiveWorld(void);
 void P_UnArchiveWorld(void);
-void P_ThinkerToIndex(void); /* phares 9/13/98: save soundtarget in savegame */
-void P_IndexToThinker(void); /* phares 9/13/98: save soundtarget in savegame */
+void P_InitWorldArchive(void); /* records the initial geometry for world dirty tracking */
+void P_ResetWorldArchive(void); /* forgets it, before the level zone is freed */
+
+/* Code changing an archived field of a sector (heights, flats, light level,
+ * special, tag, flags) or line (flags, special, tag, activations, arguments)
+ * records it, so only the recorded ones are archived. Recording is a no-op
+ * while the level is being set up. */
+void P_MarkSectorChanged(const struct sector_s *sec);
+void P_MarkLineChanged(const struct line_s *li);
 
 /* 1/18/98 killough: add RNG info to savegame */
 void P_ArchiveRNG(void);
@@ -59,52 +69,82 @@ void P_UnArchiveMap(void);
 void P_ArchiveThinkers(void);
 void P_UnArchiveThinkers(void);
 
-extern __thread byte *save_p;
-extern __thread byte* savebuffer;
+extern __STORAGE_MODIFIER byte *save_p;
+extern __STORAGE_MODIFIER byte* savebuffer;
+extern __STORAGE_MODIFIER size_t save_size;
 
-void CheckSaveGame(size_t size);
-void P_InitSaveBuffer(void);
 void P_ForgetSaveBuffer(void);
 void P_FreeSaveBuffer(void);
+size_t P_SaveOffset(void);
 
-#define P_SAVE_X(x) { CheckSaveGame(sizeof(x)); \
-                      memcpy(save_p, &x, sizeof(x)); \
-                      save_p += sizeof(x); }
+/* Writes are not checked against the buffer, which is sized beforehand by
+ * the sizing pass of the archive writers (see dsda_ArchiveSize). */
+#define P_SAVE_WRITE(x, size) { memcpy(save_p, x, size); save_p += (size); }
+
+#define P_SAVE_X(x) P_SAVE_WRITE(&x, sizeof(x))
 
 #define P_LOAD_X(x) { memcpy(&x, save_p, sizeof(x)); \
                       save_p += sizeof(x); }
 
-#define P_SAVE_SIZE(x, size) { CheckSaveGame(size); \
-                               memcpy(save_p, x, size); \
-                               save_p += size; }
+#define P_SAVE_SIZE(x, size) P_SAVE_WRITE(x, size)
 
 #define P_LOAD_SIZE(x, size) { memcpy(x, save_p, size); \
                                save_p += size; }
 
-#define P_SAVE_TYPE(x, type) { CheckSaveGame(sizeof(type)); \
-                               memcpy(save_p, x, sizeof(type)); \
-                               save_p += sizeof(type); }
-
-#define P_SAVE_TYPE_REF(x, ref, type) { CheckSaveGame(sizeof(type)); \
-                                        ref = (type *) save_p; \
-                                        memcpy(save_p, x, sizeof(type)); \
-                                        save_p += sizeof(type); }
+#define P_SAVE_TYPE(x, type) P_SAVE_WRITE(x, sizeof(type))
 
 #define P_LOAD_P(p) { memcpy(p, save_p, sizeof(*p)); \
                       save_p += sizeof(*p); }
 
-#define P_SAVE_BYTE(x) { CheckSaveGame(1); \
-                         *save_p++ = x; }
+#define P_SAVE_BYTE(x) { *save_p++ = x; }
 
 #define P_LOAD_BYTE(x) { x = *save_p++; }
 
-#define P_SAVE_ARRAY(x) { CheckSaveGame(sizeof(x)); \
-                          memcpy(save_p, x, sizeof(x)); \
-                          save_p += sizeof(x); }
+#define P_SAVE_ARRAY(x) P_SAVE_WRITE(x, sizeof(x))
 
 #define P_LOAD_ARRAY(x) { memcpy(x, save_p, sizeof(x)); \
                           save_p += sizeof(x); }
 
+// Packed (varint) encoding, used by the compact player / thinker codec
+void P_SaveVarUInt(uint64_t value);
+void P_SaveVarInt(int64_t value);
+uint64_t P_LoadVarUInt(void);
+int64_t P_LoadVarInt(void);
+
+#define P_SAVE_VARUINT(x) P_SaveVarUInt((uint64_t)(x))
+
+#define P_SAVE_VARINT(x) P_SaveVarInt((int64_t)(x))
+
+#define P_LOAD_VARUINT(x) { x = P_LoadVarUInt(); }
+
+#define P_LOAD_VARINT(x) { x = P_LoadVarInt(); }
+
+#define P_SAVE_VARINT_ARRAY(x) { size_t _i; \
+                                 for (_i = 0; _i < sizeof(x) / sizeof(*(x)); _i++) \
+                                   P_SaveVarInt((int64_t)(x)[_i]); }
+
+#define P_LOAD_VARINT_ARRAY(x) { size_t _i; \
+                                 for (_i = 0; _i < sizeof(x) / sizeof(*(x)); _i++) \
+                                   (x)[_i] = P_LoadVarInt(); }
+
+// Streaming digest of the archive: when a hash callback is set, the bytes
+// written since P_BeginSaveHash are fed to it in chunks of about
+// SAVE_HASH_CHUNK bytes, while they are still in cache. P_UpdateSaveHash
+// feeds whatever is pending when flush is set, or a full chunk otherwise.
+#define SAVE_HASH_CHUNK 8192
+void P_BeginSaveHash(void);
+void P_UpdateSaveHash(dboolean flush);
+
+// Sizing pass of the archive writers above (see p_saveg_archive.inl): they
+// add the bytes the matching P_Archive* function would write to save_size
+void P_ArchivePlayersSize(void);
+void P_ArchiveWorldSize(void);
+void P_ArchiveThinkersSize(void);
+
+// Per thinker class archive statistics for the last P_ArchiveThinkers call,
+// or its sizing pass
+int P_GetThinkerArchiveStats(int tc, const char** name, int* count, size_t* bytes);
+
 // heretic
 
 void P_ArchiveAmbientSound(void);
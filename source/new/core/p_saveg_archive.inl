@@ -0,0 +1,677 @@
+/* Emacs style mode select   -*- C -*-
+ *-----------------------------------------------------------------------------
+ *
+ *
+ *  PrBoom: a Doom port merged with LxDoom and LSDLDoom
+ *  based on BOOM, a modified and improved DOOM engine
+ *  Copyright (C) 1999 by
+ *  id Software, Chi Hoang, Lee Killough, Jim Flynn, Rand Phares, Ty Halderman
+ *  Copyright (C) 1999-2000 by
+ *  Jess Haas, Nicolas Kalkhof, Colin Phipps, Florian Schulze
+ *  Copyright 2005, 2006 by
+ *  Florian Schulze, Colin Phipps, Neil Stevens, Andrey Budko
+ *
+ *  This program is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU General Public License
+ *  as published by the Free Software Foundation; either version 2
+ *  of the License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA
+ *  02111-1307, USA.
+ *
+ * DESCRIPTION:
+ *      Archive writers, included twice by p_saveg.c: once writing the
+ *      archive through the P_SAVE_* macros, and once with those macros
+ *      only adding up the bytes they would write, under the names the
+ *      including file maps these functions to.
+ *
+ *-----------------------------------------------------------------------------*/
+
+//
+// P_ArchivePlayers
+//
+// Players are stored field by field. mo is not stored (it is relinked when
+// the player's mobj is unarchived), attacker is stored as a mobj index and
+// the interpolation-only prev_view* fields are skipped.
+//
+void P_ArchivePlayers (void)
+{
+  int i;
+
+  for (i = 0; i < g_maxplayers; i++)
+    if (engine_context->playeringame[i])
+      {
+        int      j;
+        const player_t *p = &engine_context->players[i];
+
+        P_SAVE_VARUINT(p->playerstate);
+        P_SAVE_VARINT(p->cmd.forwardmove);
+        P_SAVE_VARINT(p->cmd.sidemove);
+        P_SAVE_VARINT(p->cmd.angleturn);
+        P_SAVE_BYTE(p->cmd.buttons);
+        P_SAVE_BYTE(p->cmd.lookfly);
+        P_SAVE_BYTE(p->cmd.arti);
+        P_SAVE_BYTE(p->cmd.ex.actions);
+        P_SAVE_BYTE(p->cmd.ex.save_slot);
+        P_SAVE_BYTE(p->cmd.ex.load_slot);
+        P_SAVE_VARINT(p->cmd.ex.look);
+
+        P_SAVE_VARINT(p->viewz);
+        P_SAVE_VARINT(p->viewheight);
+        P_SAVE_VARINT(p->deltaviewheight);
+        P_SAVE_VARINT(p->bob);
+        P_SAVE_VARINT(p->health);
+        P_SAVE_VARINT(p->armorpoints);
+        P_SAVE_VARINT(p->armortype);
+        P_SAVE_VARINT_ARRAY(p->powers);
+        P_SAVE_VARINT_ARRAY(p->cards);
+        P_SAVE_VARINT(p->backpack);
+        P_SAVE_VARINT_ARRAY(p->frags);
+        P_SAVE_VARINT(p->readyweapon);
+        P_SAVE_VARINT(p->pendingweapon);
+        P_SAVE_VARINT_ARRAY(p->weaponowned);
+        P_SAVE_VARINT_ARRAY(p->ammo);
+        P_SAVE_VARINT_ARRAY(p->maxammo);
+        P_SAVE_VARINT(p->attackdown);
+        P_SAVE_VARINT(p->usedown);
+        P_SAVE_VARINT(p->cheats);
+        P_SAVE_VARINT(p->refire);
+        P_SAVE_VARINT(p->killcount);
+        P_SAVE_VARINT(p->itemcount);
+        P_SAVE_VARINT(p->secretcount);
+        P_SAVE_VARINT(p->damagecount);
+        P_SAVE_VARINT(p->bonuscount);
+        P_SAVE_VARUINT(P_UnreferencedMobjIndex(p->attacker));
+        P_SAVE_VARINT(p->extralight);
+        P_SAVE_VARINT(p->fixedcolormap);
+        P_SAVE_VARINT(p->colormap);
+
+        for (j = 0; j < NUMPSPRITES; j++)
+        {
+          const pspdef_t *psp = &p->psprites[j];
+
+          P_SAVE_VARUINT(psp->state ? psp->state - states + 1 : 0);
+          P_SAVE_VARINT(psp->tics);
+          P_SAVE_VARINT(psp->sx);
+          P_SAVE_VARINT(psp->sy);
+        }
+
+        P_SAVE_VARINT(p->didsecret);
+        P_SAVE_VARINT(p->momx);
+        P_SAVE_VARINT(p->momy);
+        P_SAVE_VARINT(p->maxkilldiscount);
+
+        // heretic
+        P_SAVE_VARINT(p->flyheight);
+        P_SAVE_VARINT(p->lookdir);
+        P_SAVE_VARINT(p->centering);
+        P_SAVE_VARINT(p->artifactCount);
+        P_SAVE_VARINT(p->inventorySlotNum);
+        P_SAVE_VARINT(p->flamecount);
+        P_SAVE_VARINT(p->chickenTics);
+        P_SAVE_VARINT(p->chickenPeck);
+
+        // hexen
+        P_SAVE_VARINT(p->morphTics);
+        P_SAVE_VARINT(p->pieces);
+        P_SAVE_VARINT(p->yellowMessage);
+        P_SAVE_VARINT(p->poisoncount);
+        P_SAVE_VARUINT(p->jumpTics);
+        P_SAVE_VARUINT(p->worldTimer);
+
+        // zdoom
+        P_SAVE_VARINT(p->hazardcount);
+        P_SAVE_BYTE(p->hazardinterval);
+
+        // The body, so that the game features can be read from this section
+        // alone (see dsda_ReadSaveFeatures). Loading takes it from the mobj.
+        P_SAVE_BYTE(p->mo != NULL);
+        if (p->mo)
+        {
+          P_SAVE_VARINT(p->mo->x);
+          P_SAVE_VARINT(p->mo->y);
+          P_SAVE_VARINT(p->mo->z);
+          P_SAVE_VARINT(p->mo->momx);
+          P_SAVE_VARINT(p->mo->momy);
+          P_SAVE_VARINT(p->mo->momz);
+          P_SAVE_VARUINT(p->mo->angle);
+          P_SAVE_VARINT(p->mo->subsector->sector->iSectorID);
+        }
+      }
+}
+
+//
+// P_ArchiveWorld
+//
+void P_ArchiveWorld (void)
+{
+  int            i;
+  const sector_t *sec;
+  const line_t   *li;
+
+  P_SAVE_VARUINT(num_dirty_sectors);
+  for (i = 0; i < num_dirty_sectors; i++)
+  {
+    sec = &sectors[dirty_sectors[i]];
+
+    P_SAVE_VARUINT(dirty_sectors[i]);
+    P_SAVE_X(sec->floorheight);
+    P_SAVE_X(sec->ceilingheight);
+    P_SAVE_X(sec->floorpic);
+    P_SAVE_X(sec->ceilingpic);
+    P_SAVE_X(sec->lightlevel);
+    P_SAVE_X(sec->special);
+    P_SAVE_X(sec->tag);
+    P_SAVE_X(sec->flags);
+  }
+
+  P_SAVE_VARUINT(num_dirty_lines);
+  for (i = 0; i < num_dirty_lines; i++)
+  {
+    li = &lines[dirty_lines[i]];
+
+    P_SAVE_VARUINT(dirty_lines[i]);
+    P_SAVE_X(li->flags);
+    P_SAVE_X(li->special);
+    P_SAVE_X(li->tag);
+    P_SAVE_BYTE(li->player_activations);
+    P_SAVE_ARRAY(li->special_args);
+  }
+}
+
+void P_ArchiveThinkerSubclass(th_class class)
+{
+  int count;
+  thinker_t *cap, *th;
+
+  count = 0;
+  cap = &engine_context->thinkerclasscap[class];
+  for (th = cap->cnext; th != cap; th = th->cnext)
+    count++;
+
+  P_SAVE_VARUINT(count);
+
+  for (th = cap->cnext; th != cap; th = th->cnext)
+  {
+    P_SAVE_VARUINT(((mobj_t *) th)->id);
+  }
+}
+
+void P_ArchiveThinkerSubclasses(void)
+{
+  // Other subclass ordering is not relevant
+  P_ArchiveThinkerSubclass(th_friends);
+  P_ArchiveThinkerSubclass(th_enemies);
+}
+
+void P_ArchiveBlockLinks(void)
+{
+  int i;
+
+  for (i = 0; i < blocklinks_count; ++i)
+  {
+    int count = 0;
+    mobj_t*  mobj;
+
+    mobj = blocklinks[i];
+    while (mobj)
+    {
+      ++count;
+      mobj = mobj->bnext;
+    }
+
+    P_SAVE_VARUINT(count);
+
+    mobj = blocklinks[i];
+    while (mobj)
+    {
+      P_SAVE_VARUINT(mobj->id);
+      mobj = mobj->bnext;
+    }
+  }
+}
+
+//
+// Special thinkers are stored as their class byte followed by the struct
+// body, packed as one varint per int-sized word. The leading thinker_t is
+// not stored, since its links are rebuilt by P_AddThinker. Pointer fields
+// must have been replaced by indices in the copy handed to this function.
+//
+
+static void P_SavePackedThinker(byte tc, const thinker_t *th, size_t size)
+{
+  const byte *body = (const byte *) (th + 1);
+  size_t i, count = (size - sizeof(*th)) / sizeof(int);
+  size_t start = P_SaveOffset();
+
+  P_SAVE_BYTE(tc);
+
+  for (i = 0; i < count; i++)
+  {
+    int word;
+
+    // memcpy, since the body holds more than ints (strict aliasing)
+    memcpy(&word, body + i * sizeof(word), sizeof(word));
+    P_SAVE_VARINT(word);
+  }
+
+  tc &= ~TC_STASIS;
+  thinker_class_count[tc]++;
+  thinker_class_bytes[tc] += P_SaveOffset() - start;
+}
+
+static void P_ArchiveSpawnPoint(const mapthing_t *mt)
+{
+  P_SAVE_VARINT(mt->tid);
+  P_SAVE_VARINT(mt->x);
+  P_SAVE_VARINT(mt->y);
+  P_SAVE_VARINT(mt->height);
+  P_SAVE_VARINT(mt->angle);
+  P_SAVE_VARINT(mt->type);
+  P_SAVE_VARINT(mt->options);
+  P_SAVE_VARINT(mt->special);
+  P_SAVE_VARINT_ARRAY(mt->special_args);
+  P_SAVE_VARINT(mt->gravity);
+  P_SAVE_VARINT(mt->health);
+  P_SAVE_X(mt->alpha);
+}
+
+static void P_ArchiveMobj(const mobj_t *mobj)
+{
+  static const mapthing_t no_spawnpoint;
+  const mobjinfo_t *info = &mobjinfo[mobj->type];
+  const state_t *st = mobj->state;
+  const sector_t *sec = mobj->subsector->sector;
+  size_t start = P_SaveOffset();
+  unsigned int fields = 0;
+
+  if (mobj->thinker.function == P_RemoveThinkerDelayed) fields |= MF_SAVE_DELETED;
+  if (mobj->thinker.function == P_BlasterMobjThinker) fields |= MF_SAVE_BLASTER;
+  if (mobj->angle) fields |= MF_SAVE_ANGLE;
+  if (mobj->sprite != st->sprite || mobj->frame != st->frame) fields |= MF_SAVE_SPRITE;
+  if (mobj->tics != st->tics) fields |= MF_SAVE_TICS;
+  if (mobj->floorz != sec->floorheight) fields |= MF_SAVE_FLOORZ;
+  if (mobj->ceilingz != sec->ceilingheight) fields |= MF_SAVE_CEILINGZ;
+  if (mobj->dropoffz != mobj->floorz) fields |= MF_SAVE_DROPOFFZ;
+  if (mobj->radius != info->radius || mobj->height != info->height) fields |= MF_SAVE_SIZE;
+  if (mobj->momx || mobj->momy) fields |= MF_SAVE_MOMXY;
+  if (mobj->momz) fields |= MF_SAVE_MOMZ;
+  if (mobj->intflags) fields |= MF_SAVE_INTFLAGS;
+  if (mobj->health != info->spawnhealth) fields |= MF_SAVE_HEALTH;
+  if (mobj->movedir || mobj->movecount || mobj->strafecount) fields |= MF_SAVE_MOVE;
+  if (P_MobjIndex(mobj->target)) fields |= MF_SAVE_TARGET;
+  if (P_MobjIndex(mobj->tracer)) fields |= MF_SAVE_TRACER;
+  if (P_MobjIndex(mobj->lastenemy)) fields |= MF_SAVE_LASTENEMY;
+  if (mobj->reactiontime != info->reactiontime) fields |= MF_SAVE_REACTION;
+  if (mobj->threshold || mobj->pursuecount || mobj->gear) fields |= MF_SAVE_THRESHOLD;
+  if (mobj->player) fields |= MF_SAVE_PLAYER;
+  if (mobj->lastlook) fields |= MF_SAVE_LASTLOOK;
+  if (memcmp(&mobj->spawnpoint, &no_spawnpoint, sizeof(no_spawnpoint))) fields |= MF_SAVE_SPAWNPOINT;
+  if (mobj->friction != ORIG_FRICTION || mobj->movefactor != ORIG_FRICTION_FACTOR) fields |= MF_SAVE_FRICTION;
+  if (mobj->pitch) fields |= MF_SAVE_PITCH;
+  if (mobj->index != -1) fields |= MF_SAVE_INDEX;
+  if (mobj->iden_nums) fields |= MF_SAVE_IDEN;
+  if (mobj->flags2 != info->flags2) fields |= MF_SAVE_FLAGS2;
+  if (mobj->gravity != map_info.gravity) fields |= MF_SAVE_GRAVITY;
+
+  P_SAVE_BYTE(tc_mobj);
+  P_SAVE_VARUINT(mobj->id);
+  P_SAVE_VARUINT(mobj->type);
+  P_SAVE_VARUINT(st - states);
+  P_SAVE_VARUINT(mobj->subsector - subsectors);
+  P_SAVE_VARINT(mobj->x);
+  P_SAVE_VARINT(mobj->y);
+  P_SAVE_VARINT(mobj->z);
+  P_SAVE_VARUINT(mobj->flags);
+  P_SAVE_VARUINT(fields);
+
+  if (fields & MF_SAVE_ANGLE) P_SAVE_X(mobj->angle);
+  if (fields & MF_SAVE_SPRITE)
+  {
+    P_SAVE_VARUINT(mobj->sprite);
+    P_SAVE_VARUINT(mobj->frame);
+  }
+  if (fields & MF_SAVE_TICS) P_SAVE_VARINT(mobj->tics);
+  if (fields & MF_SAVE_FLOORZ) P_SAVE_VARINT(mobj->floorz);
+  if (fields & MF_SAVE_CEILINGZ) P_SAVE_VARINT(mobj->ceilingz);
+  if (fields & MF_SAVE_DROPOFFZ) P_SAVE_VARINT(mobj->dropoffz);
+  if (fields & MF_SAVE_SIZE)
+  {
+    P_SAVE_VARINT(mobj->radius);
+    P_SAVE_VARINT(mobj->height);
+  }
+  if (fields & MF_SAVE_MOMXY)
+  {
+    P_SAVE_VARINT(mobj->momx);
+    P_SAVE_VARINT(mobj->momy);
+  }
+  if (fields & MF_SAVE_MOMZ) P_SAVE_VARINT(mobj->momz);
+  if (fields & MF_SAVE_INTFLAGS) P_SAVE_VARINT(mobj->intflags);
+  if (fields & MF_SAVE_HEALTH) P_SAVE_VARINT(mobj->health);
+  if (fields & MF_SAVE_MOVE)
+  {
+    P_SAVE_VARINT(mobj->movedir);
+    P_SAVE_VARINT(mobj->movecount);
+    P_SAVE_VARINT(mobj->strafecount);
+  }
+
+  // killough 2/14/98: convert pointers into indices.
+  // Fixes many savegame problems, by properly saving
+  // target and tracer fields. Note: we store NULL if
+  // the thinker pointed to by these fields is not a
+  // mobj thinker.
+  if (fields & MF_SAVE_TARGET) P_SAVE_VARUINT(P_MobjIndex(mobj->target));
+  if (fields & MF_SAVE_TRACER) P_SAVE_VARUINT(P_MobjIndex(mobj->tracer));
+
+  // killough 2/14/98: new field: save last known enemy. Prevents
+  // monsters from going to sleep after killing monsters and not
+  // seeing player anymore.
+  if (fields & MF_SAVE_LASTENEMY) P_SAVE_VARUINT(P_MobjIndex(mobj->lastenemy));
+
+  if (fields & MF_SAVE_REACTION) P_SAVE_VARINT(mobj->reactiontime);
+  if (fields & MF_SAVE_THRESHOLD)
+  {
+    P_SAVE_VARINT(mobj->threshold);
+    P_SAVE_VARINT(mobj->pursuecount);
+    P_SAVE_VARINT(mobj->gear);
+  }
+  if (fields & MF_SAVE_PLAYER) P_SAVE_VARUINT(mobj->player - engine_context->players);
+  if (fields & MF_SAVE_LASTLOOK) P_SAVE_VARINT(mobj->lastlook);
+  if (fields & MF_SAVE_SPAWNPOINT) P_ArchiveSpawnPoint(&mobj->spawnpoint);
+  if (fields & MF_SAVE_FRICTION)
+  {
+    P_SAVE_VARINT(mobj->friction);
+    P_SAVE_VARINT(mobj->movefactor);
+  }
+  if (fields & MF_SAVE_PITCH) P_SAVE_X(mobj->pitch);
+  if (fields & MF_SAVE_INDEX) P_SAVE_VARINT(mobj->index);
+  if (fields & MF_SAVE_IDEN) P_SAVE_VARINT(mobj->iden_nums);
+  if (fields & MF_SAVE_FLAGS2) P_SAVE_VARUINT(mobj->flags2);
+  if (fields & MF_SAVE_GRAVITY) P_SAVE_VARINT(mobj->gravity);
+
+  thinker_class_count[tc_mobj]++;
+  thinker_class_bytes[tc_mobj] += P_SaveOffset() - start;
+}
+
+// dsda - fix save / load synchronization
+// merges P_ArchiveThinkers & P_ArchiveSpecials
+void P_ArchiveThinkers(void) {
+  thinker_t *th;
+  size_t start;
+
+  memset(thinker_class_count, 0, sizeof(thinker_class_count));
+  memset(thinker_class_bytes, 0, sizeof(thinker_class_bytes));
+
+  start = P_SaveOffset();
+
+  P_SAVE_X(brain);
+
+  // the end of the mobj id table, to size it on load
+  P_SAVE_VARUINT(mobj_ids_end);
+
+  thinker_class_bytes[tc_end] += P_SaveOffset() - start;
+
+  // save off the current thinkers
+  for (th = thinkercap.next ; th != &thinkercap ; th=th->next) {
+    P_UpdateSaveHash(false);
+
+    if (!th->function)
+    {
+      platlist_t *pl;
+      ceilinglist_t *cl;    //jff 2/22/98 add iter variable for ceilings
+
+      // killough 2/8/98: fix plat original height bug.
+      // Since acv==NULL, this could be a plat in stasis.
+      // so check the active plats list, and save this
+      // plat (jff: or ceiling) even if it is in stasis.
+
+      for (pl=activeplats; pl; pl=pl->next)
+        if (pl->plat == (plat_t *) th)      // killough 2/14/98
+          goto plat;
+
+      for (cl=activeceilings; cl; cl=cl->next)
+        if (cl->ceiling == (ceiling_t *) th)      //jff 2/22/98
+          goto ceiling;
+
+      continue;
+    }
+
+    if (th->function == T_MoveCeiling)
+    {
+      ceiling_t ceiling;
+    ceiling:                               // killough 2/14/98
+      ceiling = *(ceiling_t *) th;
+      ceiling.sector = (sector_t *)(intptr_t)(ceiling.sector->iSectorID);
+      ceiling.list = NULL;
+      P_SavePackedThinker(tc_ceiling | (th->function ? 0 : TC_STASIS), &ceiling.thinker, sizeof(ceiling));
+      continue;
+    }
+
+    if (th->function == T_VerticalDoor)
+    {
+      vldoor_t door = *(vldoor_t *) th;
+      door.sector = (sector_t *)(intptr_t)(door.sector->iSectorID);
+      //jff 1/31/98 archive line remembered by door as well
+      door.line = (line_t *) (door.line ? door.line-lines : -1);
+      P_SavePackedThinker(tc_door, &door.thinker, sizeof(door));
+      continue;
+    }
+
+    if (th->function == T_MoveFloor)
+    {
+      floormove_t floor = *(floormove_t *) th;
+      floor.sector = (sector_t *)(intptr_t)(floor.sector->iSectorID);
+      P_SavePackedThinker(tc_floor, &floor.thinker, sizeof(floor));
+      continue;
+    }
+
+    if (th->function == T_PlatRaise)
+    {
+      plat_t plat;
+    plat:   // killough 2/14/98: added fix for original plat height above
+      plat = *(plat_t *) th;
+      plat.sector = (sector_t *)(intptr_t)(plat.sector->iSectorID);
+      plat.list = NULL;
+      P_SavePackedThinker(tc_plat | (th->function ? 0 : TC_STASIS), &plat.thinker, sizeof(plat));
+      continue;
+    }
+
+    if (th->function == T_LightFlash)
+    {
+      lightflash_t flash = *(lightflash_t *) th;
+      flash.sector = (sector_t *)(intptr_t)(flash.sector->iSectorID);
+      P_SavePackedThinker(tc_flash, &flash.thinker, sizeof(flash));
+      continue;
+    }
+
+    if (th->function == T_StrobeFlash)
+    {
+      strobe_t strobe = *(strobe_t *) th;
+      strobe.sector = (sector_t *)(intptr_t)(strobe.sector->iSectorID);
+      P_SavePackedThinker(tc_strobe, &strobe.thinker, sizeof(strobe));
+      continue;
+    }
+
+    if (th->function == T_Glow)
+    {
+      glow_t glow = *(glow_t *) th;
+      glow.sector = (sector_t *)(intptr_t)(glow.sector->iSectorID);
+      P_SavePackedThinker(tc_glow, &glow.thinker, sizeof(glow));
+      continue;
+    }
+
+    if (th->function == T_ZDoom_Glow)
+    {
+      zdoom_glow_t glow = *(zdoom_glow_t *) th;
+      glow.sector = (sector_t *)(intptr_t)(glow.sector->iSectorID);
+      P_SavePackedThinker(tc_zdoom_glow, &glow.thinker, sizeof(glow));
+      continue;
+    }
+
+    // killough 10/4/98: save flickers
+    if (th->function == T_FireFlicker)
+    {
+      fireflicker_t flicker = *(fireflicker_t *) th;
+      flicker.sector = (sector_t *)(intptr_t)(flicker.sector->iSectorID);
+      P_SavePackedThinker(tc_flicker, &flicker.thinker, sizeof(flicker));
+      continue;
+    }
+
+    if (th->function == T_ZDoom_Flicker)
+    {
+      zdoom_flicker_t flicker = *(zdoom_flicker_t *) th;
+      flicker.sector = (sector_t *)(intptr_t)(flicker.sector->iSectorID);
+      P_SavePackedThinker(tc_zdoom_flicker, &flicker.thinker, sizeof(flicker));
+      continue;
+    }
+
+    //jff 2/22/98 new case for elevators
+    if (th->function == T_MoveElevator)
+    {
+      elevator_t elevator = *(elevator_t *) th;         //jff 2/22/98
+      elevator.sector = (sector_t *)(intptr_t)(elevator.sector->iSectorID);
+      P_SavePackedThinker(tc_elevator, &elevator.thinker, sizeof(elevator));
+      continue;
+    }
+
+    if (th->function == dsda_UpdateSideScroller)
+    {
+      P_SavePackedThinker(tc_scroll_side, th, sizeof(scroll_t));
+      continue;
+    }
+
+    if (th->function == dsda_UpdateFloorScroller)
+    {
+      P_SavePackedThinker(tc_scroll_floor, th, sizeof(scroll_t));
+      continue;
+    }
+
+    if (th->function == dsda_UpdateCeilingScroller)
+    {
+      P_SavePackedThinker(tc_scroll_ceiling, th, sizeof(scroll_t));
+      continue;
+    }
+
+    if (th->function == dsda_UpdateFloorCarryScroller)
+    {
+      P_SavePackedThinker(tc_scroll_floor_carry, th, sizeof(scroll_t));
+      continue;
+    }
+
+    if (th->function == dsda_UpdateZDoomFloorScroller)
+    {
+      P_SavePackedThinker(tc_zdoom_scroll_floor, th, sizeof(scroll_t));
+      continue;
+    }
+
+    if (th->function == dsda_UpdateZDoomCeilingScroller)
+    {
+      P_SavePackedThinker(tc_zdoom_scroll_ceiling, th, sizeof(scroll_t));
+      continue;
+    }
+
+    if (th->function == dsda_UpdateThruster)
+    {
+      P_SavePackedThinker(tc_thrust, th, sizeof(scroll_t));
+      continue;
+    }
+
+    if (th->function == dsda_UpdateControlSideScroller)
+    {
+      P_SavePackedThinker(tc_scroll_side_control, th, sizeof(control_scroll_t));
+      continue;
+    }
+
+    if (th->function == dsda_UpdateControlFloorScroller)
+    {
+      P_SavePackedThinker(tc_scroll_floor_control, th, sizeof(control_scroll_t));
+      continue;
+    }
+
+    if (th->function == dsda_UpdateControlCeilingScroller)
+    {
+      P_SavePackedThinker(tc_scroll_ceiling_control, th, sizeof(control_scroll_t));
+      continue;
+    }
+
+    if (th->function == dsda_UpdateControlFloorCarryScroller)
+    {
+      P_SavePackedThinker(tc_scroll_floor_carry_control, th, sizeof(control_scroll_t));
+      continue;
+    }
+
+    // phares 3/22/98: Push/Pull effect thinkers
+
+    if (th->function == T_Pusher)
+    {
+      pusher_t pusher = *(pusher_t *) th;
+      pusher.source = NULL; // restored from affectee by P_GetPushThing
+      P_SavePackedThinker(tc_pusher, &pusher.thinker, sizeof(pusher));
+      continue;
+    }
+
+    if (th->function == T_Friction)
+    {
+      P_SavePackedThinker(tc_friction, th, sizeof(friction_t));
+      continue;
+    }
+
+    if (th->function == T_Light)
+    {
+      light_t light = *(light_t *) th;
+      light.sector = (sector_t *)(intptr_t)(light.sector->iSectorID);
+      P_SavePackedThinker(tc_light, &light.thinker, sizeof(light));
+      continue;
+    }
+
+    if (th->function == T_Phase)
+    {
+      phase_t phase = *(phase_t *) th;
+      phase.sector = (sector_t *)(intptr_t)(phase.sector->iSectorID);
+      P_SavePackedThinker(tc_phase, &phase.thinker, sizeof(phase));
+      continue;
+    }
+
+    if (th->function == T_BuildPillar)
+    {
+      pillar_t pillar = *(pillar_t *) th;
+      pillar.sector = (sector_t *)(intptr_t)(pillar.sector->iSectorID);
+      P_SavePackedThinker(tc_pillar, &pillar.thinker, sizeof(pillar));
+      continue;
+    }
+
+    if (P_IsMobjThinker(th))
+    {
+      P_ArchiveMobj((mobj_t *) th);
+      continue;
+    }
+  }
+
+  start = P_SaveOffset();
+
+  // add a terminating marker
+  P_SAVE_BYTE(tc_end);
+
+  // killough 9/14/98: save soundtargets
+  {
+    int i;
+    for (i = 0; i < numsectors; i++)
+    {
+      // Fix crash on reload when a soundtarget points to a removed corpse
+      // (prboom bug #1590350)
+      P_SAVE_VARUINT(P_MobjIndex(sectors[i].soundtarget));
+    }
+  }
+
+  P_ArchiveBlockLinks();
+  P_ArchiveThinkerSubclasses();
+
+  thinker_class_bytes[tc_end] += P_SaveOffset() - start;
+}
@@ -46,6 +46,8 @@
 #include "p_spec.h"
 #include "p_tick.h"
 #include "p_enemy.h"
+#include "p_saveg.h"
+#include "p_hash.h"
 #include "lprintf.h" //jff 10/6/98 for debug outputs
 #include "v_video.h"
 #include "g_overflow.h"
@@ -70,31 +72,31 @@
 // Store VERTEXES, LINEDEFS, SIDEDEFS, etc.
 //
 
-__thread int      numvertexes;
-__thread vertex_t *vertexes;
+__STORAGE_MODIFIER int      numvertexes;
+__STORAGE_MODIFIER vertex_t *vertexes;
 
-__thread int      numsegs;
-__thread seg_t    *segs;
+__STORAGE_MODIFIER int      numsegs;
+__STORAGE_MODIFIER seg_t    *segs;
 
-__thread int      numsectors;
-__thread sector_t *sectors;
+__STORAGE_MODIFIER int      numsectors;
+__STORAGE_MODIFIER sector_t *sectors;
 
-__thread int      numsubsectors;
-__thread subsector_t *subsectors;
+__STORAGE_MODIFIER int      numsubsectors;
+__STORAGE_MODIFIER subsector_t *subsectors;
 
-__thread int      numnodes;
-__thread node_t   *nodes;
+__STORAGE_MODIFIER int      numnodes;
+__STORAGE_MODIFIER node_t   *nodes;
 
-__thread int      numlines;
-__thread line_t   *lines;
+__STORAGE_MODIFIER int      numlines;
+__STORAGE_MODIFIER line_t   *lines;
 
-__thread int      numsides;
-__thread side_t   *sides;
+__STORAGE_MODIFIER int      numsides;
+__STORAGE_MODIFIER side_t   *sides;
 
-__thread int      *sslines_indexes;
-__thread ssline_t *sslines;
+__STORAGE_MODIFIER int      *sslines_indexes;
+__STORAGE_MODIFIER ssline_t *sslines;
 
-__thread byte     *map_subsectors;
+__STORAGE_MODIFIER byte     *map_subsectors;
 
 typedef enum {
   UNKNOWN_NODES = -1,
@@ -110,10 +112,10 @@ typedef enum {
   ZDOOM_ZGL3_NODES,
 } nodes_version_t;
 
-__thread int firstglvertex = 0;
-static __thread nodes_version_t nodesVersion = DEFAULT_BSP_NODES;
-__thread dboolean use_gl_nodes = false;
-__thread dboolean has_behavior;
+__STORAGE_MODIFIER int firstglvertex = 0;
+static __STORAGE_MODIFIER nodes_version_t nodesVersion = DEFAULT_BSP_NODES;
+__STORAGE_MODIFIER dboolean use_gl_nodes = false;
+__STORAGE_MODIFIER dboolean has_behavior;
 
 // figgi 08/21/00 -- glSegs
 typedef struct
@@ -137,18 +139,18 @@ typedef struct
 //
 // Blockmap size.
 
-__thread int       bmapwidth, bmapheight;  // size in mapblocks
+__STORAGE_MODIFIER int       bmapwidth, bmapheight;  // size in mapblocks
 
 // killough 3/1/98: remove blockmap limit internally:
-__thread int       *blockmap;              // was short -- killough
+__STORAGE_MODIFIER int       *blockmap;              // was short -- killough
 
 // offsets in blockmap are from here
-__thread int       *blockmaplump;          // was short -- killough
+__STORAGE_MODIFIER int       *blockmaplump;          // was short -- killough
 
-__thread fixed_t   bmaporgx, bmaporgy;     // origin of block map
+__STORAGE_MODIFIER fixed_t   bmaporgx, bmaporgy;     // origin of block map
 
-__thread mobj_t    **blocklinks;           // for thing chains
-__thread int       blocklinks_count;
+__STORAGE_MODIFIER mobj_t    **blocklinks;           // for thing chains
+__STORAGE_MODIFIER int       blocklinks_count;
 
 // MAES: extensions to support 512x512 blockmaps.
 // They represent the maximum negative number which represents
@@ -160,10 +162,10 @@ __thread int       blocklinks_count;
 // A 511x511 blockmap would still have a valid negative number
 // e.g. -1..510, so they would be set to -2
 // Non-extreme maps remain unaffected.
-__thread int blockmapxneg = -257;
-__thread int blockmapyneg = -257;
+__STORAGE_MODIFIER int blockmapxneg = -257;
+__STORAGE_MODIFIER int blockmapyneg = -257;
 
-__thread dboolean skipblstart;  // MaxW: Skip initial blocklist short
+__STORAGE_MODIFIER dboolean skipblstart;  // MaxW: Skip initial blocklist short
 
 //
 // REJECT
@@ -174,22 +176,22 @@ __thread dboolean skipblstart;  // MaxW: Skip initial blocklist short
 // be used as a PVS lookup as well.
 //
 
-__thread const byte *rejectmatrix; // cph - const*
+__STORAGE_MODIFIER const byte *rejectmatrix; // cph - const*
 
 // Maintain single and multi player starting spots.
 
 // 1/11/98 killough: Remove limit on deathmatch starts
-__thread mapthing_t *deathmatchstarts;      // killough
-__thread size_t     num_deathmatchstarts;   // killough
+__STORAGE_MODIFIER mapthing_t *deathmatchstarts;      // killough
+__STORAGE_MODIFIER size_t     num_deathmatchstarts;   // killough
 
-__thread mapthing_t *deathmatch_p;
-__thread mapthing_t playerstarts[MAX_PLAYER_STARTS][MAX_MAXPLAYERS];
+__STORAGE_MODIFIER mapthing_t *deathmatch_p;
+__STORAGE_MODIFIER mapthing_t playerstarts[MAX_PLAYER_STARTS][MAX_MAXPLAYERS];
 
-static __thread int current_episode = -1;
-static __thread int current_map = -1;
-static __thread nodes_version_t current_nodesVersion = UNKNOWN_NODES;
-static __thread int samelevel = false;
-static __thread int inconsistent_nodes;
+static __STORAGE_MODIFIER int current_episode = -1;
+static __STORAGE_MODIFIER int current_map = -1;
+static __STORAGE_MODIFIER nodes_version_t current_nodesVersion = UNKNOWN_NODES;
+static __STORAGE_MODIFIER int samelevel = false;
+static __STORAGE_MODIFIER int inconsistent_nodes;
 
 typedef struct
 {
@@ -209,13 +211,18 @@ typedef struct
   int znodes;
 } level_components_t;
 
-static __thread level_components_t level_components;
+static __STORAGE_MODIFIER level_components_t level_components;
 
 // e6y: Smart malloc
 // Used by P_SetupLevel() for smart data loading
 // Do nothing if level is the same
 static void *malloc_IfSameLevel(void* p, size_t size)
 {
+  // The level arena is rewound on every level load
+  if (Z_LevelArenaEnabled())
+  {
+    return Z_MallocLevel(size);
+  }
   if (!samelevel || !p)
   {
     return Z_Malloc(size);
@@ -228,6 +235,10 @@ static void *malloc_IfSameLevel(void* p, size_t size)
 // Clear the memory without allocation if level is the same
 static void *calloc_IfSameLevel(void* p, size_t n1, size_t n2)
 {
+  if (Z_LevelArenaEnabled())
+  {
+    return Z_CallocLevel(n1, n2);
+  }
   if (!samelevel)
   {
     return Z_Calloc(n1, n2);
@@ -1358,7 +1369,7 @@ static void P_LoadZNodes(int lump, int glnodes)
     Z_Free(output);
 }
 
-static __thread int no_overlapped_sprites;
+static __STORAGE_MODIFIER int no_overlapped_sprites;
 #define GETXY(mobj) ((mobj)->x + ((mobj)->y >> 16))
 static int C_DECL dicmp_sprite_by_pos(const void *a, const void *b)
 {
@@ -1981,7 +1992,7 @@ static void AddBlockLine
   done[blockno] = 1;
 }
 
-__thread blockmap_t original_blockmap;
+__STORAGE_MODIFIER blockmap_t original_blockmap;
 
 static void RememberOriginalBlockMap(void)
 {
@@ -2814,7 +2825,7 @@ map_loader_t legacy_map_loader = {
   .po_load_things = NULL,
 };
 
-__thread map_loader_t map_loader;
+__STORAGE_MODIFIER map_loader_t map_loader;
 
 void P_UpdateMapLoader(int lumpnum)
 {
@@ -2853,7 +2864,7 @@ void P_InitSubsectorsLines(void)
   }
 
   count = 0;
-  sslines_indexes = Z_Malloc((numsubsectors + 1) * sizeof(sslines_indexes[0]));
+  sslines_indexes = malloc_IfSameLevel(NULL, (numsubsectors + 1) * sizeof(sslines_indexes[0]));
 
   for (num = 0; num < numsubsectors; num++)
   {
@@ -2883,7 +2894,7 @@ void P_InitSubsectorsLines(void)
 
   sslines_indexes[numsubsectors] = count;
 
-  sslines = Z_Malloc(count * sizeof(sslines[0]));
+  sslines = malloc_IfSameLevel(NULL, count * sizeof(sslines[0]));
   count = 0;
 
   for (num = 0; num < numsubsectors; num++)
@@ -2931,7 +2942,7 @@ void P_InitSubsectorsLines(void)
   }
 }
 
-static __thread dboolean must_rebuild_blockmap;
+static __STORAGE_MODIFIER dboolean must_rebuild_blockmap;
 
 void P_MustRebuildBlockmap(void)
 {
@@ -2959,17 +2970,23 @@ void P_SetupLevel(int episode, int map, int playermask, int skill)
 
   for (i = 0; i < g_maxplayers; i++)
   {
-    players[i].killcount = players[i].secretcount = players[i].itemcount = 0;
-    players[i].maxkilldiscount = 0;//e6y
+    engine_context->players[i].killcount = engine_context->players[i].secretcount = engine_context->players[i].itemcount = 0;
+    engine_context->players[i].maxkilldiscount = 0;//e6y
   }
 
   // find map name
   snprintf(lumpname, sizeof(lumpname), "%s", dsda_MapLumpName(episode, map));
   lumpnum = W_GetNumForName(lumpname);
 
+  // The active plat / ceiling lists are level blocks too
+  P_RemoveAllActiveCeilings();
+  P_RemoveAllActivePlats();
+  P_ResetWorldArchive();
+
   Z_FreeLevel();
 
   P_InitThinkers();
+  P_InitMobjIds();
 
   // e6y
   // Refuse to load a map with incomplete pwad structure.
@@ -2978,7 +2995,7 @@ void P_SetupLevel(int episode, int map, int playermask, int skill)
 
   dsda_ApplyLevelCompatibility(lumpnum);
 
-  leveltime = 0; totallive = 0;
+  engine_context->leveltime = 0; totallive = 0;
 
   // note: most of this ordering is important
 
@@ -2989,7 +3006,8 @@ void P_SetupLevel(int episode, int map, int playermask, int skill)
   // figgi 10/19/00 -- check for gl lumps and load them
   P_GetNodesVersion();
 
-  samelevel = !inconsistent_nodes &&
+  samelevel = !Z_LevelArenaEnabled() &&
+              !inconsistent_nodes &&
               map == current_map &&
               episode == current_episode &&
               nodesVersion == current_nodesVersion;
@@ -3086,7 +3104,8 @@ void P_SetupLevel(int episode, int map, int playermask, int skill)
       break;
   }
 
-  if (!samelevel)
+  // The level arena holds new lines even for the same level
+  if (!samelevel || Z_LevelArenaEnabled())
   {
     P_InitSubsectorsLines();
   }
@@ -3103,10 +3122,12 @@ void P_SetupLevel(int episode, int map, int playermask, int skill)
   R_CalcSegsLength();
 
   /* cph - reset all multiplayer starts */
+  /* The deathmatch starts are level data, freed along with the level */
   memset(playerstarts,0,sizeof(playerstarts));
-  deathmatch_p = deathmatchstarts;
+  deathmatchstarts = deathmatch_p = NULL;
+  num_deathmatchstarts = 0;
   for (i = 0; i < g_maxplayers; i++)
-    players[i].mo = NULL;
+    engine_context->players[i].mo = NULL;
 
   P_MapStart();
 
@@ -3116,25 +3137,25 @@ void P_SetupLevel(int episode, int map, int playermask, int skill)
   if (deathmatch)
   {
     for (i = 0; i < g_maxplayers; i++)
-      if (playeringame[i])
+      if (engine_context->playeringame[i])
         {
-          players[i].mo = NULL; // not needed? - done before P_LoadThings
+          engine_context->players[i].mo = NULL; // not needed? - done before P_LoadThings
           G_DeathMatchSpawnPlayer(i);
         }
   }
   else // if !deathmatch, check all necessary player starts actually exist
   {
     for (i = 0; i < g_maxplayers; i++)
-      if (playeringame[i] && !players[i].mo)
+      if (engine_context->playeringame[i] && !engine_context->players[i].mo)
         I_Error("P_SetupLevel: missing player %d start\n", i+1);
   }
 
-  players[consoleplayer].viewz = players[consoleplayer].mo->z +
-                                 players[consoleplayer].viewheight;
+  engine_context->players[consoleplayer].viewz = engine_context->players[consoleplayer].mo->z +
+                                 engine_context->players[consoleplayer].viewheight;
 
-  if (players[consoleplayer].cheats & CF_FLY)
+  if (engine_context->players[consoleplayer].cheats & CF_FLY)
   {
-    players[consoleplayer].mo->flags |= (MF_NOGRAVITY | MF_FLY);
+    engine_context->players[consoleplayer].mo->flags |= (MF_NOGRAVITY | MF_FLY);
   }
 
   // killough 3/26/98: Spawn icon landings:
@@ -3149,6 +3170,13 @@ void P_SetupLevel(int episode, int map, int playermask, int skill)
 
   P_MapEnd();
 
+  // saved states only carry the world changes made from here on
+  P_InitWorldArchive();
+
+  // from here on the world hash, if read, is kept up to date as the world changes
+  if (world_hash_tracked)
+    P_RebuildWorldHash();
+
   dsda_HandleMapPreferences();
 
   dsda_ApplyFadeTable();
@@ -39,20 +39,20 @@
 void P_SetupLevel(int episode, int map, int playermask, int skill);
 void P_Init(void);               /* Called by startup code. */
 
-extern __thread const byte *rejectmatrix;   /* for fast sight rejection -  cph - const* */
-extern __thread int      *blockmaplump;   /* offsets in blockmap are from here */
-extern __thread int      *blockmap;
-extern __thread int      bmapwidth;
-extern __thread int      bmapheight;      /* in mapblocks */
-extern __thread fixed_t  bmaporgx;
-extern __thread fixed_t  bmaporgy;        /* origin of block map */
-extern __thread mobj_t   **blocklinks;    /* for thing chains */
+extern __STORAGE_MODIFIER const byte *rejectmatrix;   /* for fast sight rejection -  cph - const* */
+extern __STORAGE_MODIFIER int      *blockmaplump;   /* offsets in blockmap are from here */
+extern __STORAGE_MODIFIER int      *blockmap;
+extern __STORAGE_MODIFIER int      bmapwidth;
+extern __STORAGE_MODIFIER int      bmapheight;      /* in mapblocks */
+extern __STORAGE_MODIFIER fixed_t  bmaporgx;
+extern __STORAGE_MODIFIER fixed_t  bmaporgy;        /* origin of block map */
+extern __STORAGE_MODIFIER mobj_t   **blocklinks;    /* for thing chains */
 
-extern __thread dboolean skipblstart; // MaxW: Skip initial blocklist short
+extern __STORAGE_MODIFIER dboolean skipblstart; // MaxW: Skip initial blocklist short
 
 // MAES: extensions to support 512x512 blockmaps.
-extern __thread int blockmapxneg;
-extern __thread int blockmapyneg;
+extern __STORAGE_MODIFIER int blockmapxneg;
+extern __STORAGE_MODIFIER int blockmapyneg;
 
 typedef struct
 {
@@ -62,7 +62,7 @@ typedef struct
   fixed_t orgy;
 } blockmap_t;
 
-extern __thread blockmap_t original_blockmap;
+extern __STORAGE_MODIFIER blockmap_t original_blockmap;
 
 void P_RestoreOriginalBlockMap(void);
 
@@ -78,7 +78,7 @@ typedef struct
   void (*po_load_things)(int lump);
 } map_loader_t;
 
-extern __thread map_loader_t map_loader;
+extern __STORAGE_MODIFIER map_loader_t map_loader;
 
 
 #endif
@@ -53,11 +53,11 @@ This uses specialized forms of the maputils routines for optimized performance
 ==============================================================================
 */
 
-__thread fixed_t sightzstart;            // eye z of looker
-__thread fixed_t topslope, bottomslope;  // slopes to top and bottom of target
-__thread int sightcounts[3];
+__STORAGE_MODIFIER fixed_t sightzstart;            // eye z of looker
+__STORAGE_MODIFIER fixed_t topslope, bottomslope;  // slopes to top and bottom of target
+__STORAGE_MODIFIER int sightcounts[3];
 
-__thread CrossSubsectorFunc P_CrossSubsector;
+__STORAGE_MODIFIER CrossSubsectorFunc P_CrossSubsector;
 
 /*
 ==============
@@ -403,7 +403,7 @@ typedef struct {
   fixed_t maxz,minz;               // cph - z optimisations for 2sided lines
 } los_t;
 
-static __thread los_t los; // cph - made static
+static __STORAGE_MODIFIER los_t los; // cph - made static
 
 //
 // P_DivlineSide
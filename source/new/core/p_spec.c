@@ -42,6 +42,7 @@
 #include "doomstat.h"
 #include "p_spec.h"
 #include "p_tick.h"
+#include "p_saveg.h"
 #include "p_setup.h"
 #include "m_random.h"
 #include "w_wad.h"
@@ -102,12 +103,12 @@ typedef struct
 
 #define MAXANIMS 32                   // no longer a strict limit -- killough
 
-static __thread anim_t*  lastanim;
-static __thread anim_t*  anims;                // new structure w/o limits -- killough
-static __thread size_t maxanims;
+static __STORAGE_MODIFIER anim_t*  lastanim;
+static __STORAGE_MODIFIER anim_t*  anims;                // new structure w/o limits -- killough
+static __STORAGE_MODIFIER size_t maxanims;
 
-__thread TAnimItemParam *anim_flats = NULL;
-__thread TAnimItemParam *anim_textures = NULL;
+__STORAGE_MODIFIER TAnimItemParam *anim_flats = NULL;
+__STORAGE_MODIFIER TAnimItemParam *anim_textures = NULL;
 
 // killough 3/7/98: Initialize generalized scrolling
 static void P_SpawnScrollers(void);
@@ -131,8 +132,8 @@ const animdef_t heretic_animdefs[] = {
 
 // heretic
 #define MAXLINEANIMS 64*256
-__thread short numlinespecials;
-__thread line_t *linespeciallist[MAXLINEANIMS];
+__STORAGE_MODIFIER short numlinespecials;
+__STORAGE_MODIFIER line_t *linespeciallist[MAXLINEANIMS];
 
 //e6y
 void MarkAnimatedTextures(void)
@@ -407,6 +408,10 @@ fixed_t P_FindHighestFloorSurrounding(sector_t *sec)
 }
 
 
+// Scratch space for P_FindNextHighestFloor, grown in the static zone
+__STORAGE_MODIFIER fixed_t *heightlist = NULL;
+__STORAGE_MODIFIER int heightlist_size = 0;
+
 //
 // P_FindNextHighestFloor()
 //
@@ -429,12 +434,10 @@ fixed_t P_FindNextHighestFloor(sector_t *sec, int currentheight)
   {
     int h;
     int min;
-    static __thread int MAX_ADJOINING_SECTORS = 0;
-    static __thread fixed_t *heightlist = NULL;
-    static __thread int heightlist_size = 0;
+    static __STORAGE_MODIFIER int MAX_ADJOINING_SECTORS = 0;
     line_t* check;
     fixed_t height = currentheight;
-    static __thread fixed_t last_height_0 = 0;
+    static __STORAGE_MODIFIER fixed_t last_height_0 = 0;
 
     // 20 adjoining sectors max!
     if (!MAX_ADJOINING_SECTORS)
@@ -1339,6 +1342,7 @@ static void P_ResetSectorTransferFlags(unsigned int *flags)
 
 void P_CopySectorSpecial(sector_t *dest, sector_t *source)
 {
+  P_MarkSectorChanged(dest);
   dest->special = source->special;
   dest->damage = source->damage;
   P_TransferSectorFlags(&dest->flags, source->flags);
@@ -1346,6 +1350,7 @@ void P_CopySectorSpecial(sector_t *dest, sector_t *source)
 
 void P_TransferSpecial(sector_t *sector, newspecial_t *newspecial)
 {
+  P_MarkSectorChanged(sector);
   sector->special = newspecial->special;
   sector->damage = newspecial->damage;
   P_TransferSectorFlags(&sector->flags, newspecial->flags);
@@ -1367,6 +1372,7 @@ void P_ResetTransferSpecial(newspecial_t *newspecial)
 
 void P_ResetSectorSpecial(sector_t *sector)
 {
+  P_MarkSectorChanged(sector);
   sector->special = 0;
   sector->damage = no_damage;
   P_ResetSectorTransferFlags(&sector->flags);
@@ -1375,6 +1381,7 @@ void P_ResetSectorSpecial(sector_t *sector)
 void P_ClearNonGeneralizedSectorSpecial(sector_t *sector)
 {
   // jff 3/14/98 clear non-generalized sector type
+  P_MarkSectorChanged(sector);
   sector->special &= map_format.generalized_mask;
 }
 
@@ -1386,6 +1393,7 @@ dboolean P_IsSpecialSector(sector_t *sector)
 static void P_AddSectorSecret(sector_t *sector)
 {
   totalsecret++;
+  P_MarkSectorChanged(sector);
   sector->flags |= SECF_SECRET | SECF_WASSECRET;
 }
 
@@ -1402,6 +1410,7 @@ void P_PlayerCollectSecret(player_t *player)
 
 static void P_CollectSecretCommon(sector_t *sector, player_t *player)
 {
+  P_MarkSectorChanged(sector);
   sector->flags &= ~SECF_SECRET;
 
   P_PlayerCollectSecret(player);
@@ -1409,12 +1418,14 @@ static void P_CollectSecretCommon(sector_t *sector, player_t *player)
 
 static void P_CollectSecretVanilla(sector_t *sector, player_t *player)
 {
+  P_MarkSectorChanged(sector);
   sector->special = 0;
   P_CollectSecretCommon(sector, player);
 }
 
 static void P_CollectSecretBoom(sector_t *sector, player_t *player)
 {
+  P_MarkSectorChanged(sector);
   sector->special &= ~SECRET_MASK;
 
   if (sector->special < 32) // if all extended bits clear,
@@ -1499,7 +1510,7 @@ void P_CrossHexenSpecialLine(line_t *line, int side, mobj_t *thing, dboolean bos
 //  crossed. Change is qualified by demo_compatibility.
 //
 // CPhipps - take a line_t pointer instead of a line number, as in MBF
-void P_CrossCompatibleSpecialLine(line_t *line, int side, mobj_t *thing, dboolean bossaction)
+static void P_DoCrossCompatibleSpecialLine(line_t *line, int side, mobj_t *thing, dboolean bossaction)
 {
   int ok;
 
@@ -2409,6 +2420,17 @@ void P_CrossCompatibleSpecialLine(line_t *line, int side, mobj_t *thing, dboolea
   }
 }
 
+// Walk once triggers clear the special of the line they fire from
+void P_CrossCompatibleSpecialLine(line_t *line, int side, mobj_t *thing, dboolean bossaction)
+{
+  const short special = line->special;
+
+  P_DoCrossCompatibleSpecialLine(line, side, thing, bossaction);
+
+  if (line->special != special)
+    P_MarkLineChanged(line);
+}
+
 void P_CrossZDoomSpecialLine(line_t *line, int side, mobj_t *thing, dboolean bossaction)
 {
   if (thing->player)
@@ -2626,7 +2648,7 @@ void P_ShootHexenSpecialLine(mobj_t *thing, line_t *line)
 static void P_ApplySectorDamage(player_t *player, int damage, int leak)
 {
   if (!player->powers[pw_ironfeet] || (leak && P_Random(pr_slimehurt) < leak))
-    if (!(leveltime & 0x1f))
+    if (!(engine_context->leveltime & 0x1f))
       P_DamageMobj(player->mo, NULL, NULL, damage);
 }
 
@@ -2635,7 +2657,7 @@ static void P_ApplySectorDamageEndLevel(player_t *player)
   if (comp[comp_god])
     player->cheats &= ~CF_GODMODE;
 
-  if (!(leveltime & 0x1f))
+  if (!(engine_context->leveltime & 0x1f))
     P_DamageMobj(player->mo, NULL, NULL, 20);
 
   if (player->health <= 10)
@@ -2704,14 +2726,14 @@ void P_PlayerInCompatibleSector(player_t *player, sector_t *sector)
           break;
         case 2:
           for (i = 0; i < g_maxplayers; i++)
-            if (playeringame[i])
-              P_DamageMobj(players[i].mo, NULL, NULL, 10000);
+            if (engine_context->playeringame[i])
+              P_DamageMobj(engine_context->players[i].mo, NULL, NULL, 10000);
           G_ExitLevel(0);
           break;
         case 3:
           for (i = 0; i < g_maxplayers; i++)
-            if (playeringame[i])
-              P_DamageMobj(players[i].mo, NULL, NULL, 10000);
+            if (engine_context->playeringame[i])
+              P_DamageMobj(engine_context->players[i].mo, NULL, NULL, 10000);
           G_SecretExitLevel(0);
           break;
       }
@@ -2803,10 +2825,10 @@ dboolean P_MobjInZDoomSector(mobj_t *mobj)
 //  levelFragLimit, levelFragLimitCount
 //
 
-static __thread dboolean  levelTimer;
-static __thread int      levelTimeCount;
-__thread dboolean         levelFragLimit;      // Ty 03/18/98 Added -frags support
-__thread int             levelFragLimitCount; // Ty 03/18/98 Added -frags support
+static __STORAGE_MODIFIER dboolean  levelTimer;
+static __STORAGE_MODIFIER int      levelTimeCount;
+__STORAGE_MODIFIER dboolean         levelFragLimit;      // Ty 03/18/98 Added -frags support
+__STORAGE_MODIFIER int             levelFragLimitCount; // Ty 03/18/98 Added -frags support
 
 void P_UpdateSpecials (void)
 {
@@ -2831,12 +2853,12 @@ void P_UpdateSpecials (void)
     int k,m,fragcount,exitflag=false;
     for (k = 0; k < g_maxplayers; k++)
     {
-      if (!playeringame[k]) continue;
+      if (!engine_context->playeringame[k]) continue;
       fragcount = 0;
       for (m = 0; m < g_maxplayers; m++)
       {
-        if (!playeringame[m]) continue;
-          fragcount += (m!=k)?  players[k].frags[m] : -players[k].frags[m];
+        if (!engine_context->playeringame[m]) continue;
+          fragcount += (m!=k)?  engine_context->players[k].frags[m] : -engine_context->players[k].frags[m];
       }
       if (fragcount >= levelFragLimitCount) exitflag = true;
       if (exitflag == true) break; // skip out of the loop--we're done
@@ -2853,7 +2875,7 @@ void P_UpdateSpecials (void)
     {
       for (i = 0; i < anim->numpics; ++i)
       {
-        pic = anim->basepic + ((leveltime / anim->speed + i) % anim->numpics);
+        pic = anim->basepic + ((engine_context->leveltime / anim->speed + i) % anim->numpics);
         if (anim->istexture)
           texturetranslation[anim->basepic + i] = pic;
         else
@@ -2994,6 +3016,7 @@ void P_SetupSectorDamage(sector_t *sector, short amount,
   sector->damage.amount = amount;
   sector->damage.interval = interval;
   sector->damage.leakrate = leakrate;
+  P_MarkSectorChanged(sector);
   sector->flags = (sector->flags & ~SECF_DAMAGEFLAGS) | (flags & SECF_DAMAGEFLAGS);
 }
 
@@ -3243,9 +3266,9 @@ void P_SpawnCompatibleScroller(line_t *l, int i)
   }
 }
 
-static __thread int copyscroller_count = 0;
-static __thread int copyscroller_max = 0;
-static __thread line_t **copyscrollers;
+static __STORAGE_MODIFIER int copyscroller_count = 0;
+static __STORAGE_MODIFIER int copyscroller_max = 0;
+static __STORAGE_MODIFIER line_t **copyscrollers;
 
 static void P_AddCopyScroller(line_t *l)
 {
@@ -3444,6 +3467,7 @@ void P_ResolveFrictionFactor(fixed_t friction_factor, sector_t *sec)
   if (sec->movefactor < 32)
     sec->movefactor = 32;
 
+  P_MarkSectorChanged(sec);
   sec->flags |= SECF_FRICTION;
 }
 
@@ -3601,7 +3625,7 @@ static void Add_Pusher(int type, int x_mag, int y_mag, mobj_t* source, int affec
 //
 // killough 10/98: allow to affect things besides players
 
-__thread pusher_t* tmpusher; // pusher structure for blockmap searches
+__STORAGE_MODIFIER pusher_t* tmpusher; // pusher structure for blockmap searches
 
 static dboolean PIT_PushThing(mobj_t* thing)
 {
@@ -3865,7 +3889,7 @@ static void P_SpawnPushers(void)
       map_format.spawn_pusher(l);
 }
 
-__thread mobj_t LavaInflictor;
+__STORAGE_MODIFIER mobj_t LavaInflictor;
 
 
 void P_InitLava(void)
@@ -3970,6 +3994,7 @@ dboolean P_ActivateLine(line_t * line, mobj_t * mo, int side, line_activation_t
 
   if (!repeat && buttonSuccess)
   {                           // clear the special on non-retriggerable lines
+    P_MarkLineChanged(line);
     line->special = 0;
   }
 
@@ -36,6 +36,7 @@
 #include "r_main.h"
 #include "p_maputl.h"
 #include "p_spec.h"
+#include "p_saveg.h"
 #include "g_game.h"
 #include "sounds.h"
 #include "lprintf.h"
@@ -71,13 +72,13 @@ const switchlist_t hexen_alphSwitchList[] = {
 
 // killough 2/8/98: Remove switch limit
 
-static __thread int *switchlist;                           // killough
-static __thread int max_numswitches;                       // killough
-static __thread int numswitches;                           // killough
+static __STORAGE_MODIFIER int *switchlist;                           // killough
+static __STORAGE_MODIFIER int max_numswitches;                       // killough
+static __STORAGE_MODIFIER int numswitches;                           // killough
 
-__thread button_t  buttonlist[MAXBUTTONS];
+__STORAGE_MODIFIER button_t  buttonlist[MAXBUTTONS];
 
-const __thread switchlist_t *alphSwitchList;         //jff 3/23/98 pointer to switch table
+const __STORAGE_MODIFIER switchlist_t *alphSwitchList;         //jff 3/23/98 pointer to switch table
 
 //
 // P_InitSwitchList()
@@ -213,7 +214,10 @@ void P_ChangeSwitchTexture
 
   /* don't zero line->special until after exit switch test */
   if (!useAgain)
+  {
+    P_MarkLineChanged(line);
     line->special = 0;
+  }
 
   /* search for a texture to change */
   texture = NULL; position = 0;
@@ -485,7 +489,10 @@ P_UseSpecialLine
         case PushOnce:
           if (!side)
             if (linefunc(line))
+            {
+              P_MarkLineChanged(line);
               line->special = 0;
+            }
           return true;
         case PushMany:
           if (!side)
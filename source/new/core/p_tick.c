@@ -35,14 +35,13 @@
 #include "p_user.h"
 #include "p_spec.h"
 #include "p_tick.h"
+#include "p_hash.h"
 #include "p_map.h"
 #include "e6y.h"
 
 #include "dsda.h"
 
-__thread int leveltime;
-
-static __thread dboolean newthinkerpresent;
+static __STORAGE_MODIFIER dboolean newthinkerpresent;
 
 //
 // THINKERS
@@ -54,8 +53,8 @@ static __thread dboolean newthinkerpresent;
 
 // killough 8/29/98: we maintain several separate threads, each containing
 // a special class of thinkers, to allow more efficient searches.
-__thread thinker_t thinkerclasscap[th_all+1];
-__thread int init_thinkers_count = 0;
+// Their caps are in the engine context.
+__STORAGE_MODIFIER int init_thinkers_count = 0;
 
 //
 // P_InitThinkers
@@ -66,7 +65,7 @@ void P_InitThinkers(void)
   int i;
 
   for (i=0; i<NUMTHCLASS; i++)  // killough 8/29/98: initialize threaded lists
-    thinkerclasscap[i].cprev = thinkerclasscap[i].cnext = &thinkerclasscap[i];
+    engine_context->thinkerclasscap[i].cprev = engine_context->thinkerclasscap[i].cnext = &engine_context->thinkerclasscap[i];
 
   thinkercap.prev = thinkercap.next  = &thinkercap;
 
@@ -101,7 +100,7 @@ void P_UpdateThinker(thinker_t *thinker)
   }
 
   // Add to appropriate thread
-  th = &thinkerclasscap[class];
+  th = &engine_context->thinkerclasscap[class];
   th->cprev->cnext = thinker;
   thinker->cnext = th;
   thinker->cprev = th->cprev;
@@ -134,7 +133,7 @@ void P_AddThinker(thinker_t* thinker)
 // Make currentthinker external, so that P_RemoveThinkerDelayed
 // can adjust currentthinker when thinkers self-remove.
 
-static __thread thinker_t *currentthinker;
+static __STORAGE_MODIFIER thinker_t *currentthinker;
 
 //
 // P_RemoveThinkerDelayed()
@@ -193,7 +192,7 @@ void P_RemoveThinker(thinker_t *thinker)
  */
 thinker_t* P_NextThinker(thinker_t* th, th_class cl)
 {
-  thinker_t* top = &thinkerclasscap[cl];
+  thinker_t* top = &engine_context->thinkerclasscap[cl];
   if (!th) th = top;
   th = cl == th_all ? th->next : th->cnext;
   return th == top ? NULL : th;
@@ -213,10 +212,16 @@ thinker_t* P_NextThinker(thinker_t* th, th_class cl)
 
 void P_SetTarget(mobj_t **mop, mobj_t *targ)
 {
+  // A removed mobj only holds an id (see P_AssignMobjId) while referenced
+
   if (*mop)             // If there was a target already, decrease its refcount
-    (*mop)->thinker.references--;
+    if (!--(*mop)->thinker.references &&
+        (*mop)->thinker.function == P_RemoveThinkerDelayed)
+      P_ReleaseMobjId(*mop);
   if ((*mop = targ))    // Set new target and if non-NULL, increase its counter
-    targ->thinker.references++;
+    if (!targ->thinker.references++ &&
+        targ->thinker.function == P_RemoveThinkerDelayed)
+      P_AssignMobjId(targ);
 }
 
 //
@@ -278,12 +283,12 @@ static void P_FrozenTicker (void)
     mobj_t* mo;
 
     for (i = 0; i < g_maxplayers; i++)
-      if (playeringame[i])
-        P_PlayerThink(&players[i]);
+      if (engine_context->playeringame[i])
+        P_PlayerThink(&engine_context->players[i]);
 
     for (i = 0; i < g_maxplayers; i++)
-      if (playeringame[i])
-        P_MobjThinker(players[i].mo);
+      if (engine_context->playeringame[i])
+        P_MobjThinker(engine_context->players[i].mo);
 
     for (th = thinkercap.next; th != &thinkercap; th = th->next)
       if (th->function == P_MobjThinker ||
@@ -291,7 +296,7 @@ static void P_FrozenTicker (void)
       {
         mo = (mobj_t *) th;
 
-        if (mo->player && mo->player == &players[displayplayer])
+        if (mo->player && mo->player == &engine_context->players[displayplayer])
           continue;
 
       }
@@ -320,8 +325,8 @@ void P_Ticker (void)
     // not if this is an intermission screen
     if (gamestate == GS_LEVEL)
       for (i = 0; i < g_maxplayers; i++)
-        if (playeringame[i])
-          P_PlayerThink(&players[i]);
+        if (engine_context->playeringame[i])
+          P_PlayerThink(&engine_context->players[i]);
 
     P_RunThinkers();
     P_UpdateSpecials();
@@ -331,5 +336,8 @@ void P_Ticker (void)
 
   }
 
-  leveltime++;                       // for par times
+  if (world_hash_tracked)
+    P_RehashMobjs();
+
+  engine_context->leveltime++;                       // for par times
 }
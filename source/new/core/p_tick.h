@@ -63,8 +63,7 @@ typedef enum {
   th_all = NUMTHCLASS, /* For P_NextThinker, indicates "any class" */
 } th_class;
 
-extern __thread thinker_t thinkerclasscap[];
-#define thinkercap thinkerclasscap[th_all]
+#define thinkercap (engine_context->thinkerclasscap[th_all])
 
 /* cph 2002/01/13 - iterator for thinker lists */
 thinker_t* P_NextThinker(thinker_t*,th_class);
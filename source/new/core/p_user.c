@@ -67,11 +67,11 @@
 
 #define MAXBOB  0x100000
 
-__thread dboolean onground; // whether player is on ground or in air
+__STORAGE_MODIFIER dboolean onground; // whether player is on ground or in air
 
 // heretic
-__thread int newtorch;      // used in the torch flicker effect.
-__thread int newtorchdelta;
+__STORAGE_MODIFIER int newtorch;      // used in the torch flicker effect.
+__STORAGE_MODIFIER int newtorchdelta;
 
 fixed_t P_PlayerSpeed(player_t* player)
 {
@@ -219,7 +219,7 @@ void P_CalcHeight (player_t* player)
     return;
   }
 
-  angle = (FINEANGLES / 20 * leveltime) & FINEMASK;
+  angle = (FINEANGLES / 20 * engine_context->leveltime) & FINEMASK;
   bob = dsda_ViewBob() ? FixedMul(player->bob / 2, finesine[angle]) : 0;
 
   // move viewheight
@@ -301,7 +301,7 @@ void P_MovePlayer (player_t* player)
 
   onground = (mo->z <= mo->floorz || mo->flags2 & MF2_ONMOBJ);
 
-  if ((player->mo->flags & MF_FLY) && player == &players[consoleplayer] && upmove != 0)
+  if ((player->mo->flags & MF_FLY) && player == &engine_context->players[consoleplayer] && upmove != 0)
   {
     mo->momz = upmove << 8;
   }
@@ -489,6 +489,65 @@ void P_PlayerEndFlight(player_t * player)
   player->mo->flags &= ~MF_NOGRAVITY;
 }
 
+//
+// P_GetCommandWeapon
+//
+// Returns whether the command selects a weapon to switch to, and which.
+// Shared by P_PlayerThink and P_CanonicalizeTiccmd, so both agree on it.
+//
+
+static dboolean P_GetCommandWeapon(const player_t* player, const ticcmd_t* cmd, weapontype_t* newweapon_p)
+{
+  weapontype_t newweapon;
+
+  if (!(cmd->buttons & BT_CHANGE) || player->morphTics)
+    return false;
+
+  newweapon = (cmd->buttons & BT_WEAPONMASK) >> BT_WEAPONSHIFT;
+
+  // killough 3/22/98: For demo compatibility we must perform the fist
+  // and SSG weapons switches here, rather than in G_BuildTiccmd(). For
+  // other games which rely on user preferences, we must use the latter.
+
+  if (demo_compatibility)
+  { // compatibility mode -- required for old demos -- killough
+    //e6y
+    if (!prboom_comp[PC_ALLOW_SSG_DIRECT].state)
+      newweapon = (cmd->buttons & BT_WEAPONMASK_OLD)>>BT_WEAPONSHIFT;
+
+      if (
+        newweapon == g_wp_fist && player->weaponowned[g_wp_chainsaw]
+        && (
+          player->readyweapon != g_wp_chainsaw ||
+          (!player->powers[pw_strength])
+        )
+      )
+        newweapon = g_wp_chainsaw;
+
+      if (
+          gamemode == commercial &&
+          newweapon == wp_shotgun &&
+          player->weaponowned[wp_supershotgun] &&
+          player->readyweapon != wp_supershotgun)
+        newweapon = wp_supershotgun;
+  }
+
+  // killough 2/8/98, 3/22/98 -- end of weapon selection changes
+
+  if (!player->weaponowned[newweapon] || newweapon == player->readyweapon)
+    return false;
+
+  // Do not go to plasma or BFG in shareware,
+  //  even if cheated.
+
+  // heretic_note: ignoring this...not sure it's worth worrying about
+  if ((newweapon == wp_plasma || newweapon == wp_bfg) && gamemode == shareware)
+    return false;
+
+  *newweapon_p = newweapon;
+  return true;
+}
+
 //
 // P_PlayerThink
 //
@@ -558,53 +617,11 @@ void P_PlayerThink (player_t* player)
   }
 
   // Check for weapon change.
-  if (cmd->buttons & BT_CHANGE && !player->morphTics)
-  {
-    // The actual changing of the weapon is done
-    //  when the weapon psprite can do it
-    //  (read: not in the middle of an attack).
-
-    newweapon = (cmd->buttons & BT_WEAPONMASK) >> BT_WEAPONSHIFT;
-
-    // killough 3/22/98: For demo compatibility we must perform the fist
-    // and SSG weapons switches here, rather than in G_BuildTiccmd(). For
-    // other games which rely on user preferences, we must use the latter.
-
-    if (demo_compatibility)
-    { // compatibility mode -- required for old demos -- killough
-      //e6y
-      if (!prboom_comp[PC_ALLOW_SSG_DIRECT].state)
-        newweapon = (cmd->buttons & BT_WEAPONMASK_OLD)>>BT_WEAPONSHIFT;
-
-        if (
-          newweapon == g_wp_fist && player->weaponowned[g_wp_chainsaw]
-          && (
-            player->readyweapon != g_wp_chainsaw ||
-            (!player->powers[pw_strength])
-          )
-        )
-          newweapon = g_wp_chainsaw;
-
-        if (
-            gamemode == commercial &&
-            newweapon == wp_shotgun &&
-            player->weaponowned[wp_supershotgun] &&
-            player->readyweapon != wp_supershotgun)
-          newweapon = wp_supershotgun;
-    }
-
-    // killough 2/8/98, 3/22/98 -- end of weapon selection changes
-
-    if (player->weaponowned[newweapon] && newweapon != player->readyweapon)
-
-      // Do not go to plasma or BFG in shareware,
-      //  even if cheated.
-
-      // heretic_note: ignoring this...not sure it's worth worrying about
-      if ((newweapon != wp_plasma && newweapon != wp_bfg)
-          || (gamemode != shareware) )
-        player->pendingweapon = newweapon;
-  }
+  // The actual changing of the weapon is done
+  //  when the weapon psprite can do it
+  //  (read: not in the middle of an attack).
+  if (P_GetCommandWeapon(player, cmd, &newweapon))
+    player->pendingweapon = newweapon;
 
   // check for use
 
@@ -658,7 +675,7 @@ void P_PlayerThink (player_t* player)
   if (player->hazardcount)
   {
     player->hazardcount--;
-    if (!(leveltime % player->hazardinterval) && player->hazardcount > 16 * TICRATE)
+    if (!(engine_context->leveltime % player->hazardinterval) && player->hazardcount > 16 * TICRATE)
       P_DamageMobj(player->mo, NULL, NULL, 5);
   }
 
@@ -669,3 +686,65 @@ void P_PlayerThink (player_t* player)
       player->powers[pw_invulnerability] & 8) ? INVERSECOLORMAP :
       player->powers[pw_infrared] > 4*32 || player->powers[pw_infrared] & 8;
 }
+
+//
+// P_CanonicalizeTiccmd
+//
+// Clears whatever P_PlayerThink is going to ignore from a command about to
+// be run by the player, so two commands that lead to the same tic compare
+// equal. It is only a key: the weapon bits hold the weapon that would be
+// selected, which the game may read differently when run as a command.
+//
+
+void P_CanonicalizeTiccmd(const player_t* player, ticcmd_t* cmd)
+{
+  const mobj_t *mo = player->mo;
+  weapontype_t newweapon;
+  dboolean fireRead = false;
+  int i;
+
+  if (mo->flags & MF_JUSTATTACKED)
+  {
+    cmd->angleturn = 0;
+    cmd->forwardmove = 0xc800 / 512;
+    cmd->sidemove = 0;
+  }
+
+  // When the player can't move, only whether it tries to still matters:
+  // it keeps P_XYMovement from stopping its body
+  if (
+    player->playerstate == PST_DEAD || mo->reactiontime ||
+    (
+      mo->z > mo->floorz && !(mo->flags2 & MF2_ONMOBJ) &&
+      !(mo->flags & (MF_BOUNCES | MF_FLY)) && !map_info.air_control
+    )
+  )
+  {
+    cmd->forwardmove = (cmd->forwardmove | cmd->sidemove) != 0;
+    cmd->sidemove = 0;
+  }
+
+  if (player->playerstate == PST_DEAD || mo->reactiontime)
+    cmd->angleturn = 0;
+
+  if (player->playerstate == PST_DEAD)
+  {
+    cmd->buttons = 0;
+    return;
+  }
+
+  // The weapon only matters if it changes the pending one
+  if (P_GetCommandWeapon(player, cmd, &newweapon) && newweapon != player->pendingweapon)
+    cmd->buttons = (cmd->buttons & ~BT_WEAPONMASK) | BT_CHANGE | (newweapon << BT_WEAPONSHIFT);
+  else
+    cmd->buttons &= ~(BT_CHANGE | BT_WEAPONMASK);
+
+  // Fire is only read by the psprite actions, which only run this tic
+  // for the psprites whose state runs out
+  for (i = 0; i < NUMPSPRITES; i++)
+    if (player->psprites[i].state && player->psprites[i].tics == 1)
+      fireRead = true;
+
+  if (!fireRead)
+    cmd->buttons &= ~BT_ATTACK;
+}
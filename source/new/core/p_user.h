@@ -47,6 +47,9 @@ void P_Thrust(player_t *player, angle_t angle, fixed_t move);
 
 void P_SetPitch(player_t *player);
 
+// Clears what the player would ignore of a command, for comparing commands
+void P_CanonicalizeTiccmd(const player_t *player, ticcmd_t *cmd);
+
 // heretic
 
 int P_GetPlayerNum(player_t * player);
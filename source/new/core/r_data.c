@@ -87,14 +87,14 @@ typedef struct
 // of one or more mappatch_t structures that arrange graphic patches.
 
 // killough 4/17/98: make firstcolormaplump,lastcolormaplump external
-__thread int firstcolormaplump, lastcolormaplump;      // killough 4/17/98
-__thread int       firstflat, lastflat, numflats;
-__thread int       firstspritelump, lastspritelump, numspritelumps;
-__thread int       numtextures;
-__thread texture_t **textures; // proff - 04/05/2000 removed static for OpenGL
-__thread fixed_t   *textureheight; //needed for texture pegging (and TFE fix - killough)
-__thread int       *flattranslation;             // for global animation
-__thread int       *texturetranslation;
+__STORAGE_MODIFIER int firstcolormaplump, lastcolormaplump;      // killough 4/17/98
+__STORAGE_MODIFIER int       firstflat, lastflat, numflats;
+__STORAGE_MODIFIER int       firstspritelump, lastspritelump, numspritelumps;
+__STORAGE_MODIFIER int       numtextures;
+__STORAGE_MODIFIER texture_t **textures; // proff - 04/05/2000 removed static for OpenGL
+__STORAGE_MODIFIER fixed_t   *textureheight; //needed for texture pegging (and TFE fix - killough)
+__STORAGE_MODIFIER int       *flattranslation;             // for global animation
+__STORAGE_MODIFIER int       *texturetranslation;
 
 //
 // R_InitTextures
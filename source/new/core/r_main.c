@@ -61,83 +61,83 @@
 // e6y
 // Now they are variables. Depends from render_doom_lightmaps variable.
 // Unify colour maping logic by cph is removed, because of bugs.
-__thread int LIGHTLEVELS   = 32;
-__thread int LIGHTSEGSHIFT = 3;
-__thread int LIGHTBRIGHT   = 2;
-__thread int r_frame_count;
+__STORAGE_MODIFIER int LIGHTLEVELS   = 32;
+__STORAGE_MODIFIER int LIGHTSEGSHIFT = 3;
+__STORAGE_MODIFIER int LIGHTBRIGHT   = 2;
+__STORAGE_MODIFIER int r_frame_count;
 
 // Fineangles in the SCREENWIDTH wide window.
 #define FIELDOFVIEW 2048
 
 #define HEXEN_PI 3.141592657
 
-__thread int validcount = 1;         // increment every time a check is made
-__thread int validcount2 = 1;
-__thread const lighttable_t *fixedcolormap;
-__thread int      centerx, centery;
-__thread int wide_centerx;
-
-__thread fixed_t  focallength;
-__thread fixed_t  focallengthy;
-__thread fixed_t  globaluclip, globaldclip;
-__thread fixed_t  centerxfrac, centeryfrac;
-__thread fixed_t  yaspectmul;
-__thread fixed_t  viewheightfrac; //e6y: for correct cliping of things
-__thread fixed_t  projection;
-__thread fixed_t  projectiony;
-__thread fixed_t  skyiscale;
-__thread fixed_t  viewx, viewy, viewz;
-__thread angle_t  viewangle;
-__thread fixed_t  viewcos, viewsin;
-__thread fixed_t  viewtancos, viewtansin;
-__thread player_t *viewplayer;
-__thread fixed_t viewfocratio;
-__thread int r_nearclip = 5;
-__thread int FieldOfView;
-__thread int viewport[4];
-__thread float modelMatrix[16];
-__thread float projMatrix[16];
-
-extern __thread const lighttable_t **walllights;
+__STORAGE_MODIFIER int validcount = 1;         // increment every time a check is made
+__STORAGE_MODIFIER int validcount2 = 1;
+__STORAGE_MODIFIER const lighttable_t *fixedcolormap;
+__STORAGE_MODIFIER int      centerx, centery;
+__STORAGE_MODIFIER int wide_centerx;
+
+__STORAGE_MODIFIER fixed_t  focallength;
+__STORAGE_MODIFIER fixed_t  focallengthy;
+__STORAGE_MODIFIER fixed_t  globaluclip, globaldclip;
+__STORAGE_MODIFIER fixed_t  centerxfrac, centeryfrac;
+__STORAGE_MODIFIER fixed_t  yaspectmul;
+__STORAGE_MODIFIER fixed_t  viewheightfrac; //e6y: for correct cliping of things
+__STORAGE_MODIFIER fixed_t  projection;
+__STORAGE_MODIFIER fixed_t  projectiony;
+__STORAGE_MODIFIER fixed_t  skyiscale;
+__STORAGE_MODIFIER fixed_t  viewx, viewy, viewz;
+__STORAGE_MODIFIER angle_t  viewangle;
+__STORAGE_MODIFIER fixed_t  viewcos, viewsin;
+__STORAGE_MODIFIER fixed_t  viewtancos, viewtansin;
+__STORAGE_MODIFIER player_t *viewplayer;
+__STORAGE_MODIFIER fixed_t viewfocratio;
+__STORAGE_MODIFIER int r_nearclip = 5;
+__STORAGE_MODIFIER int FieldOfView;
+__STORAGE_MODIFIER int viewport[4];
+__STORAGE_MODIFIER float modelMatrix[16];
+__STORAGE_MODIFIER float projMatrix[16];
+
+extern __STORAGE_MODIFIER const lighttable_t **walllights;
 
 //
 // precalculated math tables
 //
 
-__thread angle_t clipangle;
+__STORAGE_MODIFIER angle_t clipangle;
 
 // The viewangletox[viewangle + FINEANGLES/4] lookup
 // maps the visible view angles to screen X coordinates,
 // flattening the arc to a flat projection plane.
 // There will be many angles mapped to the same X.
 
-__thread int viewangletox[FINEANGLES/2];
+__STORAGE_MODIFIER int viewangletox[FINEANGLES/2];
 
 // The xtoviewangleangle[] table maps a screen pixel
 // to the lowest viewangle that maps back to x ranges
 // from clipangle to -clipangle.
 
 // e6y: resolution limitation is removed
-__thread angle_t *xtoviewangle;   // killough 2/8/98
+__STORAGE_MODIFIER angle_t *xtoviewangle;   // killough 2/8/98
 
 // killough 3/20/98: Support dynamic colormaps, e.g. deep water
 // killough 4/4/98: support dynamic number of them as well
 
-__thread int numcolormaps;
-const __thread lighttable_t *(*c_scalelight)[LIGHTLEVELS_MAX][MAXLIGHTSCALE];
-const __thread lighttable_t *(*c_zlight)[LIGHTLEVELS_MAX][MAXLIGHTZ];
-const __thread lighttable_t *(*scalelight)[MAXLIGHTSCALE];
-const __thread lighttable_t *(*zlight)[MAXLIGHTZ];
-const __thread lighttable_t *fullcolormap;
-const __thread lighttable_t **colormaps;
+__STORAGE_MODIFIER int numcolormaps;
+const __STORAGE_MODIFIER lighttable_t *(*c_scalelight)[LIGHTLEVELS_MAX][MAXLIGHTSCALE];
+const __STORAGE_MODIFIER lighttable_t *(*c_zlight)[LIGHTLEVELS_MAX][MAXLIGHTZ];
+const __STORAGE_MODIFIER lighttable_t *(*scalelight)[MAXLIGHTSCALE];
+const __STORAGE_MODIFIER lighttable_t *(*zlight)[MAXLIGHTZ];
+const __STORAGE_MODIFIER lighttable_t *fullcolormap;
+const __STORAGE_MODIFIER lighttable_t **colormaps;
 
 // killough 3/20/98, 4/4/98: end dynamic colormaps
 
 //e6y: for Boom colormaps in OpenGL mode
-__thread dboolean use_boom_cm;
-__thread int boom_cm;         // current colormap
-__thread int frame_fixedcolormap = 0;
-__thread int extralight;                           // bumped light from gun blasts
+__STORAGE_MODIFIER dboolean use_boom_cm;
+__STORAGE_MODIFIER int boom_cm;         // current colormap
+__STORAGE_MODIFIER int frame_fixedcolormap = 0;
+__STORAGE_MODIFIER int extralight;                           // bumped light from gun blasts
 
 //
 // R_PointOnSide
@@ -192,7 +192,7 @@ PUREFUNC int R_ZDoomPointOnSide(fixed_t x, fixed_t y, const node_t *node)
   return (long long) y * node->dx >= (long long) x * node->dy;
 }
 
-__thread int (*R_PointOnSide)(fixed_t x, fixed_t y, const node_t *node);
+__STORAGE_MODIFIER int (*R_PointOnSide)(fixed_t x, fixed_t y, const node_t *node);
 
 // killough 5/2/98: reformatted
 
@@ -240,7 +240,7 @@ PUREFUNC int R_ZDoomPointOnSegSide(fixed_t x, fixed_t y, const seg_t *line)
   return (long long) y * ldx >= (long long) x * ldy;
 }
 
-__thread int (*R_PointOnSegSide)(fixed_t x, fixed_t y, const seg_t *line);
+__STORAGE_MODIFIER int (*R_PointOnSegSide)(fixed_t x, fixed_t y, const seg_t *line);
 
 //
 // R_PointToAngle
@@ -402,8 +402,8 @@ static void R_InitLightTables (void)
 // The change will take effect next refresh.
 //
 
-__thread dboolean setsizeneeded;
-static __thread int setblocks;
+__STORAGE_MODIFIER dboolean setsizeneeded;
+static __STORAGE_MODIFIER int setblocks;
 
 void R_SetViewSize(void)
 {
@@ -37,36 +37,36 @@
 #include "d_player.h"
 #include "r_data.h"
 
-extern __thread int r_frame_count;
+extern __STORAGE_MODIFIER int r_frame_count;
 
 //
 // POV related.
 //
 
-extern __thread fixed_t  viewcos;
-extern __thread fixed_t  viewsin;
-extern __thread fixed_t  viewtancos;
-extern __thread fixed_t  viewtansin;
-extern __thread int      viewwidth;
-extern __thread int      viewheight;
-extern __thread int      centerx;
-extern __thread int      centery;
-extern __thread fixed_t  globaluclip;
-extern __thread fixed_t  globaldclip;
-extern __thread fixed_t  centerxfrac;
-extern __thread fixed_t  centeryfrac;
-extern __thread fixed_t  yaspectmul;
-extern __thread fixed_t  viewheightfrac; //e6y: for correct cliping of things
-extern __thread fixed_t  projection;
-extern __thread fixed_t  skyiscale;
-extern __thread int wide_centerx;
+extern __STORAGE_MODIFIER fixed_t  viewcos;
+extern __STORAGE_MODIFIER fixed_t  viewsin;
+extern __STORAGE_MODIFIER fixed_t  viewtancos;
+extern __STORAGE_MODIFIER fixed_t  viewtansin;
+extern __STORAGE_MODIFIER int      viewwidth;
+extern __STORAGE_MODIFIER int      viewheight;
+extern __STORAGE_MODIFIER int      centerx;
+extern __STORAGE_MODIFIER int      centery;
+extern __STORAGE_MODIFIER fixed_t  globaluclip;
+extern __STORAGE_MODIFIER fixed_t  globaldclip;
+extern __STORAGE_MODIFIER fixed_t  centerxfrac;
+extern __STORAGE_MODIFIER fixed_t  centeryfrac;
+extern __STORAGE_MODIFIER fixed_t  yaspectmul;
+extern __STORAGE_MODIFIER fixed_t  viewheightfrac; //e6y: for correct cliping of things
+extern __STORAGE_MODIFIER fixed_t  projection;
+extern __STORAGE_MODIFIER fixed_t  skyiscale;
+extern __STORAGE_MODIFIER int wide_centerx;
 #define RMUL (1.6f/1.333333f)
 
 // proff 11/06/98: Added for high-res
-extern __thread fixed_t  projectiony;
-extern __thread int      validcount;
-extern __thread int      validcount2;
-extern __thread fixed_t viewfocratio;
+extern __STORAGE_MODIFIER fixed_t  projectiony;
+extern __STORAGE_MODIFIER int      validcount;
+extern __STORAGE_MODIFIER int      validcount2;
+extern __STORAGE_MODIFIER fixed_t viewfocratio;
 
 //
 // Lighting LUT.
@@ -83,9 +83,9 @@ extern __thread fixed_t viewfocratio;
 // except for maybe memory usage savings.
 #define LIGHTLEVELS_MAX   32
 
-extern __thread int LIGHTSEGSHIFT;
-extern __thread int LIGHTBRIGHT;
-extern __thread int LIGHTLEVELS;
+extern __STORAGE_MODIFIER int LIGHTSEGSHIFT;
+extern __STORAGE_MODIFIER int LIGHTBRIGHT;
+extern __STORAGE_MODIFIER int LIGHTLEVELS;
 
 #define MAXLIGHTSCALE     48
 #define LIGHTSCALESHIFT   12
@@ -93,20 +93,20 @@ extern __thread int LIGHTLEVELS;
 #define LIGHTZSHIFT       20
 
 // killough 3/20/98: Allow colormaps to be dynamic (e.g. underwater)
-extern __thread const lighttable_t *(*scalelight)[MAXLIGHTSCALE];
-extern __thread const lighttable_t *(*c_zlight)[LIGHTLEVELS_MAX][MAXLIGHTZ];
-extern __thread const lighttable_t *(*zlight)[MAXLIGHTZ];
-extern __thread const lighttable_t *fullcolormap;
-extern __thread int numcolormaps;    // killough 4/4/98: dynamic number of maps
-extern __thread const lighttable_t **colormaps;
+extern __STORAGE_MODIFIER const lighttable_t *(*scalelight)[MAXLIGHTSCALE];
+extern __STORAGE_MODIFIER const lighttable_t *(*c_zlight)[LIGHTLEVELS_MAX][MAXLIGHTZ];
+extern __STORAGE_MODIFIER const lighttable_t *(*zlight)[MAXLIGHTZ];
+extern __STORAGE_MODIFIER const lighttable_t *fullcolormap;
+extern __STORAGE_MODIFIER int numcolormaps;    // killough 4/4/98: dynamic number of maps
+extern __STORAGE_MODIFIER const lighttable_t **colormaps;
 // killough 3/20/98, 4/4/98: end dynamic colormaps
 
 //e6y: for Boom colormaps in OpenGL mode
-extern __thread dboolean use_boom_cm;
-extern __thread int boom_cm;         // current colormap
-extern __thread int frame_fixedcolormap;
-extern __thread int          extralight;
-extern __thread const lighttable_t *fixedcolormap;
+extern __STORAGE_MODIFIER dboolean use_boom_cm;
+extern __STORAGE_MODIFIER int boom_cm;         // current colormap
+extern __STORAGE_MODIFIER int frame_fixedcolormap;
+extern __STORAGE_MODIFIER int          extralight;
+extern __STORAGE_MODIFIER const lighttable_t *fixedcolormap;
 
 // Number of diminishing brightness levels.
 // There a 0-31, i.e. 32 LUT in the COLORMAP lump.
@@ -121,11 +121,11 @@ extern __thread const lighttable_t *fixedcolormap;
 
 PUREFUNC int R_CompatiblePointOnSide(fixed_t x, fixed_t y, const node_t *node);
 PUREFUNC int R_ZDoomPointOnSide(fixed_t x, fixed_t y, const node_t *node);
-extern __thread int (*R_PointOnSide)(fixed_t x, fixed_t y, const node_t *node);
+extern __STORAGE_MODIFIER int (*R_PointOnSide)(fixed_t x, fixed_t y, const node_t *node);
 
 PUREFUNC int R_CompatiblePointOnSegSide(fixed_t x, fixed_t y, const seg_t *line);
 PUREFUNC int R_ZDoomPointOnSegSide(fixed_t x, fixed_t y, const seg_t *line);
-extern __thread int (*R_PointOnSegSide)(fixed_t x, fixed_t y, const seg_t *line);
+extern __STORAGE_MODIFIER int (*R_PointOnSegSide)(fixed_t x, fixed_t y, const seg_t *line);
 
 angle_t R_PointToAngle2(fixed_t x1, fixed_t y1, fixed_t x, fixed_t y);
 subsector_t *R_PointInSubsector(fixed_t x, fixed_t y);
@@ -157,9 +157,9 @@ dboolean R_StatusBarVisible(void);
 #define MAP_COEFF 128.0f
 #define MAP_SCALE (MAP_COEFF*(float)FRACUNIT)
 
-extern __thread int viewport[4];
-extern __thread float modelMatrix[16];
-extern __thread float projMatrix[16];
+extern __STORAGE_MODIFIER int viewport[4];
+extern __STORAGE_MODIFIER float modelMatrix[16];
+extern __STORAGE_MODIFIER float projMatrix[16];
 int R_Project(float objx, float objy, float objz, float *winx, float *winy, float *winz);
 
 #endif
@@ -45,73 +45,73 @@
 //
 
 // needed for texture pegging
-extern __thread fixed_t *textureheight;
+extern __STORAGE_MODIFIER fixed_t *textureheight;
 
-extern __thread int firstflat, numflats;
+extern __STORAGE_MODIFIER int firstflat, numflats;
 
 // for global animation
-extern __thread int *flattranslation;
-extern __thread int *texturetranslation;
+extern __STORAGE_MODIFIER int *flattranslation;
+extern __STORAGE_MODIFIER int *texturetranslation;
 
 // Sprite....
-extern __thread int firstspritelump;
-extern __thread int lastspritelump;
-extern __thread int numspritelumps;
+extern __STORAGE_MODIFIER int firstspritelump;
+extern __STORAGE_MODIFIER int lastspritelump;
+extern __STORAGE_MODIFIER int numspritelumps;
 
 //
 // Lookup tables for map data.
 //
-extern __thread spritedef_t      *sprites;
+extern __STORAGE_MODIFIER spritedef_t      *sprites;
 
-extern __thread int              numvertexes;
-extern __thread vertex_t         *vertexes;
+extern __STORAGE_MODIFIER int              numvertexes;
+extern __STORAGE_MODIFIER vertex_t         *vertexes;
 
-extern __thread int              numsegs;
-extern __thread seg_t            *segs;
+extern __STORAGE_MODIFIER int              numsegs;
+extern __STORAGE_MODIFIER seg_t            *segs;
 
-extern __thread int              numsectors;
-extern __thread sector_t         *sectors;
+extern __STORAGE_MODIFIER int              numsectors;
+extern __STORAGE_MODIFIER sector_t         *sectors;
 
-extern __thread int              numsubsectors;
-extern __thread subsector_t      *subsectors;
+extern __STORAGE_MODIFIER int              numsubsectors;
+extern __STORAGE_MODIFIER subsector_t      *subsectors;
 
-extern __thread int              numnodes;
-extern __thread node_t           *nodes;
+extern __STORAGE_MODIFIER int              numnodes;
+extern __STORAGE_MODIFIER node_t           *nodes;
 
-extern __thread int              numlines;
-extern __thread line_t           *lines;
+extern __STORAGE_MODIFIER int              numlines;
+extern __STORAGE_MODIFIER line_t           *lines;
 
-extern __thread int              numsides;
-extern __thread side_t           *sides;
+extern __STORAGE_MODIFIER int              numsides;
+extern __STORAGE_MODIFIER side_t           *sides;
 
-extern __thread int              *sslines_indexes;
-extern __thread ssline_t         *sslines;
+extern __STORAGE_MODIFIER int              *sslines_indexes;
+extern __STORAGE_MODIFIER ssline_t         *sslines;
 
-extern __thread byte             *map_subsectors;
+extern __STORAGE_MODIFIER byte             *map_subsectors;
 
 //
 // POV data.
 //
-extern __thread fixed_t          viewx;
-extern __thread fixed_t          viewy;
-extern __thread fixed_t          viewz;
-extern __thread angle_t          viewangle;
-extern __thread player_t         *viewplayer;
-extern __thread angle_t          clipangle;
-extern __thread int              viewangletox[FINEANGLES/2];
+extern __STORAGE_MODIFIER fixed_t          viewx;
+extern __STORAGE_MODIFIER fixed_t          viewy;
+extern __STORAGE_MODIFIER fixed_t          viewz;
+extern __STORAGE_MODIFIER angle_t          viewangle;
+extern __STORAGE_MODIFIER player_t         *viewplayer;
+extern __STORAGE_MODIFIER angle_t          clipangle;
+extern __STORAGE_MODIFIER int              viewangletox[FINEANGLES/2];
 
 // e6y: resolution limitation is removed
-extern __thread angle_t          *xtoviewangle;  // killough 2/8/98
+extern __STORAGE_MODIFIER angle_t          *xtoviewangle;  // killough 2/8/98
 
-extern __thread int              FieldOfView;
+extern __STORAGE_MODIFIER int              FieldOfView;
 
-extern __thread fixed_t          rw_distance;
-extern __thread angle_t          rw_normalangle;
+extern __STORAGE_MODIFIER fixed_t          rw_distance;
+extern __STORAGE_MODIFIER angle_t          rw_normalangle;
 
 // angle to line origin
-extern __thread int              rw_angle1;
+extern __STORAGE_MODIFIER int              rw_angle1;
 
-extern __thread visplane_t       *floorplane;
-extern __thread visplane_t       *ceilingplane;
+extern __STORAGE_MODIFIER visplane_t       *floorplane;
+extern __STORAGE_MODIFIER visplane_t       *ceilingplane;
 
 #endif
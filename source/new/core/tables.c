@@ -75,22 +75,24 @@ int SlopeDivEx(unsigned int num, unsigned int den)
   return ans <= SLOPERANGE ? (int)ans : SLOPERANGE;
 }
 
-fixed_t __thread finetangent[4096];
+fixed_t finetangent[4096];
 
 //const fixed_t *const finecosine = &finesine[FINEANGLES/4];
 
 fixed_t finesine[10240];
 
-angle_t __thread tantoangle[2049];
+angle_t tantoangle[2049];
+
+#include <pthread.h>
 
 #include "m_swap.h"
 #include "lprintf.h"
 
-// R_LoadTrigTables
+// R_DoLoadTrigTables
 // Load trig tables from a wad file lump
 // CPhipps 24/12/98 - fix endianness (!)
 //
-void R_LoadTrigTables(void)
+static void R_DoLoadTrigTables(void)
 {
   int lump;
   {
@@ -139,3 +141,14 @@ void R_LoadTrigTables(void)
     lprintf(LO_DEBUG, "corrected.");
   }
 }
+
+// R_LoadTrigTables
+// The tables come from the engine's own lumps and are the same for every instance,
+// so the first one to start loads them for the whole process
+//
+void R_LoadTrigTables(void)
+{
+  static pthread_once_t trig_tables_once = PTHREAD_ONCE_INIT;
+
+  pthread_once(&trig_tables_once, R_DoLoadTrigTables);
+}
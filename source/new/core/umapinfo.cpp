@@ -34,7 +34,7 @@ extern "C"
 #include "dsda/episode.h"
 #include "dsda/name.h"
 
-__thread MapList Maps;
+__STORAGE_MODIFIER MapList Maps;
 }
 
 // -----------------------------------------------
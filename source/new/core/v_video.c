@@ -59,19 +59,19 @@
 // SetRatio sets the following global variables based on window geometry and
 // user preferences. The integer ratio is hardly used anymore, so further
 // simplification may be in order.
-__thread dboolean tallscreen;
-__thread unsigned int ratio_multiplier, ratio_scale;
-__thread float gl_ratio;
-__thread int psprite_offset; // Needed for "tallscreen" modes
+__STORAGE_MODIFIER dboolean tallscreen;
+__STORAGE_MODIFIER unsigned int ratio_multiplier, ratio_scale;
+__STORAGE_MODIFIER float gl_ratio;
+__STORAGE_MODIFIER int psprite_offset; // Needed for "tallscreen" modes
 
 
 // Each screen is [SCREENWIDTH*SCREENHEIGHT];
-__thread screeninfo_t screens[NUM_SCREENS];
+__STORAGE_MODIFIER screeninfo_t screens[NUM_SCREENS];
 
 /* jff 4/24/98 initialize this at runtime */
-__thread const byte *colrngs[CR_LIMIT];
+__STORAGE_MODIFIER const byte *colrngs[CR_LIMIT];
 
-__thread int usegamma;
+__STORAGE_MODIFIER int usegamma;
 
 int V_BloodColor(int blood)
 {
@@ -92,14 +92,14 @@ int V_BloodColor(int blood)
 // so it can be considered GPL as used here, rather than BSD. But,
 // I don't care either way. It is effectively dual-licensed I suppose.
 
-__thread unsigned int Col2RGB8[65][256];
-__thread byte RGB32k[32][32][32];
+__STORAGE_MODIFIER unsigned int Col2RGB8[65][256];
+__STORAGE_MODIFIER byte RGB32k[32][32][32];
 
 #define MAKECOLOR(a) (((a)<<3)|((a)>>2))
 
 void V_InitFlexTranTable(void)
 {
-  static __thread int flexTranInit = false;
+  static __STORAGE_MODIFIER int flexTranInit = false;
 
   if (!flexTranInit)
   {
@@ -319,7 +319,7 @@ void V_Init (void)
 //
 static void FUNC_V_DrawShaded(int scrn, int x, int y, int width, int height, int shade)
 {
-  extern __thread const lighttable_t **colormaps;
+  extern __STORAGE_MODIFIER const lighttable_t **colormaps;
   byte* dest;
   int ix, iy;
 
@@ -352,7 +352,7 @@ static void FUNC_V_DrawNumPatchPrecise(float x, float y, int scrn, int lump,
 {
 }
 
-static int currentPaletteIndex = 0;
+static __STORAGE_MODIFIER int currentPaletteIndex = 0;
 
 void V_TouchPalette(void)
 {
@@ -491,24 +491,24 @@ static void NULL_DrawLine(fline_t* fl, int color) {}
 static void NULL_DrawLineWu(fline_t* fl, int color) {}
 static void NULL_DrawShaded(int scrn, int x, int y, int width, int height, int shade) {}
 
-static __thread video_mode_t current_videomode = VID_MODESW;
-
-__thread V_BeginUIDraw_f V_BeginUIDraw = NULL_BeginUIDraw;
-__thread V_EndUIDraw_f V_EndUIDraw = NULL_EndUIDraw;
-__thread V_BeginUIDraw_f V_BeginAutomapDraw = NULL_BeginAutomapDraw;
-__thread V_EndUIDraw_f V_EndAutomapDraw = NULL_EndAutomapDraw;
-__thread V_CopyRect_f V_CopyRect = NULL_CopyRect;
-__thread V_FillRect_f V_FillRect = NULL_FillRect;
-__thread V_DrawNumPatch_f V_DrawNumPatch = NULL_DrawNumPatch;
-__thread V_DrawNumPatchPrecise_f V_DrawNumPatchPrecise = NULL_DrawNumPatchPrecise;
-__thread V_FillFlat_f V_FillFlat = NULL_FillFlat;
-__thread V_FillPatch_f V_FillPatch = NULL_FillPatch;
-__thread V_DrawBackground_f V_DrawBackground = NULL_DrawBackground;
-__thread V_PlotPixel_f V_PlotPixel = NULL_PlotPixel;
-__thread V_PlotPixelWu_f V_PlotPixelWu = NULL_PlotPixelWu;
-__thread V_DrawLine_f V_DrawLine = NULL_DrawLine;
-__thread V_DrawLineWu_f V_DrawLineWu = NULL_DrawLineWu;
-__thread V_DrawShaded_f V_DrawShaded = NULL_DrawShaded;
+static __STORAGE_MODIFIER video_mode_t current_videomode = VID_MODESW;
+
+__STORAGE_MODIFIER V_BeginUIDraw_f V_BeginUIDraw = NULL_BeginUIDraw;
+__STORAGE_MODIFIER V_EndUIDraw_f V_EndUIDraw = NULL_EndUIDraw;
+__STORAGE_MODIFIER V_BeginUIDraw_f V_BeginAutomapDraw = NULL_BeginAutomapDraw;
+__STORAGE_MODIFIER V_EndUIDraw_f V_EndAutomapDraw = NULL_EndAutomapDraw;
+__STORAGE_MODIFIER V_CopyRect_f V_CopyRect = NULL_CopyRect;
+__STORAGE_MODIFIER V_FillRect_f V_FillRect = NULL_FillRect;
+__STORAGE_MODIFIER V_DrawNumPatch_f V_DrawNumPatch = NULL_DrawNumPatch;
+__STORAGE_MODIFIER V_DrawNumPatchPrecise_f V_DrawNumPatchPrecise = NULL_DrawNumPatchPrecise;
+__STORAGE_MODIFIER V_FillFlat_f V_FillFlat = NULL_FillFlat;
+__STORAGE_MODIFIER V_FillPatch_f V_FillPatch = NULL_FillPatch;
+__STORAGE_MODIFIER V_DrawBackground_f V_DrawBackground = NULL_DrawBackground;
+__STORAGE_MODIFIER V_PlotPixel_f V_PlotPixel = NULL_PlotPixel;
+__STORAGE_MODIFIER V_PlotPixelWu_f V_PlotPixelWu = NULL_PlotPixelWu;
+__STORAGE_MODIFIER V_DrawLine_f V_DrawLine = NULL_DrawLine;
+__STORAGE_MODIFIER V_DrawLineWu_f V_DrawLineWu = NULL_DrawLineWu;
+__STORAGE_MODIFIER V_DrawShaded_f V_DrawShaded = NULL_DrawShaded;
 
 //
 // V_InitMode
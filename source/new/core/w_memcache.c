@@ -44,7 +44,7 @@
 #include "z_zone.h"
 #include "lprintf.h"
 
-static __thread void **lump_data;
+static __STORAGE_MODIFIER void **lump_data;
 
 /* W_InitCache
  *
@@ -75,6 +75,11 @@ const void *W_LumpByNum(int lump)
     I_Error ("W_LumpByNum: %i >= numlumps",lump);
 #endif
 
+  // Lumps of WADs held in memory, such as the shared read-only mappings,
+  // are used in place, without a copy per instance
+  if (lumpinfo[lump].wadfile && lumpinfo[lump].wadfile->buffer)
+    return &lumpinfo[lump].wadfile->buffer[lumpinfo[lump].position];
+
   // read the lump in
   if (!lump_data[lump]) {
     lump_data[lump] = Z_Malloc(W_LumpLength(lump));
@@ -84,7 +89,13 @@ const void *W_LumpByNum(int lump)
   return lump_data[lump];
 }
 
+// Locked lumps may be written to, so they are always copied out of the WAD
 const void *W_LockLumpNum(int lump)
 {
-  return W_LumpByNum(lump);
+  if (!lump_data[lump]) {
+    lump_data[lump] = Z_Malloc(W_LumpLength(lump));
+    W_ReadLump(lump, lump_data[lump]);
+  }
+
+  return lump_data[lump];
 }
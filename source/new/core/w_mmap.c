@@ -55,7 +55,7 @@
 
 #include "e6y.h"//e6y
 
-static void **lump_data;
+static __STORAGE_MODIFIER void **lump_data;
 
 #ifdef _WIN32
 typedef struct {
@@ -65,7 +65,7 @@ typedef struct {
   void   *data;
 } mmap_info_t;
 
-mmap_info_t *mapped_wad;
+__STORAGE_MODIFIER mmap_info_t *mapped_wad;
 
 void W_DoneCache(void)
 {
@@ -175,7 +175,7 @@ const void* W_LumpByNum(int lump)
 
 #else
 
-void ** mapped_wad;
+__STORAGE_MODIFIER void ** mapped_wad;
 
 void W_InitCache(void)
 {
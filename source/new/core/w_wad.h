@@ -90,9 +90,9 @@ typedef struct {
   size_t size;
 } wadfile_info_t;
 
-extern wadfile_info_t *wadfiles;
+extern __STORAGE_MODIFIER wadfile_info_t *wadfiles;
 
-extern size_t numwadfiles; // CPhipps - size of the wadfiles array
+extern __STORAGE_MODIFIER size_t numwadfiles; // CPhipps - size of the wadfiles array
 
 void W_Init(void); // CPhipps - uses the above array
 void W_InitCache(void);
@@ -133,8 +133,8 @@ typedef struct
 #define LUMP_STATIC 0x00000001 /* assigned gltexture should be static */
 #define LUMP_PRBOOM 0x00000002 /* from internal resource */
 
-extern lumpinfo_t *lumpinfo;
-extern int        numlumps;
+extern __STORAGE_MODIFIER lumpinfo_t *lumpinfo;
+extern __STORAGE_MODIFIER int numlumps;
 
 int     W_FindNumFromName2(const char *name, int ns, int lump);
 
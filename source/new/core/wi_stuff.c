@@ -45,7 +45,7 @@
 #include "dsda/mapinfo.h"
 
 // Ty 03/17/98: flag that new par times have been loaded in d_deh
-extern __thread dboolean deh_pars;
+extern __STORAGE_MODIFIER dboolean deh_pars;
 
 //
 // Data needed to add patches to full screen intermission pics.
@@ -299,62 +299,62 @@ static wi_anim_t *anims[NUMEPISODES] =
 
 
 // used to accelerate or skip a stage
-__thread int   acceleratestage;           // killough 3/28/98: made global
+__STORAGE_MODIFIER int   acceleratestage;           // killough 3/28/98: made global
 
 // wbs->pnum
-static __thread int    me;
+static __STORAGE_MODIFIER int    me;
 
  // specifies current state
-static __thread stateenum_t  state;
+static __STORAGE_MODIFIER stateenum_t  state;
 
 // contains information passed into intermission
-static __thread wbstartstruct_t* wbs;
+static __STORAGE_MODIFIER wbstartstruct_t* wbs;
 
-static __thread wbplayerstruct_t* plrs;  // wbs->plyr[]
+static __STORAGE_MODIFIER wbplayerstruct_t* plrs;  // wbs->plyr[]
 
 // used for general timing
-static __thread int    cnt;
+static __STORAGE_MODIFIER int    cnt;
 
 // used for timing of background animation
-static __thread int    bcnt;
+static __STORAGE_MODIFIER int    bcnt;
 
 // signals to refresh everything for one frame
-static __thread int    firstrefresh;
+static __STORAGE_MODIFIER int    firstrefresh;
 
-static __thread int    cnt_time;
-static __thread int    cnt_total_time;
-static __thread int    cnt_par;
-static __thread int    cnt_pause;
+static __STORAGE_MODIFIER int    cnt_time;
+static __STORAGE_MODIFIER int    cnt_total_time;
+static __STORAGE_MODIFIER int    cnt_par;
+static __STORAGE_MODIFIER int    cnt_pause;
 
 //
 //  GRAPHICS
 //
 
 // You Are Here graphic
-static __thread const char* yah[3] = { "WIURH0", "WIURH1", 0 };
-static __thread const char* splat[2] = {"WISPLAT", 0};
-static __thread const char percent[] = {"WIPCNT"};
-static __thread const char colon[] = {"WICOLON"};
-static __thread patchnum_t num[10];
-static __thread const char wiminus[] = {"WIMINUS"};
-static __thread const char finished[] = {"WIF"};
-static __thread const char entering[] = {"WIENTER"};
-static __thread const char sp_secret[] = {"WISCRT2"};
-static __thread const char kills[] = {"WIOSTK"};
-static __thread const char secret[] = {"WIOSTS"};
-static __thread const char items[] = {"WIOSTI"};
-static __thread const char frags[] = {"WIFRGS"};
-static __thread const char time1[] = {"WITIME"};
-static __thread const char par[] = {"WIPAR"};
-static __thread const char sucks[] = {"WISUCKS"};
-static __thread const char killers[] = {"WIKILRS"};
-static __thread const char victims[] = {"WIVCTMS"};
-static __thread const char total[] = {"WIMSTT"};
-static __thread const char star[] = {"STFST01"};
-static __thread const char bstar[] = {"STFDEAD0"};
-static __thread const char facebackp[] = {"STPB0"};
-static __thread const char *exitpic;
-static __thread const char *enterpic;
+static __STORAGE_MODIFIER const char* yah[3] = { "WIURH0", "WIURH1", 0 };
+static __STORAGE_MODIFIER const char* splat[2] = {"WISPLAT", 0};
+static __STORAGE_MODIFIER const char percent[] = {"WIPCNT"};
+static __STORAGE_MODIFIER const char colon[] = {"WICOLON"};
+static __STORAGE_MODIFIER patchnum_t num[10];
+static __STORAGE_MODIFIER const char wiminus[] = {"WIMINUS"};
+static __STORAGE_MODIFIER const char finished[] = {"WIF"};
+static __STORAGE_MODIFIER const char entering[] = {"WIENTER"};
+static __STORAGE_MODIFIER const char sp_secret[] = {"WISCRT2"};
+static __STORAGE_MODIFIER const char kills[] = {"WIOSTK"};
+static __STORAGE_MODIFIER const char secret[] = {"WIOSTS"};
+static __STORAGE_MODIFIER const char items[] = {"WIOSTI"};
+static __STORAGE_MODIFIER const char frags[] = {"WIFRGS"};
+static __STORAGE_MODIFIER const char time1[] = {"WITIME"};
+static __STORAGE_MODIFIER const char par[] = {"WIPAR"};
+static __STORAGE_MODIFIER const char sucks[] = {"WISUCKS"};
+static __STORAGE_MODIFIER const char killers[] = {"WIKILRS"};
+static __STORAGE_MODIFIER const char victims[] = {"WIVCTMS"};
+static __STORAGE_MODIFIER const char total[] = {"WIMSTT"};
+static __STORAGE_MODIFIER const char star[] = {"STFST01"};
+static __STORAGE_MODIFIER const char bstar[] = {"STFDEAD0"};
+static __STORAGE_MODIFIER const char facebackp[] = {"STPB0"};
+static __STORAGE_MODIFIER const char *exitpic;
+static __STORAGE_MODIFIER const char *enterpic;
 
 //
 // CODE
@@ -452,9 +452,9 @@ static void WI_DrawString(int cx, int cy, const char* ch)
 // Args:    none
 // Returns: void
 //
-__thread const char *lf_levelname;
-__thread const char *lf_levelpic;
-__thread const char *lf_author;
+__STORAGE_MODIFIER const char *lf_levelname;
+__STORAGE_MODIFIER const char *lf_levelpic;
+__STORAGE_MODIFIER const char *lf_author;
 
 void WI_drawLF(void)
 {
@@ -467,9 +467,9 @@ void WI_drawLF(void)
 // Args:    none
 // Returns: void
 //
-__thread const char *el_levelname;
-__thread const char *el_levelpic;
-__thread const char *el_author;
+__STORAGE_MODIFIER const char *el_levelname;
+__STORAGE_MODIFIER const char *el_levelpic;
+__STORAGE_MODIFIER const char *el_author;
 
 void WI_drawEL(void)
 {
@@ -805,7 +805,7 @@ void WI_updateNoState(void)
     G_WorldDone();
 }
 
-static __thread dboolean    snl_pointeron = false;
+static __STORAGE_MODIFIER dboolean    snl_pointeron = false;
 
 
 // ====================================================================
@@ -966,7 +966,7 @@ int WI_fragSum(int playernum)
 
   for (i = 0; i < g_maxplayers; i++)
   {
-    if (playeringame[i]  // is this player playing?
+    if (engine_context->playeringame[i]  // is this player playing?
        && i!=playernum) // and it's not the player we're calculating
     {
       frags += plrs[playernum].frags[i];
@@ -980,10 +980,10 @@ int WI_fragSum(int playernum)
   return frags;
 }
 
-static __thread int          dm_state;
+static __STORAGE_MODIFIER int          dm_state;
 // CPhipps - short, dynamically allocated
-static __thread short int  **dm_frags;  // frags matrix
-static __thread short int   *dm_totals;  // totals by player
+static __STORAGE_MODIFIER short int  **dm_frags;  // frags matrix
+static __STORAGE_MODIFIER short int   *dm_totals;  // totals by player
 
 // ====================================================================
 // WI_initDeathmatchStats
@@ -1008,7 +1008,7 @@ void WI_initDeathmatchStats(void)
 
   for (i = 0 ;i < g_maxplayers; i++)
   {
-    if (playeringame[i])
+    if (engine_context->playeringame[i])
     {
       // CPhipps - allocate frags line
       dm_frags[i] = Z_Calloc(g_maxplayers, sizeof(**dm_frags)); // set all counts to zero
@@ -1058,10 +1058,10 @@ void WI_updateDeathmatchStats(void)
 
     for (i = 0; i < g_maxplayers; i++)
     {
-      if (playeringame[i])
+      if (engine_context->playeringame[i])
       {
         for (j = 0; j < g_maxplayers; j++)
-          if (playeringame[j])
+          if (engine_context->playeringame[j])
             dm_frags[i][j] = plrs[i].frags[j];
 
         dm_totals[i] = WI_fragSum(i);
@@ -1079,11 +1079,11 @@ void WI_updateDeathmatchStats(void)
 
     for (i = 0; i < g_maxplayers; i++)
     {
-      if (playeringame[i])
+      if (engine_context->playeringame[i])
       {
         for (j = 0; j < g_maxplayers; j++)
         {
-          if (playeringame[j]
+          if (engine_context->playeringame[j]
              && dm_frags[i][j] != plrs[i].frags[j])
           {
             if (plrs[i].frags[j] < 0)
@@ -1154,12 +1154,12 @@ void WI_drawDeathmatchStats(void)
 // Note: The term "Netgame" means a coop game
 //
 
-static __thread int *cnt_kills;
-static __thread int *cnt_items;
-static __thread int *cnt_secret;
-static __thread int *cnt_frags;
-static __thread int    dofrags;
-static __thread int    ng_state;
+static __STORAGE_MODIFIER int *cnt_kills;
+static __STORAGE_MODIFIER int *cnt_items;
+static __STORAGE_MODIFIER int *cnt_secret;
+static __STORAGE_MODIFIER int *cnt_frags;
+static __STORAGE_MODIFIER int    dofrags;
+static __STORAGE_MODIFIER int    ng_state;
 
 // ====================================================================
 // CPhipps - WI_endNetgameStats
@@ -1198,7 +1198,7 @@ void WI_initNetgameStats(void)
   cnt_frags = Z_Calloc(g_maxplayers, sizeof(*cnt_frags));
 
   for (i = 0; i < g_maxplayers; i++)
-    if (playeringame[i])
+    if (engine_context->playeringame[i])
       dofrags += WI_fragSum(i);
 
   dofrags = !!dofrags; // set to true or false - did we have frags?
@@ -1229,7 +1229,7 @@ void WI_updateNetgameStats(void)
 
     for (i = 0; i < g_maxplayers; i++)
     {
-      if (!playeringame[i])
+      if (!engine_context->playeringame[i])
         continue;
 
       cnt_kills[i] = WI_killPercent(i);
@@ -1248,7 +1248,7 @@ void WI_updateNetgameStats(void)
 
     for (i = 0; i < g_maxplayers; i++)
     {
-      if (!playeringame[i])
+      if (!engine_context->playeringame[i])
         continue;
 
       cnt_kills[i] += 2;
@@ -1270,7 +1270,7 @@ void WI_updateNetgameStats(void)
 
     for (i = 0; i < g_maxplayers; i++)
     {
-      if (!playeringame[i])
+      if (!engine_context->playeringame[i])
         continue;
 
       cnt_items[i] += 2;
@@ -1291,7 +1291,7 @@ void WI_updateNetgameStats(void)
 
     for (i = 0; i < g_maxplayers; i++)
     {
-      if (!playeringame[i])
+      if (!engine_context->playeringame[i])
         continue;
 
       cnt_secret[i] += 2;
@@ -1313,7 +1313,7 @@ void WI_updateNetgameStats(void)
 
     for (i = 0; i < g_maxplayers; i++)
     {
-      if (!playeringame[i])
+      if (!engine_context->playeringame[i])
         continue;
 
       cnt_frags[i] += 1;
@@ -1362,7 +1362,7 @@ void WI_drawNetgameStats(void)
 {
 }
 
-static __thread int  sp_state;
+static __STORAGE_MODIFIER int  sp_state;
 
 // ====================================================================
 // WI_initStats
@@ -1397,7 +1397,7 @@ void WI_initStats(void)
 void WI_updateStats(void)
 {
   //e6y
-  static __thread dboolean play_early_explosion = true;
+  static __STORAGE_MODIFIER dboolean play_early_explosion = true;
 
   WI_updateAnimatedBack();
 
@@ -1561,9 +1561,9 @@ void WI_checkForAccelerate(void)
   player_t  *player;
 
   // check for button presses to skip delays
-  for (i = 0, player = players; i < g_maxplayers; i++, player++)
+  for (i = 0, player = engine_context->players; i < g_maxplayers; i++, player++)
   {
-    if (playeringame[i])
+    if (engine_context->playeringame[i])
     {
       if (player->cmd.buttons & BT_ATTACK)
       {
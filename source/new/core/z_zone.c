@@ -46,13 +46,18 @@
 #include "config.h"
 #endif
 
+#define _GNU_SOURCE
+
 #include <stdlib.h>
 #include <stdio.h>
+#include <link.h>
+#include <sys/mman.h>
 
 #include "z_zone.h"
 #include "doomstat.h"
 #include "v_video.h"
 #include "g_game.h"
+#include "p_maputl.h"
 #include "lprintf.h"
 
 #ifdef DJGPP
@@ -72,11 +77,125 @@ typedef struct memblock {
   struct memblock *next,*prev;
   size_t size;
   unsigned char tag;
+  unsigned generation; // level arena generation the block belongs to
 } memblock_t;
 
-static __thread const size_t HEADER_SIZE = sizeof(memblock_t);
+static __STORAGE_MODIFIER const size_t HEADER_SIZE = sizeof(memblock_t);
+
+static __STORAGE_MODIFIER memblock_t *blockbytag[ZONE_MAX];
+
+//
+// Level arena
+//
+// When enabled, ZONE_LEVEL blocks are carved out of one contiguous mapping
+// instead of being malloc'd one by one. Freed blocks go to free lists by
+// size class, and Z_FreeLevel simply rewinds the arena. All allocator state
+// lives in thread globals, so a memcpy of the used arena range plus the
+// thread globals block is a complete snapshot of the level.
+//
+
+#define ARENA_ALIGN       16
+#define ARENA_CLASSES     64 // exact fit lists for blocks up to 1KB
+#define ARENA_LARGE_CLASS ARENA_CLASSES
+
+static __STORAGE_MODIFIER byte *arena_base;
+static __STORAGE_MODIFIER size_t arena_size;
+static __STORAGE_MODIFIER size_t arena_used;
+static __STORAGE_MODIFIER unsigned arena_generation;
+static __STORAGE_MODIFIER memblock_t *arena_free[ARENA_CLASSES + 1];
+
+#define ARENA_ROUND(x) (((x) + ARENA_ALIGN - 1) & ~(size_t)(ARENA_ALIGN - 1))
+
+static dboolean Z_InLevelArena(const void *p)
+{
+  return arena_base && (const byte *) p >= arena_base && (const byte *) p < arena_base + arena_size;
+}
+
+void Z_InitLevelArena(size_t size)
+{
+  if (arena_base)
+    I_Error("Z_InitLevelArena: Level arena already initialized");
+
+  size = ARENA_ROUND(size);
+  arena_base = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (arena_base == MAP_FAILED)
+  {
+    arena_base = NULL;
+    I_Error("Z_InitLevelArena: Failure trying to map %lu bytes", (unsigned long) size);
+  }
+
+  arena_size = size;
+  arena_used = 0;
+}
+
+int Z_LevelArenaEnabled(void)
+{
+  return arena_base != NULL;
+}
 
-static __thread memblock_t *blockbytag[ZONE_MAX];
+static memblock_t *Z_ArenaMalloc(size_t size)
+{
+  memblock_t *block, **prev;
+  size_t capacity = ARENA_ROUND(size);
+  size_t class = capacity / ARENA_ALIGN - 1;
+
+  if (class < ARENA_CLASSES)
+  {
+    // exact fit
+    if ((block = arena_free[class]))
+    {
+      arena_free[class] = block->next;
+      return block;
+    }
+  }
+  else
+  {
+    // first fit; the block keeps its full capacity
+    for (prev = &arena_free[ARENA_LARGE_CLASS]; (block = *prev); prev = &block->next)
+      if (block->size >= capacity)
+      {
+        *prev = block->next;
+        return block;
+      }
+  }
+
+  if (arena_used + HEADER_SIZE + capacity > arena_size)
+    I_Error("Z_MallocLevel: Level arena exhausted (%lu bytes)", (unsigned long) arena_size);
+
+  block = (memblock_t *) (arena_base + arena_used);
+  block->size = capacity;
+  arena_used += HEADER_SIZE + capacity;
+
+  return block;
+}
+
+static void Z_ArenaFree(memblock_t *block)
+{
+  size_t class = block->size / ARENA_ALIGN - 1;
+
+  // Blocks from an earlier generation were already released by Z_FreeLevel
+  if (block->generation != arena_generation)
+    return;
+
+  if (block->signature != ZONE_SIGNATURE)
+  {
+    fprintf(stderr,"Z_Free: freed a non-zone pointer");
+    abort();
+  }
+
+  block->signature = 0;
+  if (class > ARENA_LARGE_CLASS)
+    class = ARENA_LARGE_CLASS;
+  block->next = arena_free[class];
+  arena_free[class] = block;
+}
+
+static void Z_ArenaReset(void)
+{
+  arena_used = 0;
+  arena_generation++;
+  memset(arena_free, 0, sizeof(arena_free));
+}
 
 /* Z_Malloc
  * cph - the algorithm here was a very simple first-fit round-robin
@@ -95,6 +214,16 @@ static void *Z_MallocTag(size_t size, int tag)
   if (!size)
     return NULL; // malloc(0) returns NULL
 
+  if (tag == ZONE_LEVEL && arena_base)
+  {
+    block = Z_ArenaMalloc(size);
+    block->signature = ZONE_SIGNATURE;
+    block->tag = tag;
+    block->generation = arena_generation;
+    block->next = block->prev = NULL;
+    return (char *) block + HEADER_SIZE;
+  }
+
   if (!(block = malloc(size + HEADER_SIZE)))
   {
     I_Error ("Z_Malloc: Failure trying to allocate %lu bytes", (unsigned long) size);
@@ -128,11 +257,18 @@ void Z_Free(void *p)
   if (!p)
     return;
 
+  if (Z_InLevelArena(block))
+  {
+    Z_ArenaFree(block);
+    return;
+  }
+
   if (block->signature != ZONE_SIGNATURE)
   {
     fprintf(stderr,"Z_Free: freed a non-zone pointer");
     abort();
   }
+
   block->signature = 0;       // Nullify signature so another free fails
 
   if (block == block->next)
@@ -153,6 +289,9 @@ static void Z_FreeTag(int tag)
   if (tag < 0 || tag >= ZONE_MAX)
     I_Error("Z_FreeTag: Tag %i does not exist", tag);
 
+  if (tag == ZONE_LEVEL && arena_base)
+    Z_ArenaReset();
+
   block = blockbytag[tag];
   if (!block)
     return;
@@ -234,3 +373,167 @@ char *Z_StrdupLevel(const char *s)
 {
   return Z_StrdupTag(s, ZONE_LEVEL);
 }
+
+/// Headless functions
+
+// Thread globals pointing to buffers outside the arena that are made or grow
+// on demand, such as static zone buffers. These are left untouched when a
+// level arena snapshot is restored, since the blocks they pointed to when it
+// was taken may have been reallocated or made since.
+extern __STORAGE_MODIFIER line_t **spechit;
+extern __STORAGE_MODIFIER int spechit_max;
+extern __STORAGE_MODIFIER intercept_t *intercepts;
+extern __STORAGE_MODIFIER intercept_t *intercept_p;
+extern __STORAGE_MODIFIER size_t num_intercepts;
+extern __STORAGE_MODIFIER line_mark_t *line_marks;
+extern __STORAGE_MODIFIER int line_marks_max;
+extern __STORAGE_MODIFIER mobj_t **braintargets;
+extern __STORAGE_MODIFIER int numbraintargets_alloc;
+extern __STORAGE_MODIFIER fixed_t *heightlist;
+extern __STORAGE_MODIFIER int heightlist_size;
+extern __STORAGE_MODIFIER state_t *states_copy;
+
+typedef struct {
+  memblock_t *static_blocks;
+  line_t **spechit;
+  int spechit_max;
+  intercept_t *intercepts;
+  intercept_t *intercept_p;
+  size_t num_intercepts;
+  line_mark_t *line_marks;
+  int line_marks_max;
+  mobj_t **braintargets;
+  int numbraintargets_alloc;
+  fixed_t *heightlist;
+  int heightlist_size;
+  state_t *states_copy;
+} arena_preserved_t;
+
+// Allocated along with the arena, so its address survives restores too
+static __STORAGE_MODIFIER arena_preserved_t *arena_preserved;
+
+typedef struct {
+  const void *marker;
+  void *base;
+  size_t size;
+} thread_globals_t;
+
+static int Z_FindThreadGlobals(struct dl_phdr_info *info, size_t size, void *data)
+{
+  thread_globals_t *globals = data;
+  int i;
+
+  if (!info->dlpi_tls_data)
+    return 0;
+
+  for (i = 0; i < info->dlpi_phnum; i++)
+    if (info->dlpi_phdr[i].p_type == PT_TLS)
+    {
+      byte *base = info->dlpi_tls_data;
+      size_t memsz = info->dlpi_phdr[i].p_memsz;
+
+      if ((const byte *) globals->marker >= base && (const byte *) globals->marker < base + memsz)
+      {
+        globals->base = base;
+        globals->size = memsz;
+        return 1;
+      }
+    }
+
+  return 0;
+}
+
+static __STORAGE_MODIFIER thread_globals_t arena_globals;
+
+void headlessEnableLevelArena(size_t size)
+{
+  arena_globals.marker = &arena_base;
+  if (!dl_iterate_phdr(Z_FindThreadGlobals, &arena_globals))
+    I_Error("headlessEnableLevelArena: Could not locate thread globals");
+
+  Z_InitLevelArena(size);
+  arena_preserved = malloc(sizeof(*arena_preserved));
+}
+
+// Returns the memory a level arena snapshot is made of: the block holding
+// this thread's globals, the engine context, unless it is a static one
+// among those globals, and the used part of the arena
+void headlessGetLevelArenaSnapshot(void **globals, size_t *globals_size, void **context, size_t *context_size, void **arena, size_t *used, size_t *capacity, unsigned *generation)
+{
+  *globals = arena_globals.base;
+  *globals_size = arena_globals.size;
+  *context = engine_context;
+  *context_size = headlessGetEngineContextSize();
+  *arena = arena_base;
+  *used = arena_used;
+  *capacity = arena_size;
+  *generation = arena_generation;
+}
+
+static void Z_KeepArenaPreserved(void)
+{
+  arena_preserved->static_blocks = blockbytag[ZONE_STATIC];
+  arena_preserved->spechit = spechit;
+  arena_preserved->spechit_max = spechit_max;
+  arena_preserved->intercepts = intercepts;
+  arena_preserved->intercept_p = intercept_p;
+  arena_preserved->num_intercepts = num_intercepts;
+  arena_preserved->line_marks = line_marks;
+  arena_preserved->line_marks_max = line_marks_max;
+  arena_preserved->braintargets = braintargets;
+  arena_preserved->numbraintargets_alloc = numbraintargets_alloc;
+  arena_preserved->heightlist = heightlist;
+  arena_preserved->heightlist_size = heightlist_size;
+  arena_preserved->states_copy = states_copy;
+}
+
+static void Z_PutBackArenaPreserved(void)
+{
+  blockbytag[ZONE_STATIC] = arena_preserved->static_blocks;
+  spechit = arena_preserved->spechit;
+  spechit_max = arena_preserved->spechit_max;
+  intercepts = arena_preserved->intercepts;
+  intercept_p = arena_preserved->intercept_p;
+  num_intercepts = arena_preserved->num_intercepts;
+  line_marks = arena_preserved->line_marks;
+  line_marks_max = arena_preserved->line_marks_max;
+  braintargets = arena_preserved->braintargets;
+  numbraintargets_alloc = arena_preserved->numbraintargets_alloc;
+  heightlist = arena_preserved->heightlist;
+  heightlist_size = arena_preserved->heightlist_size;
+  states_copy = arena_preserved->states_copy;
+}
+
+// The preserved globals read as zero in a snapshot, so that it only depends
+// on the game state, and not on how far the buffers have grown
+void headlessBeginLevelArenaSave(void)
+{
+  Z_KeepArenaPreserved();
+  blockbytag[ZONE_STATIC] = NULL;
+  spechit = NULL;
+  spechit_max = 0;
+  intercepts = intercept_p = NULL;
+  num_intercepts = 0;
+  line_marks = NULL;
+  line_marks_max = 0;
+  braintargets = NULL;
+  numbraintargets_alloc = 0;
+  heightlist = NULL;
+  heightlist_size = 0;
+  states_copy = NULL;
+}
+
+void headlessEndLevelArenaSave(void)
+{
+  Z_PutBackArenaPreserved();
+}
+
+void headlessBeginLevelArenaRestore(void)
+{
+  Z_KeepArenaPreserved();
+}
+
+void headlessEndLevelArenaRestore(void)
+{
+  Z_PutBackArenaPreserved();
+}
@@ -62,4 +62,8 @@ void *Z_CallocLevel(size_t n, size_t n2);
 void *Z_ReallocLevel(void *p, size_t n);
 char *Z_StrdupLevel(const char *s);
 
+// Level arena: carves all level-lifetime memory out of one contiguous block
+void Z_InitLevelArena(size_t size);
+int Z_LevelArenaEnabled(void);
+
 #endif
@@ -1,6 +1,10 @@
 #pragma once
 
 #include "../emuInstanceBase.hpp"
+#include <algorithm>
+#include <atomic>
+#include <climits>
+#include <memory>
 #include <string>
 #include <vector>
 #include <jaffarCommon/exceptions.hpp>
@@ -8,6 +12,30 @@
 #include <jaffarCommon/serializers/contiguous.hpp>
 #include <jaffarCommon/deserializers/contiguous.hpp>
 
+extern "C"
+{
+  int P_GetThinkerArchiveStats(int tc, const char** name, int* count, size_t* bytes);
+  size_t headlessGetSaveSize();
+  size_t headlessPackWorldHashData(void* buffer, size_t capacity);
+  void headlessTrackWorldHash(void);
+  void headlessGetWorldHash(uint64_t* hash);
+  int headlessCheckWorldHash(void);
+  int headlessCheckSaveSections(const uint8_t* save, size_t save_size);
+  void headlessSetSaveHash(void (*update)(const void* data, size_t size, void* context), void* context);
+  const uint8_t* dsda_SaveSection(const uint8_t* save, size_t save_size, int section, size_t* section_size);
+  void headlessGetFeatures(gameFeatures_t* features);
+  int dsda_ReadSaveFeatures(const uint8_t* save, size_t save_size, gameFeatures_t* features);
+  int headlessCanUseLines(int playerId, int angleturn);
+  void headlessGetTickCommandKey(int playerId, int forwardSpeed, int strafingSpeed, int turningSpeed, int fire, int action, int weapon, int altWeapon, ticcmd_t* key);
+
+  void headlessEnableLevelArena(size_t size);
+  void headlessGetLevelArenaSnapshot(void **globals, size_t *globalsSize, void **context, size_t *contextSize, void **arena, size_t *arenaUsed, size_t *arenaCapacity, unsigned *generation);
+  void headlessBeginLevelArenaSave(void);
+  void headlessEndLevelArenaSave(void);
+  void headlessBeginLevelArenaRestore(void);
+  void headlessEndLevelArenaRestore(void);
+}
+
 namespace jaffar
 {
 
@@ -17,10 +45,27 @@ class EmuInstance : public EmuInstanceBase
 
   EmuInstance(const nlohmann::json &config) : EmuInstanceBase(config)
   {
+    #ifdef _JAFFAR_ENGINE_GLOBAL_STORAGE
+    // The engine state is shared by the whole process, so a second instance would overwrite the first one's
+    if (_instanceCount > 0) JAFFAR_THROW_LOGIC("This build keeps the engine state in plain globals, which only allows one instance per process (build with engineStorage=thread to run more)\n");
+    _instanceCount++;
+    #endif
   }
 
   ~EmuInstance()
   {
+    #ifdef _JAFFAR_ENGINE_GLOBAL_STORAGE
+    _instanceCount--;
+    #endif
+  }
+
+  // Returns a new instance with this one's settings, initialized on the calling thread, which must not be
+  // this instance's, and in the state recorded by recordStartState()
+  std::unique_ptr<EmuInstance> createFromStartState() const
+  {
+    auto e = std::make_unique<EmuInstance>(_config);
+    e->initializeFromStartState(*this);
+    return e;
   }
 
   void setWorkRamSerializationSizeImpl(const size_t size) override
@@ -45,9 +90,188 @@ class EmuInstance : public EmuInstanceBase
 
   std::string getCoreName() const override { return "QuickerDSDA"; }
 
+  // The context is zeroed, as the globals it replaces were
+  void bindEngineContextImpl() override
+  {
+    const auto contextSize = headlessGetEngineContextSize();
+    if (contextSize == 0) return;
+    if (_engineContext == nullptr) _engineContext = std::make_unique<uint8_t[]>(contextSize);
+    headlessSetEngineContext(_engineContext.get());
+  }
+
+  // The core builds its archive writers a second time as a sizing pass, which only adds up what they would write
+  size_t getArchiveSizeImpl() const override { return headlessGetSaveSize(); }
+
+  size_t writeArchiveImpl(uint8_t* buffer, const size_t size) override
+  {
+    headlessSetSaveStatePointer(buffer, (int)std::min(size, (size_t)INT_MAX));
+    dsda_ArchiveAll();
+    return headlessGetEffectiveSaveSize();
+  }
+
+  size_t packWorldHashDataImpl(uint8_t* buffer, const size_t capacity) const override { return headlessPackWorldHashData(buffer, capacity); }
+
+  void trackWorldHashImpl() override { headlessTrackWorldHash(); }
+  void getWorldHashImpl(uint64_t* hash) const override { headlessGetWorldHash(hash); }
+  bool checkWorldHashImpl() override { return headlessCheckWorldHash() != 0; }
+
+  bool checkStateSectionsImpl(const uint8_t* state, const size_t stateSize) const override
+  {
+    if (_levelArenaSize > 0) JAFFAR_THROW_LOGIC("Level arena states have no save sections\n");
+
+    size_t archiveSize;
+    const uint8_t* archive = getStateArchive(state, stateSize, archiveSize);
+    return archive != nullptr && headlessCheckSaveSections(archive, archiveSize) != 0;
+  }
+
+  void getTickCommandKeyImpl(const int playerId, const jaffar::playerInput_t &input, ticcmd_t &key) const override
+  {
+    headlessGetTickCommandKey(playerId, input.forwardSpeed, input.strafingSpeed, input.turningSpeed, input.fire ? 1 : 0, input.action ? 1 : 0, input.weapon, input.altWeapon ? 1 : 0, &key);
+  }
+
+  bool canUseLinesImpl(const int playerId, const int16_t angleturn) const override { return headlessCanUseLines(playerId, angleturn); }
+
+  void getFeaturesImpl(gameFeatures_t& features) const override { headlessGetFeatures(&features); }
+
+  bool getStateFeaturesImpl(const uint8_t* state, const size_t stateSize, gameFeatures_t& features) const override
+  {
+    if (_levelArenaSize > 0) return false;
+
+    size_t archiveSize;
+    const uint8_t* archive = getStateArchive(state, stateSize, archiveSize);
+    return archive != nullptr && dsda_ReadSaveFeatures(archive, archiveSize, &features) != 0;
+  }
+
+  bool setArchiveHashImpl(void (*update)(const void* data, size_t size, void* context), void* context) override
+  {
+    headlessSetSaveHash(update, context);
+    return true;
+  }
+
+  void enableLevelArenaImpl(const size_t size) override
+  {
+    #ifdef _JAFFAR_ENGINE_GLOBAL_STORAGE
+    // Snapshots copy the block of thread globals, and plain globals share their segment with the rest of the process
+    JAFFAR_THROW_LOGIC("Level arena states need the engine state in thread-local storage (build with engineStorage=thread to use them)\n");
+    #endif
+    headlessEnableLevelArena(size);
+  }
+
+  size_t getLevelArenaStateSizeImpl() const override
+  {
+    const auto snapshot = getLevelArenaSnapshot();
+    return sizeof(levelArenaHeader_t) + snapshot.header.globalsSize + snapshot.header.contextSize + snapshot.arenaCapacity;
+  }
+
+  size_t getLevelArenaEffectiveSizeImpl() const override
+  {
+    const auto snapshot = getLevelArenaSnapshot();
+    return sizeof(levelArenaHeader_t) + snapshot.header.globalsSize + snapshot.header.contextSize + snapshot.header.arenaUsed;
+  }
+
+  void serializeLevelArenaImpl(jaffarCommon::serializer::Base& s) const override
+  {
+    const auto snapshot = getLevelArenaSnapshot();
+
+    // Leaves the preserved globals out of the snapshot, and puts them back even if the serializer throws
+    struct saveGuard_t
+    {
+      saveGuard_t() { headlessBeginLevelArenaSave(); }
+      ~saveGuard_t() { headlessEndLevelArenaSave(); }
+    } saveGuard;
+
+    s.push(&snapshot.header, sizeof(levelArenaHeader_t));
+    s.push(snapshot.globals, snapshot.header.globalsSize);
+    s.push(snapshot.context, snapshot.header.contextSize);
+    s.push(snapshot.header.arena, snapshot.header.arenaUsed);
+  }
+
+  void deserializeLevelArenaImpl(jaffarCommon::deserializer::Base& d) override
+  {
+    const auto snapshot = getLevelArenaSnapshot();
+
+    levelArenaHeader_t header;
+    d.pop(&header, sizeof(levelArenaHeader_t));
+    if (header.arena != snapshot.header.arena || header.globalsSize != snapshot.header.globalsSize || header.contextSize != snapshot.header.contextSize) JAFFAR_THROW_LOGIC("Level arena state was not produced by this instance\n");
+    if (header.generation != snapshot.header.generation) JAFFAR_THROW_LOGIC("Level arena state belongs to a different level load\n");
+
+    headlessBeginLevelArenaRestore();
+    d.pop(snapshot.globals, header.globalsSize);
+    d.pop(snapshot.context, header.contextSize);
+    d.pop(header.arena, header.arenaUsed);
+    headlessEndLevelArenaRestore();
+  }
+
+  // Prints the per-class breakdown of the last save state
+  void printSaveStateReport() const override
+  {
+    const char* name;
+    int count;
+    size_t bytes;
+
+    jaffarCommon::logger::log("[] Save State Thinker Breakdown:\n");
+    for (int tc = 0; P_GetThinkerArchiveStats(tc, &name, &count, &bytes); tc++)
+      if (bytes > 0)
+        jaffarCommon::logger::log("[]   %-28s %5d x %7lu bytes (%.1f bytes each)\n", name, count, bytes, count > 0 ? (double)bytes / count : 0.0);
+  }
+
+  // Returns one section (see dsda_save_section_t) of a serialized state without
+  // loading it, or nullptr if there is none, as in level arena states
+  const uint8_t* getStateSection(const uint8_t* state, const size_t stateSize, const int section, size_t& sectionSize) const
+  {
+    if (_levelArenaSize > 0) return nullptr;
+
+    size_t archiveSize;
+    const uint8_t* archive = getStateArchive(state, stateSize, archiveSize);
+    if (archive == nullptr) return nullptr;
+
+    return dsda_SaveSection(archive, archiveSize, section, &sectionSize);
+  }
+
 
   private:
 
+  // The archive a serialized state wraps, or nullptr if its size prefix does not fit
+  static const uint8_t* getStateArchive(const uint8_t* state, const size_t stateSize, size_t& archiveSize)
+  {
+    if (stateSize < sizeof(size_t)) return nullptr;
+
+    memcpy(&archiveSize, state, sizeof(size_t));
+    if (archiveSize > stateSize - sizeof(size_t)) return nullptr;
+
+    return state + sizeof(size_t);
+  }
+
+  struct levelArenaHeader_t
+  {
+    void* arena;
+    size_t globalsSize;
+    size_t contextSize;
+    size_t arenaUsed;
+    unsigned generation;
+  };
+
+  struct levelArenaSnapshot_t
+  {
+    levelArenaHeader_t header;
+    void* globals;
+    void* context;
+    size_t arenaCapacity;
+  };
+
+  static levelArenaSnapshot_t getLevelArenaSnapshot()
+  {
+    levelArenaSnapshot_t snapshot {};
+    headlessGetLevelArenaSnapshot(&snapshot.globals, &snapshot.header.globalsSize, &snapshot.context, &snapshot.header.contextSize, &snapshot.header.arena, &snapshot.header.arenaUsed, &snapshot.arenaCapacity, &snapshot.header.generation);
+    return snapshot;
+  }
+
+  // Engine context the core runs on, see core/d_context.h
+  std::unique_ptr<uint8_t[]> _engineContext;
+
+  #ifdef _JAFFAR_ENGINE_GLOBAL_STORAGE
+  static inline std::atomic<size_t> _instanceCount = 0;
+  #endif
 };
 
 } // namespace jaffar
\ No newline at end of file
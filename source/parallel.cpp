@@ -9,8 +9,15 @@
 #include <jaffarCommon/file.hpp>
 #include <jaffarCommon/parallel.hpp>
 #include "emuInstance.hpp"
+#include "stateHashSet.hpp"
+#include "scorers.hpp"
+#include <algorithm>
+#include <atomic>
 #include <chrono>
+#include <link.h>
 #include <random>
+#include <sys/resource.h>
+#include <unistd.h>
 #include <sstream>
 #include <vector>
 #include <string>
@@ -40,6 +47,270 @@ jaffar::input_t generateRandomInput(std::mt19937& rng)
   return randomInput;
 }
 
+// States vary in size, so buffers grow to fit the largest state stored in them
+void reserveStateBuffer(uint8_t *&buffer, size_t &capacity, const size_t size)
+{
+  if (size <= capacity) return;
+  buffer = (uint8_t *)realloc(buffer, size);
+  capacity = size;
+}
+
+// Resident memory of the process once the first instance is ready, and once every thread has its own
+struct residentMemory_t
+{
+  size_t oneInstance = 0;
+  size_t allInstances = 0;
+};
+
+// Current resident memory of the process, in bytes
+size_t getResidentMemory()
+{
+  size_t totalPages = 0;
+  size_t residentPages = 0;
+  FILE *statm = fopen("/proc/self/statm", "r");
+  if (statm == nullptr) return 0;
+  if (fscanf(statm, "%lu %lu", &totalPages, &residentPages) != 2) residentPages = 0;
+  fclose(statm);
+  return residentPages * (size_t)sysconf(_SC_PAGESIZE);
+}
+
+static int addTLSBlockSize(struct dl_phdr_info *info, size_t size, void *data)
+{
+  for (int i = 0; i < info->dlpi_phnum; i++)
+    if (info->dlpi_phdr[i].p_type == PT_TLS) *(size_t *)data += info->dlpi_phdr[i].p_memsz;
+  return 0;
+}
+
+// Thread local storage every thread gets for the loaded modules, engine globals included
+size_t getStaticTLSSize()
+{
+  size_t size = 0;
+  dl_iterate_phdr(addTLSBlockSize, &size);
+  return size;
+}
+
+// Peak resident memory of the process, the TLS block each thread carries, and what each thread
+// past the first adds to the resident memory: its instance, its TLS block and its stack
+void printResidentMemory(const residentMemory_t &residentMemory)
+{
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+  const double peakMb = (double)usage.ru_maxrss / 1024.0;
+  const size_t threadCount = jaffarCommon::parallel::getMaxThreadCount();
+  printf("[] Peak Resident Memory:                   %.3f Mb\n", peakMb);
+  printf("[] Static TLS Block per Thread:            %.3f Kb\n", (double)getStaticTLSSize() / 1024.0);
+  printf("[] Resident Memory at 1 / All Threads:     %.3f Mb / %.3f Mb\n", (double)residentMemory.oneInstance / (1024.0 * 1024.0), (double)residentMemory.allInstances / (1024.0 * 1024.0));
+  if (threadCount > 1 && residentMemory.allInstances >= residentMemory.oneInstance)
+    printf("[] Resident Memory per Added Thread:       %.3f Mb\n", (double)(residentMemory.allInstances - residentMemory.oneInstance) / (double)(threadCount - 1) / (1024.0 * 1024.0));
+}
+
+// The first thread runs the master instance, and the others start from its recorded state, unless its states can't
+// be loaded into another instance. Then they initialize their own.
+std::unique_ptr<jaffar::EmuInstance> createWorkerInstance(const jaffar::EmuInstance &master, const nlohmann::json &configJs)
+{
+  if (master.hasPortableStates()) return master.createFromStartState();
+  auto e = std::make_unique<jaffar::EmuInstance>(configJs);
+  e->initialize();
+  return e;
+}
+
+// Beam search benchmark. Every tic, each state in the beam is expanded with every input of the input set
+// (or its legal inputs, when no set is given), the candidates are deduplicated by the digest of their whole
+// state and scored, and the best beamWidth of them make the next beam. Each thread keeps the states it
+// scored, and the chosen ones are copied into the beam, so no state is simulated twice.
+// Candidates are ranked by score, then by digest, so the result doesn't depend on the thread count.
+int runBeamSearch(const nlohmann::json &configJs, const std::vector<std::string> &initialSequence, const std::vector<std::string> &inputSet, const jaffar::scorer_t &scorer, const size_t beamWidth, const size_t beamDepth, std::string &resultHash, residentMemory_t &residentMemory)
+{
+  struct candidate_t
+  {
+    float score;
+    jaffarCommon::hash::hash_t digest;
+    uint32_t parent;
+    uint32_t inputId;
+    uint32_t threadId;
+    size_t stateOffset; // In the scored states of its thread
+    size_t stateSize;
+  };
+
+  // The beam holds beamWidth state slots, which grow to fit the largest state chosen
+  std::vector<uint8_t> beamPool;
+  std::vector<size_t> beamStateSizes;
+  size_t slotSize = 0;
+  size_t beamSize = 1;
+
+  // States scored during the current tic, per thread
+  const size_t threadCount = jaffarCommon::parallel::getMaxThreadCount();
+  std::vector<std::vector<uint8_t>> scoredStates(threadCount);
+
+  std::vector<candidate_t> candidates;
+  std::vector<candidate_t> selected;
+  size_t simulatedStates = 0;
+  size_t duplicateStates = 0;
+  double elapsedTimeSeconds = 0.0;
+  auto t0 = jaffarCommon::timing::now();
+
+  // The master plays the initial sequence, and the other threads start from there
+  auto master = std::make_unique<jaffar::EmuInstance>(configJs);
+  master->initialize();
+  for (const auto &inputString : initialSequence) master->advanceState(master->getInputParser()->parseInputString(inputString));
+  master->recordStartState();
+  residentMemory.oneInstance = getResidentMemory();
+
+  JAFFAR_PARALLEL
+  {
+    // Getting this thread's emulator instance
+    const size_t threadId = jaffarCommon::parallel::getThreadId();
+    std::unique_ptr<jaffar::EmuInstance> worker;
+    if (threadId != 0) worker = createWorkerInstance(*master, configJs);
+    auto &e = worker == nullptr ? *master : *worker;
+
+    #pragma omp barrier
+    #pragma omp single
+    residentMemory.allInstances = getResidentMemory();
+
+    // Disable rendering
+    e.disableRendering();
+
+    // Getting input parser from the emulator
+    const auto inputParser = e.getInputParser();
+
+    std::vector<jaffar::input_t> decodedInputSet;
+    for (const auto &inputString : inputSet) decodedInputSet.push_back(inputParser->parseInputString(inputString));
+
+    auto loadSlot = [&](const size_t slot)
+    {
+      jaffarCommon::deserializer::Contiguous d(&beamPool[slot * slotSize], beamStateSizes[slot]);
+      e.deserializeState(d);
+    };
+
+    // One thread stores the starting state
+    #pragma omp single
+    {
+      slotSize = e.getStateSize();
+      beamPool.resize(beamWidth * slotSize);
+      beamStateSizes.assign(beamWidth, 0);
+      beamStateSizes[0] = slotSize;
+      jaffarCommon::serializer::Contiguous s(beamPool.data(), slotSize);
+      e.serializeState(s);
+      t0 = jaffarCommon::timing::now();
+    }
+
+    auto &threadStates = scoredStates[threadId];
+    std::vector<jaffar::playerInput_t> legalInputs;
+    std::vector<candidate_t> threadCandidates;
+    size_t threadSimulatedStates = 0;
+
+    for (size_t step = 0; step < beamDepth && beamSize > 0; step++)
+    {
+      // Expanding every state in the beam, keeping the states reached
+      threadCandidates.clear();
+      threadStates.clear();
+      #pragma omp for schedule(dynamic, 1)
+      for (size_t parent = 0; parent < beamSize; parent++)
+      {
+        loadSlot(parent);
+        if (inputSet.empty()) e.getLegalInputs(legalInputs);
+        const size_t inputCount = inputSet.empty() ? legalInputs.size() : decodedInputSet.size();
+
+        for (size_t i = 0; i < inputCount; i++)
+        {
+          if (i > 0) loadSlot(parent);
+          e.advanceState(inputSet.empty() ? jaffar::makePlayerInput(legalInputs[i]) : decodedInputSet[i]);
+          threadSimulatedStates++;
+
+          candidate_t candidate { 0.0f, {}, (uint32_t)parent, (uint32_t)i, (uint32_t)threadId, threadStates.size(), e.getStateSize() };
+          threadStates.resize(candidate.stateOffset + candidate.stateSize);
+          jaffarCommon::serializer::Contiguous s(&threadStates[candidate.stateOffset], candidate.stateSize);
+          e.serializeStateAndHash(s, candidate.digest);
+
+          gameFeatures_t features;
+          e.getFeatures(features);
+          candidate.score = scorer(features);
+          threadCandidates.push_back(candidate);
+        }
+      }
+
+      JAFFAR_CRITICAL
+      candidates.insert(candidates.end(), threadCandidates.begin(), threadCandidates.end());
+
+      #pragma omp barrier
+
+      // Keeping one candidate per state, the first one expanded, then the best ones.
+      // Which duplicate is kept must not depend on the order threads added them.
+      #pragma omp single
+      {
+        std::sort(candidates.begin(), candidates.end(), [](const candidate_t &a, const candidate_t &b)
+        {
+          if (a.digest != b.digest) return a.digest < b.digest;
+          return a.parent != b.parent ? a.parent < b.parent : a.inputId < b.inputId;
+        });
+        const auto uniqueEnd = std::unique(candidates.begin(), candidates.end(), [](const candidate_t &a, const candidate_t &b) { return a.digest == b.digest; });
+        duplicateStates += candidates.end() - uniqueEnd;
+        candidates.erase(uniqueEnd, candidates.end());
+
+        const size_t nextBeamSize = std::min(beamWidth, candidates.size());
+        std::partial_sort(candidates.begin(), candidates.begin() + nextBeamSize, candidates.end(), [](const candidate_t &a, const candidate_t &b) { return a.score != b.score ? a.score > b.score : a.digest < b.digest; });
+        selected.assign(candidates.begin(), candidates.begin() + nextBeamSize);
+        candidates.clear();
+
+        // The beam was fully expanded, so its slots can be resized and reused for the chosen states
+        for (const auto &candidate : selected) slotSize = std::max(slotSize, candidate.stateSize);
+        beamPool.resize(beamWidth * slotSize);
+        beamSize = selected.size();
+      }
+
+      // Copying the chosen states into the beam
+      #pragma omp for schedule(static)
+      for (size_t slot = 0; slot < selected.size(); slot++)
+      {
+        const auto &candidate = selected[slot];
+        memcpy(&beamPool[slot * slotSize], &scoredStates[candidate.threadId][candidate.stateOffset], candidate.stateSize);
+        beamStateSizes[slot] = candidate.stateSize;
+      }
+    }
+
+    JAFFAR_CRITICAL
+    simulatedStates += threadSimulatedStates;
+
+    #pragma omp barrier
+
+    // The best state is the first of the last beam
+    #pragma omp single
+    {
+      elapsedTimeSeconds = jaffarCommon::timing::timeDeltaSeconds(jaffarCommon::timing::now(), t0);
+
+      if (beamSize > 0)
+      {
+        loadSlot(0);
+        gameFeatures_t features;
+        e.getFeatures(features);
+        const auto hash = e.getStateHash();
+
+        char hashStringBuffer[256];
+        sprintf(hashStringBuffer, "0x%lX%lX", hash.first, hash.second);
+        resultHash = hashStringBuffer;
+
+        size_t scoredStatesSize = 0;
+        for (const auto &states : scoredStates) scoredStatesSize += states.capacity();
+
+        printf("[] ********** Beam Search Results **********\n");
+        printf("[] Beam Pool:                              %.3f Mb (%lu slots of %lu bytes)\n", (double)beamPool.size() / (1024.0 * 1024.0), beamWidth, slotSize);
+        printf("[] Scored States:                          %.3f Mb\n", (double)scoredStatesSize / (1024.0 * 1024.0));
+        printf("[] Elapsed time:                           %3.3fs\n", elapsedTimeSeconds);
+        printf("[] Simulated States:                       %lu\n", simulatedStates);
+        printf("[] Performance:                            %.3f states / s\n", (double)simulatedStates / elapsedTimeSeconds);
+        printf("[] Duplicate States:                       %lu\n", duplicateStates);
+        printf("[] Best Score:                             %f\n", selected.empty() ? scorer(features) : selected[0].score);
+        printf("[] Best Map / Tic / Health / Kills:        %d / %d / %d / %d\n", features.map, features.gameTic, features.players[0].health, features.players[0].killCount);
+      }
+    }
+  }
+
+  if (beamSize == 0) { printf("[] Test Failed: The beam ran out of states\n"); return -1; }
+
+  return 0;
+}
+
 int main(int argc, char *argv[])
 {
   // Parsing command line arguments
@@ -54,7 +325,7 @@ int main(int argc, char *argv[])
     .required();
 
   program.add_argument("--cycleType")
-    .help("Specifies the emulation actions to be performed per each input. Possible values: 'Simple': performs only advance state, 'Rerecord': performs load/advance/save, and 'Full': performs load/advance/save/advance.")
+    .help("Specifies the emulation actions to be performed per each input. Possible values: 'Simple': performs only advance state, 'Rerecord': performs load/advance/save, 'Beam': runs a beam search from the state after the first --beamStart inputs of the sequence, and 'Full': performs load/advance/save/advance.")
     .default_value(std::string("Simple"));
 
   program.add_argument("--hashOutputFile")
@@ -65,6 +336,43 @@ int main(int argc, char *argv[])
     .help("How many pre-advances to do when using a rerecord cycle.")
     .default_value(std::string("1"));
 
+  program.add_argument("--dedupBenchmark")
+    .help("During a rerecord cycle, inserts the digest of every state reached into a hash set shared by all threads, as they go, and reports its throughput and collision rates.")
+    .default_value(false)
+    .implicit_value(true);
+
+  program.add_argument("--dedupTableSize")
+    .help("Memory for the shared state hash set, in megabytes.")
+    .default_value(std::string("64"));
+
+  program.add_argument("--dedupMaxAge")
+    .help("Sequence steps after which a state not reached again can be evicted from the shared state hash set.")
+    .default_value(std::string("64"));
+
+  program.add_argument("--beamWidth")
+    .help("How many states the beam search keeps every tic.")
+    .default_value(std::string("64"));
+
+  program.add_argument("--beamDepth")
+    .help("How many tics the beam search runs for.")
+    .default_value(std::string("32"));
+
+  program.add_argument("--beamStart")
+    .help("How many inputs of the sequence to play before starting the beam search.")
+    .default_value(std::string("0"));
+
+  program.add_argument("--beamInputs")
+    .help("Path to a file with the input strings every state is expanded with during the beam search, one per line. By default, the legal inputs on the script's input grid are used.")
+    .default_value(std::string(""));
+
+  program.add_argument("--scoring")
+    .help("Scoring hook that ranks the beam search states. Possible values: 'Exit', 'Kills' and 'Health'.")
+    .default_value(std::string("Exit"));
+
+  program.add_argument("--hashScope")
+    .help("Overrides the 'Hash Scope' of the script, which decides the parts of the state the hashes cover.")
+    .default_value(std::string(""));
+
   program.add_argument("--warmup")
   .help("Warms up the CPU before running for reduced variation in performance results")
   .default_value(false)
@@ -88,17 +396,38 @@ int main(int argc, char *argv[])
   bool cycleTypeRecognized = false;
   if (cycleType == "Simple") cycleTypeRecognized = true;
   if (cycleType == "Rerecord") cycleTypeRecognized = true;
+  if (cycleType == "Beam") cycleTypeRecognized = true;
   if (cycleTypeRecognized == false) JAFFAR_THROW_LOGIC("Unrecognized cycle type: %s\n", cycleType.c_str());
 
   // Getting warmup setting
   const auto useWarmUp = program.get<bool>("--warmup");
 
+  // Getting deduplication benchmark settings
+  const auto useDedupBenchmark = program.get<bool>("--dedupBenchmark");
+  const auto dedupTableSize = std::stoul(program.get<std::string>("--dedupTableSize"));
+  const auto dedupMaxAge = std::stoul(program.get<std::string>("--dedupMaxAge"));
+  if (useDedupBenchmark == true && cycleType != "Rerecord") JAFFAR_THROW_LOGIC("The deduplication benchmark requires the 'Rerecord' cycle type\n");
+  if (dedupMaxAge > UINT16_MAX - 1) JAFFAR_THROW_LOGIC("The deduplication max age must be lower than %u\n", UINT16_MAX);
+
+  // Getting beam search settings
+  const auto beamWidth = std::stoul(program.get<std::string>("--beamWidth"));
+  const auto beamDepth = std::stoul(program.get<std::string>("--beamDepth"));
+  const auto beamStart = std::stoul(program.get<std::string>("--beamStart"));
+  const auto beamInputsFilePath = program.get<std::string>("--beamInputs");
+  const auto scoringName = program.get<std::string>("--scoring");
+  if (beamWidth < 1) JAFFAR_THROW_LOGIC("The beam width must be at least 1\n");
+  if (jaffar::scorers.contains(scoringName) == false) JAFFAR_THROW_LOGIC("Unrecognized scoring hook: %s\n", scoringName.c_str());
+
   // Loading script file
   std::string configJsRaw;
   if (jaffarCommon::file::loadStringFromFile(configJsRaw, scriptFilePath) == false) JAFFAR_THROW_LOGIC("Could not find/read script file: %s\n", scriptFilePath.c_str());
 
   // Parsing script
-  const auto configJs = nlohmann::json::parse(configJsRaw);
+  auto configJs = nlohmann::json::parse(configJsRaw);
+
+  // Overriding the hash scope, if requested
+  const auto hashScope = program.get<std::string>("--hashScope");
+  if (hashScope != "") configJs["Hash Scope"] = hashScope;
 
   // Getting expected result parameters
   auto expectedResult = jaffarCommon::json::getObject(configJs, "Expected Result");
@@ -119,6 +448,10 @@ int main(int argc, char *argv[])
   // Getting sequence lenght
   const auto sequenceLength = sequence.size();
 
+  // States move between threads in the beam search
+  if (cycleType == "Beam" && configJs.contains("Level Arena Size") && jaffarCommon::json::getNumber<size_t>(configJs, "Level Arena Size") > 0) JAFFAR_THROW_LOGIC("The beam search does not support level arena states, which only load back into the instance that saved them\n");
+  if (beamStart > sequenceLength) JAFFAR_THROW_LOGIC("The beam search start (%lu) is past the end of the sequence (%lu)\n", beamStart, sequenceLength);
+
   // Mutex for common checks
   std::mutex mutex;
 
@@ -128,6 +461,19 @@ int main(int argc, char *argv[])
   // Flag for successful execution
   bool isSuccess = true;
 
+  // Resident memory with the first instance and with every thread's, to tell what a thread adds
+  residentMemory_t residentMemory;
+
+  // State hash set shared by all threads, for the deduplication benchmark
+  std::unique_ptr<jaffar::StateHashSet> dedupSet;
+  if (useDedupBenchmark) dedupSet = std::make_unique<jaffar::StateHashSet>(dedupTableSize * 1024 * 1024, dedupMaxAge);
+  jaffar::StateHashSet::stats_t dedupStats;
+  double dedupDigestTime = 0.0;
+  double dedupInsertTime = 0.0;
+
+  // Time the slowest thread took to run the sequence, without the deduplication work
+  double cycleTime = 0.0;
+
   // If warmup is enabled, run it now. This helps in reducing variation in performance results due to CPU throttling
   if (useWarmUp)
   {
@@ -145,23 +491,66 @@ int main(int argc, char *argv[])
   printf("[] Cycle Type:                             '%s'\n", cycleType.c_str());
   printf("[] Sequence File:                          '%s'\n", sequenceFilePath.c_str());
   printf("[] Sequence Length:                        %lu\n", sequenceLength);
+
+  if (cycleType == "Beam")
+  {
+    std::vector<std::string> beamInputs;
+    if (beamInputsFilePath != "")
+    {
+      std::string beamInputsRaw;
+      if (jaffarCommon::file::loadStringFromFile(beamInputsRaw, beamInputsFilePath) == false) JAFFAR_THROW_LOGIC("[ERROR] Could not find or read from beam input set file: %s\n", beamInputsFilePath.c_str());
+      beamInputs = jaffarCommon::string::split(beamInputsRaw, '\n');
+      if (beamInputs.empty()) JAFFAR_THROW_LOGIC("[ERROR] The beam input set file is empty: %s\n", beamInputsFilePath.c_str());
+    }
+
+    printf("[] Beam Width / Depth / Start:             %lu / %lu / %lu\n", beamWidth, beamDepth, beamStart);
+    printf("[] Beam Input Set:                         '%s'\n", beamInputsFilePath == "" ? "Legal Inputs" : beamInputsFilePath.c_str());
+    printf("[] Scoring Hook:                           '%s'\n", scoringName.c_str());
+    printf("[] Threads:                                %lu\n", (size_t)jaffarCommon::parallel::getMaxThreadCount());
+    printf("[] ********** Running Test **********\n");
+    fflush(stdout);
+
+    const std::vector<std::string> initialSequence(sequence.begin(), sequence.begin() + beamStart);
+    if (runBeamSearch(configJs, initialSequence, beamInputs, jaffar::scorers.at(scoringName), beamWidth, beamDepth, verificationHash, residentMemory) != 0) return -1;
+    if (hashOutputFile != "") jaffarCommon::file::saveStringToFile(verificationHash, hashOutputFile.c_str());
+
+    printResidentMemory(residentMemory);
+    printf("[] Successful Execution.\n");
+    printf("[] Final State Hash:                       %s\n", verificationHash.c_str());
+    return 0;
+  }
+
   printf("[] ********** Running Test **********\n");
   fflush(stdout);
 
+  // Time for every thread to have its instance ready
+  double startupTime = 0.0;
+  const auto startupT0 = jaffarCommon::timing::now();
+
+  // Creating the master emulator instance
+  auto master = std::make_unique<jaffar::EmuInstance>(configJs);
+  master->initialize();
+  if (master->hasPortableStates()) master->recordStartState();
+  residentMemory.oneInstance = getResidentMemory();
+
   JAFFAR_PARALLEL
   {
-    // Creating emulator instance
-    auto e = jaffar::EmuInstance(configJs);
+    // Getting this thread's emulator instance
+    std::unique_ptr<jaffar::EmuInstance> worker;
+    if (jaffarCommon::parallel::getThreadId() != 0) worker = createWorkerInstance(*master, configJs);
+    auto &e = worker == nullptr ? *master : *worker;
+    const double threadStartupTime = jaffarCommon::timing::timeDeltaSeconds(jaffarCommon::timing::now(), startupT0);
+    mutex.lock();
+    startupTime = std::max(startupTime, threadStartupTime);
+    mutex.unlock();
 
-    // Initializing emulator instance
-    e.initialize();
+    #pragma omp barrier
+    #pragma omp single
+    residentMemory.allInstances = getResidentMemory();
     
     // Disable rendering
     e.disableRendering();
 
-    // Getting full state size
-    const auto stateSize = e.getStateSize();
-
     // Getting input parser from the emulator
     const auto inputParser = e.getInputParser();
 
@@ -177,9 +566,12 @@ int main(int argc, char *argv[])
     std::string emulationCoreName = e.getCoreName();
 
     // Serializing initial state
-    auto currentState = (uint8_t *)malloc(stateSize);
+    uint8_t *currentState = nullptr;
+    size_t currentStateCapacity = 0;
+    size_t currentStateSize = e.getStateSize();
+    reserveStateBuffer(currentState, currentStateCapacity, currentStateSize);
     {
-      jaffarCommon::serializer::Contiguous cs(currentState);
+      jaffarCommon::serializer::Contiguous cs(currentState, currentStateSize);
       e.serializeState(cs);
     }
 
@@ -188,18 +580,38 @@ int main(int argc, char *argv[])
     bool doDeserialize = cycleType == "Rerecord";
     bool doSerialize = cycleType == "Rerecord";
 
+    // For the deduplication benchmark, every state reached goes into the shared set right away, while the other
+    // threads do the same. Taking the digest and inserting it are timed apart from the rest of the cycle.
+    jaffar::StateHashSet::stats_t threadDedupStats;
+    double threadDigestTime = 0.0;
+    double threadInsertTime = 0.0;
+    auto dedupInsert = [&](const bool isSerialized)
+    {
+      const auto digestT0 = jaffarCommon::timing::now();
+      const auto digest = isSerialized ? e.getStateDigest(currentState, currentStateSize) : e.getStateDigest();
+      const auto insertT0 = jaffarCommon::timing::now();
+      dedupSet->insert(digest, threadDedupStats);
+      const auto insertTf = jaffarCommon::timing::now();
+      threadDigestTime += jaffarCommon::timing::timeDeltaSeconds(insertT0, digestT0);
+      threadInsertTime += jaffarCommon::timing::timeDeltaSeconds(insertTf, insertT0);
+    };
+
     // Actually running the sequence
     auto t0 = std::chrono::high_resolution_clock::now();
     for (const auto &input : decodedSequence)
     {
       if (doPreAdvance == true) 
       {
-        for (size_t i = 0; i < rerecordDepth; i++) e.advanceState(generateRandomInput(rng));
+        for (int i = 0; i < rerecordDepth; i++)
+        {
+          e.advanceState(generateRandomInput(rng));
+          if (useDedupBenchmark == true) dedupInsert(false);
+        }
       }
       
       if (doDeserialize == true)
       {
-        jaffarCommon::deserializer::Contiguous d(currentState, stateSize);
+        jaffarCommon::deserializer::Contiguous d(currentState, currentStateSize);
         e.deserializeState(d);
       } 
       
@@ -207,15 +619,25 @@ int main(int argc, char *argv[])
 
       if (doSerialize == true)
       {
-        auto s = jaffarCommon::serializer::Contiguous(currentState, stateSize);
+        currentStateSize = e.getStateSize();
+        reserveStateBuffer(currentState, currentStateCapacity, currentStateSize);
+        auto s = jaffarCommon::serializer::Contiguous(currentState, currentStateSize);
         e.serializeState(s);
       } 
+
+      // The first thread ages the shared set's entries once per sequence step. A state that was just
+      // serialized is hashed where it was written, so its digest does not archive it again.
+      if (useDedupBenchmark == true)
+      {
+        if (jaffarCommon::parallel::getThreadId() == 0) dedupSet->advanceAge();
+        dedupInsert(doSerialize);
+      }
     }
     auto tf = std::chrono::high_resolution_clock::now();
 
     // Calculating running time
     auto dt = std::chrono::duration_cast<std::chrono::nanoseconds>(tf - t0).count();
-    double elapsedTimeSeconds = (double)dt * 1.0e-9;
+    double elapsedTimeSeconds = (double)dt * 1.0e-9 - threadDigestTime - threadInsertTime;
 
     // Calculating final state hash
     auto result = e.getStateHash();
@@ -231,6 +653,17 @@ int main(int argc, char *argv[])
     else if (hashString != verificationHash) { printf("[] Test Failed: Diverging Hashes (%s vs %s)\n", hashString.c_str(), verificationHash.c_str()); isSuccess = false; }
     mutex.unlock();
 
+    // Gathering the deduplication benchmark results. The times are summed over threads.
+    if (useDedupBenchmark == true)
+    {
+      mutex.lock();
+      dedupStats += threadDedupStats;
+      dedupDigestTime += threadDigestTime;
+      dedupInsertTime += threadInsertTime;
+      cycleTime = std::max(cycleTime, elapsedTimeSeconds);
+      mutex.unlock();
+    }
+
     // Checking expected consitions
     auto mapNumber = e.getMapNumber ();
     auto isLevelExit = e.isLevelExit ();
@@ -246,10 +679,31 @@ int main(int argc, char *argv[])
     }
   }
  
+  // Reporting deduplication benchmark results
+  if (useDedupBenchmark)
+  {
+    const size_t attempts = dedupStats.inserted + dedupStats.present + dedupStats.full;
+    const size_t threadCount = jaffarCommon::parallel::getMaxThreadCount();
+    printf("[] ********** Deduplication Benchmark **********\n");
+    printf("[] Hash Set Size:                          %.3f Mb (%lu slots, max age %lu)\n", (double)dedupSet->getMemorySize() / (1024.0 * 1024.0), dedupSet->getSlotCount(), dedupMaxAge);
+    printf("[] Insert Attempts:                        %lu\n", attempts);
+    printf("[] Inserted / Present / Full:              %lu / %lu / %lu\n", dedupStats.inserted, dedupStats.present, dedupStats.full);
+    printf("[] Evictions:                              %lu\n", dedupStats.evicted);
+    printf("[] Collisions per Insert:                  %.4f\n", attempts > 0 ? (double)dedupStats.collisions / (double)attempts : 0.0);
+    printf("[] Duplicate Rate:                         %.2f%%\n", attempts > 0 ? 100.0 * (double)dedupStats.present / (double)attempts : 0.0);
+    printf("[] Live Entries:                           %lu (%.2f%% load)\n", dedupSet->getEntryCount(), 100.0 * (double)dedupSet->getEntryCount() / (double)dedupSet->getSlotCount());
+    printf("[] Cycle Time, Without Deduplication:      %.3fms (slowest of %lu threads)\n", cycleTime * 1.0e3, threadCount);
+    printf("[] Digest Time per Thread:                 %.3fms (%.3f us per state)\n", dedupDigestTime * 1.0e3 / (double)threadCount, attempts > 0 ? dedupDigestTime * 1.0e6 / (double)attempts : 0.0);
+    printf("[] Insert Time per Thread:                 %.3fms (%.3f ns per insert)\n", dedupInsertTime * 1.0e3 / (double)threadCount, attempts > 0 ? dedupInsertTime * 1.0e9 / (double)attempts : 0.0);
+    printf("[] Insert Throughput:                      %.3f Minserts/s (%lu threads inserting while simulating)\n", dedupInsertTime > 0.0 ? 1.0e-6 * (double)attempts * (double)threadCount / dedupInsertTime : 0.0, threadCount);
+  }
+
   // If failed, return now
   if (isSuccess == false) return -1;
 
   // If reached this point, everything ran ok
+  printf("[] Instance Startup Time:                  %3.3fs\n", startupTime);
+  printResidentMemory(residentMemory);
   printf("[] Successful Execution.\n");
   printf("[] Final State Hash:                       %s\n", verificationHash.c_str());
   return 0;
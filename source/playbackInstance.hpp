@@ -2,6 +2,8 @@
 
 #include "emuInstance.hpp"
 #include <string>
+#include <list>
+#include <unordered_map>
 #include <jaffarCommon/hash.hpp>
 #include <jaffarCommon/exceptions.hpp>
 
@@ -11,29 +13,38 @@ struct stepData_t
 {
   jaffar::input_t inputData;
   std::string inputString;
-  uint8_t *stateData;
+  uint8_t *stateData; // nullptr for steps between keyframes
+  size_t stateSize;
   uint8_t *videoBuffer;
   jaffarCommon::hash::hash_t hash;
 };
 
+// A step reconstructed from its keyframe, kept until evicted
+struct cachedStep_t
+{
+  stepData_t step;
+  std::list<size_t>::iterator lruPosition;
+};
+
 class PlaybackInstance
 {
   public:
 
-  // Initializes the playback module instance
-  PlaybackInstance(jaffar::EmuInstance *emu, const std::vector<std::string> &sequence, const std::string& cycleType) :
-   _emu(emu)
+  // Initializes the playback module instance. Only every keyframeInterval-th step
+  // stores its state and video buffer; the others are replayed from the closest
+  // earlier keyframe when visited, keeping the last cacheSize of them around.
+  PlaybackInstance(jaffar::EmuInstance *emu, const std::vector<std::string> &sequence, const std::string& cycleType, const size_t keyframeInterval = 1, const size_t cacheSize = 1) :
+   _emu(emu),
+   _keyframeInterval(keyframeInterval),
+   _cacheSize(cacheSize)
   {
+    if (_keyframeInterval == 0) JAFFAR_THROW_LOGIC("[Error] The keyframe interval must be at least 1");
+    if (_cacheSize == 0) JAFFAR_THROW_LOGIC("[Error] The step cache size must be at least 1");
+
     // Getting video buffer size
     _videoBufferSize = _emu->getVideoBufferSize();
     _videoBufferPtr = _emu->getVideoBufferPtr();
 
-    // Getting full state size
-    _fullStateSize = _emu->getStateSize();  
-
-    // Allocating temporary state data 
-    uint8_t* stateData = (uint8_t*)malloc(_fullStateSize);
-
     // Getting input decoder
     auto inputParser = _emu->getInputParser();
 
@@ -44,19 +55,13 @@ class PlaybackInstance
       stepData_t step;
       step.inputString = sequence[i];
       step.inputData = inputParser->parseInputString(step.inputString);
-
-      // Serializing state
-      jaffarCommon::serializer::Contiguous s(stateData, _fullStateSize);
-      _emu->serializeState(s);
+      step.stateData = nullptr;
+      step.stateSize = 0;
+      step.videoBuffer = nullptr;
       step.hash = _emu->getStateHash();
 
-      // Saving step data
-      step.stateData = (uint8_t *)malloc(_fullStateSize);
-      memcpy(step.stateData, stateData, _fullStateSize);
-
-      // Creating step's video buffer
-      step.videoBuffer = (uint8_t *)malloc(_videoBufferSize);
-      memcpy(step.videoBuffer, _videoBufferPtr, _videoBufferSize); 
+      // Keyframes store the state and the step's video buffer
+      if (i % _keyframeInterval == 0) storeStep(step);
 
       // Adding the step into the sequence
       _stepSequence.push_back(step);
@@ -69,8 +74,11 @@ class PlaybackInstance
 
       if (cycleType == "Rerecord")
       {
+        std::vector<uint8_t> stateData(_emu->getStateSize());
+        jaffarCommon::serializer::Contiguous s(stateData.data(), stateData.size());
+        _emu->serializeState(s);
         _emu->advanceState(step.inputData );
-        jaffarCommon::deserializer::Contiguous d(stateData, _fullStateSize);
+        jaffarCommon::deserializer::Contiguous d(stateData.data(), stateData.size());
         _emu->deserializeState(d);
         _emu->advanceState(step.inputData );
       }
@@ -80,19 +88,26 @@ class PlaybackInstance
     stepData_t step;
     step.inputString = "<End Of Sequence>";
     step.inputData = _stepSequence.rbegin()->inputData;
-    step.stateData = (uint8_t *)malloc(_fullStateSize);
-    jaffarCommon::serializer::Contiguous s(step.stateData, _fullStateSize);
-
-    _emu->serializeState(s);
+    step.stateData = nullptr;
+    step.stateSize = 0;
+    step.videoBuffer = nullptr;
     step.hash = _emu->getStateHash();
+    if (sequence.size() % _keyframeInterval == 0) storeStep(step);
 
     // Adding the step into the sequence
     _stepSequence.push_back(step);
+  }
 
-    // Freeing memory
-    free(stateData);
+  ~PlaybackInstance()
+  {
+    for (auto &step : _stepSequence) freeStep(step);
+    for (auto &entry : _stepCache) freeStep(entry.second.step);
   }
 
+  // Steps own their state and video buffers, which copies would free twice
+  PlaybackInstance(const PlaybackInstance &) = delete;
+  PlaybackInstance &operator=(const PlaybackInstance &) = delete;
+
   // Function to render frame
   void renderFrame(const size_t stepId)
   {
@@ -100,7 +115,7 @@ class PlaybackInstance
     if (stepId >= _stepSequence.size() - 1) return;
 
     // Updating video buffer
-    const auto &step = _stepSequence[stepId];
+    const auto &step = getStep(stepId);
     memcpy(_videoBufferPtr, step.videoBuffer, _videoBufferSize);
 
     // Updating image
@@ -136,18 +151,31 @@ class PlaybackInstance
     return step.inputData;
   }
 
-  const uint8_t *getStateData(const size_t stepId) const
+  // The returned data stays valid until a different step is requested
+  const uint8_t *getStateData(const size_t stepId)
   {
     // Checking the required step id does not exceed contents of the sequence
     if (stepId > _stepSequence.size()) JAFFAR_THROW_RUNTIME("[Error] Attempting to render a step larger than the step sequence");
 
     // Getting step information
-    const auto &step = _stepSequence[stepId];
+    const auto &step = getStep(stepId);
 
     // Returning step input
     return step.stateData;
   }
 
+  size_t getStateSize(const size_t stepId)
+  {
+    // Checking the required step id does not exceed contents of the sequence
+    if (stepId > _stepSequence.size()) JAFFAR_THROW_RUNTIME("[Error] Attempting to render a step larger than the step sequence");
+
+    // Getting step information
+    const auto &step = getStep(stepId);
+
+    // Returning step state size
+    return step.stateSize;
+  }
+
   const jaffarCommon::hash::hash_t getStateHash(const size_t stepId) const
   {
     // Checking the required step id does not exceed contents of the sequence
@@ -161,15 +189,86 @@ class PlaybackInstance
   }
 
   private:
-  
+
+  // Stores the emulator's current state and video buffer into the step
+  void storeStep(stepData_t &step)
+  {
+    step.stateSize = _emu->getStateSize();
+    step.stateData = (uint8_t *)malloc(step.stateSize);
+    jaffarCommon::serializer::Contiguous s(step.stateData, step.stateSize);
+    _emu->serializeState(s);
+
+    step.videoBuffer = (uint8_t *)malloc(_videoBufferSize);
+    memcpy(step.videoBuffer, _videoBufferPtr, _videoBufferSize);
+  }
+
+  void freeStep(stepData_t &step)
+  {
+    free(step.stateData);
+    free(step.videoBuffer);
+    step.stateData = nullptr;
+    step.videoBuffer = nullptr;
+  }
+
+  // Returns a step with its state and video buffer, replaying it from the
+  // closest earlier keyframe or cached step if it has not been stored
+  const stepData_t &getStep(const size_t stepId)
+  {
+    auto &step = _stepSequence[stepId];
+    if (step.stateData != nullptr) return step;
+
+    auto cached = _stepCache.find(stepId);
+    if (cached != _stepCache.end())
+    {
+      _lruSteps.splice(_lruSteps.begin(), _lruSteps, cached->second.lruPosition);
+      return cached->second.step;
+    }
+
+    // Looking for the closest step to replay from, stepping through frames
+    // in order only needs to advance once per step
+    size_t baseId = stepId - stepId % _keyframeInterval;
+    const stepData_t *base = &_stepSequence[baseId];
+    for (size_t j = stepId - 1; j > baseId; j--)
+    {
+      cached = _stepCache.find(j);
+      if (cached != _stepCache.end()) { baseId = j; base = &cached->second.step; break; }
+    }
+
+    jaffarCommon::deserializer::Contiguous d(base->stateData, base->stateSize);
+    _emu->deserializeState(d);
+    for (size_t j = baseId; j < stepId; j++) _emu->advanceState(_stepSequence[j].inputData);
+
+    // Evicting the least recently visited step, if the cache is full
+    if (_stepCache.size() >= _cacheSize)
+    {
+      auto evicted = _stepCache.find(_lruSteps.back());
+      freeStep(evicted->second.step);
+      _stepCache.erase(evicted);
+      _lruSteps.pop_back();
+    }
+
+    auto &entry = _stepCache[stepId];
+    entry.step = step;
+    storeStep(entry.step);
+    _lruSteps.push_front(stepId);
+    entry.lruPosition = _lruSteps.begin();
+
+    return entry.step;
+  }
+
   // Internal sequence information
   std::vector<stepData_t> _stepSequence;
 
+  // Steps between keyframes reconstructed recently, most recent first
+  std::unordered_map<size_t, cachedStep_t> _stepCache;
+  std::list<size_t> _lruSteps;
+
   // Pointer to the contained emulator instance
   jaffar::EmuInstance *const _emu;
 
-  // Full size of the game state
-  size_t _fullStateSize;
+  // Steps between stored keyframes, and how many replayed steps to keep
+  const size_t _keyframeInterval;
+  const size_t _cacheSize;
 
   // Video buffer
   size_t _videoBufferSize;
@@ -34,6 +34,14 @@ int main(int argc, char *argv[])
     .default_value(false)
     .implicit_value(true);
 
+  program.add_argument("--keyframeInterval")
+    .help("Stores the state and frame of every N-th step only. Steps in between are replayed from the closest keyframe when visited.")
+    .default_value(std::string("64"));
+
+  program.add_argument("--stepCacheSize")
+    .help("Number of replayed steps to keep in memory. Defaults to two keyframe intervals, enough to step back and forth across one keyframe.")
+    .default_value(std::string("0"));
+
 
   // Try to parse arguments
   try { program.parse_args(argc, argv); } catch (const std::runtime_error &err) { JAFFAR_THROW_LOGIC("%s\n%s", err.what(), program.help().str().c_str()); }
@@ -64,6 +72,13 @@ int main(int argc, char *argv[])
   // Getting reproduce flag
   bool disableRender = program.get<bool>("--disableRender");
 
+  // Getting playback storage parameters
+  const auto keyframeInterval = std::stoi(program.get<std::string>("--keyframeInterval"));
+  auto stepCacheSize = std::stoi(program.get<std::string>("--stepCacheSize"));
+  if (keyframeInterval < 1) JAFFAR_THROW_LOGIC("The keyframe interval must be at least 1\n");
+  if (stepCacheSize < 0) JAFFAR_THROW_LOGIC("The step cache size cannot be negative\n");
+  if (stepCacheSize == 0) stepCacheSize = 2 * keyframeInterval;
+
   // Loading sequence file
   std::string inputSequence;
   auto status = jaffarCommon::file::loadStringFromFile(inputSequence, sequenceFilePath.c_str());
@@ -92,10 +107,7 @@ int main(int argc, char *argv[])
   if (disableRender == false) e.enableRendering();
 
   // Creating playback instance
-  auto p = PlaybackInstance(&e, sequence, cycleType);
-
-  // Getting state size
-  auto stateSize = e.getStateSize();
+  auto p = PlaybackInstance(&e, sequence, cycleType, (size_t)keyframeInterval, (size_t)stepCacheSize);
 
   // Flag to continue running playback
   bool continueRunning = true;
@@ -126,7 +138,7 @@ int main(int argc, char *argv[])
     const auto stateData = p.getStateData(currentStep);
 
     // Deserializing state
-    jaffarCommon::deserializer::Contiguous d(stateData);
+    jaffarCommon::deserializer::Contiguous d(stateData, p.getStateSize(currentStep));
     e.deserializeState(d);
 
     // Printing data and commands
@@ -175,8 +187,8 @@ int main(int argc, char *argv[])
       std::string saveFileName = "quicksave.state";
 
       std::string saveData;
-      saveData.resize(stateSize);
-      memcpy(saveData.data(), stateData, stateSize);
+      saveData.resize(p.getStateSize(currentStep));
+      memcpy(saveData.data(), stateData, saveData.size());
       if (jaffarCommon::file::saveStringToFile(saveData, saveFileName.c_str()) == false) JAFFAR_THROW_RUNTIME("[ERROR] Could not save state file: %s\n", saveFileName.c_str());
       jaffarCommon::logger::log("[] Saved state to %s\n", saveFileName.c_str());
 
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <functional>
+#include <map>
+#include <string>
+#include "gameFeatures.h"
+
+namespace jaffar
+{
+
+// Scoring hooks that rank states by their game features, higher is better. A new one only needs an entry here.
+typedef std::function<float(const gameFeatures_t &)> scorer_t;
+inline const std::map<std::string, scorer_t> scorers =
+{
+  // Exiting the level above all, and getting closer to an exit line otherwise. Without an exit line in
+  // reach (or a body to measure from) the distance is unknown, which ranks below any known distance.
+  { "Exit", [](const gameFeatures_t &f)
+    {
+      if (f.levelExit) return 1.0e9f;
+      return f.players[0].exitDistance < 0.0f ? -1.0e9f : -f.players[0].exitDistance;
+    }
+  },
+
+  // Kills first, then items and secrets
+  { "Kills", [](const gameFeatures_t &f)
+    {
+      return 1.0e4f * (float)f.players[0].killCount + 1.0e2f * (float)f.players[0].itemCount + (float)f.players[0].secretCount;
+    }
+  },
+
+  // Staying alive with the most health and armor
+  { "Health", [](const gameFeatures_t &f)
+    {
+      return (float)f.players[0].health + (float)f.players[0].armorPoints;
+    }
+  },
+};
+
+} // namespace jaffar
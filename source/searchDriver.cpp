@@ -0,0 +1,391 @@
+#include "argparse/argparse.hpp"
+#include <jaffarCommon/json.hpp>
+#include <jaffarCommon/serializers/contiguous.hpp>
+#include <jaffarCommon/deserializers/contiguous.hpp>
+#include <jaffarCommon/hash.hpp>
+#include <jaffarCommon/string.hpp>
+#include <jaffarCommon/timing.hpp>
+#include <jaffarCommon/logger.hpp>
+#include <jaffarCommon/file.hpp>
+#include <jaffarCommon/parallel.hpp>
+#include "emuInstance.hpp"
+#include "stateHashSet.hpp"
+#include "scorers.hpp"
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <string>
+
+// Inputs that led to a search node. Each node only adds its last input to its parent's.
+struct history_t
+{
+  std::shared_ptr<const history_t> parent;
+  jaffar::input_t input;
+  size_t depth;
+};
+
+struct node_t
+{
+  std::vector<uint8_t> state;
+  std::shared_ptr<const history_t> history; // nullptr for the root
+};
+
+// Nodes waiting to be expanded by one thread. The owner pushes and pops at the back, so it goes depth
+// first; idle threads steal from the front, where the shallowest nodes, and so the largest subtrees, are.
+// Each thread has its own deque, guarded by its own mutex rather than being lock free: the lock is only
+// contended while a thread steals, and is taken once per node expansion, which simulates every legal input.
+class LockedWorkDeque
+{
+  public:
+
+  void push(node_t &&node)
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _nodes.push_back(std::move(node));
+  }
+
+  bool pop(node_t &node)
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (_nodes.empty()) return false;
+    node = std::move(_nodes.back());
+    _nodes.pop_back();
+    return true;
+  }
+
+  bool steal(node_t &node)
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (_nodes.empty()) return false;
+    node = std::move(_nodes.front());
+    _nodes.pop_front();
+    return true;
+  }
+
+  private:
+
+  std::mutex _mutex;
+  std::deque<node_t> _nodes;
+};
+
+int main(int argc, char *argv[])
+{
+  // Parsing command line arguments
+  argparse::ArgumentParser program("searchDriver", "1.0");
+
+  program.add_argument("scriptFile")
+    .help("Path to the script file to search from.")
+    .required();
+
+  program.add_argument("--initialSequence")
+    .help("Path to an input sequence file (.sol) to play before starting the search.")
+    .default_value(std::string(""));
+
+  program.add_argument("--scoring")
+    .help("Scoring hook that ranks the states found. Possible values: 'Exit', 'Kills' and 'Health'.")
+    .default_value(std::string("Exit"));
+
+  program.add_argument("--maxDepth")
+    .help("How many inputs past the initial sequence to search.")
+    .default_value(std::string("16"));
+
+  program.add_argument("--maxNodes")
+    .help("How many states to simulate before stopping (zero for no limit).")
+    .default_value(std::string("100000"));
+
+  program.add_argument("--maxSeconds")
+    .help("How many seconds to search before stopping (zero for no limit).")
+    .default_value(std::string("0"));
+
+  program.add_argument("--dedupTableSize")
+    .help("Memory for the shared state hash set that discards states already reached, in megabytes.")
+    .default_value(std::string("64"));
+
+  program.add_argument("--outputSolution")
+    .help("Path to write the best input sequence found to, in .sol format (none by default).")
+    .default_value(std::string(""));
+
+  program.add_argument("--saveInterval")
+    .help("Seconds between writes of the best input sequence found so far.")
+    .default_value(std::string("10"));
+
+  // Try to parse arguments
+  try { program.parse_args(argc, argv); } catch (const std::runtime_error &err) { JAFFAR_THROW_LOGIC("%s\n%s", err.what(), program.help().str().c_str()); }
+
+  // Getting script file path
+  const auto scriptFilePath = program.get<std::string>("scriptFile");
+
+  // Getting initial sequence file path (if any)
+  const auto initialSequenceFilePath = program.get<std::string>("--initialSequence");
+
+  // Getting scoring hook
+  const auto scoringName = program.get<std::string>("--scoring");
+  if (jaffar::scorers.contains(scoringName) == false) JAFFAR_THROW_LOGIC("Unrecognized scoring hook: %s\n", scoringName.c_str());
+  const auto &scorer = jaffar::scorers.at(scoringName);
+
+  // Getting search limits
+  const auto maxDepth = std::stoul(program.get<std::string>("--maxDepth"));
+  const auto maxNodes = std::stoul(program.get<std::string>("--maxNodes"));
+  const auto maxSeconds = std::stod(program.get<std::string>("--maxSeconds"));
+  if (maxDepth < 1) JAFFAR_THROW_LOGIC("The search depth must be at least 1\n");
+
+  // Getting deduplication and output settings
+  const auto dedupTableSize = std::stoul(program.get<std::string>("--dedupTableSize"));
+  const auto outputSolutionFilePath = program.get<std::string>("--outputSolution");
+  const auto saveInterval = std::stod(program.get<std::string>("--saveInterval"));
+
+  // Loading script file
+  std::string configJsRaw;
+  if (jaffarCommon::file::loadStringFromFile(configJsRaw, scriptFilePath) == false) JAFFAR_THROW_LOGIC("Could not find/read script file: %s\n", scriptFilePath.c_str());
+
+  // Parsing script
+  const auto configJs = nlohmann::json::parse(configJsRaw);
+
+  // Nodes move between threads, so their states must load into any instance
+  if (configJs.contains("Level Arena Size") && jaffarCommon::json::getNumber<size_t>(configJs, "Level Arena Size") > 0) JAFFAR_THROW_LOGIC("The search driver does not support level arena states, which only load back into the instance that saved them\n");
+
+  // Loading initial sequence
+  std::vector<std::string> initialSequence;
+  if (initialSequenceFilePath != "")
+  {
+    std::string sequenceRaw;
+    if (jaffarCommon::file::loadStringFromFile(sequenceRaw, initialSequenceFilePath) == false) JAFFAR_THROW_LOGIC("[ERROR] Could not find or read from input sequence file: %s\n", initialSequenceFilePath.c_str());
+    initialSequence = jaffarCommon::string::split(sequenceRaw, '\n');
+  }
+
+  // Shared search state
+  const size_t threadCount = jaffarCommon::parallel::getMaxThreadCount();
+  std::vector<std::unique_ptr<LockedWorkDeque>> deques;
+  for (size_t i = 0; i < threadCount; i++) deques.push_back(std::make_unique<LockedWorkDeque>());
+
+  // Ages are never advanced, so entries don't go stale
+  jaffar::StateHashSet dedupSet(dedupTableSize * 1024 * 1024, UINT16_MAX - 1);
+  jaffar::StateHashSet::stats_t dedupStats;
+
+  std::atomic<size_t> pendingNodes = 0; // Pushed and not yet expanded
+  std::atomic<size_t> simulatedNodes = 0;
+  std::atomic<size_t> expandedNodes = 0;
+  std::atomic<bool> stop = false;
+
+  // Best node found, read without the lock to skip it on most updates
+  std::mutex bestMutex;
+  std::atomic<float> bestScore = -std::numeric_limits<float>::infinity();
+  std::shared_ptr<const history_t> bestHistory;
+  gameFeatures_t bestFeatures;
+
+  // Per thread timing, collected at the end
+  std::mutex statsMutex;
+  double busyTime = 0.0;
+  size_t steals = 0;
+
+  // Input strings are the same for all instances, so any thread's parser writes them
+  std::mutex solutionMutex;
+  auto saveSolution = [&](const jaffar::InputParser *inputParser)
+  {
+    if (outputSolutionFilePath == "") return;
+
+    std::shared_ptr<const history_t> history;
+    {
+      std::lock_guard<std::mutex> lock(bestMutex);
+      history = bestHistory;
+    }
+
+    std::vector<jaffar::input_t> inputs;
+    for (auto h = history; h != nullptr; h = h->parent) inputs.push_back(h->input);
+    std::reverse(inputs.begin(), inputs.end());
+
+    std::string solution;
+    for (const auto &inputString : initialSequence) solution += inputString + "\n";
+    for (const auto &input : inputs) solution += inputParser->generateInputString(input) + "\n";
+
+    std::lock_guard<std::mutex> lock(solutionMutex);
+    jaffarCommon::file::saveStringToFile(solution, outputSolutionFilePath.c_str());
+  };
+
+  // Printing search information
+  printf("[] -----------------------------------------\n");
+  printf("[] Running Script:                         '%s'\n", scriptFilePath.c_str());
+  printf("[] Initial Sequence:                       '%s' (%lu inputs)\n", initialSequenceFilePath.c_str(), initialSequence.size());
+  printf("[] Scoring Hook:                           '%s'\n", scoringName.c_str());
+  printf("[] Max Depth / Nodes / Seconds:            %lu / %lu / %.1f\n", maxDepth, maxNodes, maxSeconds);
+  printf("[] Threads:                                %lu\n", threadCount);
+  printf("[] ********** Searching **********\n");
+  fflush(stdout);
+
+  // Set once the root is ready, so the initial sequence and instance setup don't count
+  auto t0 = jaffarCommon::timing::now();
+
+  // Nodes are deduplicated by the digest of their whole state, which storing them computes anyway
+  auto serializeNode = [](jaffar::EmuInstance &e, node_t &node, jaffarCommon::hash::hash_t &digest)
+  {
+    node.state.resize(e.getStateSize());
+    jaffarCommon::serializer::Contiguous s(node.state.data(), node.state.size());
+    e.serializeStateAndHash(s, digest);
+  };
+
+  // The master plays the initial sequence and seeds the first thread's deque with the root.
+  // The first thread runs it, and the others start from its state.
+  auto master = std::make_unique<jaffar::EmuInstance>(configJs);
+  master->initialize();
+  for (const auto &inputString : initialSequence) master->advanceState(master->getInputParser()->parseInputString(inputString));
+  master->recordStartState();
+  {
+    node_t root;
+    jaffarCommon::hash::hash_t digest;
+    serializeNode(*master, root, digest);
+    dedupSet.insert(digest, dedupStats);
+    master->getFeatures(bestFeatures);
+    bestScore = scorer(bestFeatures);
+
+    pendingNodes++;
+    deques[0]->push(std::move(root));
+  }
+
+  JAFFAR_PARALLEL
+  {
+    const size_t threadId = jaffarCommon::parallel::getThreadId();
+
+    // Getting this thread's emulator instance
+    std::unique_ptr<jaffar::EmuInstance> worker;
+    if (threadId != 0) worker = master->createFromStartState();
+    auto &e = worker == nullptr ? *master : *worker;
+
+    // Disable rendering
+    e.disableRendering();
+
+    // Getting input parser from the emulator
+    const auto inputParser = e.getInputParser();
+
+    jaffar::StateHashSet::stats_t threadDedupStats;
+
+    #pragma omp barrier
+
+    #pragma omp single
+    t0 = jaffarCommon::timing::now();
+
+    std::vector<jaffar::playerInput_t> legalInputs;
+    std::vector<std::pair<float, node_t>> children;
+    node_t node;
+    node_t child;
+    jaffarCommon::hash::hash_t digest;
+    double threadBusyTime = 0.0;
+    size_t threadSteals = 0;
+    auto lastSaveTime = jaffarCommon::timing::now();
+
+    while (stop == false)
+    {
+      // Taking own work first, then stealing from the others
+      bool found = deques[threadId]->pop(node);
+      for (size_t i = 1; found == false && i < threadCount; i++)
+        if (deques[(threadId + i) % threadCount]->steal(node)) { found = true; threadSteals++; }
+
+      if (found == false)
+      {
+        // Nothing pending anywhere means the tree is exhausted
+        if (pendingNodes == 0) break;
+        std::this_thread::yield();
+        continue;
+      }
+
+      const auto tb = jaffarCommon::timing::now();
+      const size_t depth = node.history == nullptr ? 0 : node.history->depth;
+
+      // Simulating every legal input from the node
+      {
+        jaffarCommon::deserializer::Contiguous d(node.state.data(), node.state.size());
+        e.deserializeState(d);
+      }
+      e.getLegalInputs(legalInputs);
+
+      children.clear();
+      for (size_t i = 0; i < legalInputs.size(); i++)
+      {
+        if (i > 0)
+        {
+          jaffarCommon::deserializer::Contiguous d(node.state.data(), node.state.size());
+          e.deserializeState(d);
+        }
+
+        const auto input = jaffar::makePlayerInput(legalInputs[i]);
+        e.advanceState(input);
+        simulatedNodes++;
+
+        serializeNode(e, child, digest);
+        if (dedupSet.insert(digest, threadDedupStats) == jaffar::StateHashSet::result_t::present) continue;
+
+        gameFeatures_t features;
+        e.getFeatures(features);
+        const float score = scorer(features);
+        auto history = std::make_shared<const history_t>(history_t{ node.history, input, depth + 1 });
+
+        if (score > bestScore)
+        {
+          std::lock_guard<std::mutex> lock(bestMutex);
+          if (score > bestScore) { bestScore = score; bestHistory = history; bestFeatures = features; }
+        }
+
+        // Leaves are not kept
+        if (features.levelExit || features.gameEnd || depth + 1 >= maxDepth) continue;
+
+        child.history = std::move(history);
+        children.emplace_back(score, std::move(child));
+        child = node_t();
+      }
+
+      // The best child goes last, so it is expanded next
+      std::sort(children.begin(), children.end(), [](const auto &a, const auto &b) { return a.first < b.first; });
+      pendingNodes += children.size();
+      for (auto &child : children) deques[threadId]->push(std::move(child.second));
+      pendingNodes--;
+      expandedNodes++;
+
+      const auto tf = jaffarCommon::timing::now();
+      threadBusyTime += jaffarCommon::timing::timeDeltaSeconds(tf, tb);
+
+      // Checking limits
+      if (maxNodes > 0 && simulatedNodes >= maxNodes) stop = true;
+      if (maxSeconds > 0.0 && jaffarCommon::timing::timeDeltaSeconds(tf, t0) >= maxSeconds) stop = true;
+
+      // The first thread writes the best solution so far, every so often
+      if (threadId == 0 && jaffarCommon::timing::timeDeltaSeconds(tf, lastSaveTime) >= saveInterval)
+      {
+        saveSolution(inputParser);
+        lastSaveTime = tf;
+      }
+    }
+
+    // Whoever stopped early, the others stop too
+    stop = true;
+
+    {
+      std::lock_guard<std::mutex> lock(statsMutex);
+      busyTime += threadBusyTime;
+      steals += threadSteals;
+      dedupStats += threadDedupStats;
+    }
+
+    #pragma omp barrier
+
+    if (threadId == 0) saveSolution(inputParser);
+  }
+
+  const double elapsedTimeSeconds = jaffarCommon::timing::timeDeltaSeconds(jaffarCommon::timing::now(), t0);
+  const size_t dedupAttempts = dedupStats.inserted + dedupStats.present + dedupStats.full;
+
+  printf("[] ********** Search Results **********\n");
+  printf("[] Elapsed time:                           %3.3fs\n", elapsedTimeSeconds);
+  printf("[] Simulated / Expanded Nodes:             %lu / %lu\n", simulatedNodes.load(), expandedNodes.load());
+  printf("[] Performance:                            %.3f nodes / s\n", (double)simulatedNodes / elapsedTimeSeconds);
+  printf("[] Thread Efficiency:                      %.2f%% (%lu steals)\n", 100.0 * busyTime / ((double)threadCount * elapsedTimeSeconds), steals);
+  printf("[] Duplicate Rate:                         %.2f%%\n", dedupAttempts > 0 ? 100.0 * (double)dedupStats.present / (double)dedupAttempts : 0.0);
+  printf("[] Best Score:                             %f (depth %lu)\n", bestScore.load(), bestHistory == nullptr ? 0 : bestHistory->depth);
+  printf("[] Best Map / Tic / Health / Kills:        %d / %d / %d / %d\n", bestFeatures.map, bestFeatures.gameTic, bestFeatures.players[0].health, bestFeatures.players[0].killCount);
+  if (outputSolutionFilePath != "") printf("[] Best Solution:                          '%s'\n", outputSolutionFilePath.c_str());
+
+  return 0;
+}
@@ -0,0 +1,152 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <jaffarCommon/hash.hpp>
+#include <jaffarCommon/exceptions.hpp>
+
+namespace jaffar
+{
+
+// Concurrent set of 128-bit state hashes with insert-if-absent semantics, for deduplicating
+// states across search threads without locks. It is an open addressing table of a fixed
+// number of 64-bit slots: the first half of the hash picks the slot, and the slot keeps 48
+// bits of the second half together with the 16-bit age at which it was last inserted or
+// found. Entries older than the maximum age are stale, and get overwritten by new ones.
+//
+// Two threads inserting the same state at once may both see it as new. Probing stops after
+// a fixed number of slots, and a state that finds no room there is reported as such.
+class StateHashSet
+{
+  public:
+
+  enum class result_t { inserted, present, full };
+
+  // Per caller statistics, so threads don't contend on shared counters
+  struct stats_t
+  {
+    size_t inserted = 0;
+    size_t present = 0;
+    size_t full = 0;
+    size_t evicted = 0;
+    size_t collisions = 0; // Slots held by other states, probed past
+
+    stats_t& operator+=(const stats_t& other)
+    {
+      inserted += other.inserted;
+      present += other.present;
+      full += other.full;
+      evicted += other.evicted;
+      collisions += other.collisions;
+      return *this;
+    }
+  };
+
+  // The slot count is the largest power of two that fits in the given memory
+  StateHashSet(const size_t memorySize, const uint16_t maxAge, const size_t maxProbes = 16) :
+    _maxAge(maxAge),
+    _maxProbes(maxProbes)
+  {
+    if (memorySize < sizeof(slot_t)) JAFFAR_THROW_LOGIC("[Error] The state hash set needs memory for at least one slot");
+    if (_maxProbes == 0) JAFFAR_THROW_LOGIC("[Error] The state hash set needs to probe at least one slot");
+
+    _slotCount = 1;
+    while (_slotCount * 2 * sizeof(slot_t) <= memorySize) _slotCount *= 2;
+    _mask = _slotCount - 1;
+
+    _slots = std::make_unique<slot_t[]>(_slotCount);
+    clear();
+  }
+
+  StateHashSet(const StateHashSet &) = delete;
+  StateHashSet &operator=(const StateHashSet &) = delete;
+
+  // Not thread safe: no thread may be inserting meanwhile
+  void clear()
+  {
+    for (size_t i = 0; i < _slotCount; i++) _slots[i].store(0, std::memory_order_relaxed);
+    _age.store(0, std::memory_order_relaxed);
+  }
+
+  // Ages all entries by one. Usually called once per search step, by a single thread.
+  void advanceAge() { _age.fetch_add(1, std::memory_order_relaxed); }
+
+  result_t insert(const jaffarCommon::hash::hash_t &hash, stats_t &stats)
+  {
+    const uint64_t tag = getTag(hash);
+    const uint16_t age = _age.load(std::memory_order_relaxed);
+    const uint64_t entry = tag | age;
+
+    slot_t *freeSlot = nullptr;
+    uint64_t freeValue = 0;
+
+    for (size_t probe = 0; probe < _maxProbes; probe++)
+    {
+      slot_t &slot = _slots[(hash.first + probe) & _mask];
+      uint64_t value = slot.load(std::memory_order_acquire);
+
+      if ((value & _TAG_MASK) == tag)
+      {
+        // Found: refreshing its age keeps it from being evicted while still being reached
+        if (value != entry) slot.compare_exchange_strong(value, entry, std::memory_order_relaxed);
+        stats.present++;
+        return result_t::present;
+      }
+
+      // The state can't be further along the probe sequence than an empty slot
+      if (value == 0)
+      {
+        if (freeSlot == nullptr) { freeSlot = &slot; freeValue = 0; }
+        break;
+      }
+
+      if (freeSlot == nullptr && isStale(value, age)) { freeSlot = &slot; freeValue = value; }
+      else stats.collisions++;
+    }
+
+    // Claiming the first empty or stale slot seen. If another thread took it meanwhile, retrying from the start
+    if (freeSlot == nullptr) { stats.full++; return result_t::full; }
+    if (freeSlot->compare_exchange_strong(freeValue, entry, std::memory_order_acq_rel) == false) return insert(hash, stats);
+
+    if (freeValue != 0) stats.evicted++;
+    stats.inserted++;
+    return result_t::inserted;
+  }
+
+  size_t getSlotCount() const { return _slotCount; }
+  size_t getMemorySize() const { return _slotCount * sizeof(slot_t); }
+
+  // Number of non stale entries. Not exact while other threads insert.
+  size_t getEntryCount() const
+  {
+    const uint16_t age = _age.load(std::memory_order_relaxed);
+    size_t count = 0;
+    for (size_t i = 0; i < _slotCount; i++)
+    {
+      const uint64_t value = _slots[i].load(std::memory_order_relaxed);
+      if (value != 0 && isStale(value, age) == false) count++;
+    }
+    return count;
+  }
+
+  private:
+
+  typedef std::atomic<uint64_t> slot_t;
+
+  static constexpr uint64_t _TAG_MASK = ~(uint64_t)0xFFFF;
+
+  // The lowest tag bit is always set, so no tag looks like an empty slot
+  static uint64_t getTag(const jaffarCommon::hash::hash_t &hash) { return (hash.second & _TAG_MASK) | 0x10000; }
+
+  bool isStale(const uint64_t value, const uint16_t age) const { return (uint16_t)(age - (uint16_t)value) > _maxAge; }
+
+  std::unique_ptr<slot_t[]> _slots;
+  size_t _slotCount;
+  size_t _mask;
+  std::atomic<uint16_t> _age;
+  const uint16_t _maxAge;
+  const size_t _maxProbes;
+};
+
+} // namespace jaffar
@@ -0,0 +1,104 @@
+#include <jaffarCommon/hash.hpp>
+#include "stateHashSet.hpp"
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+// Checks of the state hash set's insert, lookup, aging and eviction rules, and of concurrent inserts
+
+#define CHECK(condition) if ((condition) == false) { printf("[] Test Failed: %s (line %d)\n", #condition, __LINE__); return -1; }
+
+using jaffar::StateHashSet;
+
+// Hashes whose first half picks the slot, and whose second half tells them apart (above the age and always set tag bits)
+static jaffarCommon::hash::hash_t makeHash(const uint64_t slot, const uint64_t id) { return { slot, id << 17 }; }
+
+int main(int argc, char *argv[])
+{
+  // Insert and lookup
+  {
+    StateHashSet set(1024 * sizeof(uint64_t), 8);
+    StateHashSet::stats_t stats;
+    CHECK(set.getSlotCount() == 1024);
+
+    CHECK(set.insert(makeHash(5, 1), stats) == StateHashSet::result_t::inserted);
+    CHECK(set.insert(makeHash(5, 1), stats) == StateHashSet::result_t::present);
+    CHECK(set.insert(makeHash(5 + 1024, 1), stats) == StateHashSet::result_t::present); // Only the slot's bits of the first half are used
+    CHECK(set.insert(makeHash(5, 2), stats) == StateHashSet::result_t::inserted);       // Probes past the first state
+    CHECK(set.insert(makeHash(5, 2), stats) == StateHashSet::result_t::present);
+    CHECK(stats.inserted == 2 && stats.present == 3 && stats.collisions == 2);
+    CHECK(set.getEntryCount() == 2);
+
+    set.clear();
+    CHECK(set.getEntryCount() == 0);
+    CHECK(set.insert(makeHash(5, 1), stats) == StateHashSet::result_t::inserted);
+  }
+
+  // Aging: entries older than the maximum age get evicted by new states, unless reached again meanwhile
+  {
+    StateHashSet set(1024 * sizeof(uint64_t), 2);
+    StateHashSet::stats_t stats;
+
+    CHECK(set.insert(makeHash(7, 1), stats) == StateHashSet::result_t::inserted);
+    set.advanceAge();
+    set.advanceAge();
+    CHECK(set.insert(makeHash(7, 1), stats) == StateHashSet::result_t::present); // Refreshes its age
+    set.advanceAge();
+    set.advanceAge();
+    CHECK(set.getEntryCount() == 1);
+    CHECK(set.insert(makeHash(7, 2), stats) == StateHashSet::result_t::inserted);
+    CHECK(stats.evicted == 0);
+
+    set.advanceAge();
+    set.advanceAge();
+    set.advanceAge();
+    CHECK(set.getEntryCount() == 0);
+    CHECK(set.insert(makeHash(7, 3), stats) == StateHashSet::result_t::inserted);
+    CHECK(stats.evicted == 1);
+    CHECK(set.insert(makeHash(7, 3), stats) == StateHashSet::result_t::present);
+  }
+
+  // Probing stops after the maximum number of slots
+  {
+    StateHashSet set(1024 * sizeof(uint64_t), 8, 2);
+    StateHashSet::stats_t stats;
+
+    CHECK(set.insert(makeHash(9, 1), stats) == StateHashSet::result_t::inserted);
+    CHECK(set.insert(makeHash(9, 2), stats) == StateHashSet::result_t::inserted);
+    CHECK(set.insert(makeHash(9, 3), stats) == StateHashSet::result_t::full);
+    CHECK(stats.full == 1);
+  }
+
+  // Concurrent inserts of distinct states all land, and a second round finds them all
+  {
+    const size_t threadCount = 8;
+    const size_t statesPerThread = 4096;
+    StateHashSet set(threadCount * statesPerThread * 4 * sizeof(uint64_t), 8);
+    std::vector<StateHashSet::stats_t> stats(threadCount);
+
+    for (int round = 0; round < 2; round++)
+    {
+      std::vector<std::thread> threads;
+      for (size_t t = 0; t < threadCount; t++)
+        threads.emplace_back([&, t]()
+        {
+          for (size_t i = 0; i < statesPerThread; i++)
+          {
+            const uint64_t id = t * statesPerThread + i + 1;
+            set.insert(makeHash(id * 0x9E3779B97F4A7C15ull, id), stats[t]);
+          }
+        });
+      for (auto &thread : threads) thread.join();
+    }
+
+    StateHashSet::stats_t totals;
+    for (const auto &threadStats : stats) totals += threadStats;
+    CHECK(totals.inserted == threadCount * statesPerThread);
+    CHECK(totals.present == threadCount * statesPerThread);
+    CHECK(totals.full == 0);
+    CHECK(set.getEntryCount() == threadCount * statesPerThread);
+  }
+
+  printf("[] Successful Execution.\n");
+  return 0;
+}
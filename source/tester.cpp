@@ -9,7 +9,9 @@
 #include <jaffarCommon/file.hpp>
 #include "emuInstance.hpp"
 #include <chrono>
+#include <algorithm>
 #include <random>
+#include <map>
 #include <sstream>
 #include <vector>
 #include <string>
@@ -39,6 +41,14 @@ jaffar::input_t generateRandomInput(std::mt19937& rng)
   return randomInput;
 }
 
+// States vary in size, so buffers grow to fit the largest state stored in them
+void reserveStateBuffer(uint8_t *&buffer, size_t &capacity, const size_t size)
+{
+  if (size <= capacity) return;
+  buffer = (uint8_t *)realloc(buffer, size);
+  capacity = size;
+}
+
 int main(int argc, char *argv[])
 {
   // Parsing command line arguments
@@ -53,7 +63,7 @@ int main(int argc, char *argv[])
     .required();
 
   program.add_argument("--cycleType")
-    .help("Specifies the emulation actions to be performed per each input. Possible values: 'Simple': performs only advance state, 'Rerecord': performs load/advance/save, and 'Full': performs load/advance/save/advance.")
+    .help("Specifies the emulation actions to be performed per each input. Possible values: 'Simple': performs only advance state, 'Rerecord': performs load/advance/save, 'Delta': performs load/advance/save using delta states against a keyframe, 'Rewind': performs advance and rewinds through the rewind buffer at the given depths, replaying back to the same tic, 'Reload': runs ahead, then performs load/save/advance/save, checking that saving right after a load gives back the loaded state, and 'Full': performs load/advance/save/advance.")
     .default_value(std::string("Simple"));
 
   program.add_argument("--hashOutputFile")
@@ -64,6 +74,54 @@ int main(int argc, char *argv[])
     .help("How many pre-advances to do when using a rerecord cycle.")
     .default_value(std::string("1"));
 
+  program.add_argument("--deltaKeyframeInterval")
+    .help("How many inputs to advance before refreshing the keyframe when using a delta cycle.")
+    .default_value(std::string("16"));
+
+  program.add_argument("--rewindBufferSize")
+    .help("Memory for the rewind buffer when using a rewind cycle, in megabytes.")
+    .default_value(std::string("64"));
+
+  program.add_argument("--rewindKeyframeInterval")
+    .help("How many inputs the rewind buffer records between keyframes when using a rewind cycle.")
+    .default_value(std::string("16"));
+
+  program.add_argument("--rewindDepths")
+    .help("Comma-separated list of how many tics to rewind when using a rewind cycle, taken in turns every tic.")
+    .default_value(std::string("1,4,16,64"));
+
+  program.add_argument("--inputCollapse")
+    .help("How many random inputs to key on every tic, to report how many of them lead to the same next state as another one. Each is also played from the tic's state, and inputs with the same key have to reach the same state hash.")
+    .default_value(std::string("0"));
+
+  program.add_argument("--legalInputs")
+    .help("Enumerates the legal inputs of every tic on the script's input grid, and reports how many there are.")
+    .default_value(false)
+    .implicit_value(true);
+
+  program.add_argument("--checkStateDigest")
+    .help("Checks on every tic that the digest of a stored state is the hash of its archive, and that it stores the same bytes as a plain save.")
+    .default_value(false)
+    .implicit_value(true);
+
+  program.add_argument("--checkWorldHash")
+    .help("Checks after every tic and every load that the world hash the core maintains incrementally is the one rebuilt from scratch. Needs the 'Incremental World' hash scope.")
+    .default_value(false)
+    .implicit_value(true);
+
+  program.add_argument("--checkSaveSections")
+    .help("Checks after every save that the sections read back from it, without loading it, hold the current game state. Needs a cycle that saves (Rerecord or Reload).")
+    .default_value(false)
+    .implicit_value(true);
+
+  program.add_argument("--hashScope")
+    .help("Overrides the 'Hash Scope' of the script, which decides the parts of the state the hashes cover.")
+    .default_value(std::string(""));
+
+  program.add_argument("--levelArenaSize")
+    .help("Overrides the 'Level Arena Size' of the script, in bytes. Zero keeps the level data out of the arena.")
+    .default_value(std::string(""));
+
   program.add_argument("--warmup")
   .help("Warms up the CPU before running for reduced variation in performance results")
   .default_value(false)
@@ -84,10 +142,38 @@ int main(int argc, char *argv[])
   // Parsing re-record depth
   const auto rerecordDepth = std::stoi(program.get<std::string>("--rerecordDepth"));
 
+  // Parsing delta keyframe interval
+  const auto deltaKeyframeInterval = std::stoi(program.get<std::string>("--deltaKeyframeInterval"));
+  if (deltaKeyframeInterval < 1) JAFFAR_THROW_LOGIC("Delta keyframe interval must be at least 1\n");
+
+  // Parsing rewind buffer settings
+  const auto rewindBufferSize = std::stoul(program.get<std::string>("--rewindBufferSize")) * 1024ul * 1024ul;
+  const auto rewindKeyframeInterval = std::stoi(program.get<std::string>("--rewindKeyframeInterval"));
+  if (rewindKeyframeInterval < 1) JAFFAR_THROW_LOGIC("Rewind keyframe interval must be at least 1\n");
+  std::vector<size_t> rewindDepths;
+  for (const auto &depth : jaffarCommon::string::split(program.get<std::string>("--rewindDepths"), ',')) rewindDepths.push_back(std::stoul(depth));
+  if (rewindDepths.empty()) JAFFAR_THROW_LOGIC("At least one rewind depth is required\n");
+
+  // Parsing how many random inputs to key per tic
+  const auto inputCollapseCount = std::stoi(program.get<std::string>("--inputCollapse"));
+  if (inputCollapseCount < 0) JAFFAR_THROW_LOGIC("Input collapse count must not be negative\n");
+
   bool cycleTypeRecognized = false;
   if (cycleType == "Simple") cycleTypeRecognized = true;
   if (cycleType == "Rerecord") cycleTypeRecognized = true;
+  if (cycleType == "Delta") cycleTypeRecognized = true;
+  if (cycleType == "Rewind") cycleTypeRecognized = true;
+  if (cycleType == "Reload") cycleTypeRecognized = true;
   if (cycleTypeRecognized == false) JAFFAR_THROW_LOGIC("Unrecognized cycle type: %s\n", cycleType.c_str());
+  if (inputCollapseCount > 0 && cycleType == "Rewind") JAFFAR_THROW_LOGIC("Input collapse loads states, which clears the rewind buffer\n");
+
+  // Getting legal input enumeration setting
+  const auto useLegalInputs = program.get<bool>("--legalInputs");
+
+  // Getting state digest check setting
+  const auto checkStateDigest = program.get<bool>("--checkStateDigest");
+  const auto checkWorldHash = program.get<bool>("--checkWorldHash");
+  const auto checkSaveSections = program.get<bool>("--checkSaveSections");
 
   // Getting warmup setting
   const auto useWarmUp = program.get<bool>("--warmup");
@@ -97,7 +183,15 @@ int main(int argc, char *argv[])
   if (jaffarCommon::file::loadStringFromFile(configJsRaw, scriptFilePath) == false) JAFFAR_THROW_LOGIC("Could not find/read script file: %s\n", scriptFilePath.c_str());
 
   // Parsing script
-  const auto configJs = nlohmann::json::parse(configJsRaw);
+  auto configJs = nlohmann::json::parse(configJsRaw);
+
+  // Overriding the hash scope, if requested
+  const auto hashScope = program.get<std::string>("--hashScope");
+  if (hashScope != "") configJs["Hash Scope"] = hashScope;
+
+  // Overriding the level arena size, if requested
+  const auto levelArenaSize = program.get<std::string>("--levelArenaSize");
+  if (levelArenaSize != "") configJs["Level Arena Size"] = std::stoul(levelArenaSize);
 
   // Getting expected result parameters
   auto expectedResult = jaffarCommon::json::getObject(configJs, "Expected Result");
@@ -108,6 +202,9 @@ int main(int argc, char *argv[])
   // Getting sequence file path
   std::string sequenceFilePath = program.get<std::string>("sequenceFile");
 
+  // State digests cover the archive past its size prefix, or the whole snapshot for level arena states
+  const size_t stateDigestOffset = configJs.contains("Level Arena Size") && configJs["Level Arena Size"].get<size_t>() > 0 ? 0 : sizeof(size_t);
+
   // Creating emulator instance
   auto e = jaffar::EmuInstance(configJs);
 
@@ -117,7 +214,7 @@ int main(int argc, char *argv[])
   // Disable rendering
   e.disableRendering();
 
-  // Getting full state size
+  // Getting initial state size
   const auto stateSize = e.getStateSize();
 
   // Loading sequence file
@@ -152,8 +249,17 @@ int main(int argc, char *argv[])
   printf("[] Sequence File:                          '%s'\n", sequenceFilePath.c_str());
   printf("[] Sequence Length:                        %lu\n", sequenceLength);
 
-  if (cycleType == "Rerecord")
+  if (cycleType == "Rerecord" || cycleType == "Delta" || cycleType == "Reload")
   printf("[] State Size:                             %lu bytes\n", stateSize);
+
+  if (cycleType == "Delta")
+  printf("[] Delta Keyframe Interval:                %d\n", deltaKeyframeInterval);
+
+  if (cycleType == "Rewind")
+  {
+    printf("[] Rewind Keyframe Interval:               %d\n", rewindKeyframeInterval);
+    printf("[] Rewind Full Keyframe Interval:          %lu\n", e.getRewindFullKeyframeInterval());
+  }
   
   // If warmup is enabled, run it now. This helps in reducing variation in performance results due to CPU throttling
   if (useWarmUp)
@@ -171,39 +277,210 @@ int main(int argc, char *argv[])
   fflush(stdout);
 
   // Serializing initial state
-  auto currentState = (uint8_t *)malloc(stateSize);
+  uint8_t *currentState = nullptr;
+  size_t currentStateCapacity = 0;
+  size_t currentStateSize = stateSize;
+  reserveStateBuffer(currentState, currentStateCapacity, currentStateSize);
   {
-    jaffarCommon::serializer::Contiguous cs(currentState);
+    jaffarCommon::serializer::Contiguous cs(currentState, currentStateSize);
     e.serializeState(cs);
   }
 
+  // Delta states are encoded against the last keyframe, and are at most twice the size of the full state
+  uint8_t *keyframeState = nullptr;
+  size_t keyframeStateCapacity = 0;
+  size_t keyframeStateSize = stateSize;
+  reserveStateBuffer(keyframeState, keyframeStateCapacity, keyframeStateSize);
+  memcpy(keyframeState, currentState, stateSize);
+
+  uint8_t *currentDelta = nullptr;
+  size_t currentDeltaCapacity = 0;
+  reserveStateBuffer(currentDelta, currentDeltaCapacity, sizeof(size_t) + 2 * stateSize + 16);
+  {
+    jaffarCommon::serializer::Contiguous s(currentDelta, currentDeltaCapacity);
+    e.serializeDeltaState(s, keyframeState, keyframeStateSize);
+  }
+  size_t deltaStateSizeSum = 0;
+  size_t inputsSinceKeyframe = 0;
+
+  // States saved right after a load, to compare against the loaded ones
+  uint8_t *reloadState = nullptr;
+  size_t reloadStateCapacity = 0;
+
+  // States stored with their digest, followed by the same state saved plainly
+  uint8_t *digestState = nullptr;
+  size_t digestStateCapacity = 0;
+
+  // Random inputs keyed per tic have their own generator, so they don't change the ones the cycles use
+  std::mt19937 inputCollapseRng{seed()};
+  std::map<jaffarCommon::hash::hash_t, jaffarCommon::hash::hash_t> inputKeyStateHashes;
+  uint8_t *collapseState = nullptr;
+  size_t collapseStateCapacity = 0;
+  size_t collapsedInputCount = 0;
+
+  std::vector<jaffar::playerInput_t> legalInputs;
+  size_t legalInputCount = 0;
+  size_t maxLegalInputCount = 0;
+
+  // States saved before and after enumerating the legal inputs, which has to leave the state as it was
+  uint8_t *legalState = nullptr;
+  size_t legalStateCapacity = 0;
+
+  // Rewind latency per depth
+  std::vector<double> rewindTimeSums(rewindDepths.size(), 0.0);
+  std::vector<size_t> rewindCounts(rewindDepths.size(), 0);
+  size_t maxRewindMemorySize = 0;
+
   // Check whether to perform each action
-  bool doPreAdvance = cycleType == "Rerecord";
-  bool doDeserialize = cycleType == "Rerecord";
-  bool doSerialize = cycleType == "Rerecord";
+  bool doPreAdvance = cycleType == "Rerecord" || cycleType == "Delta";
+  bool doDeserialize = cycleType == "Rerecord" || cycleType == "Reload";
+  bool doSerialize = cycleType == "Rerecord" || cycleType == "Reload";
+  bool doReload = cycleType == "Reload";
+  bool doDelta = cycleType == "Delta";
+  bool doRewind = cycleType == "Rewind";
+  if (doRewind == true) e.enableRewind(rewindBufferSize, rewindKeyframeInterval, e.getRewindFullKeyframeInterval());
 
   // Actually running the sequence
   auto t0 = std::chrono::high_resolution_clock::now();
-  for (const auto &input : decodedSequence)
+  for (size_t inputId = 0; inputId < sequenceLength; inputId++)
   {
+    const auto &input = decodedSequence[inputId];
+
     if (doPreAdvance == true) 
     {
-      for (size_t i = 0; i < rerecordDepth; i++) e.advanceState(generateRandomInput(rng));
+      for (int i = 0; i < rerecordDepth; i++) e.advanceState(generateRandomInput(rng));
+    }
+
+    // Running ahead through the next inputs of the sequence, whose world changes the load has to undo
+    jaffarCommon::hash::hash_t savedStateHash;
+    if (doReload == true)
+    {
+      savedStateHash = e.getStateHash();
+      for (size_t i = inputId; i < std::min(inputId + (size_t)rerecordDepth, sequenceLength); i++) e.advanceState(decodedSequence[i]);
     }
     
     if (doDeserialize == true)
     {
-      jaffarCommon::deserializer::Contiguous d(currentState, stateSize);
+      jaffarCommon::deserializer::Contiguous d(currentState, currentStateSize);
       e.deserializeState(d);
+      if (checkWorldHash == true && e.checkWorldHash() == false) { printf("[] Test Failed: World hash after a load differs from the rebuilt one (input %lu)\n", inputId); return -1; }
     } 
+
+    // Loading has to give back the saved state, and saving right after it the same bytes
+    if (doReload == true)
+    {
+      if (e.getStateHash() != savedStateHash) { printf("[] Test Failed: State hash after a load differs from the saved one (input %lu)\n", inputId); return -1; }
+
+      const auto reloadStateSize = e.getStateSize();
+      reserveStateBuffer(reloadState, reloadStateCapacity, reloadStateSize);
+      auto s = jaffarCommon::serializer::Contiguous(reloadState, reloadStateSize);
+      e.serializeState(s);
+      if (reloadStateSize != currentStateSize || memcmp(reloadState, currentState, currentStateSize) != 0) { printf("[] Test Failed: State saved after a load differs from the loaded one (input %lu)\n", inputId); return -1; }
+    }
+
+    if (doDelta == true)
+    {
+      jaffarCommon::deserializer::Contiguous d(currentDelta, currentDeltaCapacity);
+      e.deserializeDeltaState(d, keyframeState, keyframeStateSize);
+    }
     
+    if (inputCollapseCount > 0)
+    {
+      const auto collapseStateSize = e.getStateSize();
+      reserveStateBuffer(collapseState, collapseStateCapacity, collapseStateSize);
+      auto s = jaffarCommon::serializer::Contiguous(collapseState, collapseStateSize);
+      e.serializeState(s);
+
+      // Inputs with the same key have to reach the same state
+      inputKeyStateHashes.clear();
+      for (int i = 0; i < inputCollapseCount; i++)
+      {
+        const auto randomInput = generateRandomInput(inputCollapseRng);
+        const auto key = e.getInputKey(randomInput);
+        e.advanceState(randomInput);
+        const auto stateHash = e.getStateHash();
+        jaffarCommon::deserializer::Contiguous d(collapseState, collapseStateSize);
+        e.deserializeState(d);
+
+        const auto entry = inputKeyStateHashes.emplace(key, stateHash);
+        if (entry.first->second != stateHash) { printf("[] Test Failed: Inputs with the same key reached different states (input %lu)\n", inputId); return -1; }
+      }
+      collapsedInputCount += inputCollapseCount - inputKeyStateHashes.size();
+    }
+
+    if (useLegalInputs == true)
+    {
+      const auto legalStateSize = e.getStateSize();
+      reserveStateBuffer(legalState, legalStateCapacity, 2 * legalStateSize);
+      auto s = jaffarCommon::serializer::Contiguous(legalState, legalStateSize);
+      e.serializeState(s);
+
+      e.getLegalInputs(legalInputs);
+      legalInputCount += legalInputs.size();
+      maxLegalInputCount = std::max(maxLegalInputCount, legalInputs.size());
+
+      auto ls = jaffarCommon::serializer::Contiguous(&legalState[legalStateSize], legalStateSize);
+      e.serializeState(ls);
+      if (memcmp(legalState, &legalState[legalStateSize], legalStateSize) != 0) { printf("[] Test Failed: Enumerating the legal inputs changed the state (input %lu)\n", inputId); return -1; }
+    }
+
     e.advanceState(input);
+    if (checkWorldHash == true && e.checkWorldHash() == false) { printf("[] Test Failed: World hash after a tic differs from the rebuilt one (input %lu)\n", inputId); return -1; }
+
+    if (checkStateDigest == true)
+    {
+      const auto digestStateSize = e.getStateSize();
+      reserveStateBuffer(digestState, digestStateCapacity, 2 * digestStateSize);
+      jaffarCommon::hash::hash_t digest;
+      auto ds = jaffarCommon::serializer::Contiguous(digestState, digestStateSize);
+      e.serializeStateAndHash(ds, digest);
+      auto s = jaffarCommon::serializer::Contiguous(&digestState[digestStateSize], digestStateSize);
+      e.serializeState(s);
+      if (memcmp(digestState, &digestState[digestStateSize], digestStateSize) != 0) { printf("[] Test Failed: State stored with its digest differs from the saved one (input %lu)\n", inputId); return -1; }
+      if (digest != jaffarCommon::hash::calculateMetroHash(&digestState[stateDigestOffset], digestStateSize - stateDigestOffset)) { printf("[] Test Failed: State digest differs from the hash of its archive (input %lu)\n", inputId); return -1; }
+    }
 
     if (doSerialize == true)
     {
-      auto s = jaffarCommon::serializer::Contiguous(currentState, stateSize);
+      currentStateSize = e.getStateSize();
+      reserveStateBuffer(currentState, currentStateCapacity, currentStateSize);
+      auto s = jaffarCommon::serializer::Contiguous(currentState, currentStateSize);
       e.serializeState(s);
+      if (checkSaveSections == true && e.checkStateSections(currentState, currentStateSize) == false) { printf("[] Test Failed: Sections read back from a save differ from the game state (input %lu)\n", inputId); return -1; }
     } 
+
+    if (doDelta == true)
+    {
+      if (++inputsSinceKeyframe == (size_t)deltaKeyframeInterval)
+      {
+        keyframeStateSize = e.getStateSize();
+        reserveStateBuffer(keyframeState, keyframeStateCapacity, keyframeStateSize);
+        auto s = jaffarCommon::serializer::Contiguous(keyframeState, keyframeStateSize);
+        e.serializeState(s);
+        inputsSinceKeyframe = 0;
+      }
+
+      reserveStateBuffer(currentDelta, currentDeltaCapacity, sizeof(size_t) + 2 * e.getStateSize() + 16);
+      auto s = jaffarCommon::serializer::Contiguous(currentDelta, currentDeltaCapacity);
+      e.serializeDeltaState(s, keyframeState, keyframeStateSize);
+      deltaStateSizeSum += e.getEffectiveDeltaStateSize();
+    }
+
+    // Rewinding and replaying the same inputs brings the state back to this tic
+    if (doRewind == true)
+    {
+      const size_t depthId = inputId % rewindDepths.size();
+      const size_t depth = rewindDepths[depthId];
+      if (depth <= e.getRewindDepth())
+      {
+        const auto tr = std::chrono::high_resolution_clock::now();
+        e.rewind(depth);
+        rewindTimeSums[depthId] += (double)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::high_resolution_clock::now() - tr).count();
+        rewindCounts[depthId]++;
+        for (size_t i = inputId + 1 - depth; i <= inputId; i++) e.advanceState(decodedSequence[i]);
+      }
+      maxRewindMemorySize = std::max(maxRewindMemorySize, e.getRewindMemorySize());
+    }
   }
   auto tf = std::chrono::high_resolution_clock::now();
 
@@ -227,7 +504,32 @@ int main(int argc, char *argv[])
   printf("[] Final State Hash:                       %s\n", hashStringBuffer);
 
   if (cycleType == "Rerecord")
-  printf("[] Effective Save State Size:              %lu bytes\n", e.getEffectiveSaveStateSize());
+  {
+    printf("[] Effective Save State Size:              %lu bytes\n", e.getEffectiveSaveStateSize());
+    e.printSaveStateReport();
+  }
+
+  if (cycleType == "Delta")
+  {
+    printf("[] Effective Save State Size:              %lu bytes\n", e.getEffectiveSaveStateSize());
+    printf("[] Average Delta State Size:               %.1f bytes\n", (double)deltaStateSizeSum / (double)sequenceLength);
+  }
+
+  if (cycleType == "Rewind")
+  {
+    printf("[] Max Rewind Buffer Memory:               %lu bytes\n", maxRewindMemorySize);
+    for (size_t i = 0; i < rewindDepths.size(); i++)
+      if (rewindCounts[i] > 0) printf("[] Rewind Latency (%4lu tics):              %.3f us (%lu rewinds)\n", rewindDepths[i], rewindTimeSums[i] * 1.0e-3 / (double)rewindCounts[i], rewindCounts[i]);
+  }
+
+  if (inputCollapseCount > 0)
+  {
+    const double collapsedPerTic = (double)collapsedInputCount / (double)sequenceLength;
+    printf("[] Collapsed Random Inputs:                %.1f of %d per tic (%.1f%%)\n", collapsedPerTic, inputCollapseCount, 100.0 * collapsedPerTic / inputCollapseCount);
+  }
+
+  if (useLegalInputs == true)
+    printf("[] Legal Inputs:                           %.1f per tic (max %lu)\n", (double)legalInputCount / (double)sequenceLength, maxLegalInputCount);
 
   // Checking expected consitions
   auto mapNumber = e.getMapNumber ();
@@ -237,7 +539,7 @@ int main(int argc, char *argv[])
   if (mapNumber != expectedMapNumber) { printf("[] Test Failed: Map Number (%d) different from expected one (%d)\n", mapNumber, expectedMapNumber); return -1; }
 
   // These tests don't work correctly for rerecording
-  if (cycleType != "Rerecord")
+  if (cycleType == "Simple")
   {
     if (isLevelExit != expectedIsLevelExit) { printf("[] Test Failed: Failed to reach level exit on the last tic\n"); return -1; }
     if (isGameEnd != expectedIsGameEnd) { printf("[] Test Failed: Failed to reach game end on the last tic\n"); return -1; }
@@ -40,6 +40,14 @@ jaffar::input_t generateRandomInput(std::mt19937& rng)
   return randomInput;
 }
 
+// States vary in size, so buffers grow to fit the largest state stored in them
+void reserveStateBuffer(uint8_t *&buffer, size_t &capacity, const size_t size)
+{
+  if (size <= capacity) return;
+  buffer = (uint8_t *)realloc(buffer, size);
+  capacity = size;
+}
+
 int main(int argc, char *argv[])
 {
   // Parsing command line arguments
@@ -108,33 +116,35 @@ int main(int argc, char *argv[])
   // Creating emu instance vector
   std::vector<std::unique_ptr<jaffar::EmuInstance>> emulators;
   emulators.resize(maxThreads);
+
+  // The master instance runs on this thread, which is the first one of the parallel sections
+  const auto startupT0 = jaffarCommon::timing::now();
+  emulators[0] = std::make_unique<jaffar::EmuInstance>(configJs);
+  emulators[0]->initialize();
+  emulators[0]->recordStartState();
  
-  // Creating vectors
+  // Secondaries start from the master's state, since they load its states anyway
   JAFFAR_PARALLEL
   {
     // Getting my thread id
     int threadId = jaffarCommon::parallel::getThreadId();
 
     // Instantiating emus
-    emulators[threadId] = std::make_unique<jaffar::EmuInstance>(configJs);
+    if (threadId > 0) emulators[threadId] = emulators[0]->createFromStartState();
 
-    // Initializing emulator instance
-    emulators[threadId]->initialize();
-        
     // Disable rendering
     emulators[threadId]->disableRendering();
   }
+  printf("[] Instance Startup Time:                  %3.3fs\n", jaffarCommon::timing::timeDeltaSeconds(jaffarCommon::timing::now(), startupT0));
 
-  // Getting full state size
-  const auto stateSize = 1024 * 1024;
-  
   // Buffer for initial state data
-  auto initialStateData = (uint8_t *)malloc(stateSize);
+  const auto initialStateSize = emulators[0]->getStateSize();
+  auto initialStateData = (uint8_t *)malloc(initialStateSize);
 
-  // Buffer for state data
-  std::vector<uint8_t*> stateData;
-  stateData.resize(sequence.size());
-  for (size_t i = 0; i < sequence.size(); i++) stateData[i] = (uint8_t *)malloc(stateSize);
+  // Buffers for state data, sized as the master serializes each state
+  std::vector<uint8_t*> stateData(sequence.size(), nullptr);
+  std::vector<size_t> stateCapacities(sequence.size(), 0);
+  std::vector<size_t> stateSizes(sequence.size(), 0);
 
   // Number of iterations to run for
   size_t maxIterations = 100;
@@ -147,7 +157,7 @@ int main(int argc, char *argv[])
   for (const auto &inputString : sequence) decodedSequence.push_back(inputParser->parseInputString(inputString));
 
   // Getting initial state
-  jaffarCommon::serializer::Contiguous cs(initialStateData);
+  jaffarCommon::serializer::Contiguous cs(initialStateData, initialStateSize);
   emulators[0]->serializeState(cs);
 
   for (size_t iter = 0; iter < maxIterations; iter++)
@@ -155,7 +165,7 @@ int main(int argc, char *argv[])
     printf("Running iteration %lu / %lu\n", iter, maxIterations);
 
     // Re-loading initial state
-    jaffarCommon::deserializer::Contiguous d(initialStateData, stateSize);
+    jaffarCommon::deserializer::Contiguous d(initialStateData, initialStateSize);
     emulators[0]->deserializeState(d);
 
     // Starting parallel section
@@ -176,28 +186,28 @@ int main(int argc, char *argv[])
         // Master saves state
         if (threadId == 0)
         {
-          // Actually running the sequence
-          e.advanceState(input);
-
           // Saving state
-          jaffarCommon::serializer::Contiguous cs(stateData[i]);
+          stateSizes[i] = e.getStateSize();
+          reserveStateBuffer(stateData[i], stateCapacities[i], stateSizes[i]);
+          jaffarCommon::serializer::Contiguous cs(stateData[i], stateSizes[i]);
           e.serializeState(cs);
+
+          // Actually running the sequence
+          e.advanceState(input);
         }
 
         // Barrier
         JAFFAR_BARRIER;
       
+        // Secondaries load the master's state concurrently, no locking required
         if (threadId > 0)
         {
-          JAFFAR_CRITICAL
-          {
-            // Secondary loads state
-            jaffarCommon::deserializer::Contiguous d(stateData[i], stateSize);
-            e.deserializeState(d);
-
-            // Advancing state
-            e.advanceState(input);
-          }
+          // Secondary loads state
+          jaffarCommon::deserializer::Contiguous d(stateData[i], stateSizes[i]);
+          e.deserializeState(d);
+
+          // Advancing state
+          e.advanceState(input);
         }
 
         // Barrier
@@ -232,6 +242,40 @@ int main(int argc, char *argv[])
   // If failed, return now
   if (isSuccess == false) return -1;
 
+  // Measuring how cross-thread state loading scales with the number of threads.
+  // Every thread loads states produced by the master's instance and advances them.
+  printf("[] ********** Measuring Scaling **********\n");
+  std::vector<int> threadCounts;
+  for (int threadCount = 1; threadCount < maxThreads; threadCount *= 2) threadCounts.push_back(threadCount);
+  threadCounts.push_back(maxThreads);
+
+  double singleThreadRate = 0.0;
+  for (const auto threadCount : threadCounts)
+  {
+    auto t0 = jaffarCommon::timing::now();
+
+    // All threads take part, so each one keeps driving its own instance, but only the first ones work
+    JAFFAR_PARALLEL
+    {
+      int threadId = jaffarCommon::parallel::getThreadId();
+      auto& e = *emulators[threadId];
+
+      if (threadId < threadCount)
+        for (size_t i = 0; i < decodedSequence.size(); i++)
+        {
+          jaffarCommon::deserializer::Contiguous d(stateData[i], stateSizes[i]);
+          e.deserializeState(d);
+          e.advanceState(decodedSequence[i]);
+        }
+    }
+
+    auto elapsedTimeSeconds = jaffarCommon::timing::timeDeltaSeconds(jaffarCommon::timing::now(), t0);
+    double rate = (double)(threadCount * decodedSequence.size()) / elapsedTimeSeconds;
+    if (threadCount == 1) singleThreadRate = rate;
+    double speedup = rate / singleThreadRate;
+    printf("[] Threads: %3d - Load + Advance: %10.3f / s - Speedup: %6.3fx - Efficiency: %5.1f%%\n", threadCount, rate, speedup, 100.0 * speedup / threadCount);
+  }
+
   // If reached this point, everything ran ok
   printf("[] Successful Execution.\n");
   printf("[] Final State Hash:                       %s\n", verificationHash.c_str());
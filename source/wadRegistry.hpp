@@ -0,0 +1,145 @@
+#pragma once
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <climits>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <mutex>
+#include <string>
+#include <jaffarCommon/file.hpp>
+#include <jaffarCommon/hash.hpp>
+#include <jaffarCommon/json.hpp>
+
+namespace jaffar
+{
+
+// Process-wide registry of WAD files. The first instance to ask for a file maps it read-only and computes its
+// SHA1, and every later instance gets that same mapping and hash, so startup time and memory do not grow with the
+// number of instances. The core only ever reads from WAD buffers. Mappings live until the process exits.
+//
+// Hashing is most of a cold start, so the hashes can also persist across launches in a hash cache file. Its entries
+// are keyed by the file's real path, and only used while the file's size, modification time, inode and a hash of its
+// first and last bytes still match. This trades the full check for speed: a rewrite that keeps all of these, say one
+// that changes a lump in the middle and then restores the modification time, is not noticed.
+class WadRegistry
+{
+  public:
+
+  struct wad_t
+  {
+    const char* data;
+    size_t size;
+    std::string sha1;
+  };
+
+  // Returns the file mapping, or nullptr if the file could not be opened or mapped. The hash cache file is optional.
+  static const wad_t* get(const std::string& filePath, const std::string& hashCacheFilePath = "")
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    auto it = _wads.find(filePath);
+    if (it != _wads.end()) return &it->second;
+
+    int fd = open(filePath.c_str(), O_RDONLY);
+    if (fd < 0) return nullptr;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size == 0) { close(fd); return nullptr; }
+
+    void* data = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) return nullptr;
+
+    wad_t wad;
+    wad.data = (const char*) data;
+    wad.size = st.st_size;
+
+    // Without a hash cache file there is no entry to look up, nor its sampled bytes to hash
+    nlohmann::json cacheEntry;
+    if (hashCacheFilePath != "")
+    {
+      cacheEntry = getHashCacheEntry(filePath, st, wad);
+      wad.sha1 = loadCachedSHA1(hashCacheFilePath, cacheEntry);
+    }
+    if (wad.sha1 == "")
+    {
+      // The hashing interface takes a string, so this makes a transient copy, once per file
+      wad.sha1 = jaffarCommon::hash::getSHA1String(std::string(wad.data, wad.size));
+      if (hashCacheFilePath != "") storeCachedSHA1(hashCacheFilePath, cacheEntry, wad.sha1);
+    }
+
+    return &_wads.emplace(filePath, std::move(wad)).first->second;
+  }
+
+  private:
+
+  // Bytes hashed at each end of the file for the cache entry. They hold the WAD header and, usually, its lump directory.
+  static constexpr size_t _sampleSize = 65536;
+
+  // What identifies the version of a file that a cached hash belongs to
+  static nlohmann::json getHashCacheEntry(const std::string& filePath, const struct stat& st, const wad_t& wad)
+  {
+    const size_t sampleSize = std::min(wad.size, _sampleSize);
+    const auto head = jaffarCommon::hash::calculateMetroHash(wad.data, sampleSize);
+    const auto tail = jaffarCommon::hash::calculateMetroHash(wad.data + wad.size - sampleSize, sampleSize);
+    char sampleHash[128];
+    snprintf(sampleHash, sizeof(sampleHash), "0x%016lX%016lX%016lX%016lX", head.first, head.second, tail.first, tail.second);
+
+    char realPath[PATH_MAX];
+    nlohmann::json entry;
+    entry["Path"] = realpath(filePath.c_str(), realPath) != nullptr ? std::string(realPath) : filePath;
+    entry["Size"] = (uint64_t) st.st_size;
+    entry["Modification Time"] = (uint64_t) st.st_mtim.tv_sec * 1000000000u + (uint64_t) st.st_mtim.tv_nsec;
+    entry["Device"] = (uint64_t) st.st_dev;
+    entry["Inode"] = (uint64_t) st.st_ino;
+    entry["Sample Hash"] = std::string(sampleHash);
+    return entry;
+  }
+
+  // A missing or unreadable cache file is just an empty cache
+  static nlohmann::json loadHashCache(const std::string& hashCacheFilePath)
+  {
+    std::string cacheString;
+    if (jaffarCommon::file::loadStringFromFile(cacheString, hashCacheFilePath) == false) return nlohmann::json::object();
+    auto cache = nlohmann::json::parse(cacheString, nullptr, false);
+    return cache.is_object() ? cache : nlohmann::json::object();
+  }
+
+  // Returns the cached hash, or an empty string if there is none for this version of the file
+  static std::string loadCachedSHA1(const std::string& hashCacheFilePath, const nlohmann::json& entry)
+  {
+    const auto cache = loadHashCache(hashCacheFilePath);
+    const auto it = cache.find(entry["Path"].get<std::string>());
+    if (it == cache.end() || it->is_object() == false || it->contains("SHA1") == false) return "";
+
+    auto cachedEntry = *it;
+    const auto sha1 = cachedEntry["SHA1"];
+    cachedEntry.erase("SHA1");
+    if (cachedEntry != entry || sha1.is_string() == false) return "";
+    return sha1.get<std::string>();
+  }
+
+  // Other processes may update the cache at the same time, so it is read again right before writing, and replaced
+  // in a single rename. Failing to write it only means hashing again next time.
+  static void storeCachedSHA1(const std::string& hashCacheFilePath, const nlohmann::json& entry, const std::string& sha1)
+  {
+    auto cache = loadHashCache(hashCacheFilePath);
+    auto& cachedEntry = cache[entry["Path"].get<std::string>()];
+    cachedEntry = entry;
+    cachedEntry["SHA1"] = sha1;
+
+    const auto tempFilePath = hashCacheFilePath + "." + std::to_string(getpid()) + ".tmp";
+    if (jaffarCommon::file::saveStringToFile(cache.dump(2), tempFilePath.c_str()) == false) return;
+    if (rename(tempFilePath.c_str(), hashCacheFilePath.c_str()) != 0) unlink(tempFilePath.c_str());
+  }
+
+  static inline std::mutex _mutex;
+  static inline std::map<std::string, wad_t> _wads;
+};
+
+} // namespace jaffar
@@ -0,0 +1,136 @@
+#include <jaffarCommon/file.hpp>
+#include <jaffarCommon/hash.hpp>
+#include <jaffarCommon/json.hpp>
+#include "wadRegistry.hpp"
+#include <climits>
+#include <cstdio>
+#include <cstdlib>
+#include <fcntl.h>
+#include <string>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Checks of the WAD hash cache: hits, misses after the file changes, and corrupt cache files
+
+#define CHECK(condition) if ((condition) == false) { printf("[] Test Failed: %s (line %d)\n", #condition, __LINE__); return -1; }
+
+using jaffar::WadRegistry;
+
+static std::string _folder;
+static int _linkCount = 0;
+
+// The registry keeps every file it was asked for, so each lookup goes through a new link to the same file
+static const WadRegistry::wad_t* getThroughNewLink(const std::string& filePath, const std::string& hashCacheFilePath)
+{
+  const auto linkPath = _folder + "/link" + std::to_string(_linkCount++) + ".wad";
+  if (symlink(filePath.c_str(), linkPath.c_str()) != 0) return nullptr;
+  return WadRegistry::get(linkPath, hashCacheFilePath);
+}
+
+static bool writeFile(const std::string& filePath, const std::string& contents)
+{
+  return jaffarCommon::file::saveStringToFile(contents, filePath.c_str());
+}
+
+static nlohmann::json readCache(const std::string& hashCacheFilePath)
+{
+  std::string cacheString;
+  if (jaffarCommon::file::loadStringFromFile(cacheString, hashCacheFilePath) == false) return nlohmann::json();
+  return nlohmann::json::parse(cacheString, nullptr, false);
+}
+
+int main(int argc, char *argv[])
+{
+  char folderTemplate[] = "/tmp/wadRegistryTester.XXXXXX";
+  if (mkdtemp(folderTemplate) == nullptr) { printf("[] Test Failed: Could not create a temporary folder\n"); return -1; }
+  _folder = folderTemplate;
+
+  const auto wadPath = _folder + "/data.wad";
+  const auto cachePath = _folder + "/hashes.json";
+  char realWadPath[PATH_MAX];
+
+  // A file large enough for its middle to lie outside the sampled bytes at both ends
+  std::string contents(256 * 1024, 'A');
+  CHECK(writeFile(wadPath, contents));
+  CHECK(realpath(wadPath.c_str(), realWadPath) != nullptr);
+  const std::string cacheKey = realWadPath;
+
+  // Miss on an empty cache: the file is hashed and its hash stored
+  {
+    const auto wad = getThroughNewLink(wadPath, cachePath);
+    CHECK(wad != nullptr);
+    CHECK(wad->sha1 == jaffarCommon::hash::getSHA1String(contents));
+    const auto cache = readCache(cachePath);
+    CHECK(cache.is_object() && cache.contains(cacheKey));
+    CHECK(cache[cacheKey]["SHA1"] == wad->sha1);
+  }
+
+  // Hit: the stored hash is used without hashing again, as a planted one shows
+  {
+    auto cache = readCache(cachePath);
+    cache[cacheKey]["SHA1"] = "planted";
+    CHECK(writeFile(cachePath, cache.dump(2)));
+    const auto wad = getThroughNewLink(wadPath, cachePath);
+    CHECK(wad != nullptr);
+    CHECK(wad->sha1 == "planted");
+  }
+
+  // Miss after a rewrite that keeps the size, the inode and the modification time, but not the first bytes
+  {
+    struct stat st;
+    CHECK(stat(wadPath.c_str(), &st) == 0);
+    contents[0] = 'B';
+    FILE* file = fopen(wadPath.c_str(), "r+b");
+    CHECK(file != nullptr);
+    CHECK(fwrite(contents.data(), 1, 1, file) == 1);
+    fclose(file);
+    const struct timespec times[2] = { st.st_atim, st.st_mtim };
+    CHECK(utimensat(AT_FDCWD, wadPath.c_str(), times, 0) == 0);
+
+    const auto wad = getThroughNewLink(wadPath, cachePath);
+    CHECK(wad != nullptr);
+    CHECK(wad->sha1 == jaffarCommon::hash::getSHA1String(contents));
+    CHECK(readCache(cachePath)[cacheKey]["SHA1"] == wad->sha1);
+  }
+
+  // Miss after the file grows
+  {
+    auto cache = readCache(cachePath);
+    cache[cacheKey]["SHA1"] = "planted";
+    CHECK(writeFile(cachePath, cache.dump(2)));
+    contents += "C";
+    CHECK(writeFile(wadPath, contents));
+
+    const auto wad = getThroughNewLink(wadPath, cachePath);
+    CHECK(wad != nullptr);
+    CHECK(wad->sha1 == jaffarCommon::hash::getSHA1String(contents));
+  }
+
+  // A corrupt cache is an empty one, and gets replaced by a valid one
+  {
+    CHECK(writeFile(cachePath, "{ \"broken\": "));
+    const auto wad = getThroughNewLink(wadPath, cachePath);
+    CHECK(wad != nullptr);
+    CHECK(wad->sha1 == jaffarCommon::hash::getSHA1String(contents));
+    const auto cache = readCache(cachePath);
+    CHECK(cache.is_object() && cache.contains(cacheKey));
+    CHECK(cache[cacheKey]["SHA1"] == wad->sha1);
+  }
+
+  // An entry of the wrong shape is ignored too
+  {
+    CHECK(writeFile(cachePath, nlohmann::json({ { cacheKey, "not an entry" } }).dump()));
+    const auto wad = getThroughNewLink(wadPath, cachePath);
+    CHECK(wad != nullptr);
+    CHECK(wad->sha1 == jaffarCommon::hash::getSHA1String(contents));
+  }
+
+  // Cleaning up
+  for (int i = 0; i < _linkCount; i++) unlink((_folder + "/link" + std::to_string(i) + ".wad").c_str());
+  unlink(wadPath.c_str());
+  unlink(cachePath.c_str());
+  rmdir(_folder.c_str());
+
+  printf("[] Successful Execution.\n");
+  return 0;
+}
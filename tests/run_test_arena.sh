@@ -0,0 +1,59 @@
+#!/bin/bash
+
+# Stop if anything fails
+set -e
+
+# Getting executable path
+newExecutable=${1}
+
+# Getting script name
+script=${2}
+
+# Getting additional arguments
+testerArgs=${@:3}
+
+# Getting current folder (game name)
+folder=`basename $PWD`
+
+# Getting pid (for uniqueness)
+pid=$$
+
+# Hash files
+newHashFile="/tmp/newDSDA.${folder}.${script}.${pid}.hash"
+
+# Removing them if already present
+rm -f ${newHashFile}.rerecord
+rm -f ${newHashFile}.arena
+
+# Level arena size for the arena runs
+arenaSize=67108864
+
+set -x
+
+# Running script on quickerDSDA (Rerecord)
+${newExecutable} ${script} --hashOutputFile ${newHashFile}.rerecord ${testerArgs} --cycleType Rerecord --rerecordDepth 4 --levelArenaSize 0
+
+# Running script on quickerDSDA (Rerecord, level arena states)
+${newExecutable} ${script} --hashOutputFile ${newHashFile}.arena ${testerArgs} --cycleType Rerecord --rerecordDepth 4 --levelArenaSize ${arenaSize}
+
+# Running script on quickerDSDA (Reload, level arena states)
+${newExecutable} ${script} ${testerArgs} --cycleType Reload --rerecordDepth 35 --hashScope 'Full World' --levelArenaSize ${arenaSize}
+
+set +x
+
+# Comparing hashes
+newHashRerecord=`cat ${newHashFile}.rerecord`
+newHashArena=`cat ${newHashFile}.arena`
+
+# Removing temporary files
+rm -f ${newHashFile}.rerecord ${newHashFile}.arena
+
+# Compare hashes (Rerecord)
+if [ "${newHashRerecord}" = "${newHashArena}" ]; then
+ echo "[] Level Arena Rerecord Test Passed"
+else
+ echo "[] Level Arena Rerecord Test Failed"
+ exit -1
+fi
+
+exit 0
@@ -27,6 +27,7 @@ newHashFile="/tmp/newDSDA.${folder}.${script}.${pid}.hash"
 rm -f ${baseHashFile}
 rm -f ${newHashFile}.simple
 rm -f ${newHashFile}.rerecord
+rm -f ${newHashFile}.delta
 
 set -x
 
@@ -39,15 +40,19 @@ ${newExecutable} ${script} --hashOutputFile ${newHashFile}.simple ${testerArgs}
 # Running script on quickerDSDA (Rerecord)
 ${newExecutable} ${script} --hashOutputFile ${newHashFile}.rerecord ${testerArgs} --cycleType Rerecord --rerecordDepth 1
 
+# Running script on quickerDSDA (Delta)
+${newExecutable} ${script} --hashOutputFile ${newHashFile}.delta ${testerArgs} --cycleType Delta --rerecordDepth 1
+
 set +x
 
 # Comparing hashes
 baseHash=`cat ${baseHashFile}.simple`
 newHashSimple=`cat ${newHashFile}.simple`
 newHashRerecord=`cat ${newHashFile}.rerecord`
+newHashDelta=`cat ${newHashFile}.delta`
 
 # Removing temporary files
-rm -f ${baseHashFile}.simple ${newHashFile}.simple ${newHashFile}.rerecord
+rm -f ${baseHashFile}.simple ${newHashFile}.simple ${newHashFile}.rerecord ${newHashFile}.delta
 
 # Compare hashes (Simple)
 if [ "${baseHash}" = "${newHashSimple}" ]; then
@@ -65,4 +70,12 @@ else
  exit -1
 fi
 
+# Compare hashes (Delta)
+if [ "${baseHash}" = "${newHashDelta}" ]; then
+ echo "[] Delta Test Passed"
+else
+ echo "[] Delta Test Failed"
+ exit -1
+fi
+
 exit 0
\ No newline at end of file